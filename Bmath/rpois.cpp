@@ -74,7 +74,8 @@ namespace Rmath{
 
 double rpois_mt(BOOM::RNG &rng, double mu){
   std::poisson_distribution<unsigned int> dist(mu);
-  return dist(rng.generator());
+  BOOM::RNG::BitGenerator bits(rng);
+  return dist(bits);
 }
 
 double rpois(double mu)
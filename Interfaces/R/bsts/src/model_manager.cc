@@ -15,6 +15,7 @@
 // Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
 
 #include <string>
+#include <thread>
 
 #include "model_manager.h"
 #include "state_space_gaussian_model_manager.h"
@@ -221,6 +222,32 @@ namespace BOOM {
       for (int s = 0; s < model->number_of_state_models(); ++s) {
         model->state_model(s)->observe_time_dimension(max_time);
       }
+      StateSpaceForecaster::Simulator simulator = ForecastSimulator();
+      if (simulator) {
+        // Collect the MCMC draws, and let the forecaster distribute them
+        // among clones of the model.
+        Matrix parameter_draws;
+        Matrix final_states;
+        for (int i = 0; i < iterations_after_burnin; ++i) {
+          io_manager.stream();
+          Vector parameters = model->vectorize_params(true);
+          if (i == 0) {
+            parameter_draws.resize(iterations_after_burnin, parameters.size());
+            final_states.resize(iterations_after_burnin,
+                                this->final_state().size());
+          }
+          parameter_draws.row(i) = parameters;
+          final_states.row(i) = this->final_state();
+        }
+        StateSpaceForecaster forecaster(model, simulator);
+        forecaster.set_refilter(refilter);
+        forecaster.set_number_of_threads(std::min<int>(
+            iterations_after_burnin,
+            static_cast<int>(std::thread::hardware_concurrency()) - 1));
+        return forecaster.forecast(
+            parameter_draws, final_states, forecast_horizon, rng());
+      }
+
       Matrix ans(iterations_after_burnin, forecast_horizon);
       for (int i = 0; i < iterations_after_burnin; ++i) {
         io_manager.stream();
@@ -20,6 +20,7 @@
 #include "r_interface/boom_r_tools.hpp"
 #include "r_interface/list_io.hpp"
 #include "Models/StateSpace/StateSpaceModelBase.hpp"
+#include "Models/StateSpace/StateSpaceForecaster.hpp"
 #include "Models/StateSpace/Multivariate/MultivariateStateSpaceModelBase.hpp"
 
 #include "timestamp_info.h"
@@ -302,6 +303,15 @@ namespace BOOM {
       // the posterior predictive forecast distribution.
       virtual Vector SimulateForecast(const Vector &final_state) = 0;
 
+      // Managers whose forecasts depend only on the model parameters, the
+      // final state, and the data obtained by UnpackForecastData() can return
+      // a simulator here, which Forecast() will use to spread the MCMC draws
+      // across threads.  The simulator will be called on clones of the
+      // managed model.  The default is an empty function, in which case the
+      // draws are forecast sequentially using SimulateForecast().
+      virtual StateSpaceForecaster::Simulator ForecastSimulator() {
+        return StateSpaceForecaster::Simulator();
+      }
     };
 
     //=========================================================================
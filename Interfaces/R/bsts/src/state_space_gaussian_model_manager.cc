@@ -123,6 +123,14 @@ Vector StateSpaceModelManager::SimulateForecast(const Vector &final_state) {
   return model_->simulate_forecast(rng(), forecast_horizon_, final_state);
 }
 
+StateSpaceForecaster::Simulator StateSpaceModelManager::ForecastSimulator() {
+  return [](ScalarStateSpaceModelBase *model, RNG &rng, int horizon,
+            const Vector &final_state) {
+    return dynamic_cast<StateSpaceModel *>(model)->simulate_forecast(
+        rng, horizon, final_state);
+  };
+}
+
 void StateSpaceModelManager::AddData(
     const Vector &response,
     const std::vector<bool> &response_is_observed) {
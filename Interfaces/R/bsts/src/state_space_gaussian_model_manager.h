@@ -90,6 +90,7 @@ class StateSpaceModelManager
   void AddDataFromList(SEXP r_data_list) override;
   int UnpackForecastData(SEXP r_prediction_data) override;
   Vector SimulateForecast(const Vector &final_state) override;
+  StateSpaceForecaster::Simulator ForecastSimulator() override;
 
  private:
   void AddData(const Vector &response,
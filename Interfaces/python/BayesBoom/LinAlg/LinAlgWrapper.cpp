@@ -5,11 +5,13 @@
 #include <pybind11/numpy.h>
 #include <memory>
 #include <cpputil/report_error.hpp>
+#include "LinAlg/Array.hpp"
 #include "LinAlg/Cholesky.hpp"
 #include "LinAlg/EigenMap.hpp"
 #include "LinAlg/Matrix.hpp"
 #include "LinAlg/Selector.hpp"
 #include "LinAlg/SpdMatrix.hpp"
+#include "LinAlg/SubMatrix.hpp"
 #include "LinAlg/CorrelationMatrix.hpp"
 #include "LinAlg/Vector.hpp"
 #include "LinAlg/VectorView.hpp"
@@ -19,14 +21,100 @@ namespace py = pybind11;
 namespace BayesBoom {
   using namespace BOOM;
 
+  namespace {
+    // Numpy arrays whose dtype is not float64 are converted when they are
+    // passed to a constructor that copies.  They must already be float64 to
+    // be aliased by a view.
+    using DoubleArray = py::array_t<double, py::array::forcecast>;
+
+    // The strides of a buffer, measured in doubles rather than bytes.
+    std::vector<int> element_strides(const py::buffer_info &info) {
+      if (info.format != py::format_descriptor<double>::format()) {
+        report_error("Buffer must contain 64 bit floating point numbers.");
+      }
+      std::vector<int> ans(info.ndim);
+      for (int i = 0; i < info.ndim; ++i) {
+        if (info.strides[i] % static_cast<py::ssize_t>(sizeof(double)) != 0) {
+          report_error("Buffer strides must be a multiple of the element "
+                       "size.");
+        }
+        ans[i] = info.strides[i] / static_cast<py::ssize_t>(sizeof(double));
+      }
+      return ans;
+    }
+
+    std::vector<int> buffer_dims(const py::buffer_info &info) {
+      return std::vector<int>(info.shape.begin(), info.shape.end());
+    }
+
+    // A view of a 1-D buffer.  The view aliases the buffer's memory.
+    VectorView vector_view(const py::buffer_info &info) {
+      if (info.ndim != 1) {
+        report_error("A vector can only be created from a 1-D array.");
+      }
+      std::vector<int> strides = element_strides(info);
+      return VectorView(static_cast<double *>(info.ptr), info.shape[0],
+                        strides[0]);
+    }
+
+    // Copy a 1-D or 2-D buffer of doubles, with arbitrary strides, into a
+    // Matrix.  A 1-D buffer becomes a single column.
+    Matrix matrix_from_buffer(const py::buffer_info &info) {
+      if (info.ndim < 1 || info.ndim > 2) {
+        report_error("A Matrix can only be created from a 1-D or 2-D array.");
+      }
+      std::vector<int> strides = element_strides(info);
+      int nrow = info.shape[0];
+      int ncol = info.ndim == 2 ? info.shape[1] : 1;
+      int row_stride = strides[0];
+      int col_stride = info.ndim == 2 ? strides[1] : 0;
+      const double *data = static_cast<const double *>(info.ptr);
+      Matrix ans(nrow, ncol);
+      for (int j = 0; j < ncol; ++j) {
+        const double *column = data + j * col_stride;
+        for (int i = 0; i < nrow; ++i) {
+          ans(i, j) = column[i * row_stride];
+        }
+      }
+      return ans;
+    }
+
+    // Buffer descriptions for exposing BOOM objects to numpy without copying.
+    // BOOM matrices are stored in column major order.
+    py::buffer_info vector_buffer(double *data, int size, int stride) {
+      return py::buffer_info(
+          data, sizeof(double), py::format_descriptor<double>::format(), 1,
+          {size}, {sizeof(double) * stride});
+    }
+
+    py::buffer_info matrix_buffer(double *data, int nrow, int ncol,
+                                  int leading_dimension) {
+      return py::buffer_info(
+          data, sizeof(double), py::format_descriptor<double>::format(), 2,
+          {nrow, ncol},
+          {sizeof(double), sizeof(double) * leading_dimension});
+    }
+  }  // namespace
+
   void LinAlg_def(py::module &boom) {
 
-    py::class_<Vector, std::unique_ptr<Vector>>(boom, "Vector")
-        .def(py::init( [] (Eigen::Ref<Eigen::VectorXd> numpy_array) {
-              VectorView view(numpy_array.data(), numpy_array.size(), 1);
-              return std::unique_ptr<Vector>(new Vector(view));
+    // Vector, Matrix, SpdMatrix and Array support the buffer protocol, so
+    // numpy.asarray(boom_object) aliases the memory owned by the BOOM object
+    // without copying it.  The BOOM object must outlive the numpy array.
+    // These classes own their data, so creating one from a numpy array makes
+    // a single copy.  The view classes (VectorView, SubMatrix and ArrayView)
+    // alias the memory of the numpy array they are created from, which is
+    // kept alive for as long as the view exists.
+    py::class_<Vector, std::unique_ptr<Vector>>(
+        boom, "Vector", py::buffer_protocol())
+        .def(py::init( [] (const DoubleArray &numpy_array) {
+              return std::unique_ptr<Vector>(
+                  new Vector(vector_view(numpy_array.request())));
             }),
-          "Create a Vector from a numpy array.  Be sure the dtype is float!")
+          "Create a Vector by copying a 1-D numpy array.")
+        .def_buffer([](Vector &v) {
+            return vector_buffer(v.data(), v.size(), 1);
+          })
         .def("all_finite", &Vector::all_finite,
              "Returns true iff all elements are finite.")
         .def_property_readonly("randomize", &Vector::randomize,
@@ -86,17 +174,30 @@ namespace BayesBoom {
     py::implicitly_convertible<py::array, Vector>();
 
     // =========================================================================
-    py::class_<VectorView>(boom, "VectorView")
+    py::class_<VectorView>(boom, "VectorView", py::buffer_protocol())
+        .def_buffer([](VectorView &v) {
+            return vector_buffer(v.data(), v.size(), v.stride());
+          })
         .def(py::init(
             [](Vector &v, int first) {
               return VectorView(v, first);
             }),
              py::arg("v"),
              py::arg("first") = 0,
+             py::keep_alive<1, 2>(),
              "Create a VectorView from a boom.Vector.\n\n"
              "Args:\n"
              "  v:  The vector containing data for the view.\n"
              "  first: The first element in the view.")
+        .def(py::init(
+            [](py::buffer numpy_array) {
+              return vector_view(numpy_array.request(true));
+            }),
+             py::arg("numpy_array"),
+             py::keep_alive<1, 2>(),
+             "Create a VectorView that aliases the memory of a 1-D numpy array "
+             "of dtype float64.  Changes to the view are visible in the array, "
+             "and vice versa.")
         .def("__getitem__", [](const VectorView &v, int i) {return v[i];}, py::is_operator())
         .def("__setitem__", [](VectorView &v, int i, double value) {return v[i] = value;},
              py::is_operator())
@@ -116,22 +217,23 @@ namespace BayesBoom {
         ;
 
     // =========================================================================
-    py::class_<Matrix>(boom, "Matrix")
+    py::class_<Matrix>(boom, "Matrix", py::buffer_protocol())
         .def(py::init<int, int, double>(),
              py::arg("nrow") = 0,
              py::arg("ncol") = 0,
              py::arg("value") = 0.0,
              "Create a matrix with the specified number of rows and columns, "
              "with all elements set to the the given value")
-        .def(py::init( [] (const Eigen::MatrixXd &numpy_array) {
+        .def(py::init( [] (const DoubleArray &numpy_array) {
               return std::unique_ptr<Matrix>(
-                  new Matrix(numpy_array.rows(),
-                             numpy_array.cols(),
-                             numpy_array.data(),
-                             false));   // byrow.  False means column-storage order.
+                  new Matrix(matrix_from_buffer(numpy_array.request())));
             }),
-          "Create a Matrix from a 2-D numpy array."
+          "Create a Matrix by copying a 2-D numpy array.  Either C or "
+          "Fortran storage order is accepted."
           )
+        .def_buffer([](Matrix &m) {
+            return matrix_buffer(m.data(), m.nrow(), m.ncol(), m.nrow());
+          })
         .def("__getitem__",
              [](const Matrix &m, py::tuple ij) {
                int i = ij[0].cast<int>();
@@ -194,21 +296,78 @@ namespace BayesBoom {
     py::implicitly_convertible<py::array, Matrix>();
 
     // ===========================================================================
-    py::class_<SpdMatrix, Matrix>(boom, "SpdMatrix")
+    py::class_<SubMatrix>(boom, "SubMatrix", py::buffer_protocol())
+        .def(py::init(
+            [](py::buffer numpy_array) {
+              py::buffer_info info = numpy_array.request(true);
+              if (info.ndim != 2) {
+                report_error("A SubMatrix can only view a 2-D array.");
+              }
+              std::vector<int> strides = element_strides(info);
+              if (strides[0] != 1 && info.shape[0] > 1) {
+                report_error("A SubMatrix can only view an array whose "
+                             "columns are contiguous (e.g. Fortran order).");
+              }
+              SubMatrix ans;
+              ans.reset(static_cast<double *>(info.ptr), info.shape[0],
+                        info.shape[1], strides[1]);
+              return ans;
+            }),
+             py::arg("numpy_array"),
+             py::keep_alive<1, 2>(),
+             "Create a SubMatrix that aliases the memory of a 2-D numpy array "
+             "of dtype float64 with contiguous columns, such as an array "
+             "created with order='F'.  Changes to the view are visible in the "
+             "array, and vice versa.")
+        .def(py::init([](Matrix &m) {return SubMatrix(m);}),
+             py::arg("m"),
+             py::keep_alive<1, 2>(),
+             "Create a SubMatrix viewing all of a boom.Matrix.")
+        .def_buffer([](SubMatrix &m) {
+            int leading_dimension = m.ncol() > 1
+                ? &m(0, 1) - &m(0, 0)
+                : m.nrow();
+            return matrix_buffer(m.nrow() * m.ncol() > 0 ? &m(0, 0) : nullptr,
+                                 m.nrow(), m.ncol(), leading_dimension);
+          })
+        .def_property_readonly("nrow", &SubMatrix::nrow,
+                               "The number of rows in the matrix.")
+        .def_property_readonly("ncol", &SubMatrix::ncol,
+                               "The number of columns in the matrix.")
+        .def("__getitem__",
+             [](const SubMatrix &m, py::tuple ij) {
+               int i = ij[0].cast<int>();
+               int j = ij[1].cast<int>();
+               return m(i, j);},
+             "Element access.")
+        .def("__setitem__",
+             [](SubMatrix &m, py::tuple ij, double value) {
+               int i = ij[0].cast<int>();
+               int j = ij[1].cast<int>();
+               m(i, j) = value;
+             },
+             "Element assignment.")
+        .def("to_matrix", &SubMatrix::to_matrix,
+             "A boom.Matrix containing a copy of the viewed data.")
+        ;
+
+    // ===========================================================================
+    py::class_<SpdMatrix, Matrix>(boom, "SpdMatrix", py::buffer_protocol())
         .def(py::init<int, double>(),
              py::arg("dim") = 0,
              py::arg("diagonal_value") = 1.0,
              "Create a symmetric positive definite matrix of the given dimension. "
              "The diagonal elements are constant and equal to 'digaonal_value'. "
              )
-        .def(py::init([] (const Eigen::MatrixXd &numpy_spd) {
-              return std::unique_ptr<SpdMatrix>(
-                  new SpdMatrix(numpy_spd.cols(),
-                                numpy_spd.data(),
-                                false));
+        .def(py::init([] (const DoubleArray &numpy_spd) {
+              Matrix m = matrix_from_buffer(numpy_spd.request());
+              return std::unique_ptr<SpdMatrix>(new SpdMatrix(m));
                        }),
           "Create a symmetric positive definite matrix by copying data "
           "from a 2-D numpy array.")
+        .def_buffer([](SpdMatrix &m) {
+            return matrix_buffer(m.data(), m.nrow(), m.ncol(), m.nrow());
+          })
         .def(py::init([] (const Matrix &m) {
                         return std::unique_ptr<SpdMatrix>(
                             new SpdMatrix(m));
@@ -265,6 +424,73 @@ namespace BayesBoom {
 
     py::implicitly_convertible<py::array, SpdMatrix>();
 
+    // ===========================================================================
+    py::class_<Array>(boom, "Array", py::buffer_protocol())
+        .def(py::init([] (const DoubleArray &numpy_array) {
+              py::buffer_info info = numpy_array.request();
+              std::vector<int> dims = buffer_dims(info);
+              Array ans(dims);
+              ans = ConstArrayView(static_cast<const double *>(info.ptr),
+                                   dims, element_strides(info));
+              return ans;
+            }),
+             py::arg("numpy_array"),
+             "Create an Array by copying a numpy array of any dimension.")
+        .def_buffer([](Array &a) {
+            std::vector<py::ssize_t> strides;
+            for (int stride : a.strides()) {
+              strides.push_back(sizeof(double) * stride);
+            }
+            return py::buffer_info(
+                a.data(), sizeof(double),
+                py::format_descriptor<double>::format(), a.ndim(),
+                std::vector<py::ssize_t>(a.dim().begin(), a.dim().end()),
+                strides);
+          })
+        .def_property_readonly("ndim", &Array::ndim,
+                               "The number of dimensions in the array.")
+        .def_property_readonly(
+            "dim", [](const Array &a) {return a.dim();},
+            "A list giving the extent of each array dimension.")
+        .def("__getitem__",
+             [](const Array &a, const std::vector<int> &index) {
+               return a[index];
+             },
+             "Element access.  The index is a tuple with one entry per "
+             "dimension.")
+        ;
+    py::implicitly_convertible<py::array, Array>();
+
+    py::class_<ArrayView>(boom, "ArrayView", py::buffer_protocol())
+        .def(py::init(
+            [](py::buffer numpy_array) {
+              py::buffer_info info = numpy_array.request(true);
+              return ArrayView(static_cast<double *>(info.ptr),
+                               buffer_dims(info), element_strides(info));
+            }),
+             py::arg("numpy_array"),
+             py::keep_alive<1, 2>(),
+             "Create an ArrayView that aliases the memory of a numpy array of "
+             "dtype float64.  Changes to the view are visible in the array, "
+             "and vice versa.")
+        .def_buffer([](ArrayView &a) {
+            std::vector<py::ssize_t> strides;
+            for (int stride : a.strides()) {
+              strides.push_back(sizeof(double) * stride);
+            }
+            return py::buffer_info(
+                a.data(), sizeof(double),
+                py::format_descriptor<double>::format(), a.ndim(),
+                std::vector<py::ssize_t>(a.dim().begin(), a.dim().end()),
+                strides);
+          })
+        .def_property_readonly("ndim", &ArrayView::ndim,
+                               "The number of dimensions in the array.")
+        .def_property_readonly(
+            "dim", [](const ArrayView &a) {return a.dim();},
+            "A list giving the extent of each array dimension.")
+        ;
+
     py::class_<Cholesky>(boom, "Cholesky")
         .def(py::init<const Matrix &>(),
              py::arg("A"),
@@ -65,6 +65,37 @@ class LinAlgTest(unittest.TestCase):
         vv /= 2.0
         self.assertEqual(v[1], 1.0)
 
+    def test_zero_copy(self):
+        # numpy arrays created from boom objects share their memory.
+        v = boom.Vector(np.array([1.0, 2.0, 3.0]))
+        vn = np.asarray(v)
+        vn[1] = 7.0
+        self.assertEqual(v[1], 7.0)
+
+        m = boom.Matrix(np.array([[1.0, 2], [3, 4.0]]))
+        mn = np.asarray(m)
+        self.assertTrue(np.array_equal(mn, m.to_numpy()))
+        mn[0, 1] = -1.0
+        self.assertEqual(m[0, 1], -1.0)
+
+        # Views created from numpy arrays alias the numpy memory.
+        x = np.array([1.0, 2.0, 3.0, 4.0])
+        xv = boom.VectorView(x[::2])
+        xv[1] = 12.0
+        self.assertEqual(x[2], 12.0)
+
+        X = np.asfortranarray(np.random.randn(3, 4))
+        Xv = boom.SubMatrix(X)
+        Xv[2, 1] = 8.0
+        self.assertEqual(X[2, 1], 8.0)
+
+    def test_array(self):
+        x = np.random.randn(2, 3, 4)
+        a = boom.Array(x)
+        self.assertEqual(a.dim, [2, 3, 4])
+        self.assertEqual(a[1, 2, 3], x[1, 2, 3])
+        self.assertTrue(np.array_equal(np.asarray(a), x))
+
 
 _debug_mode = False
 
@@ -239,12 +239,39 @@ namespace BayesBoom {
              [](GaussianProcessRegressionModel *model,
                 const Vector &x) {
                return model->predict(x);
-             })
+             },
+             py::call_guard<py::gil_scoped_release>())
         .def("predict_distribution",
              [](GaussianProcessRegressionModel *model,
                 const Matrix &X) {
                return model->predict_distribution(X);
-             })
+             },
+             py::call_guard<py::gil_scoped_release>())
+        .def("set_inducing_points",
+             [](GaussianProcessRegressionModel *model,
+                const Matrix &inducing_points,
+                const std::string &method) {
+               GaussianProcessRegressionModel::InducingPointMethod
+                   method_enum = GaussianProcessRegressionModel::FITC;
+               if (method == "VFE") {
+                 method_enum = GaussianProcessRegressionModel::VFE;
+               } else if (method != "FITC") {
+                 report_error("method must be 'FITC' or 'VFE'.");
+               }
+               model->set_inducing_points(inducing_points, method_enum);
+             },
+             py::arg("inducing_points"),
+             py::arg("method") = "FITC",
+             "Use a low rank approximation to the kernel matrix.\n\n"
+             "Args:\n\n"
+             "  inducing_points: A boom.Matrix with one row per inducing "
+             "point.\n"
+             "  method:  Either 'FITC' or 'VFE'.\n")
+        .def("clear_inducing_points",
+             [](GaussianProcessRegressionModel *model) {
+               model->clear_inducing_points();
+             },
+             "Return to the exact (full rank) kernel matrix.")
         ;
 
     //==========================================================================
@@ -92,7 +92,8 @@ namespace BayesBoom {
         .def("set_mean_sd", &GaussianModel::set_params,
              py::arg("mean"),
              py::arg("sd"))
-        .def("mle", &GaussianModel::mle)
+        .def("mle", &GaussianModel::mle,
+             py::call_guard<py::gil_scoped_release>())
         .def("log_likelihood", &GaussianModel::Loglike)
         .def("set_data", [](GaussianModel &model, const Vector &data) {
             for (const auto &el: data) {
@@ -105,7 +106,8 @@ namespace BayesBoom {
           "Args:\n"
           "  data: a boom.Vector containing the data values."
           )
-        .def("sample_posterior", &GaussianModel::sample_posterior)
+        .def("sample_posterior", &GaussianModel::sample_posterior,
+             py::call_guard<py::gil_scoped_release>())
         .def_property_readonly(
             "mean_parameter",
             [] (const GaussianModel &model) {
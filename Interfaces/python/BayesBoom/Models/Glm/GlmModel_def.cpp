@@ -931,6 +931,22 @@ namespace BayesBoom {
              "  max_flips:  At most this many model exploration steps will be "
              "attempted each iteration.\n"
              "")
+        .def("use_polya_gamma_augmentation",
+             [](BinomialLogitSpikeSlabSampler *sampler, bool tf) {
+               sampler->use_polya_gamma_augmentation(tf);
+             },
+             py::arg("tf") = true,
+             "Args:\n\n"
+             "  tf:  If True the latent data are imputed using Polya-Gamma "
+             "data augmentation.  If False the auxiliary mixture sampler is "
+             "used.\n")
+        .def("set_number_of_workers",
+             [](BinomialLogitSpikeSlabSampler *sampler, int n) {
+               sampler->set_number_of_workers(n);
+             },
+             py::arg("n"),
+             "Args:\n\n"
+             "  n:  The number of workers to use when imputing latent data.\n")
         ;
 
     py::class_<PoissonRegressionSpikeSlabSampler,
@@ -141,6 +141,7 @@ namespace BayesBoom {
              [](MvRegCopulaDataImputer &imputer) {
                imputer.sample_posterior();
              },
+             py::call_guard<py::gil_scoped_release>(),
              "Take one draw from the posterior distribution")
         .def("impute_data_set",
              [](MvRegCopulaDataImputer &imputer,
@@ -288,6 +289,7 @@ namespace BayesBoom {
              "    any intervening numeric variables." )
         .def("sample_posterior",
              &MixedDataImputerWithErrorCorrection::sample_posterior,
+             py::call_guard<py::gil_scoped_release>(),
              "Take one MCMC draw from the posterior distribution.")
         .def("impute_data_set",
              [](MixedDataImputer &imputer, DataTable &table, int burn) {
@@ -329,6 +331,7 @@ namespace BayesBoom {
             "ydim", &MixedDataImputer::ydim, "Number of numeric columns.")
         .def("sample_posterior",
              &MixedDataImputer::sample_posterior,
+             py::call_guard<py::gil_scoped_release>(),
              "Take one MCMC draw from the posterior distribution.")
         .def_property_readonly(
             "coefficients",
@@ -574,6 +577,7 @@ namespace BayesBoom {
 
         .def("sample_posterior",
              &MixedDataImputerWithErrorCorrection::sample_posterior,
+             py::call_guard<py::gil_scoped_release>(),
              "Take one MCMC draw from the posterior distribution.")
         .def("impute_data_set",
              [](MixedDataImputerWithErrorCorrection &imputer,
@@ -106,6 +106,7 @@ namespace BayesBoom {
              "called every time 'sample_posterior' is invoked.\n"
              )
         .def("sample_posterior", &PriorPolicy::sample_posterior,
+             py::call_guard<py::gil_scoped_release>(),
              "Take one draw from the posterior distribution of model \n"
              "parameters given data.  The work for this draw is \n"
              "performed by any posterior samplers that have been assigned \n"
@@ -100,6 +100,7 @@ namespace BayesBoom {
         .def_property_readonly(
             "smoothed_state_mean",
             [](MultivariateStateSpaceModelBase &model) {
+              py::gil_scoped_release release;
               model.kalman_filter();
               model.kalman_smoother();
               return model.state_mean();
@@ -388,6 +389,7 @@ namespace BayesBoom {
                 int max_tries) {
                return model.mle(epsilon, max_tries);
              },
+             py::call_guard<py::gil_scoped_release>(),
              py::arg("epsilon"),
              py::arg("max_tries") = 500,
              "Set model parameters to their maximum likelihood estimates.\n"
@@ -483,6 +485,7 @@ namespace BayesBoom {
 
 
              },
+             py::call_guard<py::gil_scoped_release>(),
              py::arg("time"),
              py::arg("response"),
              py::arg("predictors"),
@@ -855,6 +858,7 @@ namespace BayesBoom {
 
 
              },
+             py::call_guard<py::gil_scoped_release>(),
              py::arg("time"),
              py::arg("response"),
              py::arg("predictors"),
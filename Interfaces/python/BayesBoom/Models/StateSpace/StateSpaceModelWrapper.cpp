@@ -2,6 +2,7 @@
 #include <pybind11/stl.h>
 
 #include "Models/StateSpace/StateSpaceModelBase.hpp"
+#include "Models/StateSpace/StateSpaceForecaster.hpp"
 #include "Models/StateSpace/StateSpaceModel.hpp"
 #include "Models/StateSpace/StateSpaceRegressionModel.hpp"
 #include "Models/StateSpace/StateSpaceStudentRegressionModel.hpp"
@@ -45,7 +46,10 @@ namespace BayesBoom {
             "The state matrix. Rows are state variables, columns are time.")
         .def_property_readonly(
             "log_likelihood",
-            [](StateSpaceModelBase &model) { return model.log_likelihood(); },
+            [](StateSpaceModelBase &model) {
+              py::gil_scoped_release release;
+              return model.log_likelihood();
+            },
             "The log likelihood associated with the current model parameters. "
             "If the Kalman filter is current this is already computed.  "
             "If not, then computing log likelihood requires a Kalman filter "
@@ -88,6 +92,7 @@ namespace BayesBoom {
              "the state alpha[t] and all model parameters.")
         .def("one_step_prediction_errors",
              &ScalarStateSpaceModelBase::one_step_prediction_errors,
+             py::call_guard<py::gil_scoped_release>(),
              py::arg("standardize") = false,
              "Args:\n"
              "  standardize: Should the prediction error at each time point be "
@@ -103,6 +108,7 @@ namespace BayesBoom {
                return model.simulate_holdout_prediction_errors(
                    niter, cutpoint, standardize);
              },
+             py::call_guard<py::gil_scoped_release>(),
              py::arg("niter"),
              py::arg("cutpoint"),
              py::arg("standardize"),
@@ -188,7 +194,8 @@ namespace BayesBoom {
                 int horizon,
                 const Vector &final_state) {
                return model.simulate_forecast(rng, horizon, final_state);
-             })
+             },
+             py::call_guard<py::gil_scoped_release>())
         .def("simulate_forecast_components",
              [](StateSpaceModel &model,
                 RNG &rng,
@@ -196,7 +203,8 @@ namespace BayesBoom {
                 const Vector &final_state) {
                return model.simulate_forecast_components(
                    rng, horizon, final_state);
-             })
+             },
+             py::call_guard<py::gil_scoped_release>())
         ;
 
     py::class_<StateSpaceRegressionModel,
@@ -254,7 +262,8 @@ namespace BayesBoom {
                 const Matrix &predictors,
                 const Vector &final_state) {
                return model.simulate_forecast(rng, predictors, final_state);
-             })
+             },
+             py::call_guard<py::gil_scoped_release>())
         .def("simulate_forecast_components",
              [](StateSpaceRegressionModel &model,
                 RNG &rng,
@@ -262,7 +271,8 @@ namespace BayesBoom {
                 const Vector &final_state) {
                return model.simulate_forecast_components(
                    rng, predictors, final_state);
-             })
+             },
+             py::call_guard<py::gil_scoped_release>())
         ;
 
 
@@ -348,7 +358,8 @@ namespace BayesBoom {
                 const Matrix &predictors,
                 const Vector &final_state) {
                return model.simulate_forecast(rng, predictors, final_state);
-             })
+             },
+             py::call_guard<py::gil_scoped_release>())
         .def("simulate_forecast_components",
              [](StateSpaceStudentRegressionModel &model,
                 RNG &rng,
@@ -356,7 +367,8 @@ namespace BayesBoom {
                 const Vector &final_state) {
                return model.simulate_forecast_components(
                    rng, predictors, final_state);
-             })
+             },
+             py::call_guard<py::gil_scoped_release>())
         ;
 
     py::class_<StateSpaceLogitModel,
@@ -405,7 +417,8 @@ namespace BayesBoom {
                 const Vector &final_state) {
                return model->simulate_forecast(
                    rng, forecast_predictors, trials, final_state);
-             })
+             },
+             py::call_guard<py::gil_scoped_release>())
         .def("simulate_forecast_components",
              [](StateSpaceLogitModel *model,
                 RNG &rng,
@@ -414,7 +427,8 @@ namespace BayesBoom {
                 const Vector &final_state) {
                return model->simulate_forecast_components(
                    rng, forecast_predictors, trials, final_state);
-             })
+             },
+             py::call_guard<py::gil_scoped_release>())
         ;
 
     py::class_<StateSpacePoissonModel,
@@ -462,7 +476,8 @@ namespace BayesBoom {
                 const Vector &final_state) {
                return model->simulate_forecast_components(
                    rng, forecast_predictors, exposure, final_state);
-             })
+             },
+             py::call_guard<py::gil_scoped_release>())
         ;
 
 
@@ -554,6 +569,68 @@ namespace BayesBoom {
              "this sampler's RNG.\n")
         ;
 
+    py::class_<StateSpaceForecaster>(boom, "StateSpaceForecaster")
+        .def(py::init(
+            [](StateSpaceModel *model) {
+              return new StateSpaceForecaster(Ptr<StateSpaceModel>(model));
+            }),
+             py::arg("model"),
+             "Args:\n\n"
+             "  model:  The boom.StateSpaceModel to be forecast.  The model "
+             "is cloned, and not modified, by the forecaster.\n")
+        .def(py::init(
+            [](StateSpaceRegressionModel *model, const Matrix &predictors) {
+              return new StateSpaceForecaster(
+                  Ptr<ScalarStateSpaceModelBase>(model),
+                  [predictors](ScalarStateSpaceModelBase *worker,
+                               RNG &rng,
+                               int horizon,
+                               const Vector &final_state) {
+                    return dynamic_cast<StateSpaceRegressionModel *>(worker)
+                        ->simulate_forecast(rng, predictors, final_state);
+                  });
+            }),
+             py::arg("model"),
+             py::arg("predictors"),
+             "Args:\n\n"
+             "  model:  The boom.StateSpaceRegressionModel to be forecast.\n"
+             "  predictors: The matrix of predictors for the forecast "
+             "period.  One row per time period.\n")
+        .def("set_number_of_threads",
+             &StateSpaceForecaster::set_number_of_threads,
+             py::arg("n"),
+             "Split the forecast among 'n' threads.  Values of 0 or 1 run "
+             "in the calling thread.")
+        .def_property(
+            "refilter",
+            &StateSpaceForecaster::refilter,
+            &StateSpaceForecaster::set_refilter,
+            "If True, the final state for each draw is simulated by running "
+            "the Kalman filter through the model's data.  Otherwise the "
+            "stored final states are used.")
+        .def("forecast",
+             &StateSpaceForecaster::forecast,
+             py::arg("parameter_draws"),
+             py::arg("final_states"),
+             py::arg("horizon"),
+             py::arg("seeding_rng") = BOOM::GlobalRng::rng,
+             py::call_guard<py::gil_scoped_release>(),
+             "Args:\n\n"
+             "  parameter_draws:  A boom.Matrix with one row per MCMC draw, "
+             "containing model parameters as produced by "
+             "vectorize_params(True).\n"
+             "  final_states:  A boom.Matrix with one row per MCMC draw, "
+             "containing the state vector at the end of the training data. "
+             "Ignored if 'refilter' is True.\n"
+             "  horizon:  The number of time periods to forecast.\n"
+             "  seeding_rng:  The random number generator used to seed the "
+             "streams for the individual draws.\n\n"
+             "Returns:\n"
+             "  A boom.Matrix with one row per MCMC draw and 'horizon' "
+             "columns, containing draws from the posterior predictive "
+             "distribution.\n")
+        ;
+
   }  // StateSpaceModel_def
 
 }  // namespace BayesBoom
@@ -57,6 +57,14 @@ namespace BOOM {
     }
   }
 
+  bool chol_inplace(Matrix &A) {
+    if (!A.is_square()) return false;
+    Eigen::Map<MatrixXd> map(EigenMap(A));
+    Eigen::Ref<MatrixXd> ref(map);
+    Eigen::LLT<Eigen::Ref<MatrixXd>> eigen_cholesky(ref);
+    return eigen_cholesky.info() == Eigen::Success;
+  }
+
   SpdMatrix Cholesky::original_matrix() const {
     SpdMatrix ans(lower_cholesky_triangle_.nrow(), 0.0);
     ans.add_outer(lower_cholesky_triangle_);
@@ -88,6 +88,15 @@ namespace BOOM {
     void check() const;
   };
 
+  // Overwrite the lower triangle of the square matrix A with its lower
+  // Cholesky triangle, using A's own storage.  The strict upper triangle of A
+  // is not referenced, and is left unchanged.  The result can be passed to
+  // Lsolve_inplace and LTsolve_inplace, which only use the lower triangle.
+  //
+  // Returns true if A is positive definite.  If the return value is false then
+  // the contents of A are undefined.
+  bool chol_inplace(Matrix &A);
+
 }  // namespace BOOM
 
 #endif  // BOOM_CHOL_HPP
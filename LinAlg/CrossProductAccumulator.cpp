@@ -0,0 +1,139 @@
+/*
+  Copyright (C) 2019 Steven L. Scott
+
+  This library is free software; you can redistribute it and/or modify it under
+  the terms of the GNU Lesser General Public License as published by the Free
+  Software Foundation; either version 2.1 of the License, or (at your option)
+  any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT
+  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+  FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+  details.
+
+  You should have received a copy of the GNU Lesser General Public License along
+  with this library; if not, write to the Free Software Foundation, Inc., 51
+  Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+*/
+
+#include "LinAlg/CrossProductAccumulator.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "Eigen/Core"
+#include "LinAlg/EigenMap.hpp"
+#include "cpputil/ThreadTools.hpp"
+#include "cpputil/report_error.hpp"
+
+namespace BOOM {
+  namespace {
+    // Below this dimension observations are added one at a time.
+    const int kMinimumBlockedDimension = 8;
+
+    // Add rows [begin, end) of X, weighted by w, to the upper triangle of xtx.
+    void add_rows(CrossProductAccumulator &accumulator, const Matrix &X,
+                  const Vector &w, int begin, int end, SpdMatrix &xtx) {
+      for (int i = begin; i < end; ++i) {
+        accumulator.add(X.row(i), w[i], xtx);
+      }
+    }
+  }  // namespace
+
+  const int CrossProductAccumulator::kDefaultBlockSize;
+
+  CrossProductAccumulator::CrossProductAccumulator(int dim, int block_size)
+      : dim_(dim),
+        block_size_(block_size > 0 ? block_size : kDefaultBlockSize),
+        pending_(0),
+        negative_weights_(false) {}
+
+  void CrossProductAccumulator::add(const ConstVectorView &x, double weight,
+                                    SpdMatrix &xtx) {
+    if (x.size() != dim_) {
+      report_error("Wrong size vector passed to CrossProductAccumulator.");
+    }
+    if (dim_ < kMinimumBlockedDimension) {
+      xtx.add_outer(x, weight, false);
+      return;
+    }
+    if (tile_.ncol() != block_size_) {
+      tile_.resize(dim_, block_size_);
+      weights_.resize(block_size_);
+    }
+    EigenMap(tile_).col(pending_) = EigenMap(x);
+    weights_[pending_] = weight;
+    negative_weights_ = negative_weights_ || weight < 0;
+    if (++pending_ == block_size_) {
+      flush(xtx);
+    }
+  }
+
+  void CrossProductAccumulator::add(const Matrix &X, const Vector &weights,
+                                    SpdMatrix &xtx) {
+    if (X.ncol() != dim_ || X.nrow() != weights.size()) {
+      report_error("Wrong size arguments passed to CrossProductAccumulator.");
+    }
+    add_rows(*this, X, weights, 0, X.nrow(), xtx);
+  }
+
+  void CrossProductAccumulator::flush(SpdMatrix &xtx) {
+    if (pending_ == 0) return;
+    if (xtx.nrow() != dim_) {
+      report_error("Wrong size target matrix in CrossProductAccumulator.");
+    }
+    auto tile = EigenMap(tile_).leftCols(pending_);
+    if (negative_weights_) {
+      ::Eigen::MatrixXd weighted_tile =
+          tile * EigenMap(weights_).head(pending_).asDiagonal();
+      EigenMap(xtx).triangularView<::Eigen::Upper>() +=
+          weighted_tile * tile.transpose();
+    } else {
+      for (int i = 0; i < pending_; ++i) {
+        tile.col(i) *= std::sqrt(weights_[i]);
+      }
+      EigenMap(xtx).selfadjointView<::Eigen::Upper>().rankUpdate(tile, 1.0);
+    }
+    pending_ = 0;
+    negative_weights_ = false;
+  }
+
+  void add_weighted_cross_product(SpdMatrix &xtx, const Matrix &X,
+                                  const Vector &w, int number_of_threads) {
+    int nobs = X.nrow();
+    int dim = X.ncol();
+    if (xtx.nrow() != dim || w.size() != nobs) {
+      report_error("Wrong size arguments passed to "
+                   "add_weighted_cross_product.");
+    }
+    // Each thread should get at least a few full tiles.
+    int max_threads = nobs / (4 * CrossProductAccumulator::kDefaultBlockSize);
+    number_of_threads = std::min<int>(number_of_threads, max_threads);
+    if (number_of_threads <= 1) {
+      CrossProductAccumulator accumulator(dim);
+      add_rows(accumulator, X, w, 0, nobs, xtx);
+      accumulator.flush(xtx);
+      xtx.reflect();
+      return;
+    }
+
+    std::vector<SpdMatrix> partial_sums(number_of_threads, SpdMatrix(dim, 0.0));
+    WorkStealingThreadPool &pool(WorkStealingThreadPool::global());
+    pool.set_minimum_number_of_threads(number_of_threads);
+    pool.parallel_for(
+        0, number_of_threads, 1,
+        [&](int thread) {
+          int begin = static_cast<long>(nobs) * thread / number_of_threads;
+          int end = static_cast<long>(nobs) * (thread + 1) / number_of_threads;
+          CrossProductAccumulator accumulator(dim);
+          add_rows(accumulator, X, w, begin, end, partial_sums[thread]);
+          accumulator.flush(partial_sums[thread]);
+        });
+    for (const auto &partial_sum : partial_sums) {
+      xtx += partial_sum;
+    }
+    xtx.reflect();
+  }
+
+}  // namespace BOOM
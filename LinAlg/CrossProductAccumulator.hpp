@@ -0,0 +1,105 @@
+#ifndef BOOM_LINALG_CROSS_PRODUCT_ACCUMULATOR_HPP_
+#define BOOM_LINALG_CROSS_PRODUCT_ACCUMULATOR_HPP_
+
+/*
+  Copyright (C) 2019 Steven L. Scott
+
+  This library is free software; you can redistribute it and/or modify it under
+  the terms of the GNU Lesser General Public License as published by the Free
+  Software Foundation; either version 2.1 of the License, or (at your option)
+  any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT
+  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+  FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+  details.
+
+  You should have received a copy of the GNU Lesser General Public License along
+  with this library; if not, write to the Free Software Foundation, Inc., 51
+  Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+*/
+
+#include "LinAlg/Matrix.hpp"
+#include "LinAlg/SpdMatrix.hpp"
+#include "LinAlg/Vector.hpp"
+#include "LinAlg/VectorView.hpp"
+
+namespace BOOM {
+
+  // Accumulates a weighted cross product matrix sum_i w_i * x_i * x_i^T one
+  // observation at a time, the way complete data sufficient statistics are
+  // built during data augmentation.  Adding each observation with
+  // SpdMatrix::add_outer costs a pass over the whole p x p matrix per
+  // observation.  Instead, this class copies observations into a tile, and
+  // when the tile is full it is applied to the target matrix with a single
+  // rank-k update (SYRK, or GEMM if some weights are negative), which is much
+  // friendlier to the cache and to an external BLAS.
+  //
+  // The accumulator does not own the target matrix.  It is passed to each
+  // call that might modify it, so that objects holding both the matrix and
+  // the accumulator can be copied with the default copy constructor.  Only
+  // the upper triangle of the target is updated, so the owner must call
+  // flush() and then reflect() before reading the target.
+  //
+  // For small dimensions blocking does not pay for the copy, so observations
+  // are added directly with add_outer.
+  class CrossProductAccumulator {
+   public:
+    // The number of observations per tile, unless the caller asks otherwise.
+    static const int kDefaultBlockSize = 64;
+
+    // Args:
+    //   dim:  The dimension of the observations.
+    //   block_size: The number of observations to gather before applying them
+    //     to the target.  If block_size <= 0 a default is chosen.
+    explicit CrossProductAccumulator(int dim = 0, int block_size = 0);
+
+    // Add weight * x * x^T to the upper triangle of xtx, possibly deferring
+    // the update until a later call to add() or flush().
+    void add(const ConstVectorView &x, double weight, SpdMatrix &xtx);
+
+    // Add X^T * diag(weights) * X to the upper triangle of xtx, possibly
+    // deferring some of the update.  Each row of X is an observation.
+    void add(const Matrix &X, const Vector &weights, SpdMatrix &xtx);
+
+    // Apply any pending observations to the upper triangle of xtx.
+    void flush(SpdMatrix &xtx);
+
+    // Discard any pending observations.
+    void clear() { pending_ = 0; }
+
+    // The number of observations added, but not yet applied to the target.
+    int pending() const { return pending_; }
+
+    int dim() const { return dim_; }
+    int block_size() const { return block_size_; }
+
+   private:
+    int dim_;
+    int block_size_;
+
+    // Observations are stored in the columns of tile_, so each one is a
+    // contiguous copy.  The tile is allocated on first use.
+    Matrix tile_;
+    Vector weights_;
+    int pending_;
+    bool negative_weights_;
+  };
+
+  // Add X^T * diag(w) * X to xtx, computed in blocks of rows.  If
+  // number_of_threads > 1 the blocks are divided into contiguous groups of
+  // rows, one per thread, that are run on WorkStealingThreadPool::global().
+  // Each group accumulates a partial sum, and the partial sums are added to xtx
+  // in order, so the result does not depend on the scheduling of the threads.
+  //
+  // Args:
+  //   xtx:  The matrix to be incremented.  The full matrix is incremented.
+  //   X:  The matrix of observations, one per row.
+  //   w:  The vector of weights, one per row of X.
+  //   number_of_threads:  The number of threads to use.
+  void add_weighted_cross_product(SpdMatrix &xtx, const Matrix &X,
+                                  const Vector &w, int number_of_threads = 1);
+
+}  // namespace BOOM
+
+#endif  // BOOM_LINALG_CROSS_PRODUCT_ACCUMULATOR_HPP_
@@ -0,0 +1,281 @@
+/*
+  Copyright (C) 2019 Steven L. Scott
+
+  This library is free software; you can redistribute it and/or modify it under
+  the terms of the GNU Lesser General Public License as published by the Free
+  Software Foundation; either version 2.1 of the License, or (at your option)
+  any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT
+  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+  FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+  details.
+
+  You should have received a copy of the GNU Lesser General Public License along
+  with this library; if not, write to the Free Software Foundation, Inc., 51
+  Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+*/
+
+#include "LinAlg/IncrementalCholesky.hpp"
+#include <algorithm>
+#include <cmath>
+#include "cpputil/math_utils.hpp"
+#include "cpputil/report_error.hpp"
+
+namespace BOOM {
+
+  IncrementalCholesky::IncrementalCholesky(int refactorization_interval)
+      : A_(nullptr),
+        logdet_(0.0),
+        refactorization_interval_(refactorization_interval),
+        updates_since_refactorization_(0) {}
+
+  bool IncrementalCholesky::decompose(const SpdMatrix &A, const Selector &g) {
+    if (g.nvars_possible() != A.nrow()) {
+      report_error("Selector and matrix sizes do not match in "
+                   "IncrementalCholesky::decompose.");
+    }
+    A_ = &A;
+    position_.assign(A.nrow(), -1);
+    order_.clear();
+    for (int i = 0; i < g.nvars(); ++i) {
+      int which = g.indx(i);
+      position_[which] = i;
+      order_.push_back(which);
+    }
+    return refactor();
+  }
+
+  bool IncrementalCholesky::refactor() {
+    updates_since_refactorization_ = 0;
+    int dim = order_.size();
+    if (dim == 0) {
+      logdet_ = 0.0;
+      return true;
+    }
+    SpdMatrix block(dim);
+    for (int i = 0; i < dim; ++i) {
+      for (int j = 0; j < dim; ++j) {
+        block(i, j) = (*A_)(order_[i], order_[j]);
+      }
+    }
+    bool ok = true;
+    Matrix L = block.chol(ok);
+    if (!ok) return false;
+    reserve(dim);
+    for (int j = 0; j < dim; ++j) {
+      for (int i = 0; i < dim; ++i) {
+        L_(i, j) = i >= j ? L(i, j) : 0.0;
+      }
+    }
+    compute_logdet();
+    return true;
+  }
+
+  double IncrementalCholesky::quadratic_form(const Vector &b) const {
+    int dim = order_.size();
+    if (b.size() != dim) {
+      report_error("Wrong size argument to quadratic_form.");
+    }
+    wsp_.resize(dim);
+    forward_solve(b.data(), wsp_.data());
+    return wsp_.normsq();
+  }
+
+  double IncrementalCholesky::evaluate_add(int which, const Vector *b,
+                                           double *qform) const {
+    int dim = order_.size();
+    wsp_.resize(dim);
+    for (int i = 0; i < dim; ++i) {
+      wsp_[i] = (*A_)(order_[i], which);
+    }
+    forward_solve(wsp_.data(), wsp_.data());
+    double residual = (*A_)(which, which) - wsp_.normsq();
+    if (!(residual > 0) || !std::isfinite(residual)) {
+      return negative_infinity();
+    }
+    if (b) {
+      if (b->size() != dim + 1) {
+        report_error("Wrong size argument to evaluate_add.");
+      }
+      wsp2_.resize(dim);
+      forward_solve(b->data(), wsp2_.data());
+      double last = ((*b)[dim] - wsp_.dot(wsp2_)) / sqrt(residual);
+      *qform = wsp2_.normsq() + square(last);
+    }
+    return logdet_ + log(residual);
+  }
+
+  // If A = L * L^T then the (j, j) element of A^{-1} is |L^{-1} e_j|^2, and
+  // |A_{-j}| = |A| * (A^{-1})_{jj}.  A similar Schur complement argument gives
+  // the quadratic form.
+  double IncrementalCholesky::evaluate_drop(int which, const Vector *b,
+                                            double *qform) const {
+    int dim = order_.size();
+    int pos = position_[which];
+    if (pos < 0) {
+      report_error("Attempt to drop a variable that is not in the factor.");
+    }
+    wsp_.resize(dim);
+    wsp_ = 0.0;
+    wsp_[pos] = 1.0;
+    forward_solve(wsp_.data(), wsp_.data(), pos);
+    double inverse_diagonal = wsp_.normsq();
+    if (b) {
+      if (b->size() != dim) {
+        report_error("Wrong size argument to evaluate_drop.");
+      }
+      wsp2_.resize(dim);
+      forward_solve(b->data(), wsp2_.data());
+      double cross = 0;
+      for (int i = pos; i < dim; ++i) {
+        cross += wsp_[i] * wsp2_[i];
+      }
+      *qform = wsp2_.normsq() - square(cross) / inverse_diagonal;
+    }
+    return logdet_ + log(inverse_diagonal);
+  }
+
+  bool IncrementalCholesky::add(int which) {
+    if (position_[which] >= 0) return true;
+    int dim = order_.size();
+    wsp_.resize(dim);
+    for (int i = 0; i < dim; ++i) {
+      wsp_[i] = (*A_)(order_[i], which);
+    }
+    forward_solve(wsp_.data(), wsp_.data());
+    double residual = (*A_)(which, which) - wsp_.normsq();
+    if (!(residual > 0) || !std::isfinite(residual)) {
+      return false;
+    }
+    reserve(dim + 1);
+    for (int i = 0; i < dim; ++i) {
+      L_(dim, i) = wsp_[i];
+      L_(i, dim) = 0.0;
+    }
+    L_(dim, dim) = sqrt(residual);
+    position_[which] = dim;
+    order_.push_back(which);
+    logdet_ += log(residual);
+    count_update();
+    return true;
+  }
+
+  void IncrementalCholesky::drop(int which) {
+    int pos = position_[which];
+    if (pos < 0) return;
+    int dim = order_.size();
+
+    // Removing row and column 'pos' leaves the trailing block with
+    // L33 * L33^T + l3 * l3^T, where l3 is the part of column 'pos' below the
+    // diagonal.  Absorb l3 into L33 with a rank one update.
+    wsp_.resize(dim);
+    for (int i = pos + 1; i < dim; ++i) {
+      wsp_[i] = L_(i, pos);
+    }
+    for (int i = pos + 1; i < dim; ++i) {
+      double diagonal = L_(i, i);
+      double r = hypot(diagonal, wsp_[i]);
+      double c = r / diagonal;
+      double s = wsp_[i] / diagonal;
+      L_(i, i) = r;
+      for (int m = i + 1; m < dim; ++m) {
+        L_(m, i) = (L_(m, i) + s * wsp_[m]) / c;
+        wsp_[m] = c * wsp_[m] - s * L_(m, i);
+      }
+    }
+
+    // Shift the rows below 'pos' up by one, and the columns to the right of
+    // 'pos' left by one.
+    for (int j = 0; j < pos; ++j) {
+      for (int i = pos; i < dim - 1; ++i) {
+        L_(i, j) = L_(i + 1, j);
+      }
+    }
+    for (int j = pos; j < dim - 1; ++j) {
+      for (int i = j; i < dim - 1; ++i) {
+        L_(i, j) = L_(i + 1, j + 1);
+      }
+    }
+    for (int i = 0; i < dim; ++i) {
+      L_(dim - 1, i) = 0.0;
+      L_(i, dim - 1) = 0.0;
+    }
+
+    order_.erase(order_.begin() + pos);
+    position_[which] = -1;
+    for (int i = pos; i < order_.size(); ++i) {
+      position_[order_[i]] = i;
+    }
+    compute_logdet();
+    count_update();
+  }
+
+  Matrix IncrementalCholesky::getL() const {
+    int dim = order_.size();
+    Matrix ans(dim, dim, 0.0);
+    for (int j = 0; j < dim; ++j) {
+      for (int i = j; i < dim; ++i) {
+        ans(i, j) = L_(i, j);
+      }
+    }
+    return ans;
+  }
+
+  // The solve is organized by column, which is the contiguous direction in
+  // BOOM's column major storage.
+  void IncrementalCholesky::forward_solve(const double *b, double *x,
+                                          int start) const {
+    int dim = order_.size();
+    if (x != b) {
+      std::copy(b, b + dim, x);
+    }
+    for (int j = start; j < dim; ++j) {
+      x[j] /= L_(j, j);
+      const double *column = L_.data() + j * L_.nrow();
+      double xj = x[j];
+      for (int i = j + 1; i < dim; ++i) {
+        x[i] -= column[i] * xj;
+      }
+    }
+  }
+
+  void IncrementalCholesky::reserve(int dim) {
+    int capacity = L_.nrow();
+    if (capacity >= dim) return;
+    int new_capacity = std::max<int>(dim, std::max<int>(2 * capacity, 8));
+    Matrix L(new_capacity, new_capacity, 0.0);
+    int old_dim = std::min<int>(order_.size(), capacity);
+    for (int j = 0; j < old_dim; ++j) {
+      for (int i = j; i < old_dim; ++i) {
+        L(i, j) = L_(i, j);
+      }
+    }
+    L_ = L;
+  }
+
+  void IncrementalCholesky::count_update() {
+    if (refactorization_interval_ > 0 &&
+        ++updates_since_refactorization_ >= refactorization_interval_) {
+      // The current factor is positive definite, so a fresh decomposition of
+      // the same block should be too.  If it is not, then rounding has
+      // already gotten the better of us, and the updated factor is kept.
+      Matrix saved_L = L_;
+      double saved_logdet = logdet_;
+      if (!refactor()) {
+        L_ = saved_L;
+        logdet_ = saved_logdet;
+      }
+    }
+  }
+
+  void IncrementalCholesky::compute_logdet() {
+    double ans = 0;
+    int dim = order_.size();
+    for (int i = 0; i < dim; ++i) {
+      ans += log(L_(i, i));
+    }
+    logdet_ = 2 * ans;
+  }
+
+}  // namespace BOOM
@@ -0,0 +1,163 @@
+#ifndef BOOM_LINALG_INCREMENTAL_CHOLESKY_HPP_
+#define BOOM_LINALG_INCREMENTAL_CHOLESKY_HPP_
+
+/*
+  Copyright (C) 2019 Steven L. Scott
+
+  This library is free software; you can redistribute it and/or modify it under
+  the terms of the GNU Lesser General Public License as published by the Free
+  Software Foundation; either version 2.1 of the License, or (at your option)
+  any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT
+  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+  FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+  details.
+
+  You should have received a copy of the GNU Lesser General Public License along
+  with this library; if not, write to the Free Software Foundation, Inc., 51
+  Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+*/
+
+#include <vector>
+#include "LinAlg/Matrix.hpp"
+#include "LinAlg/Selector.hpp"
+#include "LinAlg/SpdMatrix.hpp"
+#include "LinAlg/Vector.hpp"
+
+namespace BOOM {
+
+  // Maintains the lower Cholesky triangle of a principal submatrix A[g, g] of
+  // a symmetric positive definite matrix A as the subset g gains or loses one
+  // element at a time.  This is the workhorse for stochastic search variable
+  // selection, where each proposed flip of an inclusion indicator would
+  // otherwise require an O(k^3) decomposition of the k x k included block.
+  //
+  // The rows of the factor are stored in the order in which variables entered
+  // the model (see order()), rather than in the order of their position in A.
+  // Determinants and quadratic forms are invariant to this permutation, and
+  // keeping new variables at the end means that adding a variable is a single
+  // O(k^2) forward solve.  Dropping a variable requires an O(k^2) rank one
+  // update of the trailing block.
+  //
+  // Repeated updates slowly accumulate rounding error, so the factor is
+  // recomputed from scratch after every 'refactorization_interval' changes.
+  //
+  // The proposed changes can be evaluated before they are made using
+  // evaluate_add() and evaluate_drop(), so that a Metropolis-Hastings step can
+  // decide whether to accept a flip before paying to update the factor.
+  class IncrementalCholesky {
+   public:
+    explicit IncrementalCholesky(int refactorization_interval = 100);
+
+    // Factor A[g, g] from scratch.  A pointer to A is retained, so A must
+    // remain alive (and unchanged) until the next call to decompose().
+    //
+    // Returns:
+    //   true if A[g, g] is positive definite, and false otherwise.  If false is
+    //   returned then the state of the object is undefined until the next
+    //   successful call to decompose().
+    bool decompose(const SpdMatrix &A, const Selector &g);
+
+    // The number of variables currently in the factor.
+    int dim() const { return order_.size(); }
+
+    // The positions (in A) of the variables in the factor, in factor order.
+    const std::vector<int> &order() const { return order_; }
+
+    // The index in order() of position 'which' in A, or -1 if 'which' is not
+    // part of the factored block.
+    int position(int which) const { return position_[which]; }
+
+    // log |A[g, g]|.  The determinant of an empty matrix is 1.
+    double logdet() const { return logdet_; }
+
+    // Returns b^T A[g, g]^{-1} b, where b is indexed in factor order.
+    double quadratic_form(const Vector &b) const;
+
+    // Compute the log determinant of A[g', g'] where g' is g with position
+    // 'which' added.  The factor is not modified.
+    //
+    // Args:
+    //   which:  The position in A of the variable to be added.
+    //   b: If non-NULL, a vector of dimension dim() + 1 in factor order with
+    //     the element for 'which' last.
+    //   qform: If 'b' is non-NULL then qform is filled with b^T A[g', g']^{-1}
+    //     b.
+    //
+    // Returns:
+    //   log |A[g', g']|, or negative infinity if A[g', g'] is not positive
+    //   definite.
+    double evaluate_add(int which, const Vector *b = nullptr,
+                        double *qform = nullptr) const;
+
+    // Compute the log determinant of A[g', g'] where g' is g with position
+    // 'which' removed.  The factor is not modified.
+    //
+    // Args:
+    //   which:  The position in A of the variable to be dropped.
+    //   b: If non-NULL, a vector of dimension dim() in factor order.  The
+    //     element corresponding to 'which' is ignored.
+    //   qform: If 'b' is non-NULL then qform is filled with b^T A[g', g']^{-1}
+    //     b, where the element of b corresponding to 'which' is omitted.
+    //
+    // Returns:
+    //   log |A[g', g']|.
+    double evaluate_drop(int which, const Vector *b = nullptr,
+                         double *qform = nullptr) const;
+
+    // Update the factor to include position 'which'.  Returns false (and
+    // leaves the factor unchanged) if the resulting matrix would not be
+    // positive definite.
+    bool add(int which);
+
+    // Update the factor to exclude position 'which'.
+    void drop(int which);
+
+    // The lower Cholesky triangle of A[g, g], with rows and columns in factor
+    // order.
+    Matrix getL() const;
+
+   private:
+    // Solve L * x = b, where L is the leading dim() x dim() block of L_.  The
+    // first 'start' elements of b are assumed to be zero, in which case so are
+    // the first 'start' elements of x.  It is safe for b and x to alias.
+    void forward_solve(const double *b, double *x, int start = 0) const;
+
+    // Increase the capacity of L_ so it can hold a factor with at least 'dim'
+    // rows.
+    void reserve(int dim);
+
+    // Recompute the factor from A using the current value of order_.
+    bool refactor();
+
+    // Record that an update took place, and refactor if too many updates have
+    // occurred since the last full decomposition.
+    void count_update();
+
+    // Set logdet_ to 2 * sum(log(diag(L))).
+    void compute_logdet();
+
+    const SpdMatrix *A_;
+
+    // The leading dim() x dim() block of L_ holds the lower Cholesky triangle.
+    // L_ is allocated with extra room to avoid reallocation as variables are
+    // added.
+    Matrix L_;
+    std::vector<int> order_;
+
+    // position_[i] is the index of variable i in order_, or -1 if variable i
+    // is excluded.
+    std::vector<int> position_;
+    double logdet_;
+    int refactorization_interval_;
+    int updates_since_refactorization_;
+
+    // Workspace.
+    mutable Vector wsp_;
+    mutable Vector wsp2_;
+  };
+
+}  // namespace BOOM
+
+#endif  // BOOM_LINALG_INCREMENTAL_CHOLESKY_HPP_
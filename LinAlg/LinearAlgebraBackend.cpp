@@ -0,0 +1,75 @@
+/*
+  Copyright (C) 2019 Steven L. Scott
+
+  This library is free software; you can redistribute it and/or modify it under
+  the terms of the GNU Lesser General Public License as published by the Free
+  Software Foundation; either version 2.1 of the License, or (at your option)
+  any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT
+  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+  FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+  details.
+
+  You should have received a copy of the GNU Lesser General Public License along
+  with this library; if not, write to the Free Software Foundation, Inc., 51
+  Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+*/
+
+#include "LinAlg/LinearAlgebraBackend.hpp"
+#include "Eigen/Core"
+#include "cpputil/report_error.hpp"
+
+// The thread controls of the common BLAS implementations are declared weak, so
+// BOOM links whether or not the library providing them is present.  Only the
+// symbols that resolve at load time are called.
+#if defined(EIGEN_USE_BLAS) && defined(__GNUC__) && defined(__ELF__)
+#define BOOM_BLAS_THREAD_CONTROL_
+extern "C" {
+  void openblas_set_num_threads(int) __attribute__((weak));
+  int openblas_get_num_threads() __attribute__((weak));
+  void MKL_Set_Num_Threads(int) __attribute__((weak));
+  int MKL_Get_Max_Threads() __attribute__((weak));
+}
+#endif
+
+namespace BOOM {
+
+  std::string linear_algebra_backend() {
+#if defined(EIGEN_USE_BLAS) && defined(EIGEN_USE_LAPACKE)
+    return "BLAS+LAPACKE";
+#elif defined(EIGEN_USE_BLAS)
+    return "BLAS";
+#else
+    return "Eigen";
+#endif
+  }
+
+  void set_linear_algebra_threads(int number_of_threads) {
+    if (number_of_threads < 1) {
+      report_error("The number of linear algebra threads must be positive.");
+    }
+    ::Eigen::setNbThreads(number_of_threads);
+#ifdef BOOM_BLAS_THREAD_CONTROL_
+    if (openblas_set_num_threads) {
+      openblas_set_num_threads(number_of_threads);
+    }
+    if (MKL_Set_Num_Threads) {
+      MKL_Set_Num_Threads(number_of_threads);
+    }
+#endif
+  }
+
+  int linear_algebra_threads() {
+#ifdef BOOM_BLAS_THREAD_CONTROL_
+    if (openblas_get_num_threads) {
+      return openblas_get_num_threads();
+    }
+    if (MKL_Get_Max_Threads) {
+      return MKL_Get_Max_Threads();
+    }
+#endif
+    return ::Eigen::nbThreads();
+  }
+
+}  // namespace BOOM
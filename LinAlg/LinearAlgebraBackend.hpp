@@ -0,0 +1,54 @@
+#ifndef BOOM_LINALG_LINEAR_ALGEBRA_BACKEND_HPP_
+#define BOOM_LINALG_LINEAR_ALGEBRA_BACKEND_HPP_
+
+/*
+  Copyright (C) 2019 Steven L. Scott
+
+  This library is free software; you can redistribute it and/or modify it under
+  the terms of the GNU Lesser General Public License as published by the Free
+  Software Foundation; either version 2.1 of the License, or (at your option)
+  any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT
+  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+  FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+  details.
+
+  You should have received a copy of the GNU Lesser General Public License along
+  with this library; if not, write to the Free Software Foundation, Inc., 51
+  Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+*/
+
+#include <string>
+
+namespace BOOM {
+
+  // The dense kernels behind Matrix, SpdMatrix, Cholesky, SVD, etc. are
+  // implemented with Eigen.  At build time Eigen can be told to hand large
+  // operations (matrix products, rank-k updates, triangular solves, and, with
+  // LAPACKE, the factorizations) to an external BLAS/LAPACK library such as
+  // OpenBLAS or MKL.  See the BOOM_BLAS option in the Makefile, or
+  // --define=boom_blas=... in the bazel BUILD file.  The choice must be made
+  // when the library is compiled, and all code using BOOM's headers must be
+  // built the same way.
+
+  // A short description of the backend selected at build time: "Eigen",
+  // "BLAS", or "BLAS+LAPACKE".
+  std::string linear_algebra_backend();
+
+  // Set the number of threads used by the dense linear algebra kernels.  This
+  // controls the thread pool of OpenBLAS or MKL when BOOM is linked against
+  // them, and Eigen's own OpenMP threads when it is compiled with OpenMP.  It
+  // has no effect on a single threaded build.
+  //
+  // Callers that run many small problems in parallel threads of their own
+  // (e.g. through ThreadWorkerPool) should usually set this to 1, so the two
+  // levels of parallelism do not compete for cores.
+  void set_linear_algebra_threads(int number_of_threads);
+
+  // The number of threads the dense kernels will use.
+  int linear_algebra_threads();
+
+}  // namespace BOOM
+
+#endif  // BOOM_LINALG_LINEAR_ALGEBRA_BACKEND_HPP_
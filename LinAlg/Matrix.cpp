@@ -620,21 +620,38 @@ namespace BOOM {
     return nrow() == ans.nrow() && B.nrow() == ans.ncol() && ncol() == B.ncol();
   }
 
+  // Eigen evaluates products into a temporary unless it is told that the
+  // destination does not alias the operands.  The temporary is skipped
+  // whenever ans is distinct from both operands.
   Matrix &Matrix::mult(const Matrix &B, Matrix &ans, double scal) const {
     assert(can_mult(B, ans));
-    EigenMap(ans) = EigenMap(*this) * EigenMap(B) * scal;
+    if (&ans == this || &ans == &B) {
+      EigenMap(ans) = EigenMap(*this) * EigenMap(B) * scal;
+    } else {
+      EigenMap(ans).noalias() = scal * EigenMap(*this) * EigenMap(B);
+    }
     return ans;
   }
 
   Matrix &Matrix::Tmult(const Matrix &B, Matrix &ans, double scal) const {
     assert(can_Tmult(B, ans));
-    EigenMap(ans) = EigenMap(*this).transpose() * EigenMap(B) * scal;
+    if (&ans == this || &ans == &B) {
+      EigenMap(ans) = EigenMap(*this).transpose() * EigenMap(B) * scal;
+    } else {
+      EigenMap(ans).noalias() =
+          scal * EigenMap(*this).transpose() * EigenMap(B);
+    }
     return ans;
   }
 
   Matrix &Matrix::multT(const Matrix &B, Matrix &ans, double scal) const {
     assert(can_multT(B, ans));
-    EigenMap(ans) = EigenMap(*this) * EigenMap(B).transpose() * scal;
+    if (&ans == this || &ans == &B) {
+      EigenMap(ans) = EigenMap(*this) * EigenMap(B).transpose() * scal;
+    } else {
+      EigenMap(ans).noalias() =
+          scal * EigenMap(*this) * EigenMap(B).transpose();
+    }
     return ans;
   }
 
@@ -703,13 +720,21 @@ namespace BOOM {
   //--------- Vector support
   Vector &Matrix::mult(const Vector &v, Vector &ans, double scal) const {
     assert(ncol() == v.size() && nrow() == ans.size());
-    EigenMap(ans) = EigenMap(*this) * EigenMap(v) * scal;
+    if (&ans == &v) {
+      EigenMap(ans) = EigenMap(*this) * EigenMap(v) * scal;
+    } else {
+      EigenMap(ans).noalias() = scal * EigenMap(*this) * EigenMap(v);
+    }
     return ans;
   }
 
   Vector &Matrix::Tmult(const Vector &v, Vector &ans, double scal) const {
     assert(nrow() == v.size() && ncol() == ans.size());
-    EigenMap(ans) = EigenMap(*this).transpose() * EigenMap(v) * scal;
+    if (&ans == &v) {
+      EigenMap(ans) = EigenMap(*this).transpose() * EigenMap(v) * scal;
+    } else {
+      EigenMap(ans).noalias() = scal * EigenMap(*this).transpose() * EigenMap(v);
+    }
     return ans;
   }
 
@@ -917,8 +942,44 @@ namespace BOOM {
 
   Matrix &Matrix::add_outer(const Matrix &left, const Matrix &right,
                             double coefficient) {
-    EigenMap(*this) +=
-        coefficient * EigenMap(left) * EigenMap(right).transpose();
+    if (this == &left || this == &right) {
+      EigenMap(*this) +=
+          coefficient * EigenMap(left) * EigenMap(right).transpose();
+    } else {
+      EigenMap(*this).noalias() +=
+          coefficient * EigenMap(left) * EigenMap(right).transpose();
+    }
+    return *this;
+  }
+
+  Matrix &Matrix::add_mult(const Matrix &left, const Matrix &right,
+                           double coefficient) {
+    if (nrow() != left.nrow() || ncol() != right.ncol() ||
+        left.ncol() != right.nrow()) {
+      report_error("Incompatible matrices in Matrix::add_mult.");
+    }
+    if (this == &left || this == &right) {
+      EigenMap(*this) += coefficient * EigenMap(left) * EigenMap(right);
+    } else {
+      EigenMap(*this).noalias() +=
+          coefficient * EigenMap(left) * EigenMap(right);
+    }
+    return *this;
+  }
+
+  Matrix &Matrix::add_Tmult(const Matrix &left, const Matrix &right,
+                            double coefficient) {
+    if (nrow() != left.ncol() || ncol() != right.ncol() ||
+        left.nrow() != right.nrow()) {
+      report_error("Incompatible matrices in Matrix::add_Tmult.");
+    }
+    if (this == &left || this == &right) {
+      EigenMap(*this) +=
+          coefficient * EigenMap(left).transpose() * EigenMap(right);
+    } else {
+      EigenMap(*this).noalias() +=
+          coefficient * EigenMap(left).transpose() * EigenMap(right);
+    }
     return *this;
   }
 
@@ -286,6 +286,17 @@ namespace BOOM {
     Matrix &add_outer(const Matrix &left, const Matrix &right,
                       double coefficient);
 
+    // Add coefficient * left * right to *this, and return the result.  Along
+    // with add_outer, these let compound expressions like A * B^T + C be
+    // accumulated into a preallocated matrix without temporaries.
+    Matrix &add_mult(const Matrix &left, const Matrix &right,
+                     double coefficient = 1.0);
+
+    // Add coefficient * left.transpose() * right to *this, and return the
+    // result.
+    Matrix &add_Tmult(const Matrix &left, const Matrix &right,
+                      double coefficient = 1.0);
+
     //--------  Math
     virtual Matrix &operator+=(double x);
     virtual Matrix &operator*=(double x);
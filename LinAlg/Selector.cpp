@@ -381,6 +381,18 @@ namespace BOOM {
     return inc_select<ConstVectorView>(x, *this);
   }
 
+  Vector &Selector::select(const Vector &x, Vector &ans) const {
+    check_size_eq(x.size(), "select");
+    uint n = nvars();
+    ans.resize(n);
+    if (include_all_) {
+      std::copy(x.begin(), x.end(), ans.begin());
+    } else {
+      for (uint i = 0; i < n; ++i) ans[i] = x[included_positions_[i]];
+    }
+    return ans;
+  }
+
   Vector Selector::select_if_needed(const Vector &x) const {
     if (x.size() == nvars()) {
       return x;
@@ -422,6 +434,24 @@ namespace BOOM {
     return ans;
   }
 
+  SpdMatrix &Selector::select(const SpdMatrix &S, SpdMatrix &ans) const {
+    check_size_eq(S.ncol(), "select");
+    uint n = nvars();
+    ans.resize(n);
+    if (include_all_) {
+      std::copy(S.begin(), S.end(), ans.begin());
+      return ans;
+    }
+    for (uint i = 0; i < n; ++i) {
+      const double *s(S.col(included_positions_[i]).data());
+      double *a(ans.col(i).data());
+      for (uint j = 0; j < n; ++j) {
+        a[j] = s[included_positions_[j]];
+      }
+    }
+    return ans;
+  }
+
   Matrix Selector::select_cols(const Matrix &m) const {
     if (include_all_) return m;
     Matrix ans(m.nrow(), nvars());
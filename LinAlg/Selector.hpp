@@ -163,6 +163,13 @@ namespace BOOM {
     Vector select_if_needed(const ConstVectorView &x) const;
 
     SpdMatrix select(const SpdMatrix &) const;
+
+    // Versions of select() that write into a preallocated destination, which
+    // is resized if needed.  No memory is allocated if 'ans' already has
+    // enough capacity.  'ans' must not be the same object as 'x' or 'S'.
+    Vector &select(const Vector &x, Vector &ans) const;
+    SpdMatrix &select(const SpdMatrix &S, SpdMatrix &ans) const;
+
     Matrix select_cols(const Matrix &M) const;
     Matrix select_square(const Matrix &M) const;  // selects rows and columns
     Matrix select_rows(const Matrix &M) const;
@@ -19,6 +19,7 @@
 
 #include "LinAlg/SpdMatrix.hpp"
 #include "LinAlg/Cholesky.hpp"
+#include "LinAlg/CrossProductAccumulator.hpp"
 #include "LinAlg/Matrix.hpp"
 #include "LinAlg/SubMatrix.hpp"
 #include "LinAlg/Vector.hpp"
@@ -26,6 +27,7 @@
 #include "cpputil/math_utils.hpp"
 #include "cpputil/report_error.hpp"
 
+#include <algorithm>
 #include <cmath>
 #include <numeric>
 #include <sstream>
@@ -459,10 +461,11 @@ namespace BOOM {
                                   bool force_sym) {
     assert(X.nrow() == w.size());
     assert(X.ncol() == this->ncol());
-    uint n = w.size();
-    for (uint i = 0; i < n; ++i) {
-      this->add_outer(X.row(i), w[i], false);
-    }
+    CrossProductAccumulator accumulator(
+        X.ncol(),
+        std::min<int>(X.nrow(), CrossProductAccumulator::kDefaultBlockSize));
+    accumulator.add(X, w, *this);
+    accumulator.flush(*this);
     if (force_sym) reflect();
     return *this;
   }
@@ -529,8 +532,13 @@ namespace BOOM {
     uint m = nrow();
     uint n = B.ncol();
     if (n == 0 || m == 0) return ans;
-    EigenMap(ans) =
-        EigenMap(*this).selfadjointView<Eigen::Upper>() * EigenMap(B) * scal;
+    if (&ans == this || &ans == &B) {
+      EigenMap(ans) =
+          EigenMap(*this).selfadjointView<Eigen::Upper>() * EigenMap(B) * scal;
+    } else {
+      EigenMap(ans).noalias() =
+          scal * EigenMap(*this).selfadjointView<Eigen::Upper>() * EigenMap(B);
+    }
     return ans;
   }
 
@@ -577,8 +585,13 @@ namespace BOOM {
   Vector &SpdMatrix::mult(const Vector &v, Vector &ans, double scal) const {
     assert(ans.size() == nrow());
     if (size() == 0) return ans;
-    EigenMap(ans) =
-        EigenMap(*this).selfadjointView<Eigen::Upper>() * EigenMap(v);
+    if (&ans == &v) {
+      EigenMap(ans) =
+          EigenMap(*this).selfadjointView<Eigen::Upper>() * EigenMap(v) * scal;
+    } else {
+      EigenMap(ans).noalias() =
+          scal * EigenMap(*this).selfadjointView<Eigen::Upper>() * EigenMap(v);
+    }
     return ans;
   }
 
@@ -698,6 +711,40 @@ namespace BOOM {
     return ans;
   }
 
+  SpdMatrix &sandwich(const Matrix &A, const SpdMatrix &V, SpdMatrix &ans,
+                      Matrix &workspace) {
+    if (A.ncol() != V.nrow()) {
+      report_error("Incompatible matrices in sandwich.");
+    }
+    ans.resize(A.nrow());
+    if (A.size() == 0 || V.size() == 0) {
+      ans = 0.0;
+      return ans;
+    }
+    workspace.resize(A.nrow(), V.ncol());
+    EigenMap(workspace).noalias() =
+        EigenMap(A) * EigenMap(V).selfadjointView<Eigen::Upper>();
+    EigenMap(ans).noalias() = EigenMap(workspace) * EigenMap(A).transpose();
+    return ans;
+  }
+
+  SpdMatrix &sandwich_transpose(const Matrix &A, const SpdMatrix &V,
+                                SpdMatrix &ans, Matrix &workspace) {
+    if (A.nrow() != V.nrow()) {
+      report_error("Incompatible matrices in sandwich_transpose.");
+    }
+    ans.resize(A.ncol());
+    if (A.size() == 0 || V.size() == 0) {
+      ans = 0.0;
+      return ans;
+    }
+    workspace.resize(V.nrow(), A.ncol());
+    EigenMap(workspace).noalias() =
+        EigenMap(V).selfadjointView<Eigen::Upper>() * EigenMap(A);
+    EigenMap(ans).noalias() = EigenMap(A).transpose() * EigenMap(workspace);
+    return ans;
+  }
+
   SpdMatrix sandwich(const Matrix &A, const Vector &diagonal) {
     DiagonalMatrix d(diagonal);
     return A.Tmult(d * A);
@@ -254,6 +254,21 @@ namespace BOOM {
   SpdMatrix sandwich(const Matrix &A, const SpdMatrix &V);
   SpdMatrix sandwich(const Matrix &A, const Vector &V);
 
+  // Compute A * V * A^T into a preallocated matrix.  No memory is allocated
+  // once 'ans' and 'workspace' have been sized by an earlier call.
+  //
+  // Args:
+  //   A: the outer matrix doing the sandwiching.
+  //   V: the inner matrix being sandwiched.
+  //   ans: On output, A * V * A^T.  Resized if needed.  Must not be the same
+  //     object as A or V.
+  //   workspace: Holds the intermediate product A * V.  Resized if needed.
+  //
+  // Returns:
+  //   ans
+  SpdMatrix &sandwich(const Matrix &A, const SpdMatrix &V, SpdMatrix &ans,
+                      Matrix &workspace);
+
   // Args:
   //   X: A matrix to be adjusted by averaging with its own diagonal.
   //   diagonal_shrinkage: A number between 0 and 1 giving the weight assigned
@@ -277,6 +292,11 @@ namespace BOOM {
   }
   SpdMatrix sandwich_transpose(const Matrix &A, const Vector &V);
 
+  // Compute A^T * V * A into a preallocated matrix, using 'workspace' to hold
+  // V * A.  The conventions match the preallocated version of sandwich().
+  SpdMatrix &sandwich_transpose(const Matrix &A, const SpdMatrix &V,
+                                SpdMatrix &ans, Matrix &workspace);
+
   SpdMatrix as_symmetric(const Matrix &A);
 
   SpdMatrix sum_self_transpose(const Matrix &A);  // A + A.t()
@@ -0,0 +1,183 @@
+/*
+  Copyright (C) 2019 Steven L. Scott
+
+  This library is free software; you can redistribute it and/or modify it under
+  the terms of the GNU Lesser General Public License as published by the Free
+  Software Foundation; either version 2.1 of the License, or (at your option)
+  any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT
+  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+  FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+  details.
+
+  You should have received a copy of the GNU Lesser General Public License along
+  with this library; if not, write to the Free Software Foundation, Inc., 51
+  Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+*/
+
+// Timings for the dense kernels that can be dispatched to an external BLAS.
+// To compare backends, build this program once against the default (Eigen)
+// library and once against a library built with BOOM_BLAS, then compare the
+// two outputs, e.g. with the compare.py tool that ships with google benchmark:
+//
+//   ./linalg_benchmark --benchmark_out=eigen.json
+//   ./linalg_benchmark --benchmark_out=blas.json
+//   compare.py benchmarks eigen.json blas.json
+//
+// The second benchmark argument is the number of linear algebra threads.
+// Random inputs are drawn from a fixed seed, so timings are comparable across
+// builds.
+
+#include "benchmark/benchmark.h"
+#include "LinAlg/Cholesky.hpp"
+#include "LinAlg/CrossProductAccumulator.hpp"
+#include "LinAlg/LinearAlgebraBackend.hpp"
+#include "LinAlg/Matrix.hpp"
+#include "LinAlg/SVD.hpp"
+#include "LinAlg/SpdMatrix.hpp"
+#include "distributions.hpp"
+
+namespace {
+  using namespace BOOM;
+
+  // A well conditioned random SpdMatrix of dimension n.
+  SpdMatrix random_spd(int n) {
+    Matrix X(2 * n, n);
+    X.randomize();
+    SpdMatrix ans = X.inner();
+    ans.diag() += 1.0;
+    return ans;
+  }
+
+  void setup(benchmark::State &state) {
+    GlobalRng::rng.seed(8675309);
+    set_linear_algebra_threads(state.range(1));
+    state.SetLabel(linear_algebra_backend());
+  }
+
+  void BM_MatrixMult(benchmark::State &state) {
+    setup(state);
+    int n = state.range(0);
+    Matrix A(n, n), B(n, n), C(n, n);
+    A.randomize();
+    B.randomize();
+    for (auto _ : state) {
+      A.mult(B, C);
+      benchmark::DoNotOptimize(C.data());
+    }
+    state.SetItemsProcessed(state.iterations() * 2.0 * n * n * n);
+  }
+
+  void BM_MatrixInner(benchmark::State &state) {
+    setup(state);
+    int p = state.range(0);
+    Matrix X(10 * p, p);
+    X.randomize();
+    for (auto _ : state) {
+      SpdMatrix xtx = X.inner();
+      benchmark::DoNotOptimize(xtx.data());
+    }
+  }
+
+  void BM_SpdChol(benchmark::State &state) {
+    setup(state);
+    SpdMatrix V = random_spd(state.range(0));
+    for (auto _ : state) {
+      Matrix L = V.chol();
+      benchmark::DoNotOptimize(L.data());
+    }
+  }
+
+  void BM_SpdInv(benchmark::State &state) {
+    setup(state);
+    SpdMatrix V = random_spd(state.range(0));
+    for (auto _ : state) {
+      SpdMatrix Vinv = V.inv();
+      benchmark::DoNotOptimize(Vinv.data());
+    }
+  }
+
+  void BM_CholeskySolve(benchmark::State &state) {
+    setup(state);
+    int n = state.range(0);
+    Cholesky cholesky(random_spd(n));
+    Matrix B(n, n);
+    B.randomize();
+    for (auto _ : state) {
+      Matrix ans = cholesky.solve(B);
+      benchmark::DoNotOptimize(ans.data());
+    }
+  }
+
+  void BM_SVD(benchmark::State &state) {
+    setup(state);
+    int n = state.range(0);
+    Matrix A(2 * n, n);
+    A.randomize();
+    for (auto _ : state) {
+      SingularValueDecomposition svd(A);
+      benchmark::DoNotOptimize(svd.values().data());
+    }
+  }
+
+  // Weighted cross products X^T W X of the kind built by complete data
+  // sufficient statistics, with X having 20 * p rows.  The first version adds
+  // one row at a time, as the sufficient statistics classes used to.  The
+  // second uses add_weighted_cross_product, where the second benchmark
+  // argument is the number of threads it uses.
+  void BM_RankOneCrossProduct(benchmark::State &state) {
+    setup(state);
+    int p = state.range(0);
+    Matrix X(20 * p, p);
+    X.randomize();
+    Vector w(X.nrow());
+    w.randomize();
+    SpdMatrix xtx(p, 0.0);
+    for (auto _ : state) {
+      for (int i = 0; i < X.nrow(); ++i) {
+        xtx.add_outer(X.row(i), w[i], false);
+      }
+      benchmark::DoNotOptimize(xtx.data());
+    }
+    state.SetItemsProcessed(state.iterations() * X.nrow());
+  }
+
+  void BM_BlockedCrossProduct(benchmark::State &state) {
+    GlobalRng::rng.seed(8675309);
+    set_linear_algebra_threads(1);
+    state.SetLabel(linear_algebra_backend());
+    int p = state.range(0);
+    Matrix X(20 * p, p);
+    X.randomize();
+    Vector w(X.nrow());
+    w.randomize();
+    SpdMatrix xtx(p, 0.0);
+    for (auto _ : state) {
+      add_weighted_cross_product(xtx, X, w, state.range(1));
+      benchmark::DoNotOptimize(xtx.data());
+    }
+    state.SetItemsProcessed(state.iterations() * X.nrow());
+  }
+
+  void LinearAlgebraArgs(benchmark::internal::Benchmark *benchmark) {
+    benchmark->ArgsProduct({{64, 256, 1024}, {1, 4}})
+        ->Unit(benchmark::kMillisecond)
+        ->UseRealTime();
+  }
+
+  BENCHMARK(BM_MatrixMult)->Apply(LinearAlgebraArgs);
+  BENCHMARK(BM_MatrixInner)->Apply(LinearAlgebraArgs);
+  BENCHMARK(BM_SpdChol)->Apply(LinearAlgebraArgs);
+  BENCHMARK(BM_SpdInv)->Apply(LinearAlgebraArgs);
+  BENCHMARK(BM_CholeskySolve)->Apply(LinearAlgebraArgs);
+  BENCHMARK(BM_RankOneCrossProduct)->ArgsProduct({{10, 100, 500}, {1}})
+      ->Unit(benchmark::kMillisecond)->UseRealTime();
+  BENCHMARK(BM_BlockedCrossProduct)->ArgsProduct({{10, 100, 500}, {1, 4}})
+      ->Unit(benchmark::kMillisecond)->UseRealTime();
+  BENCHMARK(BM_SVD)->Args({64, 1})->Args({256, 1})->Args({256, 4})
+      ->Unit(benchmark::kMillisecond)->UseRealTime();
+
+}  // namespace
+
+BENCHMARK_MAIN();
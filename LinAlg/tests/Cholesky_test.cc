@@ -131,5 +131,32 @@ namespace {
 
   }
 
+  // chol_inplace should put the same triangle as the Cholesky class in the
+  // lower triangle of its argument, and leave the upper triangle alone.
+  TEST_F(CholeskyTest, InPlace) {
+    Matrix L = Cholesky(spd_).getL();
+    Matrix factor = spd_;
+    EXPECT_TRUE(chol_inplace(factor));
+    for (int i = 0; i < spd_.nrow(); ++i) {
+      for (int j = 0; j < spd_.ncol(); ++j) {
+        if (j <= i) {
+          EXPECT_NEAR(factor(i, j), L(i, j), 1e-10);
+        } else {
+          EXPECT_DOUBLE_EQ(factor(i, j), spd_(i, j));
+        }
+      }
+    }
+
+    Vector v(4);
+    v.randomize();
+    Vector x = v;
+    Lsolve_inplace(factor, x);
+    LTsolve_inplace(factor, x);
+    EXPECT_TRUE(VectorEquals(spd_ * x, v));
+
+    Matrix indefinite = spd_;
+    indefinite(2, 2) = -1.0;
+    EXPECT_FALSE(chol_inplace(indefinite));
+  }
 
 }  // namespace
@@ -62,6 +62,8 @@ namespace {
     EXPECT_DOUBLE_EQ(m2(1, 0), 2.0);
   }
 
+  // An optimized BLAS may accumulate products in a different order than
+  // dot(), so the results are compared up to rounding error.
   TEST_F(MatrixTest, Multiplication) {
     Matrix M(3, 4);
     M.randomize();
@@ -70,31 +72,31 @@ namespace {
     v.randomize();
     Vector product = M * v;
     EXPECT_EQ(3, product.size());
-    EXPECT_DOUBLE_EQ(M.row(0).dot(v), product[0]);
-    EXPECT_DOUBLE_EQ(M.row(1).dot(v), product[1]);
-    EXPECT_DOUBLE_EQ(M.row(2).dot(v), product[2]);
+    EXPECT_NEAR(M.row(0).dot(v), product[0], 1e-12);
+    EXPECT_NEAR(M.row(1).dot(v), product[1], 1e-12);
+    EXPECT_NEAR(M.row(2).dot(v), product[2], 1e-12);
 
     VectorView view(v);
     product = M * view;
     EXPECT_EQ(3, product.size());
-    EXPECT_DOUBLE_EQ(M.row(0).dot(v), product[0]);
-    EXPECT_DOUBLE_EQ(M.row(1).dot(v), product[1]);
-    EXPECT_DOUBLE_EQ(M.row(2).dot(v), product[2]);
+    EXPECT_NEAR(M.row(0).dot(v), product[0], 1e-12);
+    EXPECT_NEAR(M.row(1).dot(v), product[1], 1e-12);
+    EXPECT_NEAR(M.row(2).dot(v), product[2], 1e-12);
 
     product = M * ConstVectorView(v);
     EXPECT_EQ(3, product.size());
-    EXPECT_DOUBLE_EQ(M.row(0).dot(v), product[0]);
-    EXPECT_DOUBLE_EQ(M.row(1).dot(v), product[1]);
-    EXPECT_DOUBLE_EQ(M.row(2).dot(v), product[2]);
+    EXPECT_NEAR(M.row(0).dot(v), product[0], 1e-12);
+    EXPECT_NEAR(M.row(1).dot(v), product[1], 1e-12);
+    EXPECT_NEAR(M.row(2).dot(v), product[2], 1e-12);
 
     Vector v3(3);
     v3.randomize();
     product = M.Tmult(v3);
     EXPECT_EQ(product.size(), 4);
-    EXPECT_EQ(product[0], M.col(0).dot(v3));
-    EXPECT_EQ(product[1], M.col(1).dot(v3));
-    EXPECT_EQ(product[2], M.col(2).dot(v3));
-    EXPECT_EQ(product[3], M.col(3).dot(v3));
+    EXPECT_NEAR(product[0], M.col(0).dot(v3), 1e-12);
+    EXPECT_NEAR(product[1], M.col(1).dot(v3), 1e-12);
+    EXPECT_NEAR(product[2], M.col(2).dot(v3), 1e-12);
+    EXPECT_NEAR(product[3], M.col(3).dot(v3), 1e-12);
 
     VectorView v3_view(v3);
     EXPECT_TRUE(VectorEquals(product, M.Tmult(v3_view)));
@@ -106,36 +108,36 @@ namespace {
     Matrix MM2 = M * M2;
     EXPECT_EQ(3, MM2.nrow());
     EXPECT_EQ(4, MM2.ncol());
-    EXPECT_DOUBLE_EQ(MM2(0, 0), M.row(0).dot(M2.col(0)));
-    EXPECT_DOUBLE_EQ(MM2(0, 1), M.row(0).dot(M2.col(1)));
-    EXPECT_DOUBLE_EQ(MM2(0, 2), M.row(0).dot(M2.col(2)));
-    EXPECT_DOUBLE_EQ(MM2(0, 3), M.row(0).dot(M2.col(3)));
-    EXPECT_DOUBLE_EQ(MM2(1, 0), M.row(1).dot(M2.col(0)));
-    EXPECT_DOUBLE_EQ(MM2(1, 1), M.row(1).dot(M2.col(1)));
-    EXPECT_DOUBLE_EQ(MM2(1, 2), M.row(1).dot(M2.col(2)));
-    EXPECT_DOUBLE_EQ(MM2(1, 3), M.row(1).dot(M2.col(3)));
-    EXPECT_DOUBLE_EQ(MM2(2, 0), M.row(2).dot(M2.col(0)));
-    EXPECT_DOUBLE_EQ(MM2(2, 1), M.row(2).dot(M2.col(1)));
-    EXPECT_DOUBLE_EQ(MM2(2, 2), M.row(2).dot(M2.col(2)));
-    EXPECT_DOUBLE_EQ(MM2(2, 3), M.row(2).dot(M2.col(3)));
+    EXPECT_NEAR(MM2(0, 0), M.row(0).dot(M2.col(0)), 1e-12);
+    EXPECT_NEAR(MM2(0, 1), M.row(0).dot(M2.col(1)), 1e-12);
+    EXPECT_NEAR(MM2(0, 2), M.row(0).dot(M2.col(2)), 1e-12);
+    EXPECT_NEAR(MM2(0, 3), M.row(0).dot(M2.col(3)), 1e-12);
+    EXPECT_NEAR(MM2(1, 0), M.row(1).dot(M2.col(0)), 1e-12);
+    EXPECT_NEAR(MM2(1, 1), M.row(1).dot(M2.col(1)), 1e-12);
+    EXPECT_NEAR(MM2(1, 2), M.row(1).dot(M2.col(2)), 1e-12);
+    EXPECT_NEAR(MM2(1, 3), M.row(1).dot(M2.col(3)), 1e-12);
+    EXPECT_NEAR(MM2(2, 0), M.row(2).dot(M2.col(0)), 1e-12);
+    EXPECT_NEAR(MM2(2, 1), M.row(2).dot(M2.col(1)), 1e-12);
+    EXPECT_NEAR(MM2(2, 2), M.row(2).dot(M2.col(2)), 1e-12);
+    EXPECT_NEAR(MM2(2, 3), M.row(2).dot(M2.col(3)), 1e-12);
 
     SpdMatrix V(4);
     V.randomize();
     Matrix MV = M * V;
     EXPECT_EQ(3, MV.nrow());
     EXPECT_EQ(4, MV.ncol());
-    EXPECT_DOUBLE_EQ(MV(0, 0), M.row(0).dot(V.col(0)));
-    EXPECT_DOUBLE_EQ(MV(0, 1), M.row(0).dot(V.col(1)));
-    EXPECT_DOUBLE_EQ(MV(0, 2), M.row(0).dot(V.col(2)));
-    EXPECT_DOUBLE_EQ(MV(0, 3), M.row(0).dot(V.col(3)));
-    EXPECT_DOUBLE_EQ(MV(1, 0), M.row(1).dot(V.col(0)));
-    EXPECT_DOUBLE_EQ(MV(1, 1), M.row(1).dot(V.col(1)));
-    EXPECT_DOUBLE_EQ(MV(1, 2), M.row(1).dot(V.col(2)));
-    EXPECT_DOUBLE_EQ(MV(1, 3), M.row(1).dot(V.col(3)));
-    EXPECT_DOUBLE_EQ(MV(2, 0), M.row(2).dot(V.col(0)));
-    EXPECT_DOUBLE_EQ(MV(2, 1), M.row(2).dot(V.col(1)));
-    EXPECT_DOUBLE_EQ(MV(2, 2), M.row(2).dot(V.col(2)));
-    EXPECT_DOUBLE_EQ(MV(2, 3), M.row(2).dot(V.col(3)));
+    EXPECT_NEAR(MV(0, 0), M.row(0).dot(V.col(0)), 1e-12);
+    EXPECT_NEAR(MV(0, 1), M.row(0).dot(V.col(1)), 1e-12);
+    EXPECT_NEAR(MV(0, 2), M.row(0).dot(V.col(2)), 1e-12);
+    EXPECT_NEAR(MV(0, 3), M.row(0).dot(V.col(3)), 1e-12);
+    EXPECT_NEAR(MV(1, 0), M.row(1).dot(V.col(0)), 1e-12);
+    EXPECT_NEAR(MV(1, 1), M.row(1).dot(V.col(1)), 1e-12);
+    EXPECT_NEAR(MV(1, 2), M.row(1).dot(V.col(2)), 1e-12);
+    EXPECT_NEAR(MV(1, 3), M.row(1).dot(V.col(3)), 1e-12);
+    EXPECT_NEAR(MV(2, 0), M.row(2).dot(V.col(0)), 1e-12);
+    EXPECT_NEAR(MV(2, 1), M.row(2).dot(V.col(1)), 1e-12);
+    EXPECT_NEAR(MV(2, 2), M.row(2).dot(V.col(2)), 1e-12);
+    EXPECT_NEAR(MV(2, 3), M.row(2).dot(V.col(3)), 1e-12);
 
     EXPECT_TRUE(MatrixEquals(MV, M.multT(V)));
 
@@ -547,4 +549,55 @@ namespace {
 
   }
 
+  TEST_F(MatrixTest, AccumulatingProducts) {
+    Matrix A(3, 4), B(4, 2), C(3, 2), D(5, 2);
+    A.randomize();
+    B.randomize();
+    C.randomize();
+    D.randomize();
+
+    // C + 2 * A * B
+    Matrix ans = C;
+    ans.add_mult(A, B, 2.0);
+    EXPECT_TRUE(MatrixEquals(ans, C + 2.0 * (A * B)));
+
+    // B^T * A^T - C^T, with B^T * A^T computed as (A * B)^T.
+    Matrix At = A.transpose();
+    ans = C.transpose();
+    ans *= -1.0;
+    ans.add_Tmult(B, At);
+    EXPECT_TRUE(MatrixEquals(ans, (A * B).transpose() - C.transpose()));
+
+    // C * D^T
+    Matrix target = C * D.transpose();
+    Matrix left(3, 5);
+    left = 0.0;
+    left.add_outer(C, D, 1.0);
+    EXPECT_TRUE(MatrixEquals(left, target));
+
+    // Products written into preallocated destinations match the allocating
+    // versions, including when the destination is one of the operands.
+    Matrix dest(3, 2);
+    A.mult(B, dest);
+    EXPECT_TRUE(MatrixEquals(dest, A * B));
+    A.multT(A, ans.resize(3, 3), 0.5);
+    EXPECT_TRUE(MatrixEquals(ans, 0.5 * A * A.transpose()));
+    Matrix square(4, 4);
+    square.randomize();
+    Matrix original = square;
+    square.mult(original, square);
+    EXPECT_TRUE(MatrixEquals(square, original * original));
+
+    Vector x(4);
+    x.randomize();
+    Vector y(3);
+    A.mult(x, y, 3.0);
+    EXPECT_TRUE(VectorEquals(y, 3.0 * (A * x)));
+    Vector z(4);
+    A.Tmult(y, z);
+    EXPECT_TRUE(VectorEquals(z, A.Tmult(y)));
+
+    EXPECT_THROW(ans.add_mult(A, A), std::exception);
+  }
+
 }  // namespace
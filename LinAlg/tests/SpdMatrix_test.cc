@@ -408,4 +408,35 @@ namespace {
         << "target = \n" << target;
   }
 
+  TEST_F(SpdMatrixTest, PreallocatedSandwich) {
+    SpdMatrix V(4);
+    V.randomize();
+    Matrix A(3, 4);
+    A.randomize();
+
+    SpdMatrix ans;
+    Matrix workspace;
+    sandwich(A, V, ans, workspace);
+    EXPECT_TRUE(MatrixEquals(ans, sandwich(A, V)));
+
+    // A second call reuses the memory from the first.
+    const double *data = ans.data();
+    V.randomize();
+    sandwich(A, V, ans, workspace);
+    EXPECT_EQ(data, ans.data());
+    EXPECT_TRUE(MatrixEquals(ans, sandwich(A, V)));
+
+    SpdMatrix W(3);
+    W.randomize();
+    sandwich_transpose(A, W, ans, workspace);
+    EXPECT_TRUE(MatrixEquals(ans, sandwich_transpose(A, W)));
+
+    // Multiplying by a vector honors the scale factor.
+    Vector x(4);
+    x.randomize();
+    Vector y(4);
+    V.mult(x, y, 2.0);
+    EXPECT_TRUE(VectorEquals(y, 2.0 * (V * x)));
+  }
+
 }  // namespace
@@ -0,0 +1,168 @@
+#include "gtest/gtest.h"
+#include "LinAlg/CrossProductAccumulator.hpp"
+#include "LinAlg/Matrix.hpp"
+#include "LinAlg/SpdMatrix.hpp"
+#include "LinAlg/Vector.hpp"
+#include "Models/Glm/WeightedRegressionModel.hpp"
+#include "distributions.hpp"
+
+#include "test_utils/test_utils.hpp"
+
+namespace {
+  using namespace BOOM;
+  using std::endl;
+
+  class CrossProductAccumulatorTest : public ::testing::Test {
+   protected:
+    CrossProductAccumulatorTest() {
+      GlobalRng::rng.seed(8675309);
+    }
+
+    // X^T diag(w) X computed one row at a time with add_outer.
+    SpdMatrix naive_cross_product(const Matrix &X, const Vector &w) {
+      SpdMatrix ans(X.ncol(), 0.0);
+      for (int i = 0; i < X.nrow(); ++i) {
+        ans.add_outer(X.row(i), w[i], false);
+      }
+      ans.reflect();
+      return ans;
+    }
+
+    void CheckAccumulator(int nobs, int dim, int block_size,
+                          bool negative_weights) {
+      Matrix X(nobs, dim);
+      X.randomize_gaussian();
+      Vector w(nobs);
+      for (int i = 0; i < nobs; ++i) {
+        w[i] = negative_weights ? rnorm() : rexp(1.0);
+      }
+      SpdMatrix expected = naive_cross_product(X, w);
+
+      CrossProductAccumulator accumulator(dim, block_size);
+      SpdMatrix xtx(dim, 0.0);
+      for (int i = 0; i < nobs; ++i) {
+        accumulator.add(X.row(i), w[i], xtx);
+      }
+      accumulator.flush(xtx);
+      EXPECT_EQ(0, accumulator.pending());
+      xtx.reflect();
+      EXPECT_TRUE(MatrixEquals(xtx, expected, 1e-8))
+          << "nobs = " << nobs << " dim = " << dim
+          << " block_size = " << block_size << endl
+          << xtx - expected;
+
+      SpdMatrix by_matrix(dim, 0.0);
+      accumulator.add(X, w, by_matrix);
+      accumulator.flush(by_matrix);
+      by_matrix.reflect();
+      EXPECT_TRUE(MatrixEquals(by_matrix, expected, 1e-8));
+    }
+  };
+
+  TEST_F(CrossProductAccumulatorTest, MatchesRankOneUpdates) {
+    // Small dimensions bypass the tile.
+    CheckAccumulator(100, 3, 0, false);
+    CheckAccumulator(100, 3, 0, true);
+    // Partial final tiles, and tiles that fill exactly.
+    CheckAccumulator(100, 20, 0, false);
+    CheckAccumulator(128, 20, 0, true);
+    CheckAccumulator(7, 40, 16, false);
+    CheckAccumulator(250, 40, 1, true);
+  }
+
+  TEST_F(CrossProductAccumulatorTest, ClearDiscardsPendingRows) {
+    int dim = 12;
+    CrossProductAccumulator accumulator(dim);
+    SpdMatrix xtx(dim, 0.0);
+    Vector x(dim);
+    x.randomize();
+    accumulator.add(x, 1.0, xtx);
+    EXPECT_EQ(1, accumulator.pending());
+    accumulator.clear();
+    accumulator.flush(xtx);
+    EXPECT_DOUBLE_EQ(0.0, xtx.abs_norm());
+  }
+
+  TEST_F(CrossProductAccumulatorTest, Threads) {
+    int nobs = 5000;
+    int dim = 30;
+    Matrix X(nobs, dim);
+    X.randomize_gaussian();
+    Vector w(nobs);
+    for (int i = 0; i < nobs; ++i) w[i] = rexp(1.0);
+    SpdMatrix expected = naive_cross_product(X, w);
+
+    SpdMatrix serial(dim, 0.0);
+    add_weighted_cross_product(serial, X, w, 1);
+    EXPECT_TRUE(MatrixEquals(serial, expected, 1e-8));
+
+    SpdMatrix threaded(dim, 0.0);
+    add_weighted_cross_product(threaded, X, w, 4);
+    EXPECT_TRUE(MatrixEquals(threaded, expected, 1e-8));
+
+    // The result should not depend on how the threads were scheduled.
+    SpdMatrix threaded_again(dim, 0.0);
+    add_weighted_cross_product(threaded_again, X, w, 4);
+    EXPECT_DOUBLE_EQ(0.0, (threaded - threaded_again).max_abs());
+
+    // The matrix is incremented, not overwritten.
+    add_weighted_cross_product(threaded_again, X, w, 3);
+    EXPECT_TRUE(MatrixEquals(threaded_again, expected * 2, 1e-8));
+  }
+
+  // The sufficient statistics defer some of their updates.  Check that the
+  // deferred rows are accounted for when the statistics are read, combined,
+  // or serialized.
+  TEST_F(CrossProductAccumulatorTest, WeightedRegSuf) {
+    int nobs = 150;
+    int dim = 25;
+    Matrix X(nobs, dim);
+    X.randomize_gaussian();
+    Vector y(nobs);
+    y.randomize();
+    Vector w(nobs);
+    for (int i = 0; i < nobs; ++i) w[i] = rexp(1.0);
+    SpdMatrix expected = naive_cross_product(X, w);
+
+    WeightedRegSuf suf(dim);
+    WeightedRegSuf first_half(dim);
+    WeightedRegSuf second_half(dim);
+    for (int i = 0; i < nobs; ++i) {
+      suf.add_data(X.row(i), y[i], w[i]);
+      if (i < nobs / 2) {
+        first_half.add_data(X.row(i), y[i], w[i]);
+      } else {
+        second_half.add_data(X.row(i), y[i], w[i]);
+      }
+    }
+    EXPECT_TRUE(MatrixEquals(suf.xtx(), expected, 1e-8));
+
+    first_half.combine(second_half);
+    EXPECT_TRUE(MatrixEquals(first_half.xtx(), expected, 1e-8));
+
+    WeightedRegSuf recomputed(dim);
+    recomputed.recompute(X, y, w);
+    EXPECT_TRUE(MatrixEquals(recomputed.xtx(), expected, 1e-8));
+    EXPECT_TRUE(VectorEquals(recomputed.xty(), suf.xty(), 1e-8));
+    EXPECT_NEAR(recomputed.yty(), suf.yty(), 1e-8);
+
+    WeightedRegSuf pending(dim);
+    for (int i = 0; i < 10; ++i) {
+      pending.add_data(X.row(i), y[i], w[i]);
+    }
+    WeightedRegSuf restored(dim);
+    restored.unvectorize(pending.vectorize());
+    EXPECT_TRUE(MatrixEquals(restored.xtx(), pending.xtx(), 1e-10));
+
+    // Removing data uses negative weights.
+    for (int i = 0; i < 10; ++i) {
+      suf.remove_data(X.row(i), y[i], w[i]);
+    }
+    SpdMatrix remaining(dim, 0.0);
+    for (int i = 10; i < nobs; ++i) {
+      remaining.add_outer(X.row(i), w[i]);
+    }
+    EXPECT_TRUE(MatrixEquals(suf.xtx(), remaining, 1e-8));
+  }
+
+}  // namespace
@@ -0,0 +1,113 @@
+#include "gtest/gtest.h"
+#include "distributions.hpp"
+#include "LinAlg/IncrementalCholesky.hpp"
+#include "LinAlg/Selector.hpp"
+#include "LinAlg/SpdMatrix.hpp"
+#include "cpputil/math_utils.hpp"
+#include "test_utils/test_utils.hpp"
+
+namespace {
+  using namespace BOOM;
+  using std::endl;
+
+  class IncrementalCholeskyTest : public ::testing::Test {
+   protected:
+    IncrementalCholeskyTest()
+        : dim_(12),
+          A_(dim_)
+    {
+      GlobalRng::rng.seed(8675309);
+      A_.randomize();
+    }
+
+    // Select the rows and columns of A_ in the order used by 'chol'.
+    SpdMatrix ordered_block(const IncrementalCholesky &chol) const {
+      int k = chol.dim();
+      SpdMatrix ans(k);
+      for (int i = 0; i < k; ++i) {
+        for (int j = 0; j < k; ++j) {
+          ans(i, j) = A_(chol.order()[i], chol.order()[j]);
+        }
+      }
+      return ans;
+    }
+
+    int dim_;
+    SpdMatrix A_;
+  };
+
+  TEST_F(IncrementalCholeskyTest, AddAndDrop) {
+    Selector inc("101001100001");
+    IncrementalCholesky chol(1000);
+    EXPECT_TRUE(chol.decompose(A_, inc));
+    EXPECT_EQ(5, chol.dim());
+    EXPECT_NEAR(inc.select(A_).logdet(), chol.logdet(), 1e-8);
+
+    // Walk through a sequence of changes, checking the factor each time.
+    std::vector<int> changes = {1, 0, 7, 11, 3, 2, 0, 5, 9, 6};
+    for (int which : changes) {
+      bool adding = !inc[which];
+      Vector b(chol.dim() + adding);
+      b.randomize();
+      double qform = 0;
+      double logdet = adding ? chol.evaluate_add(which, &b, &qform)
+          : chol.evaluate_drop(which, &b, &qform);
+      Vector reduced_b = b;
+      if (adding) {
+        EXPECT_TRUE(chol.add(which));
+        inc.add(which);
+      } else {
+        int position = chol.position(which);
+        std::vector<double> values(b.begin(), b.end());
+        values.erase(values.begin() + position);
+        reduced_b = Vector(values.begin(), values.end());
+        chol.drop(which);
+        inc.drop(which);
+      }
+      EXPECT_EQ(inc.nvars(), chol.dim());
+      SpdMatrix block = ordered_block(chol);
+      Matrix L = chol.getL();
+      EXPECT_TRUE(MatrixEquals(L * L.transpose(), block))
+          << "After changing " << which << endl
+          << "L * L^T = " << endl << L * L.transpose() << endl
+          << "block = " << endl << block;
+      EXPECT_NEAR(block.logdet(), logdet, 1e-8);
+      EXPECT_NEAR(block.logdet(), chol.logdet(), 1e-8);
+      EXPECT_NEAR(reduced_b.dot(block.solve(reduced_b)), qform, 1e-8);
+      EXPECT_NEAR(qform, chol.quadratic_form(reduced_b), 1e-8);
+    }
+  }
+
+  TEST_F(IncrementalCholeskyTest, Refactorization) {
+    Selector inc(dim_, false);
+    IncrementalCholesky chol(3);
+    EXPECT_TRUE(chol.decompose(A_, inc));
+    EXPECT_EQ(0, chol.dim());
+    EXPECT_DOUBLE_EQ(0.0, chol.logdet());
+    for (int i = 0; i < dim_; ++i) {
+      EXPECT_TRUE(chol.add(i));
+    }
+    for (int i = 0; i < dim_; i += 2) {
+      chol.drop(i);
+    }
+    SpdMatrix block = ordered_block(chol);
+    Matrix L = chol.getL();
+    EXPECT_TRUE(MatrixEquals(L * L.transpose(), block));
+    EXPECT_NEAR(block.logdet(), chol.logdet(), 1e-8);
+  }
+
+  TEST_F(IncrementalCholeskyTest, NotPositiveDefinite) {
+    // Make variable 3 a copy of variable 2.
+    for (int i = 0; i < dim_; ++i) {
+      A_(i, 3) = A_(3, i) = A_(i, 2);
+    }
+    A_(3, 3) = A_(2, 2);
+    Selector inc("001000000000");
+    IncrementalCholesky chol;
+    EXPECT_TRUE(chol.decompose(A_, inc));
+    EXPECT_EQ(negative_infinity(), chol.evaluate_add(3));
+    EXPECT_FALSE(chol.add(3));
+    EXPECT_EQ(1, chol.dim());
+  }
+
+}  // namespace
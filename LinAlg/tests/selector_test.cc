@@ -4,6 +4,7 @@
 #include "LinAlg/DiagonalMatrix.hpp"
 #include "LinAlg/Matrix.hpp"
 #include "LinAlg/Selector.hpp"
+#include "LinAlg/SpdMatrix.hpp"
 #include "distributions.hpp"
 #include "cpputil/math_utils.hpp"
 #include "test_utils/test_utils.hpp"
@@ -306,4 +307,35 @@ namespace {
     EXPECT_TRUE(VectorEquals(x, y));
   }
 
+  TEST_F(SelectorTest, SelectIntoDestination) {
+    Selector inc("10110");
+    Vector x(5);
+    x.randomize();
+    Vector ans;
+    inc.select(x, ans);
+    EXPECT_TRUE(VectorEquals(ans, inc.select(x)));
+
+    SpdMatrix S(5);
+    S.randomize();
+    SpdMatrix selected;
+    inc.select(S, selected);
+    EXPECT_TRUE(MatrixEquals(selected, inc.select(S)));
+
+    // Shrinking and regrowing reuses the destination's memory.
+    const double *data = selected.data();
+    inc.drop(0);
+    inc.select(S, selected);
+    EXPECT_TRUE(MatrixEquals(selected, inc.select(S)));
+    inc.add(0);
+    inc.select(S, selected);
+    EXPECT_EQ(data, selected.data());
+    EXPECT_TRUE(MatrixEquals(selected, inc.select(S)));
+
+    Selector all(5, true);
+    all.select(S, selected);
+    EXPECT_TRUE(MatrixEquals(selected, S));
+    all.select(x, ans);
+    EXPECT_TRUE(VectorEquals(ans, x));
+  }
+
 }  // namespace
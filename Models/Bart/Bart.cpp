@@ -21,6 +21,7 @@
 #include <cmath>
 #include <cstdlib>
 #include <iterator>
+#include <typeinfo>
 
 #include "Models/Bart/Bart.hpp"
 #include "Models/Bart/ResidualRegressionData.hpp"
@@ -439,6 +440,52 @@ namespace BOOM {
       return ans;
     }
 
+    //======================================================================
+    TreeData::TreeData(
+        const std::vector<ResidualRegressionData *> &data,
+        const std::shared_ptr<const BinnedPredictors> &predictors)
+        : predictors_(predictors) {
+      if (!!predictors_ &&
+          predictors_->number_of_observations() != data.size()) {
+        report_error(
+            "The binned predictors do not match the data in TreeData.");
+      }
+      entries_.resize(data.size());
+      for (int i = 0; i < data.size(); ++i) {
+        entries_[i].data = data[i];
+        entries_[i].row = i;
+      }
+    }
+
+    //----------------------------------------------------------------------
+    void TreeData::add(ResidualRegressionData *data) {
+      Entry entry;
+      entry.data = data;
+      entry.row = entries_.size();
+      entries_.push_back(entry);
+      if (!!predictors_ &&
+          predictors_->number_of_observations() < entries_.size()) {
+        predictors_.reset();
+      }
+    }
+
+    //----------------------------------------------------------------------
+    int TreeData::partition(int variable, double cutpoint, int begin,
+                            int end) {
+      Entry *first = entries_.data() + begin;
+      Entry *last = entries_.data() + end;
+      Entry *middle;
+      if (!!predictors_) {
+        middle = predictors_->partition(variable, cutpoint, first, last);
+      } else {
+        middle = std::partition(
+            first, last, [variable, cutpoint](const Entry &entry) {
+              return entry.data->x()[variable] <= cutpoint;
+            });
+      }
+      return middle - entries_.data();
+    }
+
     //======================================================================
 
     TreeNode::TreeNode(double mean_value, TreeNode *parent)
@@ -447,6 +494,8 @@ namespace BOOM {
           right_child_(NULL),
           depth_(parent_ ? 1 + parent_->depth() : 0),
           mean_(mean_value),
+          data_begin_(0),
+          data_end_(0),
           which_variable_(-1),         // needs to be set
           cutpoint_(BOOM::infinity())  // needs to be set
     {}
@@ -658,7 +707,8 @@ namespace BOOM {
 
     //----------------------------------------------------------------------
     void TreeNode::clear_data_and_delete_suf(bool recursive) {
-      data_.clear();
+      tree_data_.reset();
+      data_begin_ = data_end_ = 0;
       if (!!suf_) {
         suf_.reset();
       }
@@ -674,7 +724,8 @@ namespace BOOM {
 
     //----------------------------------------------------------------------
     void TreeNode::clear_data_and_suf(bool recursive) {
-      data_.clear();
+      tree_data_.reset();
+      data_begin_ = data_end_ = 0;
       if (!!suf_) {
         suf_->clear();
       }
@@ -699,33 +750,30 @@ namespace BOOM {
     }
 
     //----------------------------------------------------------------------
-    void TreeNode::populate_data(ResidualRegressionData *dp, bool recursive) {
-      data_.push_back(dp);
-      if (recursive && !is_leaf()) {
-        drop_data_to_subtree(dp);
-      }
-    }
-
-    //----------------------------------------------------------------------
-    void TreeNode::drop_data_to_subtree(ResidualRegressionData *dp) {
-      const Vector &x(dp->x());
-      if (x[which_variable_] <= cutpoint_) {
-        left_child_->populate_data(dp, true);
-      } else {
-        right_child_->populate_data(dp, true);
+    void TreeNode::populate_data(const std::shared_ptr<TreeData> &tree_data,
+                                 int begin, int end, bool recursive) {
+      tree_data_ = tree_data;
+      data_begin_ = begin;
+      data_end_ = end;
+      if (recursive) {
+        refresh_subtree_data();
       }
     }
 
     //----------------------------------------------------------------------
+    // The node's observations are partitioned in place, so the
+    // children's ranges are adjacent sub-ranges of this node's range.
     void TreeNode::refresh_subtree_data() {
       if (is_leaf()) {
         return;
       }
-      left_child_->clear_data_and_suf(true);
-      right_child_->clear_data_and_suf(true);
-      for (int i = 0; i < data_.size(); ++i) {
-        drop_data_to_subtree(data_[i]);
+      int middle = data_begin_;
+      if (!!tree_data_) {
+        middle = tree_data_->partition(which_variable_, cutpoint_,
+                                       data_begin_, data_end_);
       }
+      left_child_->populate_data(tree_data_, data_begin_, middle, true);
+      right_child_->populate_data(tree_data_, middle, data_end_, true);
     }
 
     //----------------------------------------------------------------------
@@ -741,28 +789,48 @@ namespace BOOM {
       } else {
         report_error("Sufficient statistics object was never allocated.");
       }
-      for (int i = 0; i < data_.size(); ++i) {
-        suf_->update(*(data_[i]));
+      for (const TreeData::Entry *it = data_begin(); it != data_end(); ++it) {
+        suf_->update(*(it->data));
       }
       return *suf_;
     }
 
     //----------------------------------------------------------------------
-    const std::vector<ResidualRegressionData *> &TreeNode::data() const {
-      return data_;
+    std::vector<ResidualRegressionData *> TreeNode::data() const {
+      std::vector<ResidualRegressionData *> ans;
+      ans.reserve(sample_size());
+      for (const TreeData::Entry *it = data_begin(); it != data_end(); ++it) {
+        ans.push_back(it->data);
+      }
+      return ans;
+    }
+
+    //----------------------------------------------------------------------
+    const TreeData::Entry *TreeNode::data_begin() const {
+      return tree_data_ ? tree_data_->begin() + data_begin_ : NULL;
+    }
+
+    //----------------------------------------------------------------------
+    const TreeData::Entry *TreeNode::data_end() const {
+      return tree_data_ ? tree_data_->begin() + data_end_ : NULL;
+    }
+
+    //----------------------------------------------------------------------
+    const BinnedPredictors *TreeNode::binned_predictors() const {
+      return tree_data_ ? tree_data_->predictors() : NULL;
     }
 
     //----------------------------------------------------------------------
     void TreeNode::remove_mean_effect() {
-      for (int i = 0; i < data_.size(); ++i) {
-        data_[i]->add_to_residual(mean_);
+      for (const TreeData::Entry *it = data_begin(); it != data_end(); ++it) {
+        it->data->add_to_residual(mean_);
       }
     }
 
     //----------------------------------------------------------------------
     void TreeNode::replace_mean_effect() {
-      for (int i = 0; i < data_.size(); ++i) {
-        data_[i]->subtract_from_residual(mean_);
+      for (const TreeData::Entry *it = data_begin(); it != data_end(); ++it) {
+        it->data->subtract_from_residual(mean_);
       }
     }
 
@@ -799,6 +867,101 @@ namespace BOOM {
       return next_id;
     }
 
+    //======================================================================
+    SplitSufficientStatistics::SplitSufficientStatistics()
+        : predictors_(NULL), variable_(-1) {}
+
+    //----------------------------------------------------------------------
+    bool SplitSufficientStatistics::compute(const TreeNode *node,
+                                            int variable) {
+      predictors_ = node->binned_predictors();
+      variable_ = variable;
+      bins_.clear();
+      if (!predictors_ || !predictors_->is_binned(variable) || !node->suf_) {
+        predictors_ = NULL;
+        return false;
+      }
+
+      // A counting pass over the node's data, accumulating a
+      // sufficient statistic for each bin.  A bin's statistic is
+      // cleared the first time the bin is seen.
+      const SufficientStatisticsBase &prototype(*node->suf_);
+      int number_of_bins = predictors_->number_of_bins(variable);
+      reserve_statistics(histogram_, number_of_bins, prototype);
+      if (bin_counts_.size() < number_of_bins) {
+        bin_counts_.resize(number_of_bins, 0);
+      }
+      for (const TreeData::Entry *it = node->data_begin();
+           it != node->data_end(); ++it) {
+        int bin = predictors_->bin(variable, it->row);
+        if (bin_counts_[bin]++ == 0) {
+          bins_.push_back(bin);
+          histogram_[bin]->clear();
+        }
+        histogram_[bin]->update(*(it->data));
+      }
+      std::sort(bins_.begin(), bins_.end());
+      for (int bin : bins_) {
+        bin_counts_[bin] = 0;
+      }
+
+      // Prefix and suffix sums over the non-empty bins.
+      int number_of_nonempty_bins = bins_.size();
+      reserve_statistics(left_, number_of_nonempty_bins + 1, prototype);
+      reserve_statistics(right_, number_of_nonempty_bins + 1, prototype);
+      left_[0]->clear();
+      for (int k = 0; k < number_of_nonempty_bins; ++k) {
+        left_[k + 1]->clear();
+        left_[k + 1]->combine(*left_[k]);
+        left_[k + 1]->combine(*histogram_[bins_[k]]);
+      }
+      right_[number_of_nonempty_bins]->clear();
+      for (int k = number_of_nonempty_bins - 1; k >= 0; --k) {
+        right_[k]->clear();
+        right_[k]->combine(*right_[k + 1]);
+        right_[k]->combine(*histogram_[bins_[k]]);
+      }
+      return true;
+    }
+
+    //----------------------------------------------------------------------
+    void SplitSufficientStatistics::reserve_statistics(
+        std::vector<std::shared_ptr<SufficientStatisticsBase>> &statistics,
+        int size, const SufficientStatisticsBase &prototype) {
+      if (!statistics.empty() &&
+          typeid(*statistics[0]) != typeid(prototype)) {
+        statistics.clear();
+      }
+      while (statistics.size() < size) {
+        statistics.emplace_back(prototype.create());
+      }
+    }
+
+    //----------------------------------------------------------------------
+    const SufficientStatisticsBase &SplitSufficientStatistics::left(
+        double cutpoint) const {
+      return *left_[split_position(cutpoint)];
+    }
+
+    //----------------------------------------------------------------------
+    const SufficientStatisticsBase &SplitSufficientStatistics::right(
+        double cutpoint) const {
+      return *right_[split_position(cutpoint)];
+    }
+
+    //----------------------------------------------------------------------
+    int SplitSufficientStatistics::split_position(double cutpoint) const {
+      if (!predictors_) {
+        report_error(
+            "SplitSufficientStatistics::compute() must succeed before "
+            "statistics can be extracted.");
+      }
+      int threshold =
+          predictors_->number_of_bins_at_or_below(variable_, cutpoint);
+      return std::lower_bound(bins_.begin(), bins_.end(), threshold) -
+             bins_.begin();
+    }
+
     //======================================================================
 
     Tree::Tree(double mean_value)
@@ -1028,9 +1191,22 @@ namespace BOOM {
       root_->populate_sufficient_statistics(suf, true);
     }
 
+    //----------------------------------------------------------------------
+    void Tree::populate_data(
+        const std::vector<ResidualRegressionData *> &data,
+        const std::shared_ptr<const BinnedPredictors> &predictors) {
+      std::shared_ptr<TreeData> tree_data(new TreeData(data, predictors));
+      root_->populate_data(tree_data, 0, tree_data->size(), true);
+    }
+
     //----------------------------------------------------------------------
     void Tree::populate_data(ResidualRegressionData *data) {
-      root_->populate_data(data, true);
+      std::shared_ptr<TreeData> tree_data = root_->tree_data_;
+      if (!tree_data) {
+        tree_data.reset(new TreeData(std::vector<ResidualRegressionData *>()));
+      }
+      tree_data->add(data);
+      root_->populate_data(tree_data, 0, tree_data->size(), true);
     }
 
     //----------------------------------------------------------------------
@@ -20,9 +20,11 @@
 #ifndef BOOM_BART_HPP_
 #define BOOM_BART_HPP_
 
+#include <memory>
 #include <set>
 
 #include "LinAlg/SubMatrix.hpp"
+#include "Models/Bart/BinnedPredictors.hpp"
 #include "Models/GaussianModelBase.hpp"
 #include "Models/Glm/Glm.hpp"  // for RegressionData
 #include "Models/Policies/IID_DataPolicy.hpp"
@@ -67,6 +69,12 @@ namespace BOOM {
       // Add relevant functions of data to the sufficient statistics
       // being modeled.
       virtual void update(const ResidualRegressionData &data) = 0;
+
+      // Add the data summarized by rhs to the data summarized by
+      // *this.  It is an error to combine sufficient statistics of
+      // different concrete types.
+      virtual void combine(const SufficientStatisticsBase &rhs) = 0;
+
       virtual SufficientStatisticsBase *create() const {
         SufficientStatisticsBase *ans = clone();
         ans->clear();
@@ -246,12 +254,62 @@ namespace BOOM {
       Vector range_;  // lower and upper limits for cutpoints
     };
 
+    //======================================================================
+    // The observations assigned to a Tree.  The observations are
+    // stored in a single array shared by all the nodes in the tree,
+    // arranged so that the observations belonging to any node occupy
+    // a contiguous range.  Splitting a node rearranges its range in
+    // place, so distributing a node's data among its children
+    // requires no allocation and no copying of data pointers.
+    class TreeData {
+     public:
+      struct Entry {
+        ResidualRegressionData *data;
+        // The index of the observation in the BinnedPredictors.
+        int row;
+      };
+
+      // Args:
+      //   data: The data to be managed by the tree.  data[i] is
+      //     observation i in 'predictors'.
+      //   predictors: A columnar copy of the predictors in 'data',
+      //     used to route observations through the tree.  If NULL,
+      //     then observations are routed by inspecting data[i]->x().
+      explicit TreeData(
+          const std::vector<ResidualRegressionData *> &data,
+          const std::shared_ptr<const BinnedPredictors> &predictors =
+              std::shared_ptr<const BinnedPredictors>());
+
+      // Add an observation to the end of the array.  If the
+      // observation is not covered by the binned predictors then the
+      // binned predictors are discarded.
+      void add(ResidualRegressionData *data);
+
+      int size() const { return entries_.size(); }
+      Entry *begin() { return entries_.data(); }
+      const Entry *begin() const { return entries_.data(); }
+
+      // The binned predictors used to route observations, or NULL if
+      // the predictors are not binned.
+      const BinnedPredictors *predictors() const { return predictors_.get(); }
+
+      // Rearrange the observations in positions [begin, end) so that
+      // those with x[variable] <= cutpoint come first.  Returns the
+      // position of the first observation with x[variable] > cutpoint.
+      int partition(int variable, double cutpoint, int begin, int end);
+
+     private:
+      std::vector<Entry> entries_;
+      std::shared_ptr<const BinnedPredictors> predictors_;
+    };
+
     //======================================================================
     // A TreeNode is one node in a Tree.  The node can be either a
     // leaf or an interior node.
     class TreeNode {
      public:
       friend class Tree;
+      friend class SplitSufficientStatistics;
 
       // At construction time, the node is a leaf.
       // Args:
@@ -349,14 +407,14 @@ namespace BOOM {
       int variable_index() const;
       double cutpoint() const;
 
-      // Clears the vector of data managed by this node, and deletes
-      // the sufficient statistics object describing the data.  If
-      // recursive is true then data and sufficient statistics will be
-      // removed from all descendants as well.
+      // Disassociates this node from the data managed by its tree,
+      // and deletes the sufficient statistics object describing the
+      // data.  If recursive is true then data and sufficient
+      // statistics will be removed from all descendants as well.
       void clear_data_and_delete_suf(bool recursive = true);
 
-      // Clears the vector of data managed by this node, and empties
-      // the accompanying sufficient statistic.
+      // Disassociates this node from the data managed by its tree,
+      // and empties the accompanying sufficient statistic.
       // Args:
       //   recursive: If true then data for descendants will be
       //     cleared as well.  Otherwise only data and sufficient
@@ -372,23 +430,23 @@ namespace BOOM {
       void populate_sufficient_statistics(SufficientStatisticsBase *suf,
                                           bool recursive = true);
 
-      // Associate an observation with this node.
+      // Associate a range of observations with this node.
       // Args:
-      //   dp:  The data point pointer to associate with this node.
-      //   recursive: If true then dp is also associated with either
-      //     the left or right child of *this, depending on whether
-      //     dp->x() indicates that the observation should fall to the
-      //     left or the right.
-      void populate_data(ResidualRegressionData *dp, bool recursive = true);
-
-      // Clear the data below this node, and drop this node's data
-      // down through the subtree formed by this node's descendants.
+      //   tree_data: The data managed by the tree containing this
+      //     node.
+      //   begin, end: This node is assigned the observations in
+      //     positions [begin, end) of tree_data.
+      //   recursive: If true then the observations are distributed
+      //     among the descendants of this node according to their
+      //     splitting rules.
+      void populate_data(const std::shared_ptr<TreeData> &tree_data,
+                         int begin, int end, bool recursive = true);
+
+      // Distribute this node's data among its descendants.  This
+      // must be called whenever the variable or cutpoint of *this
+      // (or any of its descendants) changes.
       void refresh_subtree_data();
 
-      // Take this data point, and recursively distribute it to either
-      // the left or right child.
-      void drop_data_to_subtree(ResidualRegressionData *dp);
-
       // Swaps the variable and cutpoint values for the two nodes.
       // ***** Note that this may introduce structural dead branches
       // in the tree (branches where it would be impossible to attract
@@ -407,8 +465,18 @@ namespace BOOM {
       // "is_current" observer.
       const SufficientStatisticsBase &compute_suf();
 
-      // The vector of data associated with this node.
-      const std::vector<ResidualRegressionData *> &data() const;
+      // A copy of the vector of data associated with this node.
+      std::vector<ResidualRegressionData *> data() const;
+
+      // The observations associated with this node occupy the range
+      // [data_begin(), data_end()).  Both are NULL if no data has
+      // been assigned.
+      const TreeData::Entry *data_begin() const;
+      const TreeData::Entry *data_end() const;
+
+      // The binned predictors used to route this node's data, or
+      // NULL if the data are routed using the raw predictors.
+      const BinnedPredictors *binned_predictors() const;
 
       // Remove the effect of this node on the predicted values of the
       // data associated with it.  (I.e. adjust the predictions as if
@@ -433,7 +501,7 @@ namespace BOOM {
       int fill_tree_matrix_row(int parent_id, int my_id,
                                Matrix *tree_matrix) const;
 
-      int sample_size() const { return data_.size(); }
+      int sample_size() const { return data_end_ - data_begin_; }
 
      private:
       // For singleton trees, it is possible for a node to be a root and
@@ -448,8 +516,12 @@ namespace BOOM {
       // nodes, but only used if the node is a leaf.
       double mean_;
 
-      // The data for a node is not owned by the node.
-      std::vector<ResidualRegressionData *> data_;
+      // The data for a node is not owned by the node.  The node's
+      // observations are positions [data_begin_, data_end_) of
+      // tree_data_, which is shared by all nodes in the tree.
+      std::shared_ptr<TreeData> tree_data_;
+      int data_begin_;
+      int data_end_;
       std::shared_ptr<SufficientStatisticsBase> suf_;
 
       // For interior nodes predictions are made by going left if x <=
@@ -462,6 +534,68 @@ namespace BOOM {
       return node.print(out);
     }
 
+    //======================================================================
+    // The sufficient statistics for the left and right children that
+    // would result from splitting a node on a particular variable, for
+    // every possible cutpoint.  The statistics are computed by a
+    // single histogram pass over the node's data, grouping the
+    // observations by their bin in a BinnedPredictors object.  After
+    // that the statistics for any cutpoint are available without
+    // touching the data, which makes it cheap to evaluate many
+    // candidate cutpoints (e.g. in a slice sampler).
+    class SplitSufficientStatistics {
+     public:
+      SplitSufficientStatistics();
+
+      // Compute the left and right sufficient statistics for all
+      // possible cutpoints on 'variable' for the data assigned to
+      // 'node'.  The node must have a sufficient statistics object
+      // (which is used as a prototype), and its data must be routed
+      // using binned predictors in which 'variable' is binned.
+      //
+      // Returns:
+      //   true if the statistics were computed successfully, and
+      //   false if the node's data is not binned on 'variable'.
+      bool compute(const TreeNode *node, int variable);
+
+      // The sufficient statistics for the data in the left and right
+      // children if the node were split at 'cutpoint'.  Only valid
+      // after a successful call to compute().
+      const SufficientStatisticsBase &left(double cutpoint) const;
+      const SufficientStatisticsBase &right(double cutpoint) const;
+
+     private:
+      // The position in bins_ of the first bin falling to the right
+      // of 'cutpoint'.
+      int split_position(double cutpoint) const;
+
+      // Ensure that 'statistics' holds at least 'size' objects of the
+      // same concrete type as 'prototype'.  Existing objects are
+      // reused.
+      static void reserve_statistics(
+          std::vector<std::shared_ptr<SufficientStatisticsBase>> &statistics,
+          int size, const SufficientStatisticsBase &prototype);
+
+      const BinnedPredictors *predictors_;
+      int variable_;
+
+      // The sorted set of bins containing at least one observation.
+      std::vector<int> bins_;
+
+      // histogram_[b] describes the observations in bin b.  Only the
+      // elements indexed by bins_ are current.  The histogram and the
+      // counts are reused across calls to compute().  Between calls
+      // every element of bin_counts_ is zero.
+      std::vector<std::shared_ptr<SufficientStatisticsBase>> histogram_;
+      std::vector<int> bin_counts_;
+
+      // left_[k] describes the observations in bins_[0], ...,
+      // bins_[k-1].  right_[k] describes bins_[k], ..., bins_.back().
+      // Only the first bins_.size() + 1 elements are current.
+      std::vector<std::shared_ptr<SufficientStatisticsBase>> left_;
+      std::vector<std::shared_ptr<SufficientStatisticsBase>> right_;
+    };
+
     //======================================================================
     // A Tree is just a collection of TreeNodes, handled through the
     // root.  The class is useful because it helps clarify tree-level
@@ -575,8 +709,23 @@ namespace BOOM {
       // statistics for the data that has been assigned to it.
       void populate_sufficient_statistics(SufficientStatisticsBase *suf);
 
-      // Drops the data pointer through the tree.  Each node that it
-      // falls through keeps a copy of the pointer.
+      // Assigns a set of observations to the tree, replacing any
+      // data the tree currently holds, and distributes the data
+      // among the nodes in the tree.
+      // Args:
+      //   data:  The observations to assign to the tree.
+      //   predictors: A columnar copy of the predictors in 'data',
+      //     with data[i] as observation i.  If NULL then observations
+      //     are routed through the tree using data[i]->x().
+      void populate_data(const std::vector<ResidualRegressionData *> &data,
+                         const std::shared_ptr<const BinnedPredictors>
+                             &predictors =
+                                 std::shared_ptr<const BinnedPredictors>());
+
+      // Adds a single data point to the tree, and drops it through
+      // the tree.  Each call re-distributes all the data in the tree
+      // among its nodes, so adding many observations should be done
+      // using the vector version of populate_data().
       void populate_data(ResidualRegressionData *data);
 
       // Removes the data from the nodes in the tree, and deletes the
@@ -0,0 +1,132 @@
+/*
+  Copyright (C) 2019 Steven L. Scott
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+*/
+
+#include "Models/Bart/BinnedPredictors.hpp"
+#include <algorithm>
+#include <cmath>
+#include "Models/Bart/ResidualRegressionData.hpp"
+#include "cpputil/report_error.hpp"
+
+namespace BOOM {
+  namespace Bart {
+
+    namespace {
+      const int kMaxSmallBins = 255;
+      const int kMaxLargeBins = 65535;
+    }  // namespace
+
+    BinnedPredictors::BinnedPredictors() : number_of_observations_(0) {}
+
+    BinnedPredictors::BinnedPredictors(
+        const std::vector<ResidualRegressionData *> &data)
+        : number_of_observations_(data.size()) {
+      if (data.empty()) return;
+      int number_of_variables = data[0]->x().size();
+      columns_.resize(number_of_variables);
+      std::vector<double> values(number_of_observations_);
+      for (int v = 0; v < number_of_variables; ++v) {
+        Column &column(columns_[v]);
+        column.has_missing = false;
+        for (int i = 0; i < number_of_observations_; ++i) {
+          const Vector &x(data[i]->x());
+          if (x.size() != number_of_variables) {
+            report_error(
+                "All observations passed to BinnedPredictors must have the "
+                "same number of variables.");
+          }
+          values[i] = x[v];
+          if (std::isnan(values[i])) column.has_missing = true;
+        }
+
+        std::vector<double> distinct;
+        distinct.reserve(number_of_observations_);
+        for (int i = 0; i < number_of_observations_; ++i) {
+          if (!std::isnan(values[i])) distinct.push_back(values[i]);
+        }
+        std::sort(distinct.begin(), distinct.end());
+        distinct.erase(std::unique(distinct.begin(), distinct.end()),
+                       distinct.end());
+        column.values = Vector(distinct.begin(), distinct.end());
+
+        int nbins = distinct.size() + column.has_missing;
+        if (nbins > kMaxLargeBins) {
+          column.raw_values = values;
+          continue;
+        }
+        std::vector<int> bins(number_of_observations_);
+        for (int i = 0; i < number_of_observations_; ++i) {
+          if (std::isnan(values[i])) {
+            bins[i] = distinct.size();
+          } else {
+            bins[i] = std::lower_bound(distinct.begin(), distinct.end(),
+                                       values[i]) -
+                      distinct.begin();
+          }
+        }
+        if (nbins <= kMaxSmallBins) {
+          column.small_bins.assign(bins.begin(), bins.end());
+        } else {
+          column.large_bins.assign(bins.begin(), bins.end());
+        }
+      }
+    }
+
+    bool BinnedPredictors::is_binned(int variable) const {
+      return columns_[variable].raw_values.empty();
+    }
+
+    int BinnedPredictors::number_of_values(int variable) const {
+      return columns_[variable].values.size();
+    }
+
+    int BinnedPredictors::number_of_bins(int variable) const {
+      const Column &column(columns_[variable]);
+      return column.values.size() + column.has_missing;
+    }
+
+    int BinnedPredictors::bin(int variable, int row) const {
+      const Column &column(columns_[variable]);
+      if (!column.small_bins.empty()) {
+        return column.small_bins[row];
+      } else if (!column.large_bins.empty()) {
+        return column.large_bins[row];
+      }
+      report_error("Variable is not binned.");
+      return -1;
+    }
+
+    int BinnedPredictors::number_of_bins_at_or_below(int variable,
+                                                     double cutpoint) const {
+      const Vector &values(columns_[variable].values);
+      return std::upper_bound(values.begin(), values.end(), cutpoint) -
+             values.begin();
+    }
+
+    bool BinnedPredictors::goes_left(int variable, double cutpoint,
+                                     int row) const {
+      const Column &column(columns_[variable]);
+      if (column.raw_values.empty()) {
+        return bin(variable, row) <
+               number_of_bins_at_or_below(variable, cutpoint);
+      } else {
+        return column.raw_values[row] <= cutpoint;
+      }
+    }
+
+  }  // namespace Bart
+}  // namespace BOOM
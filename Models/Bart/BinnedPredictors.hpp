@@ -0,0 +1,172 @@
+#ifndef BOOM_BART_BINNED_PREDICTORS_HPP_
+#define BOOM_BART_BINNED_PREDICTORS_HPP_
+/*
+  Copyright (C) 2019 Steven L. Scott
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+*/
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "LinAlg/Vector.hpp"
+
+namespace BOOM {
+  namespace Bart {
+    class ResidualRegressionData;
+
+    // A column-oriented copy of the predictors used to fit a Bart model.
+    //
+    // The MCMC moves for Bart spend most of their time deciding which side
+    // of a cutpoint each observation falls on.  Doing so through
+    // ResidualRegressionData::x() means chasing a pointer to a separately
+    // allocated Vector for each observation, and reading one double out of
+    // it.  BinnedPredictors stores each variable in its own contiguous
+    // column instead.
+    //
+    // The values of each variable are replaced by their rank among the
+    // distinct values observed for that variable (the "bin").  An
+    // observation falls to the left of a cutpoint exactly when its bin is
+    // less than number_of_bins_at_or_below(variable, cutpoint), so routing by
+    // bin reproduces the x <= cutpoint rule used by TreeNode::predict for
+    // any cutpoint, including the random cutpoints used for continuous
+    // variables.  Bins are stored in one byte per observation if the
+    // variable takes at most 255 distinct values, and in two bytes if it
+    // takes at most 65535.  Variables with more distinct values than that
+    // are stored as raw doubles, and are routed by comparing values.
+    // Missing (NaN) values are placed in a bin of their own that falls to
+    // the right of every cutpoint, matching the behavior of predict().
+    class BinnedPredictors {
+     public:
+      BinnedPredictors();
+
+      // Args:
+      //   data: The data to be binned.  Observation i is data[i]->x().
+      //     All elements of data must have predictors of the same
+      //     dimension.
+      explicit BinnedPredictors(
+          const std::vector<ResidualRegressionData *> &data);
+
+      int number_of_observations() const { return number_of_observations_; }
+      int number_of_variables() const { return columns_.size(); }
+
+      // Returns true if 'variable' is stored as bin indices, and false if
+      // it is stored as raw values.
+      bool is_binned(int variable) const;
+
+      // The number of distinct (non-NaN) values observed for 'variable'.
+      int number_of_values(int variable) const;
+
+      // The number of bins for 'variable'.  This is number_of_values(), plus
+      // one if any observations are missing.  Only meaningful if
+      // is_binned(variable).
+      int number_of_bins(int variable) const;
+
+      // The bin containing observation 'row' for 'variable'.  Only
+      // meaningful if is_binned(variable).
+      int bin(int variable, int row) const;
+
+      // The number of distinct observed values of 'variable' that are less
+      // than or equal to 'cutpoint'.  An observation with bin b falls to the
+      // left of 'cutpoint' iff b < number_of_bins_at_or_below(variable,
+      // cutpoint).
+      int number_of_bins_at_or_below(int variable, double cutpoint) const;
+
+      // Returns true if observation 'row' falls to the left of 'cutpoint',
+      // i.e. if x[variable] <= cutpoint.
+      bool goes_left(int variable, double cutpoint, int row) const;
+
+      // Rearrange the elements of [begin, end) so that those falling to the
+      // left of 'cutpoint' come first.  Each element must have a public
+      // integer member named 'row' giving its observation index.  Returns
+      // the first element that falls to the right.  The relative order of
+      // the elements is not preserved.
+      template <class ENTRY>
+      ENTRY *partition(int variable, double cutpoint, ENTRY *begin,
+                       ENTRY *end) const;
+
+     private:
+      struct Column {
+        // The sorted distinct values of the variable.
+        Vector values;
+        bool has_missing;
+        // Exactly one of the following is populated.
+        std::vector<std::uint8_t> small_bins;
+        std::vector<std::uint16_t> large_bins;
+        std::vector<double> raw_values;
+      };
+
+      // Rearrange [begin, end) so that elements with bins[row] < threshold
+      // come first.
+      template <class ENTRY, class BIN>
+      static ENTRY *partition_bins(const BIN *bins, int threshold,
+                                   ENTRY *begin, ENTRY *end);
+
+      int number_of_observations_;
+      std::vector<Column> columns_;
+    };
+
+    //----------------------------------------------------------------------
+    template <class ENTRY, class BIN>
+    ENTRY *BinnedPredictors::partition_bins(const BIN *bins, int threshold,
+                                            ENTRY *begin, ENTRY *end) {
+      while (true) {
+        while (begin != end && bins[begin->row] < threshold) {
+          ++begin;
+        }
+        if (begin == end) return begin;
+        --end;
+        while (begin != end && !(bins[end->row] < threshold)) {
+          --end;
+        }
+        if (begin == end) return begin;
+        std::swap(*begin, *end);
+        ++begin;
+      }
+    }
+
+    template <class ENTRY>
+    ENTRY *BinnedPredictors::partition(int variable, double cutpoint,
+                                       ENTRY *begin, ENTRY *end) const {
+      const Column &column(columns_[variable]);
+      if (!column.small_bins.empty()) {
+        return partition_bins(column.small_bins.data(),
+                              number_of_bins_at_or_below(variable, cutpoint),
+                              begin, end);
+      } else if (!column.large_bins.empty()) {
+        return partition_bins(column.large_bins.data(),
+                              number_of_bins_at_or_below(variable, cutpoint),
+                              begin, end);
+      }
+      const double *values = column.raw_values.data();
+      while (true) {
+        while (begin != end && values[begin->row] <= cutpoint) {
+          ++begin;
+        }
+        if (begin == end) return begin;
+        --end;
+        while (begin != end && !(values[end->row] <= cutpoint)) {
+          --end;
+        }
+        if (begin == end) return begin;
+        std::swap(*begin, *end);
+        ++begin;
+      }
+    }
+
+  }  // namespace Bart
+}  // namespace BOOM
+
+#endif  // BOOM_BART_BINNED_PREDICTORS_HPP_
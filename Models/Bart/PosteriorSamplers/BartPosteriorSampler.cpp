@@ -337,11 +337,14 @@ namespace BOOM {
     if (residual_size() != model_->sample_size()) {
       clear_residuals();
       clear_data_from_trees();
+      std::vector<Bart::ResidualRegressionData *> data;
+      data.reserve(model_->sample_size());
       for (int i = 0; i < model_->sample_size(); ++i) {
-        Bart::ResidualRegressionData *data = create_and_store_residual(i);
-        for (int j = 0; j < model_->number_of_trees(); ++j) {
-          model_->tree(j)->populate_data(data);
-        }
+        data.push_back(create_and_store_residual(i));
+      }
+      binned_predictors_.reset(new Bart::BinnedPredictors(data));
+      for (int j = 0; j < model_->number_of_trees(); ++j) {
+        model_->tree(j)->populate_data(data, binned_predictors_);
       }
       for (int i = 0; i < model_->number_of_trees(); ++i) {
         model_->tree(i)->populate_sufficient_statistics(create_suf());
@@ -351,8 +354,15 @@ namespace BOOM {
 
   //----------------------------------------------------------------------
   void BartPosteriorSamplerBase::fill_tree_with_residual_data(Tree *tree) {
-    for (int i = 0; i < residual_size(); ++i) {
-      tree->populate_data(residual(i));
+    std::vector<Bart::ResidualRegressionData *> data(residual_size());
+    for (int i = 0; i < data.size(); ++i) {
+      data[i] = residual(i);
+    }
+    if (!!binned_predictors_ &&
+        binned_predictors_->number_of_observations() == data.size()) {
+      tree->populate_data(data, binned_predictors_);
+    } else {
+      tree->populate_data(data);
     }
   }
 
@@ -759,15 +769,21 @@ namespace BOOM {
   }
 
   //----------------------------------------------------------------------
+  // If split_suf is non-NULL then it must hold the split statistics for
+  // node's data on node's variable, and node's children must be leaves.
+  // The log likelihood is then computed from split_suf without moving
+  // any data.
   class ContinuousCutpointLogLikelihood {
    public:
-    ContinuousCutpointLogLikelihood(BartPosteriorSamplerBase *sampler,
-                                    TreeNode *node, double lower_cutpoint_bound,
-                                    double upper_cutpoint_bound)
+    ContinuousCutpointLogLikelihood(
+        BartPosteriorSamplerBase *sampler, TreeNode *node,
+        double lower_cutpoint_bound, double upper_cutpoint_bound,
+        const Bart::SplitSufficientStatistics *split_suf = nullptr)
         : sampler_(sampler),
           node_(node),
           lower_cutpoint_bound_(lower_cutpoint_bound),
-          upper_cutpoint_bound_(upper_cutpoint_bound) {}
+          upper_cutpoint_bound_(upper_cutpoint_bound),
+          split_suf_(split_suf) {}
 
     double operator()(double cutpoint) {
       if (cutpoint < lower_cutpoint_bound_) {
@@ -775,6 +791,10 @@ namespace BOOM {
       } else if (cutpoint > upper_cutpoint_bound_) {
         return negative_infinity();
       }
+      if (split_suf_) {
+        return sampler_->log_integrated_likelihood(split_suf_->left(cutpoint)) +
+               sampler_->log_integrated_likelihood(split_suf_->right(cutpoint));
+      }
       node_->set_variable_and_cutpoint(node_->variable_index(), cutpoint);
       node_->refresh_subtree_data();
       return sampler_->subtree_log_integrated_likelihood(node_);
@@ -785,6 +805,7 @@ namespace BOOM {
     TreeNode *node_;
     double lower_cutpoint_bound_;
     double upper_cutpoint_bound_;
+    const Bart::SplitSufficientStatistics *split_suf_;
   };
 
   void BartPosteriorSamplerBase::slice_sample_continuous_cutpoint(
@@ -792,7 +813,11 @@ namespace BOOM {
     int variable = node->variable_index();
     const VariableSummary &variable_summary(model_->variable_summary(variable));
     Vector range = variable_summary.get_cutpoint_range(node);
-    ContinuousCutpointLogLikelihood logf(this, node, range[0], range[1]);
+    bool use_split_suf =
+        !node->is_leaf() && node->has_no_grandchildren() &&
+        split_suf_.compute(node, variable);
+    ContinuousCutpointLogLikelihood logf(this, node, range[0], range[1],
+                                         use_split_suf ? &split_suf_ : nullptr);
     ScalarSliceSampler slice(logf);
     slice.set_limits(range[0], range[1]);
     double cutpoint = slice.draw(node->cutpoint());
@@ -817,9 +842,17 @@ namespace BOOM {
 
     double logf_slice =
         subtree_log_integrated_likelihood(node) - rexp_mt(rng(), 1.0);
+
+    // If the children of node are leaves, the likelihood of each
+    // candidate cutpoint can be computed from a histogram of the node's
+    // data, and the data need only be moved once the cutpoint is chosen.
+    bool use_split_suf =
+        !node->is_leaf() && node->has_no_grandchildren() &&
+        split_suf_.compute(node, variable);
     Selector possible_cutpoint_positions(potential_cutpoint_values.size(),
                                          true);
     double logp = logf_slice - 1;
+    double cutpoint = node->cutpoint();
     while (logp < logf_slice && possible_cutpoint_positions.nvars() > 0) {
       int pos = possible_cutpoint_positions.random_included_position(rng());
       if (pos < 0) {
@@ -827,11 +860,20 @@ namespace BOOM {
             "Something went wrong when sampling cutpoints in "
             "'slice_sample_discrete_cutpoint'");
       }
-      double cutpoint = potential_cutpoint_values[pos];
+      cutpoint = potential_cutpoint_values[pos];
+      if (use_split_suf) {
+        logp = log_integrated_likelihood(split_suf_.left(cutpoint)) +
+               log_integrated_likelihood(split_suf_.right(cutpoint));
+      } else {
+        node->set_variable_and_cutpoint(variable, cutpoint);
+        node->refresh_subtree_data();
+        logp = subtree_log_integrated_likelihood(node);
+      }
+      possible_cutpoint_positions.drop(pos);
+    }
+    if (use_split_suf) {
       node->set_variable_and_cutpoint(variable, cutpoint);
       node->refresh_subtree_data();
-      logp = subtree_log_integrated_likelihood(node);
-      possible_cutpoint_positions.drop(pos);
     }
     if (logp < logf_slice && possible_cutpoint_positions.nvars() == 0) {
       report_error(
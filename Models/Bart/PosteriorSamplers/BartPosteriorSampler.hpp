@@ -331,6 +331,14 @@ namespace BOOM {
 
     MoveAccounting MH_accounting_;
 
+    // A columnar copy of the predictors, shared by all the trees, used
+    // to route the residual data through the trees.
+    std::shared_ptr<const Bart::BinnedPredictors> binned_predictors_;
+
+    // Workspace for evaluating candidate cutpoints in the slice
+    // samplers.
+    Bart::SplitSufficientStatistics split_suf_;
+
     // The vector of move_probabilities_ must be the same length as
     // the number of elements in the MoveType enum.
     Vector move_probabilities_;
@@ -19,6 +19,7 @@
 
 #include "Models/Bart/PosteriorSamplers/GaussianBartPosteriorSampler.hpp"
 #include "cpputil/math_utils.hpp"
+#include "cpputil/report_error.hpp"
 #include "distributions.hpp"
 
 namespace BOOM {
@@ -35,6 +36,18 @@ namespace BOOM {
       suf.update(*this);
     }
 
+    void GaussianBartSufficientStatistics::combine(
+        const SufficientStatisticsBase &rhs) {
+      const GaussianBartSufficientStatistics *gaussian_rhs =
+          dynamic_cast<const GaussianBartSufficientStatistics *>(&rhs);
+      if (!gaussian_rhs) {
+        report_error(
+            "GaussianBartSufficientStatistics can only be combined with "
+            "another GaussianBartSufficientStatistics.");
+      }
+      suf_.combine(gaussian_rhs->suf_);
+    }
+
   }  // namespace Bart
 
   const double GaussianBartPosteriorSampler::log_2_pi(1.83787706640935);
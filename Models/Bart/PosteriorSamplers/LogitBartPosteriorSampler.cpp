@@ -85,6 +85,25 @@ namespace BOOM {
       information_weighted_sum_of_squared_predictions_ += info * pred * pred;
     }
 
+    void LogitSufficientStatistics::combine(
+        const SufficientStatisticsBase &rhs) {
+      const LogitSufficientStatistics *logit_rhs =
+          dynamic_cast<const LogitSufficientStatistics *>(&rhs);
+      if (!logit_rhs) {
+        report_error(
+            "LogitSufficientStatistics can only be combined with another "
+            "LogitSufficientStatistics.");
+      }
+      sum_of_information_ += logit_rhs->sum_of_information_;
+      information_weighted_sum_ += logit_rhs->information_weighted_sum_;
+      information_weighted_prediction_ +=
+          logit_rhs->information_weighted_prediction_;
+      information_weighted_sum_of_observation_times_prediction_ +=
+          logit_rhs->information_weighted_sum_of_observation_times_prediction_;
+      information_weighted_sum_of_squared_predictions_ +=
+          logit_rhs->information_weighted_sum_of_squared_predictions_;
+    }
+
     double LogitSufficientStatistics::sum_of_information() const {
       return sum_of_information_;
     }
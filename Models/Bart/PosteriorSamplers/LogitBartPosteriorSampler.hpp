@@ -99,6 +99,7 @@ namespace BOOM {
       void clear() override;
       void update(const ResidualRegressionData &abstract_data) override;
       virtual void update(const LogitResidualData &data);
+      void combine(const SufficientStatisticsBase &rhs) override;
 
       double sum_of_information() const;
       double information_weighted_sum() const;
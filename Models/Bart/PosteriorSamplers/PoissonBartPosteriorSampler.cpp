@@ -20,6 +20,7 @@
 #include "Models/Bart/PosteriorSamplers/PoissonBartPosteriorSampler.hpp"
 #include "Models/Glm/PosteriorSamplers/poisson_mixture_approximation_table.hpp"
 #include "cpputil/math_utils.hpp"
+#include "cpputil/report_error.hpp"
 #include "distributions.hpp"
 
 namespace BOOM {
@@ -121,6 +122,22 @@ namespace BOOM {
         weighted_sum_of_squared_residuals_ += weight * square(residual);
       }
     }
+
+    //----------------------------------------------------------------------
+    void PoissonSufficientStatistics::combine(
+        const SufficientStatisticsBase &rhs) {
+      const PoissonSufficientStatistics *poisson_rhs =
+          dynamic_cast<const PoissonSufficientStatistics *>(&rhs);
+      if (!poisson_rhs) {
+        report_error(
+            "PoissonSufficientStatistics can only be combined with another "
+            "PoissonSufficientStatistics.");
+      }
+      sum_of_weights_ += poisson_rhs->sum_of_weights_;
+      weighted_sum_of_residuals_ += poisson_rhs->weighted_sum_of_residuals_;
+      weighted_sum_of_squared_residuals_ +=
+          poisson_rhs->weighted_sum_of_squared_residuals_;
+    }
   }  // namespace Bart
 
   //======================================================================
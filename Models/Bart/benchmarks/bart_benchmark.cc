@@ -0,0 +1,67 @@
+/*
+  Copyright (C) 2019 Steven L. Scott
+
+  This library is free software; you can redistribute it and/or modify it under
+  the terms of the GNU Lesser General Public License as published by the Free
+  Software Foundation; either version 2.1 of the License, or (at your option)
+  any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT
+  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+  FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+  details.
+
+  You should have received a copy of the GNU Lesser General Public License along
+  with this library; if not, write to the Free Software Foundation, Inc., 51
+  Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+*/
+
+// Timings for one MCMC iteration of a Gaussian BART model, which visits every
+// tree with a birth/death/swap/change move and then redraws the leaf means.
+// The first benchmark argument is the sample size, and the second is the
+// number of trees.  The data and the sampler's RNG use fixed seeds, so the
+// sequence of trees visited is the same from run to run.
+
+#include "benchmark/benchmark.h"
+#include "distributions.hpp"
+#include "Models/Bart/GaussianBartModel.hpp"
+#include "Models/Bart/PosteriorSamplers/GaussianBartPosteriorSampler.hpp"
+#include "stats/moments.hpp"
+
+namespace {
+  using namespace BOOM;
+
+  void BM_GaussianBartDraw(benchmark::State &state) {
+    GlobalRng::rng.seed(8675309);
+    int sample_size = state.range(0);
+    int number_of_trees = state.range(1);
+    int xdim = 10;
+    Matrix X(sample_size, xdim);
+    X.randomize();
+    Vector y(sample_size);
+    for (int i = 0; i < sample_size; ++i) {
+      double mu = X(i, 0) > .5 ? 3.0 : -1.0;
+      mu += 2 * X(i, 1) * X(i, 2);
+      y[i] = mu + rnorm(0, 1);
+    }
+
+    NEW(GaussianBartModel, model)(number_of_trees, y, X);
+    model->finalize_data();
+    RNG seeding_rng(12345);
+    NEW(GaussianBartPosteriorSampler, sampler)(
+        model.get(), sd(y), 3.0, 2.0, .95, 2.0,
+        PointMassPrior(number_of_trees), seeding_rng);
+    model->set_method(sampler);
+    for (auto _ : state) {
+      sampler->draw();
+      benchmark::DoNotOptimize(model->sigsq());
+    }
+  }
+
+  BENCHMARK(BM_GaussianBartDraw)
+      ->ArgsProduct({{1000, 10000}, {50, 200}})
+      ->Unit(benchmark::kMillisecond);
+
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,165 @@
+#include "gtest/gtest.h"
+#include "Models/Bart/Bart.hpp"
+#include "Models/Bart/BinnedPredictors.hpp"
+#include "Models/Bart/PosteriorSamplers/GaussianBartPosteriorSampler.hpp"
+#include "Models/Glm/Glm.hpp"
+#include "distributions.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "test_utils/test_utils.hpp"
+
+namespace {
+  using namespace BOOM;
+  using namespace BOOM::Bart;
+  using std::endl;
+
+  class BinnedPredictorsTest : public ::testing::Test {
+   protected:
+    // Variable 0 is discrete with 10 values.  Variable 1 is continuous, with
+    // more than 255 distinct values, so it is stored in 16 bit bins.
+    // Variable 2 is discrete with some missing values.
+    BinnedPredictorsTest() : nobs_(600), xdim_(3) {
+      GlobalRng::rng.seed(8675309);
+      for (int i = 0; i < nobs_; ++i) {
+        Vector x(xdim_);
+        x[0] = random_int(0, 9);
+        x[1] = rnorm();
+        x[2] = runif() < .1 ? std::nan("") : random_int(0, 4) * .5;
+        NEW(RegressionData, data_point)(rnorm(), x);
+        raw_data_.push_back(data_point);
+        residual_data_.emplace_back(
+            new GaussianResidualRegressionData(data_point, 0.0));
+        data_.push_back(residual_data_.back().get());
+      }
+      predictors_.reset(new BinnedPredictors(data_));
+    }
+
+    // A finalized summary of the observed values of 'variable'.
+    VariableSummary summarize(int variable) const {
+      VariableSummary summary(variable);
+      for (int i = 0; i < nobs_; ++i) {
+        double value = raw_data_[i]->x()[variable];
+        if (!std::isnan(value)) summary.observe_value(value);
+      }
+      summary.finalize();
+      return summary;
+    }
+
+    // Cutpoints to check for 'variable', as seen from 'node'.  Discrete
+    // variables check every available cutpoint.  Continuous variables check
+    // every observed value in range, along with some random cutpoints.
+    Vector cutpoints(const VariableSummary &summary, const TreeNode *node,
+                     int variable) const {
+      Vector range = summary.get_cutpoint_range(node);
+      if (!summary.is_continuous()) return range;
+      Vector ans;
+      for (int i = 0; i < nobs_; ++i) {
+        double value = raw_data_[i]->x()[variable];
+        if (value >= range[0] && value <= range[1]) ans.push_back(value);
+      }
+      for (int i = 0; i < 20; ++i) {
+        ans.push_back(runif(range[0], range[1]));
+      }
+      return ans;
+    }
+
+    int nobs_;
+    int xdim_;
+    std::vector<Ptr<RegressionData>> raw_data_;
+    std::vector<std::unique_ptr<GaussianResidualRegressionData>>
+        residual_data_;
+    std::vector<ResidualRegressionData *> data_;
+    std::shared_ptr<BinnedPredictors> predictors_;
+  };
+
+  // Routing by bin must reproduce the x <= cutpoint rule for every cutpoint
+  // the VariableSummary can produce.
+  TEST_F(BinnedPredictorsTest, QuantizationMatchesCutpoints) {
+    EXPECT_EQ(nobs_, predictors_->number_of_observations());
+    EXPECT_EQ(xdim_, predictors_->number_of_variables());
+    TreeNode root;
+    for (int v = 0; v < xdim_; ++v) {
+      EXPECT_TRUE(predictors_->is_binned(v));
+      VariableSummary summary = summarize(v);
+      EXPECT_EQ(v == 1, summary.is_continuous());
+
+      std::vector<double> distinct;
+      bool has_missing = false;
+      for (int i = 0; i < nobs_; ++i) {
+        double value = raw_data_[i]->x()[v];
+        if (std::isnan(value)) {
+          has_missing = true;
+        } else {
+          distinct.push_back(value);
+        }
+      }
+      std::sort(distinct.begin(), distinct.end());
+      distinct.erase(std::unique(distinct.begin(), distinct.end()),
+                     distinct.end());
+      EXPECT_EQ(distinct.size(), predictors_->number_of_values(v));
+      EXPECT_EQ(distinct.size() + has_missing, predictors_->number_of_bins(v));
+
+      for (double cutpoint : cutpoints(summary, &root, v)) {
+        int threshold = predictors_->number_of_bins_at_or_below(v, cutpoint);
+        int expected_threshold = 0;
+        for (double value : distinct) expected_threshold += value <= cutpoint;
+        EXPECT_EQ(expected_threshold, threshold)
+            << "variable " << v << " cutpoint " << cutpoint;
+        for (int i = 0; i < nobs_; ++i) {
+          bool goes_left = raw_data_[i]->x()[v] <= cutpoint;
+          EXPECT_EQ(goes_left, predictors_->goes_left(v, cutpoint, i));
+          EXPECT_EQ(goes_left, predictors_->bin(v, i) < threshold);
+        }
+      }
+    }
+  }
+
+  // The statistics for every cutpoint must match those found by re-routing
+  // the node's data.
+  TEST_F(BinnedPredictorsTest, SplitStatisticsMatchBruteForce) {
+    std::shared_ptr<TreeData> tree_data(new TreeData(data_, predictors_));
+    TreeNode root;
+    root.set_variable_and_cutpoint(1, 0.3);
+    root.grow();
+    root.populate_sufficient_statistics(new GaussianBartSufficientStatistics);
+    root.populate_data(tree_data, 0, nobs_);
+
+    SplitSufficientStatistics split_suf;
+    for (const TreeNode *node : {root.left_child(), root.right_child()}) {
+      EXPECT_GT(node->sample_size(), 0);
+      for (int v = 0; v < xdim_; ++v) {
+        ASSERT_TRUE(split_suf.compute(node, v));
+        VariableSummary summary = summarize(v);
+        for (double cutpoint : cutpoints(summary, node, v)) {
+          GaussianBartSufficientStatistics left, right;
+          for (const TreeData::Entry *it = node->data_begin();
+               it != node->data_end(); ++it) {
+            if (it->data->x()[v] <= cutpoint) {
+              left.update(*it->data);
+            } else {
+              right.update(*it->data);
+            }
+          }
+          const GaussianBartSufficientStatistics &fast_left(
+              dynamic_cast<const GaussianBartSufficientStatistics &>(
+                  split_suf.left(cutpoint)));
+          const GaussianBartSufficientStatistics &fast_right(
+              dynamic_cast<const GaussianBartSufficientStatistics &>(
+                  split_suf.right(cutpoint)));
+          EXPECT_DOUBLE_EQ(left.n(), fast_left.n())
+              << "variable " << v << " cutpoint " << cutpoint;
+          EXPECT_NEAR(left.sum(), fast_left.sum(), 1e-8);
+          EXPECT_NEAR(left.sumsq(), fast_left.sumsq(), 1e-8);
+          EXPECT_DOUBLE_EQ(right.n(), fast_right.n());
+          EXPECT_NEAR(right.sum(), fast_right.sum(), 1e-8);
+          EXPECT_NEAR(right.sumsq(), fast_right.sumsq(), 1e-8);
+        }
+      }
+    }
+  }
+
+}  // namespace
@@ -46,7 +46,12 @@ namespace BOOM {
   }
 
   Data::missing_status Data::missing() const { return missing_flag; }
-  void Data::set_missing_status(missing_status m) { missing_flag = m; }
+  void Data::set_missing_status(missing_status m) {
+    if (m != missing_flag) {
+      missing_flag = m;
+      signal();
+    }
+  }
 
   //------------------------------------------------------------
   VectorData::VectorData(uint n, double X) : data_(n, X) {}
@@ -35,6 +35,7 @@
 #include "LinAlg/Vector.hpp"
 #include "LinAlg/Selector.hpp"
 
+#include <cstdint>
 #include <functional>
 #include "cpputil/Ptr.hpp"
 #include "cpputil/RefCounted.hpp"
@@ -50,10 +51,11 @@ namespace BOOM {
 
     enum missing_status { observed = 0, completely_missing, partly_missing };
 
-    Data() : missing_flag(observed) {}
+    Data() : missing_flag(observed), version_(0) {}
     // When copying Data, the observers should not be copied.
     Data(const Data &rhs)
         : missing_flag(rhs.missing_flag),
+          version_(0),
           signals_() {}
     virtual Data *clone() const = 0;
     virtual ~Data() {signals_.clear();}
@@ -61,10 +63,17 @@ namespace BOOM {
     missing_status missing() const;
     void set_missing_status(missing_status m);
     void signal() {
+      ++version_;
       for (auto &it : signals_) {
         it.second();
       }
     }
+
+    // A counter that is incremented each time the data signals a change in
+    // its value (or missing status).  Objects caching information derived
+    // from the data can compare the version with the one they recorded to
+    // tell whether the cache is stale.
+    std::uint64_t version() const { return version_; }
     // TODO: This implementation of the observer pattern is broken by
     // assignment.  When an object is created from an old object by assignment,
     // it should eliminate any observers it has placed on other objects.  This
@@ -88,6 +97,7 @@ namespace BOOM {
 
    private:
     missing_status missing_flag;
+    std::uint64_t version_;
     std::multimap<void *, std::function<void(void)>>  signals_;
   };
   //======================================================================
@@ -18,9 +18,12 @@
 */
 
 #include "Models/FiniteMixtureModel.hpp"
+#include "cpputil/ThreadTools.hpp"
 #include "cpputil/lse.hpp"
 #include "distributions.hpp"
 
+#include <algorithm>
+#include <cstdint>
 #include <functional>
 #include <stdexcept>
 
@@ -58,7 +61,8 @@ namespace BOOM {
         ParamPolicy(rhs),
         DataPolicy(rhs),
         mixture_components_(rhs.mixture_components_),
-        mixing_dist_(rhs.mixing_dist_->clone()) {
+        mixing_dist_(rhs.mixing_dist_->clone()),
+        number_of_threads_(rhs.number_of_threads_) {
     uint S = number_of_mixture_components();
     for (uint s = 0; s < S; ++s) {
       mixture_components_[s] = rhs.mixture_components_[s]->clone();
@@ -77,45 +81,123 @@ namespace BOOM {
   }
 
   void FMM::impute_latent_data(RNG &rng) {
-    const std::vector<Ptr<Data> > &d(dat());
-    std::vector<Ptr<CategoricalData> > hvec(latent_data());
+    const std::vector<Ptr<Data>> &d(dat());
+    set_logpi();
+    clear_component_data();
+    fill_log_densities(class_membership_probabilities_);
+    if (number_of_threads_ > 1) {
+      impute_latent_data_with_threads(rng);
+      return;
+    }
 
-    uint n = d.size();
-    uint S = number_of_mixture_components();
-    class_membership_probabilities_.resize(n, S);
+    std::vector<Ptr<CategoricalData>> &hvec(latent_data());
+    last_loglike_ = 0;
+    for (int i = 0; i < d.size(); ++i) {
+      int h = impute_class_membership(i, rng, last_loglike_);
+      hvec[i]->set(h);
+      mixture_components_[h]->add_data(d[i]);
+      mixing_dist_->add_data(hvec[i]);
+    }
+  }
 
-    wsp_.resize(S);
-    set_logpi();
+  void FMM::impute_latent_data_with_threads(RNG &rng) {
+    const std::vector<Ptr<Data>> &d(dat());
+    std::vector<Ptr<CategoricalData>> &hvec(latent_data());
+    if (workspaces_.size() != number_of_threads_) {
+      build_imputation_workspaces();
+    }
+    std::int64_t n = d.size();
+    int number_of_blocks = workspaces_.size();
+    RNG::RngIntType key = rng.random_bits();
+    WorkStealingThreadPool::global().parallel_for(
+        0, number_of_blocks, 1, [&](int block) {
+          ImputationWorkspace &workspace(workspaces_[block]);
+          workspace.loglike = 0;
+          RNG observation_rng(key, RNG::PHILOX);
+          int begin = block * n / number_of_blocks;
+          int end = (block + 1) * n / number_of_blocks;
+          for (int i = begin; i < end; ++i) {
+            observation_rng.jump(i);
+            int h = impute_class_membership(i, observation_rng,
+                                            workspace.loglike);
+            hvec[i]->set(h);
+            workspace.mixture_components[h]->add_data(d[i]);
+            workspace.mixing_distribution->add_data(hvec[i]);
+          }
+        });
+
+    // Blocks are combined in order, so each component sees its data in the
+    // same order as in sequential imputation.
     last_loglike_ = 0;
-    const std::vector<Ptr<MixtureComponent> > &mod(mixture_components_);
-    Ptr<MultinomialModel> mix(mixing_dist_);
-    clear_component_data();
-    for (uint i = 0; i < n; ++i) {
-      Ptr<Data> dp = d[i];
-      Ptr<CategoricalData> cd = hvec[i];
-      if (dp->missing() != 0u) {
-        wsp_ = logpi_;
-      } else if (which_mixture_component(i) > 0) {
-        int source = which_mixture_component(i);
-        last_loglike_ += mod[source]->pdf(dp.get(), true);
-        class_membership_probabilities_.row(i) = 0;
-        class_membership_probabilities_(i, source) = 1.0;
-        cd->set(source);
-        mix->add_data(cd);
-        mod[source]->add_data(dp);
-        continue;
-      } else {
-        for (uint s = 0; s < S; ++s) {
-          wsp_[s] = logpi_[s] + mod[s]->pdf(dp.get(), true);
-        }
+    int S = number_of_mixture_components();
+    for (auto &workspace : workspaces_) {
+      last_loglike_ += workspace.loglike;
+      for (int s = 0; s < S; ++s) {
+        mixture_components_[s]->combine_data(
+            *workspace.mixture_components[s], false);
+        workspace.mixture_components[s]->clear_data();
       }
-      last_loglike_ += lse(wsp_);
-      wsp_.normalize_logprob();
-      class_membership_probabilities_.row(i) = wsp_;
-      uint h = rmulti_mt(rng, wsp_);
-      cd->set(h);
-      mod[h]->add_data(dp);
-      mix->add_data(cd);
+      mixing_dist_->combine_data(*workspace.mixing_distribution, false);
+      workspace.mixing_distribution->clear_data();
+    }
+  }
+
+  void FMM::fill_log_densities(Matrix &ans) const {
+    const std::vector<Ptr<Data>> &d(dat());
+    int S = number_of_mixture_components();
+    ans.resize(d.size(), S);
+    auto fill_column = [this, &d, &ans](int s) {
+      mixture_components_[s]->batch_logp(d, 0, ans.col(s));
+    };
+    // Each component is handled by a single thread, because batch_logp may
+    // refresh cached functions of the component's parameters.
+    if (number_of_threads_ > 1) {
+      WorkStealingThreadPool::global().parallel_for(0, S, 1, fill_column);
+    } else {
+      for (int s = 0; s < S; ++s) {
+        fill_column(s);
+      }
+    }
+  }
+
+  int FMM::impute_class_membership(int i, RNG &rng, double &loglike) {
+    VectorView probs(class_membership_probabilities_.row(i));
+    int source = which_mixture_component(i);
+    if (source > 0 && dat()[i]->missing() == Data::observed) {
+      loglike += probs[source];
+      probs = 0.0;
+      probs[source] = 1.0;
+      return source;
+    }
+    // Missing observations have log density 0 under every component, so
+    // their class membership probabilities are the mixing weights.
+    probs += logpi_;
+    double max_logprob = probs.max();
+    loglike += max_logprob + log(probs.normalize_logprob());
+    return rmulti_mt(rng, probs);
+  }
+
+  void FMM::set_number_of_threads(int n) {
+    number_of_threads_ = std::max(n, 0);
+    if (number_of_threads_ > 1) {
+      WorkStealingThreadPool::global().set_minimum_number_of_threads(
+          number_of_threads_);
+    }
+    workspaces_.clear();
+  }
+
+  void FMM::build_imputation_workspaces() {
+    workspaces_.clear();
+    workspaces_.resize(number_of_threads_);
+    for (auto &workspace : workspaces_) {
+      for (const auto &component : mixture_components_) {
+        Ptr<MixtureComponent> clone = component->clone();
+        clone->clear_data();
+        workspace.mixture_components.push_back(clone);
+      }
+      workspace.mixing_distribution = mixing_dist_->clone();
+      workspace.mixing_distribution->clear_data();
+      workspace.loglike = 0;
     }
   }
 
@@ -294,28 +376,28 @@ namespace BOOM {
 
   double EmFiniteMixtureModel::EStep() {
     clear_component_data();
-    Vector &wsp(wsp_);
-    wsp.resize(number_of_mixture_components());
-    const std::vector<Ptr<Data> > &data(dat());
+    const std::vector<Ptr<Data>> &data(dat());
+    int S = number_of_mixture_components();
+    Matrix probs;
+    fill_log_densities(probs);
     double ans = 0;
     const Vector &log_pi(logpi());
+    Vector &wsp(wsp_);
     for (int i = 0; i < data.size(); ++i) {
-      for (int s = 0; s < number_of_mixture_components(); ++s) {
-        wsp[s] = log_pi[s] + mixture_component(s)->pdf(data[i].get(), true);
-      }
+      wsp = probs.row(i);
+      wsp += log_pi;
       double total = lse(wsp);
       ans += total;
       double normalizing_constant = 0;
-      for (int s = 0; s < number_of_mixture_components(); ++s) {
+      for (int s = 0; s < S; ++s) {
         wsp[s] = exp(wsp[s] - total);
         normalizing_constant += wsp[s];
       }
-      for (int s = 0; s < number_of_mixture_components(); ++s) {
-        em_mixture_components_[s]->add_mixture_data(
-            data[i], wsp[s] / normalizing_constant);
+      wsp /= normalizing_constant;
+      for (int s = 0; s < S; ++s) {
+        em_mixture_components_[s]->add_mixture_data(data[i], wsp[s]);
       }
-      mixing_distribution()->suf()->add_mixture_data(wsp /
-                                                     normalizing_constant);
+      mixing_distribution()->suf()->add_mixture_data(wsp);
     }
     return ans;
   }
@@ -52,7 +52,30 @@ namespace BOOM {
     // Clear data from mixture components and the mixing distribution.
     void clear_component_data();
 
+    // Draw the latent class of each observation given the current
+    // parameters, and assign each observation to its mixture component.
+    //
+    // The log densities of all observations are computed by each mixture
+    // component's batch_logp(), and stored in the class membership
+    // probability table, which is then normalized in place.  If threads have
+    // been requested, the components evaluate their densities in parallel,
+    // and class memberships are drawn in parallel over blocks of
+    // observations.  Each block accumulates complete data for the mixture
+    // components in a private workspace, and the workspaces are combined with
+    // the model at the end.
     void impute_latent_data(RNG &rng) override;
+
+    // Set the number of threads used by impute_latent_data().  If n <= 1 the
+    // latent data are imputed sequentially in the calling thread.  Otherwise
+    // the global thread pool is grown (if needed) to at least n threads.
+    //
+    // In threaded mode each observation draws its class from its own random
+    // number stream, keyed by a value drawn from the RNG passed to
+    // impute_latent_data().  The imputed classes thus do not depend on the
+    // number of threads, though they differ from those drawn in sequential
+    // mode.
+    void set_number_of_threads(int n);
+    int number_of_threads() const { return number_of_threads_; }
     void class_membership_probability(const Ptr<Data> &, Vector &ans) const;
     int impute_observation(const Ptr<Data> &data, RNG &rng) const;
     int impute_observation(const Ptr<Data> &data, RNG &rng,
@@ -88,7 +111,30 @@ namespace BOOM {
     // Save the class membership probabilities for user i.
     void update_class_membership_probabilities(int i, const Vector &probs);
 
+    // Fill ans(i, s) with the log density of observation i under mixture
+    // component s.  Missing observations get 0.  The components are
+    // evaluated in parallel if threads have been requested.
+    void fill_log_densities(Matrix &ans) const;
+
    private:
+    // Complete data accumulated by one block of observations during threaded
+    // imputation.  The models are clones of the mixture components and the
+    // mixing distribution, used only to hold data and sufficient statistics.
+    struct ImputationWorkspace {
+      std::vector<Ptr<MixtureComponent>> mixture_components;
+      Ptr<MultinomialModel> mixing_distribution;
+      double loglike;
+    };
+
+    // Convert row i of the class membership probability table from log
+    // densities to class membership probabilities, and draw the class of
+    // observation i.  The contribution of observation i to the log
+    // likelihood is added to 'loglike'.
+    int impute_class_membership(int i, RNG &rng, double &loglike);
+
+    void impute_latent_data_with_threads(RNG &rng);
+    void build_imputation_workspaces();
+
     std::vector<Ptr<MixtureComponent>> mixture_components_;
     Ptr<MultinomialModel> mixing_dist_;
     mutable Vector logpi_;
@@ -100,6 +146,9 @@ namespace BOOM {
     double last_loglike_;
     Matrix class_membership_probabilities_;
     std::vector<int> which_mixture_component_;
+
+    int number_of_threads_ = 0;
+    std::vector<ImputationWorkspace> workspaces_;
   };
   //----------------------------------------------------------------------
   template <class FwdIt>
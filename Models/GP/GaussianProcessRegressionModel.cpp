@@ -18,8 +18,12 @@
 
 #include "Models/GP/GaussianProcessRegressionModel.hpp"
 #include "cpputil/report_error.hpp"
+#include "cpputil/Constants.hpp"
+#include "LinAlg/Cholesky.hpp"
 #include "distributions.hpp"
 
+#include <sstream>
+
 namespace BOOM {
 
   GaussianProcessRegressionModel::GaussianProcessRegressionModel(
@@ -27,7 +31,10 @@ namespace BOOM {
       const Ptr<KernelParams> &kernel,
       const Ptr<UnivParams> &sigsq)
       : ParamPolicy(mean_function, kernel, sigsq),
-        kernel_matrix_current_(false)
+        kernel_matrix_current_(false),
+        inducing_point_method_(FITC),
+        sparse_logdet_(0.0),
+        trace_penalty_(0.0)
   {
     add_observers();
   }
@@ -35,22 +42,132 @@ namespace BOOM {
   GaussianProcessRegressionModel::GaussianProcessRegressionModel(
       const GaussianProcessRegressionModel &rhs)
       : Model(rhs),
-        ParamPolicy(Ptr<FunctionParams>(mean_param()->clone()),
-                    Ptr<KernelParams>(kernel_param()->clone()),
-                    Ptr<UnivParams>(sigsq_param()->clone())),
+        ParamPolicy(Ptr<FunctionParams>(rhs.mean_param()->clone()),
+                    Ptr<KernelParams>(rhs.kernel_param()->clone()),
+                    Ptr<UnivParams>(rhs.sigsq_param()->clone())),
         DataPolicy(rhs),
-        PriorPolicy(rhs)
+        PriorPolicy(rhs),
+        kernel_matrix_current_(false),
+        inducing_points_(rhs.inducing_points_),
+        inducing_point_method_(rhs.inducing_point_method_),
+        sparse_logdet_(0.0),
+        trace_penalty_(0.0)
   {
     add_observers();
+    for (const auto &data_point : dat()) {
+      observe_data(data_point);
+    }
   }
 
+  GaussianProcessRegressionModel::~GaussianProcessRegressionModel() {
+    for (const auto &data_point : dat()) {
+      data_point->remove_observer(this);
+    }
+  }
 
   GaussianProcessRegressionModel * GaussianProcessRegressionModel::clone() const {
     return new GaussianProcessRegressionModel(*this);
   }
 
+  const SpdMatrix &GaussianProcessRegressionModel::inverse_kernel_matrix() const {
+    refresh_kernel_matrix();
+    if (uses_inducing_points()) {
+      Kinv_ = SpdMatrix(inverse_kernel_matrix_times(
+          SpdMatrix(sample_size(), 1.0)));
+    }
+    return Kinv_;
+  }
+
+  Matrix GaussianProcessRegressionModel::inverse_kernel_matrix_times(
+      const Matrix &A) const {
+    refresh_kernel_matrix();
+    if (A.nrow() != sample_size()) {
+      report_error("Wrong number of rows in inverse_kernel_matrix_times.");
+    }
+    if (!uses_inducing_points()) {
+      return Kinv_ * A;
+    }
+    // (V'V + Lambda)^{-1} = Lambda^{-1} - Lambda^{-1} V' B^{-1} V Lambda^{-1},
+    // where B = I + V Lambda^{-1} V'.
+    Matrix ans = A;
+    for (int i = 0; i < ans.nrow(); ++i) {
+      ans.row(i) *= inverse_diagonal_[i];
+    }
+    Matrix inner = scaled_cross_kernel_ * ans;
+    Lsolve_inplace(inner_cholesky_, inner);
+    LTsolve_inplace(inner_cholesky_, inner);
+    ans = A - scaled_cross_kernel_.Tmult(inner);
+    for (int i = 0; i < ans.nrow(); ++i) {
+      ans.row(i) *= inverse_diagonal_[i];
+    }
+    return ans;
+  }
+
+  Vector GaussianProcessRegressionModel::inverse_kernel_matrix_times(
+      const Vector &v) const {
+    refresh_kernel_matrix();
+    if (v.size() != sample_size()) {
+      report_error("Wrong sized argument to inverse_kernel_matrix_times.");
+    }
+    if (!uses_inducing_points()) {
+      return Kinv_ * v;
+    }
+    Vector inner = scaled_cross_kernel_ * (inverse_diagonal_ * v);
+    inner = Lsolve(inner_cholesky_, inner);
+    LTsolve_inplace(inner_cholesky_, inner);
+    return inverse_diagonal_ * (v - scaled_cross_kernel_.Tmult(inner));
+  }
+
+  void GaussianProcessRegressionModel::set_inducing_points(
+      const Matrix &inducing_points, InducingPointMethod method) {
+    if (inducing_points.nrow() == 0) {
+      clear_inducing_points();
+      return;
+    }
+    if (!dat().empty() && inducing_points.ncol() != xdim()) {
+      std::ostringstream err;
+      err << "The inducing points have " << inducing_points.ncol()
+          << " columns, but the predictors have dimension " << xdim()
+          << ".";
+      report_error(err.str());
+    }
+    inducing_points_ = inducing_points;
+    inducing_point_method_ = method;
+    kernel_matrix_current_ = false;
+  }
+
+  void GaussianProcessRegressionModel::clear_inducing_points() {
+    inducing_points_ = Matrix();
+    scaled_cross_kernel_ = Matrix();
+    kernel_matrix_current_ = false;
+  }
+
+  void GaussianProcessRegressionModel::add_data(
+      const Ptr<RegressionData> &data_point) {
+    kernel_matrix_current_ = false;
+    DataPolicy::add_data(data_point);
+    observe_data(data_point);
+  }
+
+  void GaussianProcessRegressionModel::clear_data() {
+    for (const auto &data_point : dat()) {
+      data_point->remove_observer(this);
+    }
+    DataPolicy::clear_data();
+    kernel_matrix_current_ = false;
+  }
+
+  void GaussianProcessRegressionModel::observe_data(
+      const Ptr<RegressionData> &data_point) {
+    data_point->add_observer(
+        this, [this]() {this->kernel_matrix_current_ = false;});
+  }
+
   double GaussianProcessRegressionModel::predict(const Vector &x) const {
     refresh_kernel_matrix();
+    if (uses_inducing_points()) {
+      return mean_function(x) + inducing_kernel(x).dot(inducing_weights_);
+    }
 
     // The vector of kernel values of the new x against the training data.
     const std::vector<Ptr<RegressionData>> & data(dat());
@@ -60,7 +177,7 @@ namespace BOOM {
       Kstrip(i) = kernel(x, data[i]->x());
     }
 
-    return mean_function(x) + Kstrip.dot(Kinv_ * residuals_);
+    return mean_function(x) + Kstrip.dot(weights_);
   }
 
   Ptr<MvnBase> GaussianProcessRegressionModel::predict_distribution(
@@ -71,7 +188,6 @@ namespace BOOM {
     int nobs = data.size();
     int nx = X.nrow();
 
-    Matrix Kstrip(nobs, nx);
     Vector yhat(nx);
 
     SpdMatrix base_variance(nx);
@@ -87,16 +203,33 @@ namespace BOOM {
       }
     }
 
-    for (int j = 0; j < nx; ++j) {
-      for (int i = 0; i < nobs; ++i) {
-        Kstrip(i, j) = kernel(data[i]->x(), X.row(j));
+    Vector mean;
+    SpdMatrix variance;
+    if (uses_inducing_points()) {
+      // With V1 = Luu^{-1} K(Z, X) and V2 = L_B^{-1} V1, the predictive
+      // variance of the function values is K(X, X) - V1'V1 + V2'V2.
+      int m = inducing_points_.nrow();
+      Matrix cross_kernel(m, nx);
+      for (int j = 0; j < nx; ++j) {
+        cross_kernel.col(j) = inducing_kernel(X.row(j));
+      }
+      mean = yhat + cross_kernel.Tmult(inducing_weights_);
+      Lsolve_inplace(inducing_cholesky_, cross_kernel);
+      variance = base_variance;
+      variance.add_inner(cross_kernel, -1.0);
+      Lsolve_inplace(inner_cholesky_, cross_kernel);
+      variance.add_inner(cross_kernel, 1.0);
+    } else {
+      Matrix Kstrip(nobs, nx);
+      for (int j = 0; j < nx; ++j) {
+        for (int i = 0; i < nobs; ++i) {
+          Kstrip(i, j) = kernel(data[i]->x(), X.row(j));
+        }
       }
+      mean = yhat + Kstrip.Tmult(weights_);
+      variance = base_variance - sandwich_transpose(Kstrip, Kinv_);
     }
 
-    Vector mean = yhat + Kstrip.Tmult(Kinv_ * residuals_);
-    SpdMatrix variance = base_variance + Kstrip.Tmult(
-        inverse_kernel_matrix() * Kstrip);
-
     if (predict_data) {
       return new MvnModel(mean, variance);
     } else {
@@ -139,6 +272,11 @@ namespace BOOM {
     size_t sample_size = data.size();
 
     refresh_kernel_matrix();
+    if (uses_inducing_points()) {
+      return -0.5 * (sample_size * Constants::log_2pi + sparse_logdet_
+                     + residuals_.dot(weights_) + trace_penalty_);
+    }
+
     Vector mu(sample_size);
     Vector y(sample_size);
     for (size_t i = 0; i < sample_size; ++i) {
@@ -152,6 +290,11 @@ namespace BOOM {
     if (kernel_matrix_current_) {
       return;
     }
+    if (uses_inducing_points()) {
+      refresh_sparse_kernel_matrix();
+      kernel_matrix_current_ = true;
+      return;
+    }
 
     const std::vector<Ptr<RegressionData>> & data(dat());
     int nobs = data.size();
@@ -172,7 +315,91 @@ namespace BOOM {
     Kfunc_ = K;
     K.diag() += residual_variance();
     Kinv_ = K.inv();
+    weights_ = Kinv_ * residuals_;
     kernel_matrix_current_ = true;
   }
 
+  // Write the approximate kernel matrix as V'V + Lambda, where V = Luu^{-1}
+  // K(Z, X), and Luu is the Cholesky factor of K(Z, Z).  All the required
+  // solves go through B = I + V Lambda^{-1} V', which is m x m and well
+  // conditioned.
+  void GaussianProcessRegressionModel::refresh_sparse_kernel_matrix() const {
+    const std::vector<Ptr<RegressionData>> & data(dat());
+    int nobs = data.size();
+    int m = inducing_points_.nrow();
+
+    SpdMatrix inducing_kernel_matrix(m);
+    for (int i = 0; i < m; ++i) {
+      for (int j = 0; j <= i; ++j) {
+        inducing_kernel_matrix(i, j) = kernel(
+            inducing_points_.row(i), inducing_points_.row(j));
+        inducing_kernel_matrix(j, i) = inducing_kernel_matrix(i, j);
+      }
+    }
+    // A small amount of jitter keeps the factorization stable when inducing
+    // points are close together.
+    inducing_kernel_matrix.diag() +=
+        1e-8 * (1.0 + inducing_kernel_matrix.diag().sum() / m);
+    Cholesky inducing_chol(inducing_kernel_matrix);
+    if (!inducing_chol.is_pos_def()) {
+      report_error("The kernel matrix of the inducing points is not "
+                   "positive definite.");
+    }
+    inducing_cholesky_ = inducing_chol.getL(false);
+
+    residuals_.resize(nobs);
+    scaled_cross_kernel_.resize(m, nobs);
+    for (int j = 0; j < nobs; ++j) {
+      residuals_[j] = data[j]->y() - mean_function(data[j]->x());
+      scaled_cross_kernel_.col(j) = inducing_kernel(data[j]->x());
+    }
+    Lsolve_inplace(inducing_cholesky_, scaled_cross_kernel_);
+
+    double sigsq = residual_variance();
+    inverse_diagonal_.resize(nobs);
+    Matrix scaled_V = scaled_cross_kernel_;
+    double trace = 0;
+    sparse_logdet_ = 0;
+    for (int j = 0; j < nobs; ++j) {
+      const Vector &x(data[j]->x());
+      double excess_variance = std::max<double>(
+          kernel(x, x) - scaled_cross_kernel_.col(j).normsq(), 0.0);
+      double lambda = sigsq;
+      if (inducing_point_method_ == FITC) {
+        lambda += excess_variance;
+      } else {
+        trace += excess_variance;
+      }
+      inverse_diagonal_[j] = 1.0 / lambda;
+      sparse_logdet_ += log(lambda);
+      scaled_V.col(j) /= sqrt(lambda);
+    }
+    trace_penalty_ = inducing_point_method_ == VFE ? trace / sigsq : 0.0;
+
+    SpdMatrix inner(m, 1.0);
+    inner.add_outer(scaled_V);
+    Cholesky inner_chol(inner);
+    inner_cholesky_ = inner_chol.getL(false);
+    sparse_logdet_ += inner_chol.logdet();
+
+    // inner_solution = B^{-1} V Lambda^{-1} r.
+    Vector inner_solution = Lsolve(
+        inner_cholesky_, scaled_cross_kernel_ * (inverse_diagonal_ * residuals_));
+    LTsolve_inplace(inner_cholesky_, inner_solution);
+    weights_ = inverse_diagonal_ *
+        (residuals_ - scaled_cross_kernel_.Tmult(inner_solution));
+    inducing_weights_ = inner_solution;
+    LTsolve_inplace(inducing_cholesky_, inducing_weights_);
+  }
+
+  Vector GaussianProcessRegressionModel::inducing_kernel(
+      const ConstVectorView &x) const {
+    int m = inducing_points_.nrow();
+    Vector ans(m);
+    for (int i = 0; i < m; ++i) {
+      ans[i] = kernel(inducing_points_.row(i), x);
+    }
+    return ans;
+  }
+
 }  // namespace BOOM
@@ -46,6 +46,16 @@ namespace BOOM {
   // Both the mean function and the kernel function may depend on model
   // parameters.  Any such dependence is encapsulated by wrapping these
   // functions in FunctionParams and KernelParams objects.
+  //
+  // By default the model works with the exact n x n kernel matrix, which costs
+  // O(n^3) time and O(n^2) memory each time the parameters change.  For larger
+  // data sets the model can instead be given a set of m << n "inducing
+  // points" Z, in which case K(X, X) is replaced by the low rank
+  //
+  //    Q(X, X) = K(X, Z) K(Z, Z)^{-1} K(Z, X),
+  //
+  // plus a diagonal correction determined by the InducingPointMethod.  The
+  // likelihood and predictions then cost O(n m^2) time and O(n m) memory.
   class GaussianProcessRegressionModel :
       public ParamPolicy_3<FunctionParams, KernelParams, UnivParams>,
       public IID_DataPolicy<RegressionData>,
@@ -59,6 +69,7 @@ namespace BOOM {
         const Ptr<UnivParams> &residual_variance);
 
     GaussianProcessRegressionModel(const GaussianProcessRegressionModel &rhs);
+    ~GaussianProcessRegressionModel();
 
     GaussianProcessRegressionModel * clone() const override;
 
@@ -118,20 +129,58 @@ namespace BOOM {
     }
 
     // The inverse of the kernel matrix (K(X) + sigsq) evaluated at the training
-    // data.
-    const SpdMatrix &inverse_kernel_matrix() const {
-      refresh_kernel_matrix();
-      return Kinv_;
+    // data.  If inducing points are in use this materializes the n x n inverse
+    // of the approximate kernel matrix, which defeats the purpose of the
+    // approximation.  Prefer inverse_kernel_matrix_times().
+    const SpdMatrix &inverse_kernel_matrix() const;
+
+    // Returns (K(X) + sigsq)^{-1} * A, without forming the inverse kernel
+    // matrix when inducing points are in use.  A must have sample_size() rows.
+    Matrix inverse_kernel_matrix_times(const Matrix &A) const;
+    Vector inverse_kernel_matrix_times(const Vector &v) const;
+
+    //----------- Inducing points
+    enum InducingPointMethod {
+      // The "fully independent training conditional" approximation.  The
+      // diagonal of the approximate kernel matrix is corrected to match the
+      // diagonal of K(X, X), so the marginal variance of each observation is
+      // exact.
+      FITC,
+
+      // The "variational free energy" approximation of Titsias (2009).  The
+      // approximate kernel matrix is Q(X, X) + sigsq * I, and the log
+      // likelihood is replaced by a lower bound that penalizes the trace of
+      // K(X, X) - Q(X, X), so that maximizing it moves the approximation
+      // towards the exact model.
+      VFE
+    };
+
+    // Use a low rank approximation to the kernel matrix based on the given
+    // inducing points.
+    //
+    // Args:
+    //   inducing_points: A matrix with one row per inducing point, and xdim()
+    //     columns.  The inducing points are typically a subset of the training
+    //     data, or a grid covering the range of the predictors.
+    //   method:  The form of the approximation.
+    void set_inducing_points(const Matrix &inducing_points,
+                             InducingPointMethod method = FITC);
+
+    // Return to the exact model.
+    void clear_inducing_points();
+
+    bool uses_inducing_points() const { return inducing_points_.nrow() > 0; }
+    const Matrix &inducing_points() const { return inducing_points_; }
+    InducingPointMethod inducing_point_method() const {
+      return inducing_point_method_;
     }
 
     //----------- Data access
 
     using DataPolicy::add_data;
 
-    void add_data(const Ptr<RegressionData> &data_point) override {
-      kernel_matrix_current_ = false;
-      DataPolicy::add_data(data_point);
-    }
+    void add_data(const Ptr<RegressionData> &data_point) override;
+    void clear_data() override;
 
     size_t sample_size() const {return dat().size();}
     size_t xdim() const {
@@ -171,6 +220,11 @@ namespace BOOM {
 
     mutable bool kernel_matrix_current_;
 
+    // The inducing points, or an empty matrix if the exact kernel matrix is
+    // being used.
+    Matrix inducing_points_;
+    InducingPointMethod inducing_point_method_;
+
     // The inverse of the kernel matrix based on the training data.  This matrix
     // includes contributions from the residual variance, so it describes
     // individual data points.  This one is for "prediction intervals" not
@@ -186,13 +240,53 @@ namespace BOOM {
     // The residuals from the prior mean function.
     mutable Vector residuals_;
 
+    // Kinv * residuals_.
+    mutable Vector weights_;
+
+    //---------------------------------------------------------------------------
+    // Storage used when inducing points are in use.  Let Z denote the inducing
+    // points, and write the approximate kernel matrix as V'V + Lambda, where
+    // Lambda is diagonal.
+
+    // The lower Cholesky triangle of K(Z, Z).
+    mutable Matrix inducing_cholesky_;
+
+    // V = inducing_cholesky_^{-1} * K(Z, X).
+    mutable Matrix scaled_cross_kernel_;
+
+    // The diagonal of Lambda^{-1}.
+    mutable Vector inverse_diagonal_;
+
+    // The lower Cholesky triangle of I + V * Lambda^{-1} * V'.
+    mutable Matrix inner_cholesky_;
+
+    // The weights on K(x, Z) that give the predictive mean at x.
+    mutable Vector inducing_weights_;
+
+    // log det(V'V + Lambda).
+    mutable double sparse_logdet_;
+
+    // The VFE penalty trace(K(X, X) - V'V) / sigsq.  Zero for FITC.
+    mutable double trace_penalty_;
+
     // Put observers on the kernel and mean function parameters so if the
     // parameters change our kernel matrix will be invalidated.
     void add_observers();
 
+    // Put an observer on a data point, so that changes to the data point
+    // invalidate the kernel matrix.
+    void observe_data(const Ptr<RegressionData> &data_point);
+
     // Refresh the mutable parameters.  Fill a matrix K with K(X) + sigsq, where
     // X is the matrix of predictors in the training data.
     void refresh_kernel_matrix() const;
+
+    // The version of refresh_kernel_matrix used when inducing points are in
+    // use.
+    void refresh_sparse_kernel_matrix() const;
+
+    // The vector of kernel values K(Z, x) between the inducing points and x.
+    Vector inducing_kernel(const ConstVectorView &x) const;
   };
 
 
@@ -45,7 +45,8 @@ namespace BOOM {
       const Ptr<GaussianProcessRegressionModel> &mean_function_model)
       : shared_mean_function_model_(mean_function_model),
         shared_mean_function_param_(
-            new GpMeanFunction(shared_mean_function_model_))
+            new GpMeanFunction(shared_mean_function_model_)),
+        inducing_point_method_(GaussianProcessRegressionModel::FITC)
   {}
 
   HierarchicalGpRegressionModel::HierarchicalGpRegressionModel(
@@ -94,6 +95,20 @@ namespace BOOM {
     model->set_params(shared_mean_function_param_,
                       model->kernel_param(),
                       model->sigsq_param());
+    if (inducing_points_.nrow() > 0) {
+      model->set_inducing_points(inducing_points_, inducing_point_method_);
+    }
+  }
+
+  void HierarchicalGpRegressionModel::set_inducing_points(
+      const Matrix &inducing_points,
+      GaussianProcessRegressionModel::InducingPointMethod method) {
+    inducing_points_ = inducing_points;
+    inducing_point_method_ = method;
+    prior()->set_inducing_points(inducing_points, method);
+    for (auto &it : models_) {
+      it.second->set_inducing_points(inducing_points, method);
+    }
   }
 
   void HierarchicalGpRegressionModel::add_data(
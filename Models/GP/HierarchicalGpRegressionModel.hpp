@@ -126,6 +126,14 @@ namespace BOOM {
     std::vector<Ptr<HierarchicalRegressionData>> &data_set(
         GaussianProcessRegressionModel *model);
 
+    // Use an inducing point approximation in the prior and in every group
+    // model, including group models added later.  See
+    // GaussianProcessRegressionModel::set_inducing_points.
+    void set_inducing_points(
+        const Matrix &inducing_points,
+        GaussianProcessRegressionModel::InducingPointMethod method =
+        GaussianProcessRegressionModel::FITC);
+
    private:
     std::map<std::string, Ptr<GaussianProcessRegressionModel>> models_;
     std::vector<std::string> group_names_;
@@ -138,6 +146,11 @@ namespace BOOM {
     std::map<GaussianProcessRegressionModel *,
              std::vector<Ptr<HierarchicalRegressionData>>> data_store_;
 
+    // Inducing points to be used by group models as they are added.  Empty if
+    // the group models use exact kernel matrices.
+    Matrix inducing_points_;
+    GaussianProcessRegressionModel::InducingPointMethod inducing_point_method_;
+
   };
 
 }  // namespace BOOM
@@ -52,13 +52,15 @@ namespace BOOM {
       y[i] = data_point->y();
     }
 
-    const SpdMatrix &Kinv(model_->inverse_kernel_matrix());
+    // Kinv * X is formed without materializing Kinv, which matters when the
+    // model uses inducing points.
+    Matrix Kinv_X = model_->inverse_kernel_matrix_times(X);
 
     SpdMatrix posterior_precision =
-        prior_->precision() + sandwich_transpose(X, Kinv);
+        prior_->precision() + as_symmetric(X.Tmult(Kinv_X));
 
     Vector unscaled_posterior_mean =
-        prior_->precision() * prior_->mean() + X.Tmult(Kinv * y);
+        prior_->precision() * prior_->mean() + Kinv_X.Tmult(y);
     Vector posterior_mean = posterior_precision.solve(unscaled_posterior_mean);
     Vector beta = rmvn_ivar_mt(rng, posterior_mean, posterior_precision);
     mean_function_->coef()->set_Beta(beta);
@@ -234,4 +234,106 @@ namespace {
     out << beta << "\n" << beta_draws;
   }
 
+  // When the inducing points are the training data the approximation is exact
+  // (up to a small amount of jitter).
+  TEST_F(GpTest, InducingPointsAtDataAreExact) {
+    int sample_size = 30;
+    Matrix X(sample_size, 2);
+    X.randomize();
+    Vector y = X.col(0) - 2 * X.col(1) + rnorm_vector(sample_size, 0, .3);
+
+    GaussianProcessRegressionModel exact(
+        new ZeroFunction, new RadialBasisFunction(.5), new UnivParams(.09));
+    for (int i = 0; i < sample_size; ++i) {
+      exact.add_data(new RegressionData(y[i], X.row(i)));
+    }
+
+    int nnew = 4;
+    Matrix Xnew(nnew, 2);
+    Xnew.randomize();
+    Ptr<MvnBase> exact_prediction = exact.predict_distribution(Xnew, false);
+
+    for (auto method : {GaussianProcessRegressionModel::FITC,
+            GaussianProcessRegressionModel::VFE}) {
+      GaussianProcessRegressionModel sparse(
+          new ZeroFunction, new RadialBasisFunction(.5), new UnivParams(.09));
+      for (int i = 0; i < sample_size; ++i) {
+        sparse.add_data(new RegressionData(y[i], X.row(i)));
+      }
+      sparse.set_inducing_points(X, method);
+      EXPECT_TRUE(sparse.uses_inducing_points());
+
+      EXPECT_NEAR(exact.log_likelihood(), sparse.log_likelihood(), 1e-4);
+      EXPECT_NEAR(exact.predict(Xnew.row(0)), sparse.predict(Xnew.row(0)),
+                  1e-4);
+
+      Ptr<MvnBase> sparse_prediction = sparse.predict_distribution(Xnew, false);
+      EXPECT_TRUE(VectorEquals(exact_prediction->mu(),
+                               sparse_prediction->mu(), 1e-4))
+          << exact_prediction->mu() << "\n" << sparse_prediction->mu();
+      EXPECT_TRUE(MatrixEquals(exact_prediction->Sigma(),
+                               sparse_prediction->Sigma(), 1e-4))
+          << exact_prediction->Sigma() << "\n" << sparse_prediction->Sigma();
+
+      Matrix Kinv_X = sparse.inverse_kernel_matrix_times(X);
+      EXPECT_TRUE(MatrixEquals(exact.inverse_kernel_matrix() * X, Kinv_X,
+                               1e-3));
+    }
+
+    // The posterior variance of the function can't exceed the prior variance.
+    for (int i = 0; i < nnew; ++i) {
+      EXPECT_LT(exact_prediction->Sigma()(i, i),
+                exact.kernel(Xnew.row(i), Xnew.row(i)));
+    }
+  }
+
+  // With a modest number of inducing points a smooth function is well
+  // approximated, and the VFE log likelihood is a lower bound on the exact log
+  // likelihood.
+  TEST_F(GpTest, FewInducingPoints) {
+    int sample_size = 400;
+    Matrix X(sample_size, 1);
+    X.randomize();
+    Vector y(sample_size);
+    for (int i = 0; i < sample_size; ++i) {
+      y[i] = sin(6 * X(i, 0)) + rnorm(0, .1);
+    }
+
+    int number_of_inducing_points = 15;
+    Matrix Z(number_of_inducing_points, 1);
+    for (int i = 0; i < number_of_inducing_points; ++i) {
+      Z(i, 0) = i / (number_of_inducing_points - 1.0);
+    }
+
+    GaussianProcessRegressionModel model(
+        new ZeroFunction, new RadialBasisFunction(.3), new UnivParams(.01));
+    for (int i = 0; i < sample_size; ++i) {
+      model.add_data(new RegressionData(y[i], X.row(i)));
+    }
+    double exact_loglike = model.log_likelihood();
+    Vector x0 = {.37};
+    double exact_prediction = model.predict(x0);
+
+    model.set_inducing_points(Z, GaussianProcessRegressionModel::VFE);
+    EXPECT_LE(model.log_likelihood(), exact_loglike + 1e-6);
+    EXPECT_NEAR(model.log_likelihood(), exact_loglike,
+                .01 * fabs(exact_loglike));
+    EXPECT_NEAR(model.predict(x0), exact_prediction, .02);
+    EXPECT_NEAR(model.predict(x0), sin(6 * .37), .1);
+
+    model.set_inducing_points(Z, GaussianProcessRegressionModel::FITC);
+    EXPECT_NEAR(model.predict(x0), exact_prediction, .02);
+
+    // Changing a data point invalidates the cached computations.
+    double before = model.predict(x0);
+    for (int i = 0; i < sample_size; ++i) {
+      model.dat()[i]->set_y(model.dat()[i]->y() + 1.0);
+    }
+    EXPECT_NEAR(model.predict(x0), before + 1.0, .05);
+
+    model.clear_inducing_points();
+    EXPECT_FALSE(model.uses_inducing_points());
+    EXPECT_NEAR(model.predict(x0), exact_prediction + 1.0, .05);
+  }
+
 }  // namespace
@@ -158,6 +158,24 @@ namespace BOOM {
     return logscale ? ans : exp(ans);
   }
 
+  void GaussianModelBase::batch_logp(const std::vector<Ptr<Data>> &data,
+                                     int begin, VectorView ans) const {
+    double m = mu();
+    double variance = sigsq();
+    double normalizing_constant =
+        -Constants::log_root_2pi - 0.5 * log(variance);
+    double scale = -0.5 / variance;
+    for (int i = 0; i < ans.size(); ++i) {
+      const Data *dp = data[begin + i].get();
+      if (dp->missing() == Data::observed) {
+        double residual = DAT(dp)->value() - m;
+        ans[i] = normalizing_constant + scale * residual * residual;
+      } else {
+        ans[i] = 0.0;
+      }
+    }
+  }
+
   double GaussianModelBase::Logp(double x, double &g, double &h,
                                  uint nd) const {
     double m = mu();
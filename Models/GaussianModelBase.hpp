@@ -46,6 +46,16 @@ namespace BOOM {
     // Remove the effect of observation y from the sufficient
     // statistics, as if it were dropped from the data set.
     void remove(double y);
+    bool can_remove() const override { return true; }
+    void Remove(const DoubleData &y) override { remove(y.value()); }
+    int removal_size(const DoubleData &) const override { return 1; }
+    void store_removal_values(const DoubleData &y,
+                              VectorView dest) const override {
+      dest[0] = y.value();
+    }
+    void remove_stored_values(const ConstVectorView &values) override {
+      remove(values[0]);
+    }
 
     // Increment n by prob, sum by prob * y, and sumsq by prob * y^2.
     void add_mixture_data(double y, double prob);
@@ -107,6 +117,8 @@ namespace BOOM {
 
     double pdf(const Ptr<Data> &dp, bool logscale) const override;
     double pdf(const Data *dp, bool logscale) const override;
+    void batch_logp(const std::vector<Ptr<Data>> &data, int begin,
+                    VectorView ans) const override;
     double Logp(double x, double &g, double &h, uint nd) const override;
     double Logp(const Vector &x, Vector &g, Matrix &h, uint nd) const;
 
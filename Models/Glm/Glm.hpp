@@ -237,6 +237,7 @@ namespace BOOM {
   template <class D>
   void GlmData<D>::set_y(const value_type &Y) {
     y_->set(Y);
+    this->signal();
   }
 
 }  // namespace BOOM
@@ -108,7 +108,11 @@ namespace BOOM {
     for (int i = 0; i < n; ++i) {
       bool y = data[i]->y();
       const Vector &x(data[i]->x());
-      double eta = predict(x) + log_alpha_;
+      // Evaluate eta at the supplied coefficients, not the model's current
+      // parameter value, so that optimizers see a function of beta.
+      double eta = (beta.size() == x.size() ? beta.dot(x)
+                                            : inc.select(x).dot(beta)) +
+                   log_alpha_;
       double loglike = plogis(eta, 0, 1, y, true);
       ans += loglike;
       if (g) {
@@ -16,7 +16,7 @@
   Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
 */
 
-#include <thread>
+#include <algorithm>
 #include "Models/Glm/PosteriorSamplers/BigAssSpikeSlabSampler.hpp"
 #include "distributions.hpp"
 #include "cpputil/ThreadTools.hpp"
@@ -33,7 +33,8 @@ namespace BOOM {
         model_(model),
         spike_(spike),
         slab_prototype_(slab_prototype),
-        residual_precision_prior_(residual_precision_prior)
+        residual_precision_prior_(residual_precision_prior),
+        number_of_threads_(1)
   {}
 
   void BigAssSpikeSlabSampler::draw() {
@@ -46,6 +47,10 @@ namespace BOOM {
     return negative_infinity();
   }
 
+  void BigAssSpikeSlabSampler::set_number_of_threads(int n) {
+    number_of_threads_ = std::max<int>(n, 1);
+  }
+
   void BigAssSpikeSlabSampler::initial_screen(int niter, double threshold, bool use_threads) {
     assign_subordinate_samplers();
     run_parallel_initial_screen(niter, threshold, use_threads);
@@ -152,28 +157,38 @@ namespace BOOM {
     int num_models = model_->number_of_subordinate_models();
     std::vector<std::vector<Selector>> draws(num_models);
 
-    if (use_threads) {
-      int num_threads = std::min<int>(std::thread::hardware_concurrency(),
-                                      num_models);
-      ThreadWorkerPool pool(num_threads);
-      std::vector<std::future<void>> futures;
-
-
-      for (int i = 0; i < num_models; ++i) {
-        std::vector<Selector> &worker_model_draws(draws[i]);
-        RegressionModel *worker_model = model_->subordinate_model(i);
-        futures.emplace_back(
-            pool.submit(
-                [worker_model, niter, &worker_model_draws]() {
-                  for (int iter = 0; iter < niter; ++iter) {
-                    worker_model->sample_posterior();
-                    worker_model_draws.push_back(worker_model->inc());
-                  }
-                }));
-      }
-      for (auto & future : futures) {
-        future.get();
+    // Give each subordinate sampler its own stream, derived from this
+    // sampler's RNG, so the screen is reproducible however the work is
+    // scheduled.
+    RNG streams(seed_rng(rng()), RNG::PHILOX);
+    std::uint64_t stream_id = 0;
+    for (int i = 0; i < num_models; ++i) {
+      RegressionModel *worker_model = model_->subordinate_model(i);
+      for (int s = 0; s < worker_model->number_of_sampling_methods(); ++s) {
+        RNG &worker_rng(worker_model->sampler(s)->rng());
+        worker_rng = streams;
+        worker_rng.jump(stream_id++);
       }
+    }
+
+    if (use_threads) {
+      // The global pool may hold more threads than were requested, so the
+      // models are dealt into at most num_threads tasks.
+      int num_threads = std::min<int>(number_of_threads_, num_models);
+      WorkStealingThreadPool &pool(WorkStealingThreadPool::global());
+      pool.set_minimum_number_of_threads(num_threads);
+      pool.parallel_for(
+          0, num_threads, 1,
+          [this, niter, num_models, num_threads, &draws](int task) {
+            for (int i = task; i < num_models; i += num_threads) {
+              std::vector<Selector> &worker_model_draws(draws[i]);
+              RegressionModel *worker_model = model_->subordinate_model(i);
+              for (int iter = 0; iter < niter; ++iter) {
+                worker_model->sample_posterior();
+                worker_model_draws.push_back(worker_model->inc());
+              }
+            }
+          });
     } else {
       // The non-thread code path should match the code in the thread code path
       // as closely as possible.
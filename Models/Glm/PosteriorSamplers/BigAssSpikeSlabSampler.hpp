@@ -71,8 +71,9 @@ namespace BOOM {
     //   niter:  The number of MCMC iterations to use.
     //   threshold: The variables whose 'marginal inclusion probabilities'
     //     exceed 'threshold' become candidates in the next round.
-    //   use_threads: If 'true' then C++11 threads will be used to run the MCMC
-    //     algorithms for the subordinate models.  If 'false' then the code path
+    //   use_threads: If 'true' then the global thread pool will be used to run
+    //     the MCMC algorithms for the subordinate models.  See
+    //     set_number_of_threads().  If 'false' then the code path
     //     for doing the MCMC will not use threads.
     //
     // Preconditions:
@@ -84,6 +85,11 @@ namespace BOOM {
     //   managed model are set.
     void initial_screen(int niter, double threshold, bool use_threads);
 
+    // Set the number of threads used by initial_screen() when use_threads is
+    // true.  The subordinate models are run on at most this many threads from
+    // the global thread pool.  The default is a single thread.
+    void set_number_of_threads(int n);
+
     // Args:
     //   v: A Vector of objects to be selected.  The elements of v correspond to
     //     columns in the global predictor matrix.
@@ -96,6 +102,9 @@ namespace BOOM {
     Ptr<RegressionSlabPrior> slab_prototype_;
     Ptr<GammaModelBase> residual_precision_prior_;
 
+    // The maximum number of threads to use in the initial screen.
+    int number_of_threads_;
+
     // The posterior samplers assigned to the subordinate models held by model_.
     std::vector<Ptr<BregVsSampler>> intial_screen_samplers_;
 
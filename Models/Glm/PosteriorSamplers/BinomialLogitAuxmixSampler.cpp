@@ -18,6 +18,7 @@
 */
 
 #include "Models/Glm/PosteriorSamplers/BinomialLogitAuxmixSampler.hpp"
+#include <algorithm>
 #include "cpputil/report_error.hpp"
 #include "distributions.hpp"
 
@@ -28,7 +29,11 @@ namespace BOOM {
 
   namespace BinomialLogit {
     SufficientStatistics::SufficientStatistics(int dim)
-        : xtx_(dim), xty_(dim), sym_(false), sample_size_(0) {}
+        : xtx_(dim),
+          xty_(dim),
+          sym_(false),
+          sample_size_(0),
+          xtx_accumulator_(dim) {}
 
     SufficientStatistics *SufficientStatistics::clone() const {
       return new SufficientStatistics(*this);
@@ -39,29 +44,34 @@ namespace BOOM {
       xty_ = 0;
       sym_ = false;
       sample_size_ = 0;
+      xtx_accumulator_.clear();
     }
 
     void SufficientStatistics::combine(const SufficientStatistics &rhs) {
-      xtx_ += rhs.xtx_;
+      // rhs.xtx() is complete and symmetric, so the sum is symmetric if xtx_
+      // is.
+      xtx_ += rhs.xtx();
       xty_ += rhs.xty_;
-      sym_ = sym_ && rhs.sym_;
       sample_size_ += rhs.sample_size_;
     }
 
     const SpdMatrix &SufficientStatistics::xtx() const {
-      if (!sym_) {
-        xtx_.reflect();
-        sym_ = true;
-      }
+      if (!sym_) make_symmetric();
       return xtx_;
     }
 
+    void SufficientStatistics::make_symmetric() const {
+      xtx_accumulator_.flush(xtx_);
+      xtx_.reflect();
+      sym_ = true;
+    }
+
     const Vector &SufficientStatistics::xty() const { return xty_; }
 
     void SufficientStatistics::update(const Vector &x, double weighted_value,
                                       double weight) {
       sym_ = false;
-      xtx_.add_outer(x, weight, false);
+      xtx_accumulator_.add(x, weight, xtx_);
       xty_.axpy(x, weighted_value);
       ++sample_size_;
     }
@@ -95,6 +105,23 @@ namespace BOOM {
         report_error(err.str());
       }
     }
+
+    PolyaGammaImputeWorker::PolyaGammaImputeWorker(
+        SufficientStatistics &global_suf, std::mutex &global_suf_mutex,
+        const GlmCoefs *coef, RNG *rng, RNG &seeding_rng)
+        : ImputeWorkerBase(global_suf, global_suf_mutex, rng, seeding_rng),
+          coefficients_(coef) {}
+
+    void PolyaGammaImputeWorker::impute_latent_data_point(
+        const BinomialRegressionData &observation, SufficientStatistics *suf,
+        RNG &rng) {
+      double n = observation.n();
+      if (n <= 0) return;
+      const Vector &x(observation.x());
+      double eta = coefficients_->predict(x);
+      double omega = rpolya_gamma_mt(rng, n, eta);
+      suf->update(x, observation.y() - 0.5 * n, omega);
+    }
   }  // namespace BinomialLogit
 
   using namespace BinomialLogit;
@@ -106,7 +133,8 @@ namespace BOOM {
         model_(model),
         prior_(prior),
         suf_(model->xdim()),
-        clt_threshold_(clt_threshold) {
+        clt_threshold_(clt_threshold),
+        polya_gamma_(false) {
     set_number_of_workers(1);
   }
 
@@ -117,11 +145,23 @@ namespace BOOM {
     draw_params();
   }
 
-  Ptr<ImputeWorker> BLAMS::create_worker(std::mutex &suf_mutex) {
+  Ptr<ImputeWorkerBase> BLAMS::create_worker(std::mutex &suf_mutex) {
+    if (polya_gamma_) {
+      return new PolyaGammaImputeWorker(suf_, suf_mutex,
+                                        model_->coef_prm().get(), nullptr,
+                                        rng());
+    }
     return new ImputeWorker(suf_, suf_mutex, clt_threshold_,
                             model_->coef_prm().get(), nullptr, rng());
   }
 
+  void BLAMS::use_polya_gamma_augmentation(bool tf) {
+    if (tf != polya_gamma_) {
+      polya_gamma_ = tf;
+      set_number_of_workers(std::max<int>(1, workers().size()));
+    }
+  }
+
   void BLAMS::draw_params() {
     SpdMatrix ivar = prior_->siginv() + suf_.xtx();
     Vector ivar_mu = suf_.xty() + prior_->siginv() * prior_->mu();
@@ -20,6 +20,7 @@
 #ifndef BOOM_BINOMIAL_LOGIT_AUXMIX_SAMPLER_HPP_
 #define BOOM_BINOMIAL_LOGIT_AUXMIX_SAMPLER_HPP_
 
+#include "LinAlg/CrossProductAccumulator.hpp"
 #include "Models/PosteriorSamplers/Imputer.hpp"
 #include "Models/PosteriorSamplers/PosteriorSampler.hpp"
 
@@ -53,10 +54,15 @@ namespace BOOM {
       int sample_size() const { return sample_size_; }
 
      private:
+      // Apply any observations held by xtx_accumulator_ to xtx_, and fill in
+      // the lower triangle.
+      void make_symmetric() const;
+
       mutable SpdMatrix xtx_;
       Vector xty_;
       mutable bool sym_;
       int sample_size_;
+      mutable CrossProductAccumulator xtx_accumulator_;
       friend void intrusive_ptr_add_ref(SufficientStatistics *w) {
         w->up_count();
       }
@@ -66,10 +72,14 @@ namespace BOOM {
       }
     };
 
+    // The base class for workers that impute the complete data sufficient
+    // statistics for binomial logit models.
+    typedef SufstatImputeWorker<BinomialRegressionData, SufficientStatistics>
+        ImputeWorkerBase;
+
     // An worker class for drawing latent data in the auxiliary
     // mixture sampling algorithm for binomial logit models.
-    class ImputeWorker : public SufstatImputeWorker<BinomialRegressionData,
-                                                    SufficientStatistics> {
+    class ImputeWorker : public ImputeWorkerBase {
      public:
       // Args:
       //   global_suf: A reference to the global sufficient statistics
@@ -103,12 +113,50 @@ namespace BOOM {
       BinomialLogitCltDataImputer binomial_data_imputer_;
       const GlmCoefs *coefficients_;
     };
+
+    // A worker class for the Polya-Gamma data augmentation scheme of Polson,
+    // Scott, and Windle (2013).  Given an observation with y successes in n
+    // trials, and linear predictor eta, the latent variable is omega ~ PG(n,
+    // eta).  Conditional on omega, the likelihood contribution is a normal
+    // kernel for eta with precision omega and precision weighted sum y - n/2,
+    // so only one latent draw is needed per observation.
+    class PolyaGammaImputeWorker : public ImputeWorkerBase {
+     public:
+      // Args:
+      //   global_suf: A reference to the global sufficient statistics
+      //     object held by the primary sampler.
+      //   global_suf_mutex:  A reference to a mutex protecting global_suf.
+      //   coef: A pointer to a set of logisitic regression
+      //     coefficients, owned by the model for which this imputer
+      //     is responsible.
+      //   rng:  A random number generator or nullptr.
+      //   seeding_rng: A RNG used to initialize a new RNG in the case
+      //     that rng==nullptr.
+      PolyaGammaImputeWorker(SufficientStatistics &global_suf,
+                             std::mutex &global_suf_mutex,
+                             const GlmCoefs *coef, RNG *rng = nullptr,
+                             RNG &seeding_rng = GlobalRng::rng);
+
+      void impute_latent_data_point(const BinomialRegressionData &data,
+                                    SufficientStatistics *suf,
+                                    RNG &rng) override;
+
+     private:
+      const GlmCoefs *coefficients_;
+    };
   }  // namespace BinomialLogit
 
   //======================================================================
+  // Samples the coefficients of a BinomialLogitModel by data augmentation.
+  // By default the latent data are imputed using the auxiliary mixture
+  // sampler of Fruhwirth-Schnatter and Fruhwirth (2007).  Calling
+  // use_polya_gamma_augmentation() switches to the Polya-Gamma scheme of
+  // Polson, Scott, and Windle (2013), which is exact, and which mixes better
+  // when successes (or failures) are rare.  Both schemes produce the same
+  // complete data sufficient statistics.
   class BinomialLogitAuxmixSampler
       : public PosteriorSampler,
-        public LatentDataSampler<BinomialLogit::ImputeWorker> {
+        public LatentDataSampler<BinomialLogit::ImputeWorkerBase> {
    public:
     BinomialLogitAuxmixSampler(BinomialLogitModel *model,
                                const Ptr<MvnBase> &prior,
@@ -118,7 +166,8 @@ namespace BOOM {
     void draw() override;
     void draw_params();
 
-    Ptr<BinomialLogit::ImputeWorker> create_worker(std::mutex &m) override;
+    Ptr<BinomialLogit::ImputeWorkerBase> create_worker(
+        std::mutex &m) override;
     void clear_latent_data() override;
 
     void assign_data_to_workers() override;
@@ -144,11 +193,18 @@ namespace BOOM {
 
     int clt_threshold() const { return clt_threshold_; }
 
+    // Impute the latent data using Polya-Gamma augmentation if 'tf' is true,
+    // or auxiliary mixture sampling if it is false.  The workers are rebuilt,
+    // keeping the current number of workers.
+    void use_polya_gamma_augmentation(bool tf = true);
+    bool polya_gamma_augmentation() const { return polya_gamma_; }
+
    private:
     BinomialLogitModel *model_;
     Ptr<MvnBase> prior_;
     BinomialLogit::SufficientStatistics suf_;
     int clt_threshold_;
+    bool polya_gamma_;
   };
 
 }  // namespace BOOM
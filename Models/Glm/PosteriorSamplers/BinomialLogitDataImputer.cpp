@@ -100,7 +100,8 @@ namespace BOOM {
       // term in the sum recieves (the variance of the logistic
       // distribution, pi^2/3).
       information_weighted_sum =
-          rnorm_mt(rng, mean_of_logit_sum, sqrt(variance_of_logit_sum));
+          mean_of_logit_sum +
+          sqrt(variance_of_logit_sum) * rnorm_ziggurat_mt(rng);
       information_weighted_sum /= Constants::pi_squared_over_3;
 
       // Each latent logit carries the same amount of information:
@@ -205,7 +206,7 @@ namespace BOOM {
       }
     }
     double information_weighted_sum =
-        rnorm_mt(rng, simulation_mean, sqrt(simulation_variance));
+        simulation_mean + sqrt(simulation_variance) * rnorm_ziggurat_mt(rng);
     return std::make_pair(information_weighted_sum, information);
   }
 
@@ -40,11 +40,13 @@ namespace BOOM {
         log_posterior_at_mode_(negative_infinity()) {}
 
   BLSSS * BLSSS::clone_to_new_host(Model *new_host) const {
-    return new BLSSS(dynamic_cast<BinomialLogitModel *>(new_host),
-                     slab_->clone(),
-                     spike_->clone(),
-                     clt_threshold(),
-                     rng());
+    BLSSS *ans = new BLSSS(dynamic_cast<BinomialLogitModel *>(new_host),
+                           slab_->clone(),
+                           spike_->clone(),
+                           clt_threshold(),
+                           rng());
+    ans->use_polya_gamma_augmentation(polya_gamma_augmentation());
+    return ans;
   }
 
   void BLSSS::draw() {
@@ -50,7 +50,7 @@ namespace BOOM {
       // If we draw y deviates from the same truncated normal and add
       // them up we'll have a normal with mean (y * mean) and variance
       // (y * variance).
-      ans += rnorm_mt(rng, y * mean, sqrt(y * variance));
+      ans += y * mean + sqrt(y * variance) * rnorm_ziggurat_mt(rng);
     } else {
       for (int i = 0; i < y; ++i) {
         // TODO: If y is large-ish but not quite
@@ -62,7 +62,7 @@ namespace BOOM {
 
     if (n - y > clt_threshold_) {
       trun_norm_moments(eta, 1, 0, false, &mean, &variance);
-      ans += rnorm_mt(rng, (n - y) * mean, sqrt((n - y) * variance));
+      ans += (n - y) * mean + sqrt((n - y) * variance) * rnorm_ziggurat_mt(rng);
     } else {
       for (int i = 0; i < n - y; ++i) {
         ans += rtrun_norm_mt(rng, eta, 1, 0, false);
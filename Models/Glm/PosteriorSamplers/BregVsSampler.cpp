@@ -62,6 +62,7 @@ namespace BOOM {
         DF_(negative_infinity()),
         SS_(negative_infinity()),
         sigsq_sampler_(residual_precision_prior_),
+        use_incremental_cholesky_(false),
         failure_count_(0) {
     uint p = model_->nvars_possible();
     Vector prior_mean = Vector(p, 0.0);
@@ -98,6 +99,7 @@ namespace BOOM {
         draw_beta_(true),
         draw_sigma_(true),
         sigsq_sampler_(residual_precision_prior_),
+        use_incremental_cholesky_(false),
         failure_count_(0) {
     uint p = model_->nvars_possible();
     Vector b = Vector(p, 0.0);
@@ -157,6 +159,7 @@ namespace BOOM {
         draw_beta_(true),
         draw_sigma_(true),
         sigsq_sampler_(residual_precision_prior_),
+        use_incremental_cholesky_(false),
         failure_count_(0) {}
   //----------------------------------------------------------------------
   BVS::BregVsSampler(RegressionModel *model,
@@ -175,6 +178,7 @@ namespace BOOM {
         draw_beta_(true),
         draw_sigma_(true),
         sigsq_sampler_(residual_precision_prior_),
+        use_incremental_cholesky_(false),
         failure_count_(0) {}
   //----------------------------------------------------------------------
   BVS::BregVsSampler(RegressionModel *model,
@@ -191,6 +195,7 @@ namespace BOOM {
         draw_beta_(true),
         draw_sigma_(true),
         sigsq_sampler_(residual_precision_prior_),
+        use_incremental_cholesky_(false),
         failure_count_(0) {}
   //----------------------------------------------------------------------
   void BVS::limit_model_selection(uint n) { max_nflips_ = n; }
@@ -202,6 +207,12 @@ namespace BOOM {
     }
   }
   void BVS::suppress_model_selection() { max_nflips_ = 0; }
+  void BVS::use_incremental_cholesky(bool tf, int refactorization_interval) {
+    use_incremental_cholesky_ = tf;
+    prior_precision_cholesky_ = IncrementalCholesky(refactorization_interval);
+    posterior_precision_cholesky_ =
+        IncrementalCholesky(refactorization_interval);
+  }
   void BVS::suppress_beta_draw() { draw_beta_ = false; }
   void BVS::allow_beta_draw() { draw_beta_ = false; }
   void BVS::suppress_sigma_draw() { draw_sigma_ = false; }
@@ -249,6 +260,111 @@ namespace BOOM {
     return logp_new;
   }
   //----------------------------------------------------------------------
+  double BVS::mcmc_one_flip_incremental(Selector &model, uint which_var,
+                                        double logp_old) {
+    model.flip(which_var);
+    double logp_new = incremental_log_model_prob(model, which_var);
+    double u = runif_mt(rng(), 0, 1);
+    if (log(u) > logp_new - logp_old) {
+      model.flip(which_var);  // reject draw
+      return logp_old;
+    }
+    if (model[which_var]) {
+      if (!prior_precision_cholesky_.add(which_var) ||
+          !posterior_precision_cholesky_.add(which_var)) {
+        report_error("Incremental Cholesky update failed in BregVsSampler.");
+      }
+    } else {
+      prior_precision_cholesky_.drop(which_var);
+      posterior_precision_cholesky_.drop(which_var);
+    }
+    return logp_new;
+  }
+  //----------------------------------------------------------------------
+  bool BVS::prepare_incremental_sweep(const Selector &inclusion_indicators) {
+    const SpdMatrix &unscaled_prior_precision(slab_->unscaled_precision());
+    unscaled_posterior_precision_full_ = model_->suf()->xtx();
+    unscaled_posterior_precision_full_ += unscaled_prior_precision;
+    xty_full_ = model_->suf()->xty();
+    return prior_precision_cholesky_.decompose(unscaled_prior_precision,
+                                               inclusion_indicators) &&
+        posterior_precision_cholesky_.decompose(
+            unscaled_posterior_precision_full_, inclusion_indicators);
+  }
+  //----------------------------------------------------------------------
+  // The sum of squares computed by set_reg_post_params can be written
+  //
+  //   SS = prior_ss + y'y + b' Ominv b - m' (Ominv + X'X)^{-1} m,
+  //
+  // where m = Ominv * b + X'y, with all vectors and matrices restricted to
+  // the included variables.  The determinants and the quadratic form in m are
+  // available from O(k^2) updates of the Cholesky decompositions.
+  double BVS::incremental_log_model_prob(const Selector &g, uint which_var) {
+    if (g.nvars() == 0) {
+      return log_model_prob(g);
+    }
+    double ans = spike_->logp(g);
+    if (ans == negative_infinity()) {
+      return ans;
+    }
+    bool adding = g[which_var];
+    candidate_positions_ = posterior_precision_cholesky_.order();
+    int excluded = -1;
+    if (adding) {
+      candidate_positions_.push_back(which_var);
+    } else {
+      excluded = posterior_precision_cholesky_.position(which_var);
+    }
+
+    const Vector &prior_mean(slab_->mu());
+    const SpdMatrix &ominv(slab_->unscaled_precision());
+    int dim = candidate_positions_.size();
+    posterior_precision_mean_.resize(dim);
+    double prior_ss_of_mean = 0;
+    for (int i = 0; i < dim; ++i) {
+      if (i == excluded) {
+        posterior_precision_mean_[i] = 0.0;
+        continue;
+      }
+      int I = candidate_positions_[i];
+      double element = 0;
+      for (int j = 0; j < dim; ++j) {
+        if (j != excluded) {
+          int J = candidate_positions_[j];
+          element += ominv(J, I) * prior_mean[J];
+        }
+      }
+      prior_ss_of_mean += prior_mean[I] * element;
+      posterior_precision_mean_[i] = xty_full_[I] + element;
+    }
+
+    double ldoi, posterior_logdet, quadratic_form;
+    if (adding) {
+      ldoi = prior_precision_cholesky_.evaluate_add(which_var);
+      posterior_logdet = posterior_precision_cholesky_.evaluate_add(
+          which_var, &posterior_precision_mean_, &quadratic_form);
+    } else {
+      ldoi = prior_precision_cholesky_.evaluate_drop(which_var);
+      posterior_logdet = posterior_precision_cholesky_.evaluate_drop(
+          which_var, &posterior_precision_mean_, &quadratic_form);
+    }
+    if (ldoi <= negative_infinity() ||
+        posterior_logdet <= negative_infinity()) {
+      return negative_infinity();
+    }
+
+    Ptr<RegSuf> suf = model_->suf();
+    double DF = suf->n() + prior_df();
+    double SS = prior_ss() + suf->yty() + prior_ss_of_mean - quadratic_form;
+    if (!(SS > 0) || !std::isfinite(SS)) {
+      // Let the direct calculation sort out (and report) numerical trouble.
+      return log_model_prob(g);
+    }
+    ans += .5 * (ldoi - posterior_logdet);
+    ans -= (.5 * DF - 1) * log(SS);
+    return ans;
+  }
+  //----------------------------------------------------------------------
   void BVS::draw() {
     if (max_nflips_ > 0) {
       draw_model_indicators();
@@ -367,9 +483,15 @@ namespace BOOM {
       report_error(err.str());
     }
 
+    bool incremental = use_incremental_cholesky_ &&
+        prepare_incremental_sweep(g);
     uint n = std::min<uint>(max_nflips_, g.nvars_possible());
     for (uint i = 0; i < n; ++i) {
-      logp = mcmc_one_flip(g, indx[i], logp);
+      if (incremental) {
+        logp = mcmc_one_flip_incremental(g, indx[i], logp);
+      } else {
+        logp = mcmc_one_flip(g, indx[i], logp);
+      }
     }
     model_->coef().set_inc(g);
     attempt_swap();
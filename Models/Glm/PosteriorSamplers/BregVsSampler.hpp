@@ -19,6 +19,7 @@
 
 #ifndef BOOM_BREG_VS_SAMPLER_HPP
 #define BOOM_BREG_VS_SAMPLER_HPP
+#include "LinAlg/IncrementalCholesky.hpp"
 #include "Models/ChisqModel.hpp"
 #include "Models/GammaModel.hpp"
 #include "Models/Glm/RegressionModel.hpp"
@@ -140,6 +141,15 @@ namespace BOOM {
     // Restrict model selection to be no more than 'nflips' locations per sweep.
     void limit_model_selection(uint nflips);
 
+    // If true, the Cholesky decompositions of the included blocks of the prior
+    // and posterior precision matrices are computed once at the start of each
+    // sweep through the inclusion indicators, and updated in O(k^2) as
+    // variables enter or leave the model, instead of being recomputed in
+    // O(k^3) for each proposed flip.  The decompositions are recomputed from
+    // scratch every 'refactorization_interval' updates.
+    void use_incremental_cholesky(bool tf = true,
+                                  int refactorization_interval = 100);
+
     // For testing purposes, the draw of beta and/or sigma can be suppressed.
     // This is also useful in cases where sigma is known.
     void suppress_beta_draw();
@@ -201,6 +211,11 @@ namespace BOOM {
     double mcmc_one_flip(Selector &inclusion_indicators, uint which_var,
                          double current_logp);
 
+    // The equivalent of mcmc_one_flip for sweeps using incremental Cholesky
+    // decompositions.  Only valid during draw_model_indicators().
+    double mcmc_one_flip_incremental(Selector &inclusion_indicators,
+                                     uint which_var, double current_logp);
+
    private:
     // The model whose paramaters are to be drawn.
     RegressionModel *model_;
@@ -243,6 +258,18 @@ namespace BOOM {
 
     CorrelationMap correlation_map_;
 
+    // Workspace for sweeps using incremental Cholesky decompositions.  The
+    // decompositions refer to slab_->unscaled_precision() and to
+    // unscaled_posterior_precision_full_, which are refreshed at the start of
+    // each sweep.
+    bool use_incremental_cholesky_;
+    SpdMatrix unscaled_posterior_precision_full_;
+    Vector xty_full_;
+    IncrementalCholesky prior_precision_cholesky_;
+    IncrementalCholesky posterior_precision_cholesky_;
+    std::vector<int> candidate_positions_;
+    Vector posterior_precision_mean_;
+
     // Keeps track of the number of times within the current draw that algorithm
     // had to restart because of a degenerate information matrix.
     int failure_count_;
@@ -274,6 +301,18 @@ namespace BOOM {
     void draw_model_indicators();
     void draw_sigma();
 
+    // Set up the incremental Cholesky decompositions for a sweep starting at
+    // inclusion_indicators.  Returns false if a required matrix is not
+    // positive definite, in which case the sweep should not use the
+    // incremental algorithm.
+    bool prepare_incremental_sweep(const Selector &inclusion_indicators);
+
+    // Equivalent to log_model_prob, evaluated after element 'which_var' of
+    // inclusion_indicators has been flipped, but before the incremental
+    // decompositions have been updated.
+    double incremental_log_model_prob(const Selector &inclusion_indicators,
+                                      uint which_var);
+
     const Ptr<MvnGivenScalarSigmaBase> &check_slab_dimension(
         const Ptr<MvnGivenScalarSigmaBase> &slab);
     const Ptr<VariableSelectionPrior> &check_spike_dimension(
@@ -0,0 +1,93 @@
+/*
+  Copyright (C) 2019 Steven L. Scott
+
+  This library is free software; you can redistribute it and/or modify it under
+  the terms of the GNU Lesser General Public License as published by the Free
+  Software Foundation; either version 2.1 of the License, or (at your option)
+  any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT
+  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+  FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+  details.
+
+  You should have received a copy of the GNU Lesser General Public License along
+  with this library; if not, write to the Free Software Foundation, Inc., 51
+  Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+*/
+
+#include "Models/Glm/PosteriorSamplers/LogisticRegressionPolyaGammaSampler.hpp"
+#include "distributions.hpp"
+
+namespace BOOM {
+  namespace {
+    typedef LogisticRegressionPolyaGammaSampler LRPGS;
+  }  // namespace
+
+  namespace LogisticRegressionPolyaGamma {
+    ImputeWorker::ImputeWorker(BinomialLogit::SufficientStatistics &global_suf,
+                               std::mutex &global_suf_mutex,
+                               const LogisticRegressionModel *model,
+                               RNG *rng, RNG &seeding_rng)
+        : SufstatImputeWorker<BinaryRegressionData,
+                              BinomialLogit::SufficientStatistics>(
+                                  global_suf, global_suf_mutex, rng,
+                                  seeding_rng),
+          model_(model) {}
+
+    void ImputeWorker::impute_latent_data_point(
+        const BinaryRegressionData &observation,
+        BinomialLogit::SufficientStatistics *suf,
+        RNG &rng) {
+      const Vector &x(observation.x());
+      double log_alpha = model_->log_alpha();
+      double eta = model_->predict(x) + log_alpha;
+      double omega = rpolya_gamma_mt(rng, 1.0, eta);
+      // Given omega, (y - 1/2) / omega ~ N(x * beta + log_alpha, 1 / omega).
+      double kappa = observation.y() ? 0.5 : -0.5;
+      suf->update(x, kappa - omega * log_alpha, omega);
+    }
+  }  // namespace LogisticRegressionPolyaGamma
+
+  using LogisticRegressionPolyaGamma::ImputeWorker;
+
+  LRPGS::LogisticRegressionPolyaGammaSampler(LogisticRegressionModel *model,
+                                             const Ptr<MvnBase> &prior,
+                                             RNG &seeding_rng)
+      : PosteriorSampler(seeding_rng),
+        model_(model),
+        prior_(prior),
+        suf_(model->xdim()) {
+    set_number_of_workers(1);
+  }
+
+  LRPGS *LRPGS::clone_to_new_host(Model *new_host) const {
+    return new LRPGS(dynamic_cast<LogisticRegressionModel *>(new_host),
+                     prior_->clone(),
+                     rng());
+  }
+
+  double LRPGS::logpri() const { return prior_->logp(model_->Beta()); }
+
+  void LRPGS::draw() {
+    impute_latent_data();
+    draw_params();
+  }
+
+  void LRPGS::draw_params() {
+    SpdMatrix ivar = prior_->siginv() + suf_.xtx();
+    Vector ivar_mu = suf_.xty() + prior_->siginv() * prior_->mu();
+    model_->set_Beta(rmvn_suf_mt(rng(), ivar, ivar_mu));
+  }
+
+  Ptr<ImputeWorker> LRPGS::create_worker(std::mutex &suf_mutex) {
+    return new ImputeWorker(suf_, suf_mutex, model_, nullptr, rng());
+  }
+
+  void LRPGS::clear_latent_data() { suf_.clear(); }
+
+  void LRPGS::assign_data_to_workers() {
+    BOOM::assign_data_to_workers(model_->dat(), workers());
+  }
+
+}  // namespace BOOM
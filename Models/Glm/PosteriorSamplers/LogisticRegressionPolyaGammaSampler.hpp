@@ -0,0 +1,97 @@
+/*
+  Copyright (C) 2019 Steven L. Scott
+
+  This library is free software; you can redistribute it and/or modify it under
+  the terms of the GNU Lesser General Public License as published by the Free
+  Software Foundation; either version 2.1 of the License, or (at your option)
+  any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT
+  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+  FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+  details.
+
+  You should have received a copy of the GNU Lesser General Public License along
+  with this library; if not, write to the Free Software Foundation, Inc., 51
+  Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+*/
+
+#ifndef BOOM_LOGISTIC_REGRESSION_POLYA_GAMMA_SAMPLER_HPP_
+#define BOOM_LOGISTIC_REGRESSION_POLYA_GAMMA_SAMPLER_HPP_
+
+#include "Models/Glm/LogisticRegressionModel.hpp"
+#include "Models/Glm/PosteriorSamplers/BinomialLogitAuxmixSampler.hpp"
+#include "Models/MvnBase.hpp"
+#include "Models/PosteriorSamplers/Imputer.hpp"
+#include "Models/PosteriorSamplers/PosteriorSampler.hpp"
+
+namespace BOOM {
+  namespace LogisticRegressionPolyaGamma {
+    // Imputes omega ~ PG(1, eta) for each observation, where eta is the
+    // linear predictor (including the model's log_alpha offset).  The
+    // complete data sufficient statistics are those of a weighted regression
+    // of (y - 1/2) / omega on x, with weights omega.
+    class ImputeWorker
+        : public SufstatImputeWorker<BinaryRegressionData,
+                                     BinomialLogit::SufficientStatistics> {
+     public:
+      // Args:
+      //   global_suf: The complete data sufficient statistics held by the
+      //     primary sampler.
+      //   global_suf_mutex:  A mutex protecting global_suf.
+      //   model: The model whose latent data are to be imputed.
+      //   rng:  A random number generator or nullptr.
+      //   seeding_rng: A RNG used to initialize a new RNG in the case
+      //     that rng==nullptr.
+      ImputeWorker(BinomialLogit::SufficientStatistics &global_suf,
+                   std::mutex &global_suf_mutex,
+                   const LogisticRegressionModel *model,
+                   RNG *rng = nullptr,
+                   RNG &seeding_rng = GlobalRng::rng);
+
+      void impute_latent_data_point(const BinaryRegressionData &data,
+                                    BinomialLogit::SufficientStatistics *suf,
+                                    RNG &rng) override;
+
+     private:
+      const LogisticRegressionModel *model_;
+    };
+  }  // namespace LogisticRegressionPolyaGamma
+
+  //======================================================================
+  // Draws the coefficients of a LogisticRegressionModel given a multivariate
+  // normal prior, using the Polya-Gamma data augmentation scheme of Polson,
+  // Scott, and Windle (2013).  Only one latent variable is imputed per
+  // observation, and the conditional distribution of the coefficients given
+  // the latent data is exactly normal.
+  class LogisticRegressionPolyaGammaSampler
+      : public PosteriorSampler,
+        public LatentDataSampler<LogisticRegressionPolyaGamma::ImputeWorker> {
+   public:
+    LogisticRegressionPolyaGammaSampler(LogisticRegressionModel *model,
+                                        const Ptr<MvnBase> &prior,
+                                        RNG &seeding_rng = GlobalRng::rng);
+
+    LogisticRegressionPolyaGammaSampler *clone_to_new_host(
+        Model *new_host) const override;
+
+    double logpri() const override;
+    void draw() override;
+    void draw_params();
+
+    Ptr<LogisticRegressionPolyaGamma::ImputeWorker> create_worker(
+        std::mutex &m) override;
+    void clear_latent_data() override;
+    void assign_data_to_workers() override;
+
+    const BinomialLogit::SufficientStatistics &suf() const { return suf_; }
+
+   private:
+    LogisticRegressionModel *model_;
+    Ptr<MvnBase> prior_;
+    BinomialLogit::SufficientStatistics suf_;
+  };
+
+}  // namespace BOOM
+
+#endif  // BOOM_LOGISTIC_REGRESSION_POLYA_GAMMA_SAMPLER_HPP_
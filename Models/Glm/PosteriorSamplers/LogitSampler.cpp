@@ -32,7 +32,8 @@ namespace BOOM {
       : PosteriorSampler(seeding_rng),
         mod_(mod),
         pri_(pri),
-        suf_(new WeightedRegSuf(pri->dim())) {}
+        suf_(new WeightedRegSuf(pri->dim())),
+        posterior_mode_method_(NewtonRaphson) {}
 
   void LS::draw() {
     impute_latent_data();
@@ -80,6 +81,18 @@ namespace BOOM {
     d2LoglikeTF log_likelihood(mod_);
     d2LogPostTF logpost(log_likelihood, pri_);
     Vector b = mod_->Beta();
+    if (posterior_mode_method_ == LimitedMemoryBFGS) {
+      // Avoid forming the dim x dim Hessian required by Newton's method.
+      std::string error_message;
+      bool ok = max_nd1_careful(b, logpost_at_mode_, Target(logpost),
+                                dTarget(logpost), error_message, epsilon,
+                                500, LBFGS);
+      if (!ok) {
+        report_error(error_message);
+      }
+      mod_->set_Beta(b);
+      return;
+    }
     uint dim = b.size();
     Vector g(dim);
     Matrix h(dim, dim);
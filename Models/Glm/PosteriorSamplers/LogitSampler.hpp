@@ -39,6 +39,14 @@ namespace BOOM {
     void impute_latent_data();
     const Ptr<WeightedRegSuf> suf() const { return suf_; }
 
+    // Newton-Raphson needs the full Hessian of the log posterior, which is
+    // expensive when the number of predictors is large.  Limited memory BFGS
+    // needs only the gradient.
+    enum PosteriorModeMethod { NewtonRaphson, LimitedMemoryBFGS };
+    void set_posterior_mode_method(PosteriorModeMethod method) {
+      posterior_mode_method_ = method;
+    }
+
     void find_posterior_mode(double epsilon = 1e-5) override;
     bool can_find_posterior_mode() const override { return true; }
     double log_posterior_at_mode() const { return logpost_at_mode_; }
@@ -56,6 +64,7 @@ namespace BOOM {
     Vector ivar_mu;  // workspace:  stores un-normalized mean
 
     double logpost_at_mode_;
+    PosteriorModeMethod posterior_mode_method_;
   };
 
 }  // namespace BOOM
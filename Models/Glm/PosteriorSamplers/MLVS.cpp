@@ -32,6 +32,7 @@
 #include "cpputil/math_utils.hpp"
 #include "cpputil/seq.hpp"
 #include "distributions.hpp"  // for rlexp,dnorm,rmvn
+#include "numopt.hpp"
 #include "stats/logit.hpp"
 
 namespace BOOM {
@@ -52,7 +53,8 @@ namespace BOOM {
         log_sampling_probs_(mod_->log_sampling_probs()),
         downsampling_(log_sampling_probs_.size() == mod_->Nchoices()),
         select_(true),
-        max_nflips_(mod_->beta_size(false)) {
+        max_nflips_(mod_->beta_size(false)),
+        log_posterior_at_mode_(negative_infinity()) {
     if (check_initial_condition) {
       if (!std::isfinite(this->logpri())) {
         ostringstream err;
@@ -95,6 +97,34 @@ namespace BOOM {
     return ans;
   }
 
+  void MLVS::find_posterior_mode(double epsilon) {
+    const Selector &inc(mod_->coef().inc());
+    Vector beta = mod_->coef().included_coefficients();
+    if (beta.empty()) {
+      log_posterior_at_mode_ = mod_->log_likelihood();
+      return;
+    }
+    Target log_posterior = [this, &inc](const Vector &b) {
+      Vector g;
+      Matrix h;
+      return mod_->Loglike(b, g, h, 0) +
+             pri->logp_given_inclusion(b, nullptr, nullptr, inc, false);
+    };
+    dTarget log_posterior_gradient = [this, &inc](const Vector &b, Vector &g) {
+      Matrix h;
+      double ans = mod_->Loglike(b, g, h, 1);
+      return ans + pri->logp_given_inclusion(b, &g, nullptr, inc, false);
+    };
+    std::string error_message;
+    bool ok = max_nd1_careful(beta, log_posterior_at_mode_, log_posterior,
+                              log_posterior_gradient, error_message, epsilon,
+                              500, LBFGS);
+    if (!ok) {
+      report_error(error_message);
+    }
+    mod_->coef().set_included_coefficients(beta);
+  }
+
   //______________________________________________________________________
   // Drawing parameters
 
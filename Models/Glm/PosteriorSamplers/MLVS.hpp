@@ -76,6 +76,15 @@ namespace BOOM {
     // Part of the implementation for draw().
     void draw_beta();
 
+    // Sets the included coefficients of the model to the mode of their
+    // posterior distribution, given the current include/exclude pattern.
+    // The Hessian has one row per included coefficient, and one
+    // coefficient per predictor per choice, so the mode is found using
+    // limited memory BFGS, which only needs gradients.
+    void find_posterior_mode(double epsilon = 1e-5) override;
+    bool can_find_posterior_mode() const override { return true; }
+    double log_posterior_at_mode() const { return log_posterior_at_mode_; }
+
     // Functions to control Bayesian variable selection.  If
     // suppress_model_selection is called then the current
     // include/exclude state of the coefficients will not be modified
@@ -111,6 +120,7 @@ namespace BOOM {
 
     SpdMatrix Ominv;
     SpdMatrix iV_tilde_;
+    double log_posterior_at_mode_;
     virtual void draw_inclusion_vector();
     double log_model_prob(const Selector &inc);
   };
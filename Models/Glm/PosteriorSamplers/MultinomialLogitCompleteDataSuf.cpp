@@ -27,7 +27,11 @@ namespace BOOM {
     }
 
     MLVSS::CompleteDataSufficientStatistics(uint dim)
-        : xtwx_(dim), xtwu_(dim), sym_(false), weighted_sum_of_squares_(0.0) {}
+        : xtwx_(dim),
+          xtwu_(dim),
+          sym_(false),
+          weighted_sum_of_squares_(0.0),
+          xtwx_accumulator_(dim) {}
 
     MLVSS *MLVSS::clone() const { return new MLVSS(*this); }
 
@@ -36,13 +40,16 @@ namespace BOOM {
       xtwu_ = 0;
       weighted_sum_of_squares_ = 0.0;
       sym_ = false;
+      xtwx_accumulator_.clear();
     }
 
     void MLVSS::update(const ChoiceData &dp, const Vector &wgts,
                        const Vector &u) {
-      const Matrix &X(dp.X(false));     // 'false' means omit columns
-      xtwx_.add_inner(X, wgts, false);  // corresponding to subject X's at
-      xtwu_ += X.Tmult(wgts * u);       // choice level 0.
+      // 'false' means omit columns corresponding to subject X's at choice
+      // level 0.
+      const Matrix &X(dp.X(false));
+      xtwx_accumulator_.add(X, wgts, xtwx_);
+      xtwu_ += X.Tmult(wgts * u);
       sym_ = false;
       for (int i = 0; i < wgts.size(); ++i) {
         weighted_sum_of_squares_ += wgts[i] * square(u[i]);
@@ -57,8 +64,11 @@ namespace BOOM {
     }
 
     const SpdMatrix &MLVSS::xtwx() const {
-      if (!sym_) xtwx_.reflect();
-      sym_ = true;
+      if (!sym_) {
+        xtwx_accumulator_.flush(xtwx_);
+        xtwx_.reflect();
+        sym_ = true;
+      }
       return xtwx_;
     }
 
@@ -20,6 +20,7 @@
 #ifndef BOOM_MULTINOMIAL_LOGIT_COMPLETE_DATA_SUF_HPP_
 #define BOOM_MULTINOMIAL_LOGIT_COMPLETE_DATA_SUF_HPP_
 
+#include "LinAlg/CrossProductAccumulator.hpp"
 #include "LinAlg/SpdMatrix.hpp"
 #include "Models/Glm/ChoiceData.hpp"
 #include "cpputil/RefCounted.hpp"
@@ -45,6 +46,9 @@ namespace BOOM {
       Vector xtwu_;
       mutable bool sym_;
       double weighted_sum_of_squares_;
+      // Rows of the choice level design matrices are added to xtwx_ in
+      // blocks.  Pending rows are applied by xtwx().
+      mutable CrossProductAccumulator xtwx_accumulator_;
 
       friend void intrusive_ptr_add_ref(CompleteDataSufficientStatistics *w) {
         w->up_count();
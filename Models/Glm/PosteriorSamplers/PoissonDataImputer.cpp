@@ -51,7 +51,7 @@ namespace BOOM {
     double delta = exposure - time_of_final_internal_event;
     double z_external;
     if (safe_to_exp(log_lambda)) {
-      z_external = -log(delta + rexp_mt(rng, exp(log_lambda)));
+      z_external = -log(delta + rexp_ziggurat_mt(rng) / exp(log_lambda));
     } else {
       if (delta > 0) {
         // Handle cases where log lambda is really big or small.  Really big
@@ -71,10 +71,10 @@ namespace BOOM {
         // z = -log(D + E/lambda)
         //   = -lse2( log(D), log(E) - log_lambda)
         //   = -lse2( log(D),  -StandardExv - log(lambda))
-        double error = rexv_mt(rng, 0, 1);
+        double error = -log(rexp_ziggurat_mt(rng));
         z_external = -lse2(log(delta), -error - log_lambda);
       } else {
-        z_external = log_lambda + rexv_mt(rng, 0, 1);
+        z_external = log_lambda - log(rexp_ziggurat_mt(rng));
       }
     }
     double mu = 0;
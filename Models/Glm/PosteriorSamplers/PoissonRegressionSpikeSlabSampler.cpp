@@ -66,6 +66,10 @@ namespace BOOM {
     sam_.limit_model_selection(max_flips);
   }
 
+  void PRSS::use_incremental_cholesky(bool tf, int refactorization_interval) {
+    sam_.use_incremental_cholesky(tf, refactorization_interval);
+  }
+
   void PRSS::find_posterior_mode(double) {
     log_posterior_at_mode_ = negative_infinity();
     const Selector &included(model_->inc());
@@ -59,6 +59,12 @@ namespace BOOM {
     // inclusion indicators will be sampled.
     void limit_model_selection(int max_flips);
 
+    // Update the Cholesky decompositions used for model selection
+    // incrementally as variables enter and leave the model.  See
+    // SpikeSlabSampler::use_incremental_cholesky.
+    void use_incremental_cholesky(bool tf = true,
+                                  int refactorization_interval = 100);
+
     // Sets the coefficients in model_ to their posterior mode, and
     // saves the value of the un-normalized log-posterior at the
     // mode.  The optimization is with respect to coefficients that
@@ -18,6 +18,7 @@
 */
 
 #include "Models/Glm/PosteriorSamplers/SpikeSlabSampler.hpp"
+#include "LinAlg/Cholesky.hpp"
 #include "cpputil/math_utils.hpp"
 #include "cpputil/seq.hpp"
 #include "distributions.hpp"
@@ -34,7 +35,8 @@ namespace BOOM {
         slab_prior_(slab_prior),
         spike_prior_(spike_prior),
         max_flips_(-1),
-        allow_model_selection_(true) {}
+        allow_model_selection_(true),
+        use_incremental_cholesky_(false) {}
 
   // Performs one MCMC sweep along the provided set of inclusion indicators.
   void SSS::draw_inclusion_indicators(
@@ -73,11 +75,19 @@ namespace BOOM {
       report_error(err.str());
     }
 
+    bool incremental = use_incremental_cholesky_ &&
+        prepare_incremental_sweep(inclusion_indicators, suf, sigsq);
+
     uint n = inclusion_indicators.nvars_possible();
     if (max_flips_ > 0) n = std::min<int>(n, max_flips_);
     for (int i = 0; i < n; ++i) {
-      logp = mcmc_one_flip(
-          rng, inclusion_indicators, indx[i], logp, suf, sigsq);
+      if (incremental) {
+        logp = mcmc_one_flip_incremental(
+            rng, inclusion_indicators, indx[i], logp, sigsq);
+      } else {
+        logp = mcmc_one_flip(
+            rng, inclusion_indicators, indx[i], logp, suf, sigsq);
+      }
     }
   }
 
@@ -123,17 +133,38 @@ namespace BOOM {
       }
       return;
     }
-    SpdMatrix precision = inclusion_indicators.select(slab_prior_->siginv());
-    Vector precision_mu =
-        precision * inclusion_indicators.select(slab_prior_->mu());
-    precision += inclusion_indicators.select(suf.xtx()) / sigsq;
-    precision_mu += inclusion_indicators.select(suf.xty()) / sigsq;
-    Vector mean = precision.solve(precision_mu);
-    Vector draw = rmvn_ivar_mt(rng, mean, precision);
+    SpdMatrix &precision(inclusion_indicators.select(
+        slab_prior_->siginv(), precision_workspace_));
+    inclusion_indicators.select(slab_prior_->mu(), mu_workspace_);
+    Vector &precision_mu(precision_mu_workspace_);
+    precision_mu.resize(mu_workspace_.size());
+    precision.mult(mu_workspace_, precision_mu);
+    suf.xtx(inclusion_indicators, xtx_workspace_);
+    xtx_workspace_ /= sigsq;
+    precision += xtx_workspace_;
+    suf.xty(inclusion_indicators, xty_workspace_);
+    precision_mu.axpy(xty_workspace_, 1.0 / sigsq);
+
+    // Factor the posterior precision in place, so that precision = L * L^T.
+    if (!chol_inplace(precision)) {
+      report_error("The posterior precision matrix in SpikeSlabSampler "
+                   "is not positive definite.");
+    }
+    const Matrix &L(precision);
+    Vector &mean(precision_mu);
+    Lsolve_inplace(L, mean);
+    LTsolve_inplace(L, mean);
+
+    // If z ~ N(0, I) then L^{-T} z has variance (L * L^T)^{-1}.
+    Vector &draw(full_set ? draw_workspace_ : coefficients);
+    draw.resize(mean.size());
+    for (int i = 0; i < draw.size(); ++i) {
+      draw[i] = rnorm_mt(rng, 0, 1);
+    }
+    LTsolve_inplace(L, draw);
+    draw += mean;
     if (full_set) {
       coefficients = inclusion_indicators.expand(draw);
-    } else {
-      coefficients = draw;
     }
   }
 
@@ -168,6 +199,13 @@ namespace BOOM {
 
   void SSS::limit_model_selection(int max_flips) { max_flips_ = max_flips; }
 
+  void SSS::use_incremental_cholesky(bool tf, int refactorization_interval) {
+    use_incremental_cholesky_ = tf;
+    prior_precision_cholesky_ = IncrementalCholesky(refactorization_interval);
+    posterior_precision_cholesky_ =
+        IncrementalCholesky(refactorization_interval);
+  }
+
   double SSS::log_model_prob(const Selector &inclusion_indicators,
                              const WeightedRegSuf &suf, double sigsq) const {
     double numerator = spike_prior_->logp(inclusion_indicators);
@@ -182,20 +220,28 @@ namespace BOOM {
       // case below.
       return numerator;
     }
-    SpdMatrix precision = inclusion_indicators.select(slab_prior_->siginv());
+    SpdMatrix &precision(inclusion_indicators.select(
+        slab_prior_->siginv(), precision_workspace_));
     numerator += .5 * precision.logdet();
     if (numerator == BOOM::negative_infinity()) return numerator;
 
-    Vector mu = inclusion_indicators.select(slab_prior_->mu());
-    Vector precision_mu = precision * mu;
+    const Vector &mu(
+        inclusion_indicators.select(slab_prior_->mu(), mu_workspace_));
+    precision_mu_workspace_.resize(mu.size());
+    const Vector &precision_mu(precision.mult(mu, precision_mu_workspace_));
     numerator -= .5 * mu.dot(precision_mu);
 
-    bool ok = true;
-    precision += inclusion_indicators.select(suf.xtx()) / sigsq;
-    Matrix L = precision.chol(ok);
-    if (!ok) return BOOM::negative_infinity();
+    suf.xtx(inclusion_indicators, xtx_workspace_);
+    xtx_workspace_ /= sigsq;
+    precision += xtx_workspace_;
+    // Factor the posterior precision in place, so that precision = L * L^T.
+    if (!chol_inplace(precision)) return BOOM::negative_infinity();
+    const Matrix &L(precision);
     double denominator = sum(log(L.diag()));  // = .5 log |precision|
-    Vector S = inclusion_indicators.select(suf.xty()) / sigsq + precision_mu;
+    Vector &S(xty_workspace_);
+    suf.xty(inclusion_indicators, S);
+    S /= sigsq;
+    S += precision_mu;
     Lsolve_inplace(L, S);
     denominator -= .5 * S.normsq();
     // S.normsq =  beta_tilde ^T V_tilde beta_tilde
@@ -215,4 +261,105 @@ namespace BOOM {
     return logp_new;
   }
 
+  bool SSS::prepare_incremental_sweep(const Selector &inclusion_indicators,
+                                      const WeightedRegSuf &suf,
+                                      double sigsq) const {
+    posterior_precision_ = suf.xtx();
+    posterior_precision_ /= sigsq;
+    posterior_precision_ += slab_prior_->siginv();
+    xty_ = suf.xty();
+    xty_ /= sigsq;
+    return prior_precision_cholesky_.decompose(
+               slab_prior_->siginv(), inclusion_indicators) &&
+        posterior_precision_cholesky_.decompose(
+            posterior_precision_, inclusion_indicators);
+  }
+
+  // Computes the same quantity as log_model_prob, but the determinants and
+  // quadratic forms come from O(k^2) updates to the Cholesky decompositions of
+  // the model before 'which_variable' was flipped.
+  double SSS::incremental_log_model_prob(const Selector &inclusion_indicators,
+                                         int which_variable,
+                                         double sigsq) const {
+    double ans = spike_prior_->logp(inclusion_indicators);
+    if (ans == BOOM::negative_infinity() ||
+        inclusion_indicators.nvars() == 0) {
+      return ans;
+    }
+    bool adding = inclusion_indicators[which_variable];
+    candidate_positions_ = posterior_precision_cholesky_.order();
+    int excluded = -1;
+    if (adding) {
+      candidate_positions_.push_back(which_variable);
+    } else {
+      excluded = posterior_precision_cholesky_.position(which_variable);
+    }
+
+    // posterior_precision_mu_ is xty / sigsq + prior_precision * prior_mean
+    // for the candidate model, in the order used by the Cholesky
+    // decompositions.  The element corresponding to a dropped variable is set
+    // to zero, and ignored.
+    const Vector &mu(slab_prior_->mu());
+    const SpdMatrix &siginv(slab_prior_->siginv());
+    int dim = candidate_positions_.size();
+    posterior_precision_mu_.resize(dim);
+    double mu_precision_mu = 0;
+    for (int i = 0; i < dim; ++i) {
+      double element = 0;
+      if (i != excluded) {
+        int I = candidate_positions_[i];
+        for (int j = 0; j < dim; ++j) {
+          if (j != excluded) {
+            int J = candidate_positions_[j];
+            element += siginv(J, I) * mu[J];
+          }
+        }
+        mu_precision_mu += mu[I] * element;
+        posterior_precision_mu_[i] = xty_[I] + element;
+      } else {
+        posterior_precision_mu_[i] = 0.0;
+      }
+    }
+
+    double prior_logdet, posterior_logdet, quadratic_form;
+    if (adding) {
+      prior_logdet = prior_precision_cholesky_.evaluate_add(which_variable);
+      posterior_logdet = posterior_precision_cholesky_.evaluate_add(
+          which_variable, &posterior_precision_mu_, &quadratic_form);
+    } else {
+      prior_logdet = prior_precision_cholesky_.evaluate_drop(which_variable);
+      posterior_logdet = posterior_precision_cholesky_.evaluate_drop(
+          which_variable, &posterior_precision_mu_, &quadratic_form);
+    }
+    if (prior_logdet == BOOM::negative_infinity() ||
+        posterior_logdet == BOOM::negative_infinity()) {
+      return BOOM::negative_infinity();
+    }
+    ans += .5 * prior_logdet - .5 * mu_precision_mu;
+    ans -= .5 * posterior_logdet - .5 * quadratic_form;
+    return ans;
+  }
+
+  double SSS::mcmc_one_flip_incremental(RNG &rng, Selector &mod, int which_var,
+                                        double logp_old, double sigsq) const {
+    mod.flip(which_var);
+    double logp_new = incremental_log_model_prob(mod, which_var, sigsq);
+    double u = runif_mt(rng, 0, 1);
+    if (log(u) > logp_new - logp_old) {
+      mod.flip(which_var);  // reject draw
+      return logp_old;
+    }
+    if (mod[which_var]) {
+      if (!prior_precision_cholesky_.add(which_var) ||
+          !posterior_precision_cholesky_.add(which_var)) {
+        report_error("Incremental Cholesky update failed in "
+                     "SpikeSlabSampler.");
+      }
+    } else {
+      prior_precision_cholesky_.drop(which_var);
+      posterior_precision_cholesky_.drop(which_var);
+    }
+    return logp_new;
+  }
+
 }  // namespace BOOM
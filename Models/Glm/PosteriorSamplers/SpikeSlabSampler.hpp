@@ -20,6 +20,7 @@
 #ifndef BOOM_GLM_SPIKE_SLAB_SAMPLER_HPP_
 #define BOOM_GLM_SPIKE_SLAB_SAMPLER_HPP_
 
+#include "LinAlg/IncrementalCholesky.hpp"
 #include "Models/Glm/Glm.hpp"
 #include "Models/Glm/VariableSelectionPrior.hpp"
 #include "Models/Glm/WeightedRegressionModel.hpp"
@@ -131,6 +132,20 @@ namespace BOOM {
     // inclusion indicators will be sampled.
     void limit_model_selection(int max_flips);
 
+    // Each proposed flip in draw_inclusion_indicators requires the Cholesky
+    // decomposition of the included block of the posterior precision matrix,
+    // which costs O(k^3) when k variables are included.  If incremental
+    // updates are turned on then the decomposition is computed once per sweep
+    // and updated in O(k^2) as variables enter and leave the model.
+    //
+    // Args:
+    //   tf:  Turns incremental updating on (true) or off (false).
+    //   refactorization_interval: The number of incremental updates after
+    //     which the decomposition is recomputed from scratch, to keep rounding
+    //     errors from accumulating.
+    void use_incremental_cholesky(bool tf = true,
+                                  int refactorization_interval = 100);
+
    private:
     // Compute the log of the marginal posterior probability of model 'g'.
     // Args:
@@ -161,11 +176,49 @@ namespace BOOM {
                          double logp_old, const WeightedRegSuf &suf,
                          double sigsq = 1.0) const;
 
+    // Set up the incremental Cholesky decompositions at the start of a sweep.
+    // Returns false if either of the relevant matrices is not positive
+    // definite, in which case the sweep should use the non-incremental
+    // algorithm.
+    bool prepare_incremental_sweep(const Selector &g, const WeightedRegSuf &suf,
+                                   double sigsq) const;
+
+    // Versions of log_model_prob and mcmc_one_flip that use (and in the case
+    // of mcmc_one_flip, maintain) the incremental Cholesky decompositions.
+    // The incremental log_model_prob is called after element 'which_variable'
+    // of 'g' has been flipped, but before the decompositions are updated.
+    double incremental_log_model_prob(const Selector &g, int which_variable,
+                                      double sigsq) const;
+    double mcmc_one_flip_incremental(RNG &rng, Selector &g, int which_variable,
+                                     double logp_old, double sigsq) const;
+
     GlmModel *model_;
     Ptr<MvnBase> slab_prior_;
     Ptr<VariableSelectionPrior> spike_prior_;
     int max_flips_;
     bool allow_model_selection_;
+    bool use_incremental_cholesky_;
+
+    // Workspace for incremental model selection.  The Cholesky decompositions
+    // refer to slab_prior_->siginv() and to posterior_precision_, which are
+    // refreshed at the start of each sweep.
+    mutable SpdMatrix posterior_precision_;
+    mutable Vector xty_;
+    mutable IncrementalCholesky prior_precision_cholesky_;
+    mutable IncrementalCholesky posterior_precision_cholesky_;
+    mutable std::vector<int> candidate_positions_;
+    mutable Vector posterior_precision_mu_;
+
+    // Workspace for log_model_prob() and draw_coefficients_given_inclusion(),
+    // which are called once per candidate model.  Reusing these avoids
+    // allocating several matrices and vectors for each flip.  The posterior
+    // precision is Cholesky factored in place in precision_workspace_.
+    mutable SpdMatrix precision_workspace_;
+    mutable SpdMatrix xtx_workspace_;
+    mutable Vector mu_workspace_;
+    mutable Vector precision_mu_workspace_;
+    mutable Vector xty_workspace_;
+    mutable Vector draw_workspace_;
   };
 
 }  // namespace BOOM
@@ -29,4 +29,15 @@ namespace BOOM {
     return rgamma_mt(rng, 0.5 * (nu + 1), 0.5 * (nu + square(delta)));
   }
 
+  void TDataImputer::impute(RNG &rng, const Vector &residuals, double sd,
+                            double nu, Vector &weights) const {
+    int n = residuals.size();
+    weights.resize(n);
+    rgamma_mt(rng, weights, 0.5 * (nu + 1), 1.0);
+    double precision = 1.0 / square(sd);
+    for (int i = 0; i < n; ++i) {
+      weights[i] /= 0.5 * (nu + square(residuals[i]) * precision);
+    }
+  }
+
 }  // namespace BOOM
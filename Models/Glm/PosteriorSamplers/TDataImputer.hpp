@@ -20,6 +20,7 @@
 #ifndef BOOM_T_DATA_IMPUTER_HPP_
 #define BOOM_T_DATA_IMPUTER_HPP_
 
+#include "LinAlg/Vector.hpp"
 #include "distributions/rng.hpp"
 
 namespace BOOM {
@@ -52,6 +53,20 @@ namespace BOOM {
     // Returns:
     //   A random draw of w from its posterior distribution.
     double impute(RNG &rng, double residual, double sd, double df) const;
+
+    // Impute the weights for a collection of observations sharing the same
+    // sd and nu.  The shape parameter of the posterior is the same for each
+    // observation, so the draws can be made in a single batch.
+    //
+    // Args:
+    //   rng:  A random number generator.
+    //   residuals:  The values of y-mu for each observation.
+    //   sd:  s in the comment above.
+    //   nu:  nu in the comment above.
+    //   weights: On output, weights[i] is a draw of w for the observation with
+    //     residuals[i].  Resized if needed.
+    void impute(RNG &rng, const Vector &residuals, double sd, double nu,
+                Vector &weights) const;
   };
 
 }  // namespace BOOM
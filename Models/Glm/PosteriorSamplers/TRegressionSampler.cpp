@@ -126,14 +126,17 @@ namespace BOOM {
       complete_data_sufficient_statistics_.clear();
       weight_model_->suf()->clear();
       const std::vector<Ptr<RegressionData> > &data(model_->dat());
+      Vector residuals(data.size());
       for (int i = 0; i < data.size(); ++i) {
-        double mu = model_->predict(data[i]->x());
-        double residual = data[i]->y() - mu;
-        double weight = data_imputer_.impute(rng(), residual, model_->sigma(),
-                                             model_->nu());
-        weight_model_->suf()->update_raw(weight);
+        residuals[i] = data[i]->y() - model_->predict(data[i]->x());
+      }
+      Vector weights;
+      data_imputer_.impute(rng(), residuals, model_->sigma(), model_->nu(),
+                           weights);
+      for (int i = 0; i < data.size(); ++i) {
+        weight_model_->suf()->update_raw(weights[i]);
         complete_data_sufficient_statistics_.add_data(data[i]->x(),
-                                                      data[i]->y(), weight);
+                                                      data[i]->y(), weights[i]);
       }
     }
   }
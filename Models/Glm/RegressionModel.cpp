@@ -405,6 +405,35 @@ namespace BOOM {
     x_column_sums_.axpy(tmpx, 1.0);
   }
 
+  void NeRegSuf::Remove(const RegressionData &rdp) {
+    remove(rdp.y(), ConstVectorView(rdp.x()));
+  }
+
+  void NeRegSuf::store_removal_values(const RegressionData &rdp,
+                                      VectorView dest) const {
+    dest[0] = rdp.y();
+    VectorView(dest, 1) = rdp.x();
+  }
+
+  void NeRegSuf::remove_stored_values(const ConstVectorView &values) {
+    remove(values[0], ConstVectorView(values, 1));
+  }
+
+  void NeRegSuf::remove(double y, const ConstVectorView &x) {
+    if (x.size() != xty_.size()) {
+      report_error("Wrong size predictor passed to NeRegSuf::Remove().");
+    }
+    --n_;
+    xty_.axpy(x, -y);
+    if (!xtx_is_fixed_) {
+      xtx_.add_outer(x, -1.0, false);
+      needs_to_reflect_ = true;
+    }
+    sumsqy_ -= y * y;
+    sumy_ -= y;
+    x_column_sums_.axpy(x, -1.0);
+  }
+
   uint NeRegSuf::size() const { return xtx_.ncol(); }  // dim(beta)
   SpdMatrix NeRegSuf::xtx() const {
     reflect();
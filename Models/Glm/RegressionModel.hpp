@@ -187,6 +187,16 @@ namespace BOOM {
     void add_mixture_data(double y, const ConstVectorView &x,
                           double prob) override;
     void Update(const RegressionData &rdp) override;
+    bool can_remove() const override { return true; }
+    void Remove(const RegressionData &rdp) override;
+
+    // The stored values are y followed by x.
+    int removal_size(const RegressionData &rdp) const override {
+      return 1 + rdp.xdim();
+    }
+    void store_removal_values(const RegressionData &rdp,
+                              VectorView dest) const override;
+    void remove_stored_values(const ConstVectorView &values) override;
     uint size() const override;  // dimension of beta
     double yty() const override;
     Vector xty() const override;
@@ -219,6 +229,10 @@ namespace BOOM {
     }
 
    private:
+    // Remove the contribution of an observation with response y and
+    // predictors x.
+    void remove(double y, const ConstVectorView &x);
+
     mutable SpdMatrix xtx_;
     mutable bool needs_to_reflect_;
     Vector xty_;
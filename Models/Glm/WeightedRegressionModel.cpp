@@ -38,7 +38,7 @@ namespace BOOM {
 
   WRS::WeightedRegSuf(const Matrix &X, const Vector &y, const Vector &w) {
     Matrix tmpx = add_intercept(X);
-    uint p = tmpx.nrow();
+    uint p = tmpx.ncol();
     setup_mat(p);
     if (w.empty()) {
       recompute(tmpx, y, Vector(y.size(), 1.0));
@@ -67,6 +67,7 @@ namespace BOOM {
   }
 
   void WRS::combine(const Ptr<WRS> &s) {
+    if (!s->sym_) s->make_symmetric();
     xtwx_ += s->xtwx_;
     xtwy_ += s->xtwy_;
     n_ += s->n_;
@@ -77,6 +78,7 @@ namespace BOOM {
   }
 
   void WRS::combine(const WRS &s) {
+    if (!s.sym_) s.make_symmetric();
     xtwx_ += s.xtwx_;
     xtwy_ += s.xtwy_;
     n_ += s.n_;
@@ -91,6 +93,7 @@ namespace BOOM {
   }
 
   Vector WRS::vectorize(bool minimal) const {
+    if (!sym_) make_symmetric();
     Vector ans = xtwx_.vectorize(minimal);
     ans.concat(xtwy_);
     ans.push_back(n_);
@@ -101,6 +104,7 @@ namespace BOOM {
   }
 
   Vector::const_iterator WRS::unvectorize(Vector::const_iterator &v, bool) {
+    xtwx_accumulator_.clear();
     xtwx_.unvectorize(v);
     uint dim = xtwy_.size();
     xtwy_.assign(v, v + dim);
@@ -126,13 +130,22 @@ namespace BOOM {
     xtwx_ = SpdMatrix(p, 0.0);
     xtwy_ = Vector(p, 0.0);
     sym_ = false;
+    xtwx_accumulator_ = CrossProductAccumulator(p);
   }
 
   void WRS::recompute(const Matrix &X, const Vector &y, const Vector &w) {
     uint n = w.size();
     assert(y.size() == n && X.nrow() == n);
     clear();
-    for (uint i = 0; i < n; ++i) add_data(X.row(i), y[i], w[i]);
+    add_weighted_cross_product(xtwx_, X, w);
+    for (uint i = 0; i < n; ++i) {
+      ++n_;
+      yt_w_y_ += w[i] * y[i] * y[i];
+      sumw_ += w[i];
+      sumlogw_ += log(w[i]);
+      xtwy_.axpy(X.row(i), w[i] * y[i]);
+    }
+    sym_ = true;
   }
 
   void WRS::recompute(const std::vector<Ptr<WeightedRegressionData>> &data) {
@@ -141,12 +154,16 @@ namespace BOOM {
   }
 
   //------------------------------------------------------------
-  void WRS::set_xtwx(const SpdMatrix &xtwx) { xtwx_ = xtwx; }
+  void WRS::set_xtwx(const SpdMatrix &xtwx) {
+    xtwx_accumulator_.clear();
+    xtwx_ = xtwx;
+  }
 
   void WRS::set_xtwy(const Vector &xtwy) { xtwy_ = xtwy; }
 
   void WRS::reset(const SpdMatrix &xtwx, const Vector &xtwy, double ytwy,
                   double sample_size, double sum_weights, double sum_log_weights) {
+    xtwx_accumulator_.clear();
     xtwx_ = xtwx;
     xtwy_ = xtwy;
     n_ = sample_size;
@@ -163,7 +180,7 @@ namespace BOOM {
     yt_w_y_ += w * y * y;
     sumw_ += w;
     sumlogw_ += log(w);
-    xtwx_.add_outer(x, w, false);
+    xtwx_accumulator_.add(x, w, xtwx_);
     xtwy_.axpy(x, w * y);
     sym_ = false;
   }
@@ -181,6 +198,7 @@ namespace BOOM {
     xtwy_ = 0.0;
     sumw_ = yt_w_y_ = n_ = sumlogw_ = 0.0;
     sym_ = false;
+    xtwx_accumulator_.clear();
   }
 
   void WRS::Update(const WRD &d) { add_data(d.x(), d.y(), d.weight()); }
@@ -194,12 +212,25 @@ namespace BOOM {
     return xtwx_;
   }
   void WRS::make_symmetric() const {
+    xtwx_accumulator_.flush(xtwx_);
     xtwx_.reflect();
     sym_ = true;
   }
 
   Vector WRS::xty(const Selector &inc) const { return inc.select(xtwy_); }
-  SpdMatrix WRS::xtx(const Selector &inc) const { return inc.select(xtx()); }
+  SpdMatrix WRS::xtx(const Selector &inc) const {
+    if (!sym_) make_symmetric();
+    return inc.select(xtwx_);
+  }
+
+  void WRS::xtx(const Selector &inc, SpdMatrix &ans) const {
+    if (!sym_) make_symmetric();
+    inc.select(xtwx_, ans);
+  }
+
+  void WRS::xty(const Selector &inc, Vector &ans) const {
+    inc.select(xtwy_, ans);
+  }
 
   Vector WRS::beta_hat() const { return xtx().solve(xtwy_); }
 
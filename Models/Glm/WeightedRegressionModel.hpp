@@ -20,6 +20,7 @@
 #ifndef BOOM_WEIGHTED_REGRESSION_MODEL_HPP
 #define BOOM_WEIGHTED_REGRESSION_MODEL_HPP
 
+#include "LinAlg/CrossProductAccumulator.hpp"
 #include "Models/Glm/Glm.hpp"
 #include "Models/Glm/RegressionModel.hpp"
 
@@ -83,6 +84,12 @@ namespace BOOM {
     virtual SpdMatrix xtx() const;                  // X^T W X
     virtual Vector xty(const Selector &) const;     // X^T W Y
     virtual SpdMatrix xtx(const Selector &) const;  // X^T W X
+
+    // Fill 'ans' with the subset of X^T W X (or X^T W Y) selected by 'inc',
+    // reusing the memory already held by 'ans'.
+    void xtx(const Selector &inc, SpdMatrix &ans) const;
+    void xty(const Selector &inc, Vector &ans) const;
+
     virtual Vector beta_hat() const;                // WLS estimate
     double weighted_sum_of_squared_errors(const Vector &beta) const;
     virtual double SSE() const;   //
@@ -111,7 +118,13 @@ namespace BOOM {
     double sumlogw_;
     mutable bool sym_;
 
+    // Observations are added to xtwx_ in blocks.  Pending observations are
+    // applied by make_symmetric().
+    mutable CrossProductAccumulator xtwx_accumulator_;
+
     void setup_mat(uint p);
+
+    // Apply any pending observations to xtwx_ and fill in its lower triangle.
     void make_symmetric() const;
   };
 
@@ -0,0 +1,108 @@
+/*
+  Copyright (C) 2019 Steven L. Scott
+
+  This library is free software; you can redistribute it and/or modify it under
+  the terms of the GNU Lesser General Public License as published by the Free
+  Software Foundation; either version 2.1 of the License, or (at your option)
+  any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT
+  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+  FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+  details.
+
+  You should have received a copy of the GNU Lesser General Public License along
+  with this library; if not, write to the Free Software Foundation, Inc., 51
+  Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+*/
+
+// Compares the auxiliary mixture and Polya-Gamma data augmentation schemes for
+// binomial logit regression.  Each benchmark iteration runs a short MCMC chain
+// on simulated data with rare successes, where the two schemes differ most.
+// Along with the time per chain, the "ess_per_second" counter reports the
+// effective number of draws of the slowest mixing coefficient per second of
+// run time, which is the number that matters when choosing between them.  The
+// benchmark argument is the number of observations.
+
+#include "benchmark/benchmark.h"
+#include "distributions.hpp"
+#include "Models/Glm/BinomialLogitModel.hpp"
+#include "Models/Glm/PosteriorSamplers/BinomialLogitAuxmixSampler.hpp"
+#include "Models/MvnModel.hpp"
+#include "stats/acf.hpp"
+
+namespace {
+  using namespace BOOM;
+
+  const int kChainLength = 200;
+  const int kMaxLag = 40;
+
+  // The effective sample size of a sequence of MCMC draws, using the initial
+  // positive sequence of autocorrelations.
+  double effective_sample_size(const ConstVectorView &draws) {
+    Vector rho = acf(draws, kMaxLag);
+    double tau = 1.0;
+    for (int lag = 1; lag < rho.size(); ++lag) {
+      if (rho[lag] <= 0) break;
+      tau += 2 * rho[lag];
+    }
+    return draws.size() / tau;
+  }
+
+  void run_chain(benchmark::State &state, bool polya_gamma) {
+    GlobalRng::rng.seed(8675309);
+    int nobs = state.range(0);
+    int xdim = 5;
+    Matrix X(nobs, xdim);
+    X.randomize_gaussian(0, 1);
+    X.col(0) = 1.0;
+    Vector beta(xdim, 0.5);
+    beta[0] = -4.0;
+    Vector eta = X * beta;
+    Vector y(nobs);
+    Vector trials(nobs, 1.0);
+    for (int i = 0; i < nobs; ++i) {
+      y[i] = runif() < plogis(eta[i]);
+    }
+
+    NEW(BinomialLogitModel, model)(X, y, trials);
+    NEW(MvnModel, prior)(xdim, 0.0, 10.0);
+    NEW(BinomialLogitAuxmixSampler, sampler)(model.get(), prior);
+    sampler->use_polya_gamma_augmentation(polya_gamma);
+    model->set_method(sampler);
+
+    Matrix draws(kChainLength, xdim);
+    double total_ess = 0;
+    for (auto _ : state) {
+      model->set_Beta(beta);
+      for (int i = 0; i < kChainLength; ++i) {
+        model->sample_posterior();
+        draws.row(i) = model->Beta();
+      }
+      double ess = kChainLength;
+      for (int j = 0; j < xdim; ++j) {
+        ess = std::min(ess, effective_sample_size(draws.col(j)));
+      }
+      total_ess += ess;
+    }
+    state.counters["ess_per_second"] =
+        benchmark::Counter(total_ess, benchmark::Counter::kIsRate);
+    state.SetItemsProcessed(state.iterations() * kChainLength);
+  }
+
+  void BM_AuxmixLogit(benchmark::State &state) {
+    run_chain(state, false);
+  }
+
+  void BM_PolyaGammaLogit(benchmark::State &state) {
+    run_chain(state, true);
+  }
+
+  BENCHMARK(BM_AuxmixLogit)
+      ->Arg(1000)->Arg(10000)->Unit(benchmark::kMillisecond);
+  BENCHMARK(BM_PolyaGammaLogit)
+      ->Arg(1000)->Arg(10000)->Unit(benchmark::kMillisecond);
+
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,83 @@
+/*
+  Copyright (C) 2019 Steven L. Scott
+
+  This library is free software; you can redistribute it and/or modify it under
+  the terms of the GNU Lesser General Public License as published by the Free
+  Software Foundation; either version 2.1 of the License, or (at your option)
+  any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT
+  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+  FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+  details.
+
+  You should have received a copy of the GNU Lesser General Public License along
+  with this library; if not, write to the Free Software Foundation, Inc., 51
+  Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+*/
+
+// Timings for one sweep of SpikeSlabSampler::draw_model_indicators.  The
+// benchmark argument is the number of candidate predictors.  The data are
+// simulated from a fixed seed, and each benchmark restarts the sampler's RNG
+// from a fixed seed, so the sequence of models visited is the same from run
+// to run.
+
+#include "benchmark/benchmark.h"
+#include "distributions.hpp"
+#include "Models/Glm/PosteriorSamplers/SpikeSlabSampler.hpp"
+#include "Models/Glm/VariableSelectionPrior.hpp"
+#include "Models/Glm/WeightedRegressionModel.hpp"
+#include "Models/MvnModel.hpp"
+
+namespace {
+  using namespace BOOM;
+
+  void run_sweep(benchmark::State &state, bool incremental) {
+    GlobalRng::rng.seed(8675309);
+    int xdim = state.range(0);
+    int nobs = 10 * xdim;
+    Matrix X(nobs, xdim);
+    X.randomize_gaussian(0, 1);
+    X.col(0) = 1.0;
+    Vector beta(xdim, 0.0);
+    for (int i = 0; i < xdim; i += 10) {
+      beta[i] = rnorm(0, 3);
+    }
+    Vector y = X * beta;
+    for (int i = 0; i < nobs; ++i) {
+      y[i] += rnorm(0, 1);
+    }
+    WeightedRegSuf suf(xdim);
+    suf.recompute(X, y, Vector(nobs, 1.0));
+
+    NEW(WeightedRegressionModel, model)(xdim);
+    NEW(MvnModel, slab)(Vector(xdim, 0.0), suf.xtx() / nobs, true);
+    NEW(VariableSelectionPrior, spike)(xdim, 10.0 / xdim);
+    SpikeSlabSampler sampler(model.get(), slab, spike);
+    if (incremental) {
+      sampler.use_incremental_cholesky(true);
+    }
+    RNG rng(12345);
+    for (auto _ : state) {
+      sampler.draw_model_indicators(rng, suf, 1.0);
+      benchmark::DoNotOptimize(model->coef().inc().nvars());
+    }
+    state.SetItemsProcessed(state.iterations() * xdim);
+  }
+
+  void BM_DrawModelIndicators(benchmark::State &state) {
+    run_sweep(state, false);
+  }
+
+  void BM_DrawModelIndicatorsIncremental(benchmark::State &state) {
+    run_sweep(state, true);
+  }
+
+  BENCHMARK(BM_DrawModelIndicators)
+      ->Arg(20)->Arg(100)->Arg(400)->Unit(benchmark::kMillisecond);
+  BENCHMARK(BM_DrawModelIndicatorsIncremental)
+      ->Arg(20)->Arg(100)->Arg(400)->Unit(benchmark::kMillisecond);
+
+}  // namespace
+
+BENCHMARK_MAIN();
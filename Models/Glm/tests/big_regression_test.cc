@@ -179,6 +179,7 @@ namespace {
     NEW(BigAssSpikeSlabSampler, sampler)(
         model.get(), spike, slab_prototype, residual_precision_prior);
     model->set_method(sampler);
+    sampler->set_number_of_threads(4);
 
     bool use_threads = true;
     double inclusion_threshold = .10;
@@ -0,0 +1,150 @@
+#include "gtest/gtest.h"
+
+#include "Models/Glm/BinomialLogitModel.hpp"
+#include "Models/Glm/LogisticRegressionModel.hpp"
+#include "Models/Glm/VariableSelectionPrior.hpp"
+#include "Models/Glm/PosteriorSamplers/BinomialLogitAuxmixSampler.hpp"
+#include "Models/Glm/PosteriorSamplers/BinomialLogitSpikeSlabSampler.hpp"
+#include "Models/Glm/PosteriorSamplers/LogisticRegressionPolyaGammaSampler.hpp"
+#include "Models/MvnModel.hpp"
+#include "distributions.hpp"
+#include "stats/moments.hpp"
+
+#include "test_utils/test_utils.hpp"
+
+namespace {
+  using namespace BOOM;
+  using std::endl;
+
+  class PolyaGammaLogitTest : public ::testing::Test {
+   protected:
+    PolyaGammaLogitTest()
+        : sample_size_(500),
+          beta_{-1.0, 0.8, 0.0, -0.6},
+          niter_(400),
+          burn_(50)
+    {
+      GlobalRng::rng.seed(8675309);
+      int xdim = beta_.size();
+      X_.resize(sample_size_, xdim);
+      X_.randomize_gaussian();
+      X_.col(0) = 1.0;
+      Vector eta = X_ * beta_;
+      y_.resize(sample_size_);
+      trials_.resize(sample_size_);
+      binary_y_.resize(sample_size_);
+      for (int i = 0; i < sample_size_; ++i) {
+        double prob = plogis(eta[i]);
+        trials_[i] = 1 + (i % 4);
+        y_[i] = rbinom(trials_[i], prob);
+        binary_y_[i] = runif() < prob;
+      }
+      prior_.reset(new MvnModel(xdim, 0.0, 10.0));
+    }
+
+    int sample_size_;
+    Vector beta_;
+    int niter_;
+    int burn_;
+    Matrix X_;
+    Vector y_;
+    Vector trials_;
+    Vector binary_y_;
+    Ptr<MvnModel> prior_;
+  };
+
+  TEST_F(PolyaGammaLogitTest, BinomialLogit) {
+    NEW(BinomialLogitModel, model)(X_, y_, trials_);
+    NEW(BinomialLogitAuxmixSampler, sampler)(model.get(), prior_);
+    sampler->use_polya_gamma_augmentation();
+    EXPECT_TRUE(sampler->polya_gamma_augmentation());
+    sampler->set_number_of_workers(3);
+    model->set_method(sampler);
+
+    Matrix draws(niter_, beta_.size());
+    for (int i = 0; i < burn_; ++i) {
+      model->sample_posterior();
+    }
+    for (int i = 0; i < niter_; ++i) {
+      model->sample_posterior();
+      draws.row(i) = model->Beta();
+    }
+    auto status = CheckMcmcMatrix(draws, beta_);
+    EXPECT_TRUE(status.ok) << status;
+  }
+
+  // Imputing with observation streams makes the complete data sufficient
+  // statistics independent of the number of workers, up to the order in
+  // which the workers' contributions are summed.
+  TEST_F(PolyaGammaLogitTest, WorkerCountDoesNotMatter) {
+    NEW(BinomialLogitModel, model)(X_, y_, trials_);
+    model->set_Beta(beta_);
+    NEW(BinomialLogitAuxmixSampler, sampler)(model.get(), prior_);
+    sampler->use_polya_gamma_augmentation();
+
+    sampler->use_observation_streams(12345);
+    sampler->impute_latent_data();
+    SpdMatrix xtx = sampler->suf().xtx();
+    Vector xty = sampler->suf().xty();
+
+    sampler->set_number_of_workers(4);
+    EXPECT_TRUE(sampler->polya_gamma_augmentation());
+    sampler->use_observation_streams(12345);
+    sampler->impute_latent_data();
+    EXPECT_TRUE(MatrixEquals(xtx, sampler->suf().xtx(), 1e-8));
+    EXPECT_TRUE(VectorEquals(xty, sampler->suf().xty(), 1e-8));
+    EXPECT_EQ(sample_size_, sampler->suf().sample_size());
+  }
+
+  TEST_F(PolyaGammaLogitTest, SpikeSlab) {
+    NEW(BinomialLogitModel, model)(X_, y_, trials_);
+    NEW(VariableSelectionPrior, spike)(beta_.size(), 0.5);
+    NEW(BinomialLogitSpikeSlabSampler, sampler)(
+        model.get(), prior_, spike, 10);
+    sampler->use_polya_gamma_augmentation();
+    model->set_method(sampler);
+
+    Matrix draws(niter_, beta_.size());
+    for (int i = 0; i < burn_; ++i) {
+      model->sample_posterior();
+    }
+    for (int i = 0; i < niter_; ++i) {
+      model->sample_posterior();
+      draws.row(i) = model->Beta();
+    }
+    // The intercept and the large coefficients should always be included.
+    EXPECT_GT(min(abs(draws.col(0))), 0.0);
+    EXPECT_GT(min(abs(draws.col(1))), 0.0);
+    EXPECT_NEAR(mean(draws.col(1)), beta_[1], .3);
+    EXPECT_NEAR(mean(draws.col(3)), beta_[3], .3);
+
+    Ptr<BinomialLogitModel> clone = model->clone();
+    BinomialLogitSpikeSlabSampler *cloned_sampler =
+        sampler->clone_to_new_host(clone.get());
+    EXPECT_TRUE(cloned_sampler->polya_gamma_augmentation());
+    delete cloned_sampler;
+  }
+
+  TEST_F(PolyaGammaLogitTest, LogisticRegression) {
+    NEW(LogisticRegressionModel, model)(beta_.size());
+    for (int i = 0; i < sample_size_; ++i) {
+      NEW(BinaryRegressionData, data_point)(binary_y_[i] > 0, X_.row(i));
+      model->add_data(data_point);
+    }
+    NEW(LogisticRegressionPolyaGammaSampler, sampler)(model.get(), prior_);
+    sampler->set_number_of_workers(2);
+    model->set_method(sampler);
+
+    Matrix draws(niter_, beta_.size());
+    for (int i = 0; i < burn_; ++i) {
+      model->sample_posterior();
+    }
+    for (int i = 0; i < niter_; ++i) {
+      model->sample_posterior();
+      draws.row(i) = model->Beta();
+    }
+    auto status = CheckMcmcMatrix(draws, beta_);
+    EXPECT_TRUE(status.ok) << status;
+  }
+
+}  // namespace
@@ -562,19 +562,10 @@ namespace BOOM {
     return loglike;
   }
   //----------------------------------------------------------------------
-  struct ClickstreamSamplingImputer {
-    Ptr<NestedHmm> mod;
-    explicit ClickstreamSamplingImputer(const Ptr<NestedHmm> &m) : mod(m) {}
-    void operator()() { mod->impute_latent_data(); }
-  };
-  //----------------------------------------------------------------------
-  struct ClickstreamEmImputer {
-    explicit ClickstreamEmImputer(const Ptr<NestedHmm> &m) : mod(m) {}
-    Ptr<NestedHmm> mod;
-    void operator()() { mod->fwd_bkwd(false, false); }
-  };
-  //----------------------------------------------------------------------
   void NestedHmm::set_threads(int n) {
+    if (n > 0) {
+      WorkStealingThreadPool::global().set_minimum_number_of_threads(n);
+    }
     clear_workers();
     for (int i = 0; i < n; ++i) {
       NEW(NestedHmm, worker)(S2_, S1_, S0_);
@@ -590,16 +581,9 @@ namespace BOOM {
   }
   //----------------------------------------------------------------------
   void NestedHmm::start_thread_imputation() {
-    ThreadWorkerPool pool;
-    pool.add_threads(workers_.size());
-    std::vector<std::future<void>> futures;
-    for (int i = 0; i < workers_.size(); ++i){
-      ClickstreamSamplingImputer imputer(workers_[i]);
-      futures.emplace_back(pool.submit(imputer));
-    }
-    for (int i = 0; i < workers_.size(); ++i) {
-      futures[i].get();
-    }
+    WorkStealingThreadPool::global().parallel_for(
+        0, workers_.size(), 1,
+        [this](int i) { workers_[i]->impute_latent_data(); });
   }
   //----------------------------------------------------------------------
   void NestedHmm::add_worker(const Ptr<NestedHmm> &w) { workers_.push_back(w); }
@@ -615,16 +599,9 @@ namespace BOOM {
   }
   //----------------------------------------------------------------------
   void NestedHmm::start_thread_em() {
-    ThreadWorkerPool pool;
-    pool.add_threads(workers_.size());
-    std::vector<std::future<void>> futures;
-    for (int i = 0; i < workers_.size(); ++i) {
-      ClickstreamEmImputer imputer(workers_[i]);
-      futures.emplace_back(pool.submit(imputer));
-    }
-    for (int i = 0; i < workers_.size(); ++i) {
-      futures[i].get();
-    }
+    WorkStealingThreadPool::global().parallel_for(
+        0, workers_.size(), 1,
+        [this](int i) { workers_[i]->fwd_bkwd(false, false); });
   }
   //----------------------------------------------------------------------
   double NestedHmm::collect_threads() {
@@ -31,7 +31,6 @@
 #include "distributions.hpp"
 
 #include <cmath>
-#include <future>
 #include <stdexcept>
 
 namespace BOOM {
@@ -277,7 +276,9 @@ namespace BOOM {
   }
 
   void HMM::set_nthreads(uint n) {
-    thread_pool_.set_number_of_threads(n);
+    if (n > 0) {
+      WorkStealingThreadPool::global().set_minimum_number_of_threads(n);
+    }
     workers_.clear();
     for (uint i = 0; i < n; ++i) {
       NEW(HmmDataImputer, imp)(this, i, n);
@@ -287,32 +288,18 @@ namespace BOOM {
 
   uint HMM::nthreads() const { return workers_.size(); }
 
-  namespace {
-    class HmmWorkWrapper {
-     public:
-      explicit HmmWorkWrapper(const Ptr<HmmDataImputer> &worker)
-          : worker_(worker) {}
-      void operator()() { worker_->impute_data(); }
-
-     public:
-      Ptr<HmmDataImputer> worker_;
-    };
-  }  // namespace
-
   double HMM::impute_latent_data_with_threads() {
     try {
       clear_client_data();
-
-      std::vector<std::future<void>> futures;
       for (int i = 0; i < nthreads(); ++i) {
         workers_[i]->setup(this);
-        futures.emplace_back(thread_pool_.submit(HmmWorkWrapper(workers_[i])));
       }
+      WorkStealingThreadPool::global().parallel_for(
+          0, nthreads(), 1, [this](int i) { workers_[i]->impute_data(); });
 
       uint S = state_space_size();
       double loglike = 0;
       for (uint i = 0; i < nthreads(); ++i) {
-        futures[i].get();
         loglike += workers_[i]->loglike();
         mark_->combine_data(*workers_[i]->mark(), true);
         for (uint s = 0; s < S; ++s) {
@@ -116,8 +116,6 @@ namespace BOOM {
     Ptr<UnivParams> logpost_;
     std::vector<Ptr<HmmDataImputer>> workers_;
 
-    ThreadWorkerPool thread_pool_;
-
     double impute_latent_data_with_threads();
   };
   //----------------------------------------------------------------------
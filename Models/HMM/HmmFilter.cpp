@@ -18,7 +18,6 @@
 */
 
 #include "Models/HMM/HmmFilter.hpp"
-#include "Models/HMM/hmm_tools.hpp"
 #include "cpputil/math_utils.hpp"
 
 #include "Models/EmMixtureComponent.hpp"
@@ -29,133 +28,77 @@
 
 namespace BOOM {
 
-  void hmm_recursion_error(const Matrix &p, const Vector &Marg,
-                           const Matrix &Tmat, const Vector &Wsp, uint i,
-                           const Ptr<Data> &);
-  void hmm_recursion_error(const Matrix &P, const Vector &marg,
-                           const Matrix &tmat, const Vector &wsp, uint i,
-                           const Ptr<Data> &dp) {
-    std::string str;
-    std::ostringstream s(str);
-    s << "error in HMM recursion at step " << i << ":" << endl;
-    s << "marg:" << endl << marg << endl;
-    s << "P: " << endl << P << endl;
-    s << "hmm.cpp:  Q = " << endl << tmat << endl;
-    s << "hmm.cpp: p(data|state) = " << wsp << endl;
-    s << "here is the observed data that caused the error: " << endl
-      << *dp << endl;
-    report_error(s.str());
-  }
-
   HmmFilter::HmmFilter(const std::vector<Ptr<MixtureComponent>> &mix,
                        const Ptr<MarkovModel> &mark)
       : models_(mix),
-        P(0),
+        engine_(mix.size()),
+        loglike_engine_(mix.size()),
         pi(mix.size()),
-        logp(mix.size()),
-        logpi(mix.size()),
-        one(mix.size(), 1.0),
-        logQ(mix.size(), mix.size()),
         markov_(mark) {}
 
   uint HmmFilter::state_space_size() const { return models_.size(); }
 
-  double HmmFilter::initialize(const Data *dp) {
-    uint S = state_space_size();
-    pi = markov_->pi0();
-    if (dp->missing())
-      logp = 0;
-    else
-      for (uint s = 0; s < S; ++s) logp[s] = models_[s]->pdf(dp, true);
-    pi = log(pi) + logp;
-    double m = max(pi);
-    pi = exp(pi - m);
-    double nc = sum(pi);
-    double loglike = m + log(nc);
-    pi /= nc;
-    return loglike;
+  ScaledForwardBackward::LogDensityFunction HmmFilter::log_density(
+      const std::vector<Ptr<Data>> &data) const {
+    return [this, &data](int t, Vector &logp) {
+      const Data *dp = data[t].get();
+      if (dp->missing()) {
+        logp = 0;
+      } else {
+        for (int s = 0; s < logp.size(); ++s) {
+          logp[s] = models_[s]->pdf(dp, true);
+        }
+      }
+    };
   }
 
+  // The filter does not store its own copy of the data, so bkwd_sampling()
+  // and bkwd_smoothing() must be passed the same vector that was passed to
+  // fwd().
   double HmmFilter::fwd(const std::vector<Ptr<Data>> &dv) {
-    logQ = log(markov_->Q());
-    uint n = dv.size();
-    uint S = state_space_size();
-    if (logp.size() != S) logp.resize(S);
-    if (P.size() < n) P.resize(n);
-    double loglike = initialize(dv[0].get());
-    for (uint i = 1; i < n; ++i) {
-      if (dv[i]->missing())
-        logp = 0;
-      else
-        for (uint s = 0; s < S; ++s)
-          logp[s] = models_[s]->pdf(dv[i].get(), true);
-      loglike += fwd_1(pi, P[i], logQ, logp, one);
-    }
-    return loglike;
+    double ans = engine_.filter(markov_->pi0(), markov_->Q(), dv.size(),
+                                log_density(dv));
+    pi = engine_.final_state_distribution();
+    return ans;
   }
   //------------------------------------------------------------
 
   double HmmFilter::loglike(const std::vector<Ptr<Data>> &dv) {
-    logQ = log(markov_->Q());
-    pi = markov_->pi0();
-    uint S = pi.size();
-    uint n = dv.size();
-    Matrix P(logQ);
-    double ans = initialize(dv[0].get());
-    for (uint i = 1; i < n; ++i) {
-      if (dv[i]->missing())
-        logp = 0;
-      else
-        for (uint s = 0; s < S; ++s)
-          logp[s] = models_[s]->pdf(dv[i].get(), true);
-      ans += fwd_1(pi, P, logQ, logp, one);
-    }
-    return ans;
+    return loglike_engine_.filter(markov_->pi0(), markov_->Q(), dv.size(),
+                                  log_density(dv));
   }
   //------------------------------------------------------------
 
-  void HmmFilter::bkwd_sampling_mt(const std::vector<Ptr<Data>> &data, RNG &rng) {
-    uint sample_size = data.size();
-    std::vector<int> imputed_state(sample_size);
-    // pi was already set by fwd.
-    // So the following line would  break things when sample_size=1.
-    //      pi = one * P.back();
-    uint s = rmulti_mt(rng, pi);
-    models_[s]->add_data(data.back());
-    imputed_state.back() = s;
-    for (int64_t i = sample_size - 1; i >= 0; --i) {
-      pi = P[i].col(s);
-      pi.normalize_prob();
-      uint r = rmulti_mt(rng, pi);
-      if (i > 0) {
-        imputed_state[i - 1] = r;
-      }
-      models_[r]->add_data(data[i - 1]);
-      markov_->suf()->add_transition(r, s);
-      s = r;
-    }
-    markov_->suf()->add_initial_value(s);
+  void HmmFilter::bkwd_sampling_mt(const std::vector<Ptr<Data>> &data,
+                                   RNG &rng) {
+    std::vector<int> imputed_state;
+    engine_.sample_states(
+        rng, imputed_state,
+        [this, &data](int t, int state, const Vector &distribution) {
+          models_[state]->add_data(data[t]);
+        });
+    record_transitions(imputed_state);
     imputed_state_map_[data] = imputed_state;
   }
 
   //------------------------------------------------------------
   void HmmFilter::bkwd_sampling(const std::vector<Ptr<Data>> &dv) {
-    uint n = dv.size();
-    // pi was already set by fwd, so the following line would breaks
-    // things when n=1.
-    //      pi = one * P.back();
-    uint s = rmulti(pi);     // last obs in state s
-    allocate(dv.back(), s);  // last data point allocated
-
-    for (uint i = n - 1; i != 0; --i) {  // start with s=h[i]
-      pi = P[i].col(s);                  // compute r = h[i-1]
-      uint r = rmulti(pi);
-      allocate(dv[i - 1], r);
-      markov_->suf()->add_transition(r, s);
-      s = r;
+    std::vector<int> imputed_state;
+    engine_.sample_states(
+        GlobalRng::rng, imputed_state,
+        [this, &dv](int t, int state, const Vector &distribution) {
+          pi = distribution;
+          allocate(dv[t], state);
+        });
+    record_transitions(imputed_state);
+  }
+
+  void HmmFilter::record_transitions(const std::vector<int> &states) {
+    if (states.empty()) return;
+    for (int t = 1; t < states.size(); ++t) {
+      markov_->suf()->add_transition(states[t - 1], states[t]);
     }
-    markov_->suf()->add_initial_value(s);
-    // in last step of loop i = 1, so s=h[0]
+    markov_->suf()->add_initial_value(states[0]);
   }
   //----------------------------------------------------------------------
   void HmmFilter::allocate(const Ptr<Data> &dp, uint h) {
@@ -215,21 +158,20 @@ namespace BOOM {
         em_models_(mix) {}
   //------------------------------------------------------------
   void HmmEmFilter::bkwd_smoothing(const std::vector<Ptr<Data>> &dv) {
-    // pi was set by fwd;
-    uint n = dv.size();
+    // The forward filter was run by fwd().
     uint S = state_space_size();
-    for (uint i = n - 1; i != 0; --i) {
-      for (uint s = 0; s < S; ++s) {
-        em_models_[s]->add_mixture_data(dv[i], pi[s]);
-      }
-      markov_->suf()->add_transition_distribution(P[i]);
-      bkwd_1(pi, P[i], logp, one);
-    }
-    pi = P[1] * one;
-    for (uint s = 0; s < S; ++s) {
-      em_models_[s]->add_mixture_data(dv[0], pi[s]);
-    }
-    markov_->suf()->add_initial_distribution(pi);
+    engine_.smooth(
+        [this, &dv, S](int t, const Vector &marginal) {
+          for (uint s = 0; s < S; ++s) {
+            em_models_[s]->add_mixture_data(dv[t], marginal[s]);
+          }
+          if (t == 0) {
+            markov_->suf()->add_initial_distribution(marginal);
+          }
+        },
+        [this](int t, const Matrix &joint_distribution) {
+          markov_->suf()->add_transition_distribution(joint_distribution);
+        });
   }
 
 }  // namespace BOOM
@@ -21,6 +21,7 @@
 #define BOOM_HMM_FILTER_HPP
 
 #include "LinAlg/Matrix.hpp"
+#include "Models/HMM/ScaledForwardBackward.hpp"
 #include "Models/MarkovModel.hpp"
 #include "cpputil/Ptr.hpp"
 #include "cpputil/RefCounted.hpp"
@@ -45,7 +46,9 @@ namespace BOOM {
     ~HmmFilter() override {}
     uint state_space_size() const;
 
-    double initialize(const Data *);
+    // The log likelihood of the data.  This uses its own forward filter, so
+    // it can be called between fwd() and the backward pass without changing
+    // what the backward pass does.
     double loglike(const std::vector<Ptr<Data>> &);
     double fwd(const std::vector<Ptr<Data>> &);
     void bkwd_sampling(const std::vector<Ptr<Data>> &);
@@ -53,15 +56,35 @@ namespace BOOM {
     virtual void allocate(const Ptr<Data> &, uint);
     virtual Vector state_probs(const Ptr<Data> &) const;
 
+    // By default the filtered state distribution is stored for every time
+    // point.  For long series, storing it only every 'interval' time points
+    // reduces memory use at the cost of recomputing the component densities
+    // during the backward pass.  An interval near sqrt(n) is a good choice.
+    void set_checkpoint_interval(int interval) {
+      engine_.set_checkpoint_interval(interval);
+      loglike_engine_.set_checkpoint_interval(interval);
+    }
+
     // Return the state vector that was imputed for data during the call to
     // bkwd_sampling or bkwd_sampling_mt.
     std::vector<int> imputed_state(const std::vector<Ptr<Data>> &data) const;
     
    protected:
+    // Returns a function filling its argument with the log density of
+    // data[t] under each mixture component.  Missing data have log density 0.
+    ScaledForwardBackward::LogDensityFunction log_density(
+        const std::vector<Ptr<Data>> &data) const;
+
+    // Add the transitions in an imputed state sequence to the sufficient
+    // statistics of the Markov model.
+    void record_transitions(const std::vector<int> &states);
+
     std::vector<Ptr<MixtureComponent>> models_;
-    std::vector<Matrix> P;
-    Vector pi, logp, logpi, one;
-    Matrix logQ;
+    ScaledForwardBackward engine_;
+    // A scratch filter for loglike(), so that evaluating the likelihood
+    // leaves the forward probabilities in engine_ alone.
+    ScaledForwardBackward loglike_engine_;
+    Vector pi;
     Ptr<MarkovModel> markov_;
     std::map<std::vector<Ptr<Data>>, std::vector<int>> imputed_state_map_;
   };
@@ -0,0 +1,230 @@
+/*
+  Copyright (C) 2019 Steven L. Scott
+
+  This library is free software; you can redistribute it and/or modify it under
+  the terms of the GNU Lesser General Public License as published by the Free
+  Software Foundation; either version 2.1 of the License, or (at your option)
+  any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT
+  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+  FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+  details.
+
+  You should have received a copy of the GNU Lesser General Public License along
+  with this library; if not, write to the Free Software Foundation, Inc., 51
+  Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+*/
+
+#include "Models/HMM/ScaledForwardBackward.hpp"
+#include <algorithm>
+#include <cmath>
+#include "cpputil/math_utils.hpp"
+#include "cpputil/report_error.hpp"
+#include "distributions.hpp"
+
+namespace BOOM {
+
+  ScaledForwardBackward::ScaledForwardBackward(int state_space_size,
+                                               int checkpoint_interval)
+      : checkpoint_interval_(1),
+        sample_size_(0),
+        transition_(nullptr),
+        block_start_(0),
+        predicted_(state_space_size),
+        log_density_workspace_(state_space_size),
+        filtered_(state_space_size),
+        final_state_distribution_(state_space_size),
+        distribution_(state_space_size),
+        ratio_(state_space_size),
+        wsp_(state_space_size),
+        joint_(state_space_size, state_space_size) {
+    if (state_space_size <= 0) {
+      report_error("State space size must be positive.");
+    }
+    set_checkpoint_interval(checkpoint_interval);
+  }
+
+  void ScaledForwardBackward::set_checkpoint_interval(int interval) {
+    if (interval < 1) {
+      report_error("Checkpoint interval must be at least 1.");
+    }
+    checkpoint_interval_ = interval;
+    // Changing the interval invalidates any stored checkpoints.
+    sample_size_ = 0;
+    if (interval > 1) {
+      block_.resize(state_space_size(), interval);
+    } else {
+      block_.resize(state_space_size(), 0);
+    }
+  }
+
+  //----------------------------------------------------------------------
+  double ScaledForwardBackward::filter(const Vector &initial_distribution,
+                                       const Matrix &transition_probabilities,
+                                       int sample_size,
+                                       const LogDensityFunction &log_density) {
+    int S = state_space_size();
+    if (initial_distribution.size() != S ||
+        transition_probabilities.nrow() != S ||
+        transition_probabilities.ncol() != S) {
+      report_error("Initial distribution or transition matrix does not match "
+                   "the state space size.");
+    }
+    transition_ = &transition_probabilities;
+    log_density_ = log_density;
+    sample_size_ = sample_size;
+    if (sample_size <= 0) {
+      sample_size_ = 0;
+      final_state_distribution_ = initial_distribution;
+      return 0;
+    }
+
+    // Only grow the checkpoint storage, so that repeated calls on series of
+    // similar length do not reallocate.
+    int number_of_checkpoints = (sample_size - 1) / checkpoint_interval_ + 1;
+    if (checkpoints_.ncol() < number_of_checkpoints) {
+      checkpoints_.resize(S, number_of_checkpoints);
+    }
+
+    predicted_ = initial_distribution;
+    double loglike = 0;
+    for (int t = 0; t < sample_size; ++t) {
+      if (t > 0) {
+        transition_->Tmult(filtered_, predicted_);
+      }
+      loglike += update(t, filtered_);
+      if (loglike == negative_infinity()) {
+        sample_size_ = 0;
+        return loglike;
+      }
+      if (t % checkpoint_interval_ == 0) {
+        checkpoints_.col(t / checkpoint_interval_) = filtered_;
+      }
+    }
+    final_state_distribution_ = filtered_;
+    return loglike;
+  }
+
+  //----------------------------------------------------------------------
+  double ScaledForwardBackward::update(int t, Vector &filtered) {
+    log_density_(t, log_density_workspace_);
+    double max_log_density = max(log_density_workspace_);
+    if (max_log_density == negative_infinity()) {
+      return negative_infinity();
+    }
+    int S = state_space_size();
+    double total = 0;
+    for (int s = 0; s < S; ++s) {
+      filtered[s] = predicted_[s] *
+                    std::exp(log_density_workspace_[s] - max_log_density);
+      total += filtered[s];
+    }
+    if (!(total > 0) || !std::isfinite(total)) {
+      return negative_infinity();
+    }
+    filtered /= total;
+    return max_log_density + log(total);
+  }
+
+  //----------------------------------------------------------------------
+  void ScaledForwardBackward::fill_block(int t) {
+    block_start_ = t - t % checkpoint_interval_;
+    int block_end =
+        std::min<int>(block_start_ + checkpoint_interval_, sample_size_);
+    wsp_ = checkpoints_.col(block_start_ / checkpoint_interval_);
+    block_.col(0) = wsp_;
+    for (int time = block_start_ + 1; time < block_end; ++time) {
+      transition_->Tmult(wsp_, predicted_);
+      update(time, wsp_);
+      block_.col(time - block_start_) = wsp_;
+    }
+  }
+
+  ConstVectorView ScaledForwardBackward::filtered(int t) {
+    if (checkpoint_interval_ == 1) {
+      return ConstVectorView(checkpoints_.col(t));
+    }
+    if (t < block_start_ || t >= block_start_ + checkpoint_interval_) {
+      fill_block(t);
+    }
+    return ConstVectorView(block_.col(t - block_start_));
+  }
+
+  void ScaledForwardBackward::check_filtered() const {
+    if (sample_size_ <= 0 || !transition_) {
+      report_error("The forward filter must be run successfully before the "
+                   "backward pass.");
+    }
+  }
+
+  //----------------------------------------------------------------------
+  void ScaledForwardBackward::sample_states(RNG &rng, std::vector<int> &states,
+                                            const StateCallback &callback) {
+    check_filtered();
+    int n = sample_size_;
+    int S = state_space_size();
+    states.resize(n);
+    // Force the first call to filtered() to recompute its block.
+    block_start_ = n;
+
+    distribution_ = final_state_distribution_;
+    int s = rmulti_mt(rng, distribution_);
+    states[n - 1] = s;
+    if (callback) callback(n - 1, s, distribution_);
+    for (int t = n - 2; t >= 0; --t) {
+      // p(h[t] = r | Y, h[t+1] = s) is proportional to alpha[t](r) * Q(r, s).
+      ConstVectorView alpha(filtered(t));
+      for (int r = 0; r < S; ++r) {
+        distribution_[r] = alpha[r] * (*transition_)(r, s);
+      }
+      distribution_.normalize_prob();
+      s = rmulti_mt(rng, distribution_);
+      states[t] = s;
+      if (callback) callback(t, s, distribution_);
+    }
+  }
+
+  //----------------------------------------------------------------------
+  // If alpha[t] = p(h[t] | y[0..t]), pred[t] = Q' * alpha[t-1], and gamma[t] =
+  // p(h[t] | y[0..n-1]), then
+  //
+  //   p(h[t-1] = r, h[t] = s | Y) = alpha[t-1](r) * Q(r, s) * gamma[t](s) /
+  //   pred[t](s).
+  //
+  // Summing over s gives gamma[t-1], so the backward pass needs only the
+  // filtered distributions and no backward likelihood recursion.
+  void ScaledForwardBackward::smooth(const MarginalCallback &marginal,
+                                     const TransitionCallback &transition) {
+    check_filtered();
+    int n = sample_size_;
+    int S = state_space_size();
+    block_start_ = n;
+
+    distribution_ = final_state_distribution_;
+    marginal(n - 1, distribution_);
+    for (int t = n - 1; t > 0; --t) {
+      ConstVectorView alpha(filtered(t - 1));
+      wsp_ = alpha;
+      transition_->Tmult(wsp_, predicted_);
+      for (int s = 0; s < S; ++s) {
+        ratio_[s] = predicted_[s] > 0 ? distribution_[s] / predicted_[s] : 0.0;
+      }
+      if (transition) {
+        for (int s = 0; s < S; ++s) {
+          for (int r = 0; r < S; ++r) {
+            joint_(r, s) = alpha[r] * (*transition_)(r, s) * ratio_[s];
+          }
+        }
+        transition(t, joint_);
+      }
+      transition_->mult(ratio_, wsp_);
+      for (int r = 0; r < S; ++r) {
+        distribution_[r] = alpha[r] * wsp_[r];
+      }
+      distribution_.normalize_prob();
+      marginal(t - 1, distribution_);
+    }
+  }
+
+}  // namespace BOOM
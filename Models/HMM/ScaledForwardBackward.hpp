@@ -0,0 +1,168 @@
+#ifndef BOOM_HMM_SCALED_FORWARD_BACKWARD_HPP_
+#define BOOM_HMM_SCALED_FORWARD_BACKWARD_HPP_
+
+/*
+  Copyright (C) 2019 Steven L. Scott
+
+  This library is free software; you can redistribute it and/or modify it under
+  the terms of the GNU Lesser General Public License as published by the Free
+  Software Foundation; either version 2.1 of the License, or (at your option)
+  any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT
+  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+  FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+  details.
+
+  You should have received a copy of the GNU Lesser General Public License along
+  with this library; if not, write to the Free Software Foundation, Inc., 51
+  Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+*/
+
+#include <functional>
+#include <vector>
+#include "LinAlg/Matrix.hpp"
+#include "LinAlg/Vector.hpp"
+#include "distributions/rng.hpp"
+
+namespace BOOM {
+
+  // Forward filtering, backward sampling and backward smoothing for a hidden
+  // Markov model with S states.
+  //
+  // The forward recursion works on the probability scale.  At each time point
+  // the one step prediction Q' * alpha[t-1] is formed with a single
+  // matrix-vector multiply, multiplied by the (rescaled) emission densities,
+  // and renormalized.  The log normalizing constants accumulate into the log
+  // likelihood.  Only S-vectors are stored, instead of the S x S joint
+  // distribution matrices kept by fwd_1, and all workspace is reused from one
+  // call to the next.
+  //
+  // Storage can be reduced further by keeping the filtered distribution only
+  // at every k'th time point (a "checkpoint").  The backward pass then
+  // recomputes the filtered distributions between checkpoints, one block at a
+  // time, which requires evaluating the emission densities a second time.
+  // With k around sqrt(n) the storage is O(S sqrt(n)) at the cost of one
+  // extra forward pass.
+  class ScaledForwardBackward {
+   public:
+    // Fill log_density[s] with log p(y[t] | h[t] = s).  For missing data fill
+    // log_density with zeros.  When checkpointing is used this function is
+    // called again for some time points during the backward pass, so it must
+    // return the same values each time it is called.
+    typedef std::function<void(int t, Vector &log_density)>
+        LogDensityFunction;
+
+    // Args:
+    //   state_space_size:  The number of hidden states.
+    //   checkpoint_interval: The filtered state distribution is stored every
+    //     checkpoint_interval time points.  A value of 1 stores every filtered
+    //     distribution, and never recomputes emission densities.
+    explicit ScaledForwardBackward(int state_space_size,
+                                   int checkpoint_interval = 1);
+
+    int state_space_size() const { return predicted_.size(); }
+
+    void set_checkpoint_interval(int interval);
+    int checkpoint_interval() const { return checkpoint_interval_; }
+
+    // Run the forward filter.
+    //
+    // Args:
+    //   initial_distribution: The distribution of the hidden state at time 0,
+    //     before observing y[0].
+    //   transition_probabilities: The S x S transition probability matrix.
+    //     Rows sum to 1.  The matrix must remain unchanged until the backward
+    //     pass is complete.
+    //   sample_size: The number of time points in the series.
+    //   log_density: Emission log densities.  See LogDensityFunction.
+    //
+    // Returns:
+    //   The log likelihood log p(y[0], ..., y[n-1]).  If some observation is
+    //   impossible under every state then negative infinity is returned, and
+    //   the backward pass may not be run.
+    double filter(const Vector &initial_distribution,
+                  const Matrix &transition_probabilities,
+                  int sample_size,
+                  const LogDensityFunction &log_density);
+
+    // The filtered distribution p(h[n-1] | y[0..n-1]) of the final state.
+    const Vector &final_state_distribution() const {
+      return final_state_distribution_;
+    }
+
+    // Simulate the hidden states from their joint posterior distribution
+    // given the data passed to the most recent call to filter().
+    //
+    // Args:
+    //   rng: The random number generator used for the simulation.
+    //   states: On output, the simulated state at each time point.
+    //   callback: If supplied, called once for each time point (in decreasing
+    //     order) with the time, the simulated state, and the distribution from
+    //     which it was drawn, which is the distribution of h[t] given the data
+    //     and h[t+1].
+    typedef std::function<void(int t, int state, const Vector &distribution)>
+        StateCallback;
+    void sample_states(RNG &rng, std::vector<int> &states,
+                       const StateCallback &callback = StateCallback());
+
+    // Compute the posterior (smoothed) distributions of the hidden states
+    // given the data passed to the most recent call to filter().  Time points
+    // are visited in decreasing order.
+    //
+    // Args:
+    //   marginal: Called with t and p(h[t] | y[0..n-1]) for each t.
+    //   transition: If supplied, called with t and the S x S matrix
+    //     p(h[t-1] = r, h[t] = s | y[0..n-1]) for each t > 0.
+    typedef std::function<void(int t, const Vector &distribution)>
+        MarginalCallback;
+    typedef std::function<void(int t, const Matrix &joint_distribution)>
+        TransitionCallback;
+    void smooth(const MarginalCallback &marginal,
+                const TransitionCallback &transition = TransitionCallback());
+
+   private:
+    // Multiply the one step prediction in predicted_ by the emission
+    // densities at time t, and normalize the result into 'filtered'.
+    // Returns log p(y[t] | y[0..t-1]), or negative infinity if y[t] is
+    // impossible.
+    double update(int t, Vector &filtered);
+
+    // Recompute the filtered distributions for the block of time points
+    // containing t, starting from the checkpoint at the start of the block.
+    void fill_block(int t);
+
+    // The filtered distribution p(h[t] | y[0..t]).  During the backward pass
+    // time points must be requested in decreasing order, so that each block is
+    // recomputed only once.
+    ConstVectorView filtered(int t);
+
+    void check_filtered() const;
+
+    int checkpoint_interval_;
+    int sample_size_;
+    const Matrix *transition_;
+    LogDensityFunction log_density_;
+
+    // Column j is the filtered distribution at time j * checkpoint_interval_.
+    Matrix checkpoints_;
+
+    // Filtered distributions for the time points in the current block.
+    // Column i corresponds to time block_start_ + i.
+    Matrix block_;
+    int block_start_;
+
+    // Workspace.
+    Vector predicted_;
+    Vector log_density_workspace_;
+    Vector filtered_;
+    Vector final_state_distribution_;
+    Vector distribution_;
+    Vector ratio_;
+    Vector wsp_;
+    Matrix joint_;
+  };
+
+}  // namespace BOOM
+
+#endif  // BOOM_HMM_SCALED_FORWARD_BACKWARD_HPP_
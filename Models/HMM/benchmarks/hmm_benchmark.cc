@@ -0,0 +1,99 @@
+/*
+  Copyright (C) 2019 Steven L. Scott
+
+  This library is free software; you can redistribute it and/or modify it under
+  the terms of the GNU Lesser General Public License as published by the Free
+  Software Foundation; either version 2.1 of the License, or (at your option)
+  any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT
+  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+  FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+  details.
+
+  You should have received a copy of the GNU Lesser General Public License along
+  with this library; if not, write to the Free Software Foundation, Inc., 51
+  Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+*/
+
+// Timings for the forward-backward recursions in hmm_tools.  The first
+// benchmark argument is the length of the sequence, and the second is the
+// number of hidden states.  Transition probabilities and log densities are
+// drawn from a fixed seed.
+
+#include "benchmark/benchmark.h"
+#include "distributions.hpp"
+#include "LinAlg/Matrix.hpp"
+#include "LinAlg/Vector.hpp"
+#include "Models/HMM/hmm_tools.hpp"
+
+namespace {
+  using namespace BOOM;
+
+  class HmmInputs {
+   public:
+    HmmInputs(int time_dimension, int state_size)
+        : one(state_size, 1.0),
+          logQ(state_size, state_size),
+          logd(time_dimension, Vector(state_size)),
+          P(time_dimension, Matrix(state_size, state_size)) {
+      GlobalRng::rng.seed(8675309);
+      for (int r = 0; r < state_size; ++r) {
+        logQ.row(r) = log(rdirichlet(Vector(state_size, 1.0)));
+      }
+      for (int t = 0; t < time_dimension; ++t) {
+        for (int s = 0; s < state_size; ++s) {
+          logd[t][s] = dnorm(rnorm(0, 1), s, 1.0, true);
+        }
+      }
+    }
+
+    // Run the forward recursion, leaving the filtered distribution in pi.
+    double forward(Vector &pi) {
+      pi = Vector(one.size(), 1.0 / one.size());
+      double loglike = 0;
+      for (int t = 0; t < logd.size(); ++t) {
+        loglike += fwd_1(pi, P[t], logQ, logd[t], one);
+      }
+      return loglike;
+    }
+
+    Vector one;
+    Matrix logQ;
+    std::vector<Vector> logd;
+    std::vector<Matrix> P;
+  };
+
+  void BM_Forward(benchmark::State &state) {
+    HmmInputs inputs(state.range(0), state.range(1));
+    Vector pi;
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(inputs.forward(pi));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+
+  void BM_ForwardBackward(benchmark::State &state) {
+    HmmInputs inputs(state.range(0), state.range(1));
+    Vector pi, wsp(state.range(1));
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(inputs.forward(pi));
+      for (int t = inputs.P.size() - 1; t > 0; --t) {
+        bkwd_1(pi, inputs.P[t], wsp, inputs.one);
+      }
+      benchmark::DoNotOptimize(pi.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+
+  void HmmArgs(benchmark::internal::Benchmark *benchmark) {
+    benchmark->ArgsProduct({{1000, 10000}, {2, 5, 20}})
+        ->Unit(benchmark::kMicrosecond);
+  }
+
+  BENCHMARK(BM_Forward)->Apply(HmmArgs);
+  BENCHMARK(BM_ForwardBackward)->Apply(HmmArgs);
+
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -1,5 +1,6 @@
 #include "gtest/gtest.h"
 #include "Models/HMM/HMM2.hpp"
+#include "Models/HMM/HmmFilter.hpp"
 #include "Models/PoissonModel.hpp"
 #include "Models/MarkovModel.hpp"
 #include "Models/ProductDirichletModel.hpp"
@@ -7,6 +8,9 @@
 #include "Models/PosteriorSamplers/PoissonGammaSampler.hpp"
 #include "Models/PosteriorSamplers/MarkovConjSampler.hpp"
 #include "Models/HMM/PosteriorSamplers/HmmPosteriorSampler.hpp"
+#include "Models/HMM/ScaledForwardBackward.hpp"
+#include "Models/HMM/hmm_tools.hpp"
+#include "distributions.hpp"
 
 #include "test_utils/test_utils.hpp"
 #include <fstream>
@@ -118,4 +122,165 @@ namespace {
                            << status;
   }
 
+  // Log densities of the lamb data under a 3 state Poisson model.
+  class ScaledForwardBackwardTest : public ::testing::Test {
+   protected:
+    ScaledForwardBackwardTest()
+        : lambda_{.05, .5, 3.0},
+          Q_(3, 3),
+          initial_distribution_{.6, .3, .1} {
+      GlobalRng::rng.seed(8675309);
+      Q_.row(0) = Vector{.88, .1, .02};
+      Q_.row(1) = Vector{.08, .9, .02};
+      Q_.row(2) = Vector{.2, .2, .6};
+      log_density_ = [this](int t, Vector &logp) {
+        for (int s = 0; s < 3; ++s) {
+          logp[s] = dpois(lamb_data[t], lambda_[s], true);
+        }
+      };
+    }
+
+    // The log likelihood computed by the original fwd_1 recursion.
+    double reference_loglike() const {
+      Matrix logQ = log(Q_);
+      Vector one(3, 1.0);
+      Vector logp(3);
+      log_density_(0, logp);
+      Vector pi = log(initial_distribution_) + logp;
+      double m = max(pi);
+      pi = exp(pi - m);
+      double nc = sum(pi);
+      double ans = m + log(nc);
+      pi /= nc;
+      Matrix P(3, 3);
+      for (int t = 1; t < lamb_data.size(); ++t) {
+        log_density_(t, logp);
+        ans += fwd_1(pi, P, logQ, logp, one);
+      }
+      return ans;
+    }
+
+    Vector lambda_;
+    Matrix Q_;
+    Vector initial_distribution_;
+    ScaledForwardBackward::LogDensityFunction log_density_;
+  };
+
+  TEST_F(ScaledForwardBackwardTest, LoglikeMatchesLogScaleRecursion) {
+    ScaledForwardBackward engine(3);
+    double loglike = engine.filter(initial_distribution_, Q_,
+                                   lamb_data.size(), log_density_);
+    EXPECT_NEAR(loglike, reference_loglike(), 1e-8);
+    EXPECT_NEAR(sum(engine.final_state_distribution()), 1.0, 1e-10);
+
+    // Impossible observations give a log likelihood of -infinity.
+    double impossible = engine.filter(
+        initial_distribution_, Q_, 3,
+        [](int t, Vector &logp) { logp = negative_infinity(); });
+    EXPECT_EQ(impossible, negative_infinity());
+  }
+
+  TEST_F(ScaledForwardBackwardTest, CheckpointsDoNotChangeResults) {
+    ScaledForwardBackward engine(3);
+    double loglike = engine.filter(initial_distribution_, Q_,
+                                   lamb_data.size(), log_density_);
+    std::vector<int> states;
+    RNG rng(12345);
+    engine.sample_states(rng, states);
+    std::vector<Vector> marginals(lamb_data.size());
+    engine.smooth([&marginals](int t, const Vector &marginal) {
+      marginals[t] = marginal;
+    });
+
+    for (int interval : {2, 7, 16, 240, 1000}) {
+      ScaledForwardBackward checkpointed(3, interval);
+      EXPECT_DOUBLE_EQ(loglike,
+                       checkpointed.filter(initial_distribution_, Q_,
+                                           lamb_data.size(), log_density_));
+      std::vector<int> checkpointed_states;
+      RNG checkpointed_rng(12345);
+      checkpointed.sample_states(checkpointed_rng, checkpointed_states);
+      EXPECT_EQ(states, checkpointed_states) << "interval = " << interval;
+      checkpointed.smooth([&marginals](int t, const Vector &marginal) {
+        EXPECT_TRUE(VectorEquals(marginals[t], marginal));
+      });
+    }
+  }
+
+  // HmmFilter::loglike must not disturb the forward probabilities used by a
+  // pending backward pass.
+  TEST_F(ScaledForwardBackwardTest, FilterLoglikeKeepsForwardState) {
+    std::vector<Ptr<Data>> data;
+    for (int y : lamb_data) {
+      data.push_back(new IntData(y));
+    }
+    std::vector<Ptr<Data>> other_data(data.begin() + 80, data.begin() + 120);
+
+    auto make_filter = [this]() {
+      std::vector<Ptr<MixtureComponent>> components;
+      for (int s = 0; s < 3; ++s) {
+        components.push_back(new PoissonModel(lambda_[s]));
+      }
+      NEW(MarkovModel, markov)(Q_, initial_distribution_);
+      return Ptr<HmmFilter>(new HmmFilter(components, markov));
+    };
+
+    Ptr<HmmFilter> filter = make_filter();
+    double loglike = filter->fwd(data);
+    RNG rng(12345);
+    filter->bkwd_sampling_mt(data, rng);
+
+    Ptr<HmmFilter> interrupted_filter = make_filter();
+    EXPECT_DOUBLE_EQ(loglike, interrupted_filter->fwd(data));
+    EXPECT_DOUBLE_EQ(loglike, interrupted_filter->loglike(data));
+    interrupted_filter->loglike(other_data);
+    RNG interrupted_rng(12345);
+    interrupted_filter->bkwd_sampling_mt(data, interrupted_rng);
+
+    EXPECT_EQ(filter->imputed_state(data),
+              interrupted_filter->imputed_state(data));
+  }
+
+  TEST_F(ScaledForwardBackwardTest, SmoothedDistributionsAreConsistent) {
+    ScaledForwardBackward engine(3, 10);
+    engine.filter(initial_distribution_, Q_, lamb_data.size(), log_density_);
+    std::vector<Vector> marginals(lamb_data.size());
+    std::vector<Matrix> joints(lamb_data.size());
+    engine.smooth(
+        [&marginals](int t, const Vector &marginal) {
+          marginals[t] = marginal;
+        },
+        [&joints](int t, const Matrix &joint) { joints[t] = joint; });
+    EXPECT_TRUE(VectorEquals(marginals.back(),
+                             engine.final_state_distribution()));
+    Vector one(3, 1.0);
+    for (int t = 0; t < lamb_data.size(); ++t) {
+      EXPECT_NEAR(sum(marginals[t]), 1.0, 1e-10);
+      if (t > 0) {
+        // The joint distribution of (h[t-1], h[t]) has margins gamma[t-1] and
+        // gamma[t].
+        EXPECT_TRUE(VectorEquals(joints[t] * one, marginals[t - 1]));
+        EXPECT_TRUE(VectorEquals(one * joints[t], marginals[t]));
+      }
+    }
+
+    // The smoothed marginals should match the average of many posterior
+    // draws of the hidden states.
+    int niter = 2000;
+    Matrix counts(lamb_data.size(), 3, 0.0);
+    std::vector<int> states;
+    for (int i = 0; i < niter; ++i) {
+      engine.sample_states(GlobalRng::rng, states);
+      for (int t = 0; t < states.size(); ++t) {
+        counts(t, states[t]) += 1.0 / niter;
+      }
+    }
+    for (int t = 0; t < lamb_data.size(); ++t) {
+      for (int s = 0; s < 3; ++s) {
+        EXPECT_NEAR(counts(t, s), marginals[t][s], .05)
+            << "t = " << t << " s = " << s;
+      }
+    }
+  }
+
 }  // namespace
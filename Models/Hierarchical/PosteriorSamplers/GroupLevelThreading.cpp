@@ -0,0 +1,60 @@
+/*
+  Copyright (C) 2019 Steven L. Scott
+
+  This library is free software; you can redistribute it and/or modify it under
+  the terms of the GNU Lesser General Public License as published by the Free
+  Software Foundation; either version 2.1 of the License, or (at your option)
+  any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT
+  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+  FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+  details.
+
+  You should have received a copy of the GNU Lesser General Public License along
+  with this library; if not, write to the Free Software Foundation, Inc., 51
+  Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+*/
+
+#include "Models/Hierarchical/PosteriorSamplers/GroupLevelThreading.hpp"
+
+#include <algorithm>
+#include "cpputil/ThreadTools.hpp"
+
+namespace BOOM {
+
+  const int GroupLevelThreading::kGroupsPerBlock;
+
+  void GroupLevelThreading::set_number_of_threads(int n) {
+    number_of_threads_ = std::max(n, 0);
+    if (number_of_threads_ > 1) {
+      WorkStealingThreadPool::global().set_minimum_number_of_threads(
+          number_of_threads_);
+    }
+  }
+
+  int GroupLevelThreading::number_of_blocks(int number_of_groups) {
+    return (number_of_groups + kGroupsPerBlock - 1) / kGroupsPerBlock;
+  }
+
+  void GroupLevelThreading::draw_groups(
+      int number_of_groups,
+      const std::function<void(int, int)> &draw_group) const {
+    auto run_block = [&](int block) {
+      int begin = block * kGroupsPerBlock;
+      int end = std::min(begin + kGroupsPerBlock, number_of_groups);
+      for (int group = begin; group < end; ++group) {
+        draw_group(group, block);
+      }
+    };
+    int nblocks = number_of_blocks(number_of_groups);
+    if (number_of_threads_ > 1 && nblocks > 1) {
+      WorkStealingThreadPool::global().parallel_for(0, nblocks, 1, run_block);
+    } else {
+      for (int block = 0; block < nblocks; ++block) {
+        run_block(block);
+      }
+    }
+  }
+
+}  // namespace BOOM
@@ -0,0 +1,92 @@
+#ifndef BOOM_HIERARCHICAL_GROUP_LEVEL_THREADING_HPP_
+#define BOOM_HIERARCHICAL_GROUP_LEVEL_THREADING_HPP_
+
+/*
+  Copyright (C) 2019 Steven L. Scott
+
+  This library is free software; you can redistribute it and/or modify it under
+  the terms of the GNU Lesser General Public License as published by the Free
+  Software Foundation; either version 2.1 of the License, or (at your option)
+  any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT
+  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+  FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+  details.
+
+  You should have received a copy of the GNU Lesser General Public License along
+  with this library; if not, write to the Free Software Foundation, Inc., 51
+  Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+*/
+
+#include <functional>
+#include <vector>
+#include "cpputil/Ptr.hpp"
+
+namespace BOOM {
+
+  // A mix-in for posterior samplers of hierarchical models.  Given the
+  // hyperparameters, the parameters of the group level models are
+  // independent, so they can be drawn in parallel.
+  //
+  // The groups are divided into blocks of kGroupsPerBlock consecutive groups.
+  // The blocks are run on WorkStealingThreadPool::global(), with the groups
+  // inside a block visited in order.  A sampler keeps one partial copy of the
+  // hyperparameter sufficient statistics per block, and combines the partial
+  // copies in block order once all the groups have been drawn.  The blocks do
+  // not depend on the number of threads, so as long as each group draws from
+  // its own random number stream, the draws for a given seed are the same no
+  // matter how many threads are used.
+  class GroupLevelThreading {
+   public:
+    // The number of consecutive groups handled by a single task.
+    static const int kGroupsPerBlock = 32;
+
+    GroupLevelThreading() : number_of_threads_(0) {}
+
+    // Draw the group level parameters using 'n' threads from the global
+    // thread pool.  Values of 0 or 1 draw them in the calling thread.
+    void set_number_of_threads(int n);
+    int number_of_threads() const { return number_of_threads_; }
+
+   protected:
+    // The number of blocks needed to cover the given number of groups.
+    static int number_of_blocks(int number_of_groups);
+
+    // Call draw_group(group, block) once for each group in [0,
+    // number_of_groups), where 'block' is the index of the block containing
+    // 'group'.  Calls for groups in the same block happen in order, from the
+    // same thread.  Exceptions thrown by draw_group are rethrown here.
+    void draw_groups(
+        int number_of_groups,
+        const std::function<void(int group, int block)> &draw_group) const;
+
+   private:
+    int number_of_threads_;
+  };
+
+  // Returns a vector of empty copies of 'suf', one for each block.
+  template <class SUF>
+  std::vector<Ptr<SUF>> partial_sufstats(const Ptr<SUF> &suf,
+                                         int number_of_blocks) {
+    std::vector<Ptr<SUF>> ans;
+    ans.reserve(number_of_blocks);
+    for (int i = 0; i < number_of_blocks; ++i) {
+      ans.push_back(suf->clone());
+      ans.back()->clear();
+    }
+    return ans;
+  }
+
+  // Combine the elements of 'partials' into 'suf', in order.
+  template <class SUF>
+  void combine_partial_sufstats(const Ptr<SUF> &suf,
+                                const std::vector<Ptr<SUF>> &partials) {
+    for (const auto &partial : partials) {
+      suf->combine(*partial);
+    }
+  }
+
+}  // namespace BOOM
+
+#endif  // BOOM_HIERARCHICAL_GROUP_LEVEL_THREADING_HPP_
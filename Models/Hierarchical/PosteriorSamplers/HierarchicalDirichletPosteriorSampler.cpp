@@ -51,7 +51,8 @@ namespace BOOM {
   void HDPS::draw() {
     DirichletModel *prior = model_->prior_model();
     prior->clear_data();
-    for (int i = 0; i < model_->number_of_groups(); ++i) {
+    int number_of_groups = model_->number_of_groups();
+    for (int i = 0; i < number_of_groups; ++i) {
       MultinomialModel *data_model = model_->data_model(i);
       if (data_model->number_of_sampling_methods() != 1) {
         data_model->clear_methods();
@@ -59,9 +60,15 @@ namespace BOOM {
         (data_model, Ptr<DirichletModel>(prior), rng());
         data_model->set_method(data_model_sampler);
       }
-      data_model->sample_posterior();
-      prior->suf()->update(*(data_model->Pi_prm()));
     }
+    std::vector<Ptr<DirichletSuf>> partial_suf =
+        partial_sufstats(prior->suf(), number_of_blocks(number_of_groups));
+    draw_groups(number_of_groups, [&](int group, int block) {
+      MultinomialModel *data_model = model_->data_model(group);
+      data_model->sample_posterior();
+      partial_suf[block]->update(*(data_model->Pi_prm()));
+    });
+    combine_partial_sufstats(prior->suf(), partial_suf);
     prior->sample_posterior();
   }
 
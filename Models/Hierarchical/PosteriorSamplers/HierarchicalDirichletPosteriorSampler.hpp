@@ -24,9 +24,11 @@
 #include "Models/PosteriorSamplers/DirichletPosteriorSampler.hpp"
 #include "Models/PosteriorSamplers/PosteriorSampler.hpp"
 #include "Models/Hierarchical/HierarchicalDirichletModel.hpp"
+#include "Models/Hierarchical/PosteriorSamplers/GroupLevelThreading.hpp"
 namespace BOOM {
 
-  class HierarchicalDirichletPosteriorSampler : public PosteriorSampler {
+  class HierarchicalDirichletPosteriorSampler : public PosteriorSampler,
+                                                public GroupLevelThreading {
    public:
     HierarchicalDirichletPosteriorSampler(
         HierarchicalDirichletModel *model,
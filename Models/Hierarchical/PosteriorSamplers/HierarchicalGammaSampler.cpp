@@ -49,21 +49,31 @@ namespace BOOM {
 
   // The draw() method will draw values of the gamma_mean and gamma_shape
   void HierarchicalGammaSampler::draw() {
-    model_->prior_for_mean_parameters()->clear_data();
-    model_->prior_for_shape_parameters()->clear_data();
+    GammaModel *mean_prior = model_->prior_for_mean_parameters();
+    GammaModel *shape_prior = model_->prior_for_shape_parameters();
+    mean_prior->clear_data();
+    shape_prior->clear_data();
 
-    for (int i = 0; i < model_->number_of_groups(); ++i) {
-      GammaModel *data_model = model_->data_model(i);
-      ensure_posterior_sampling_method(data_model);
-      data_model->sample_posterior();
-      model_->prior_for_mean_parameters()->suf()->update_raw(
-          data_model->mean());
-      model_->prior_for_shape_parameters()->suf()->update_raw(
-          data_model->alpha());
+    int number_of_groups = model_->number_of_groups();
+    for (int i = 0; i < number_of_groups; ++i) {
+      ensure_posterior_sampling_method(model_->data_model(i));
     }
+    int nblocks = number_of_blocks(number_of_groups);
+    std::vector<Ptr<GammaSuf>> mean_suf =
+        partial_sufstats(mean_prior->suf(), nblocks);
+    std::vector<Ptr<GammaSuf>> shape_suf =
+        partial_sufstats(shape_prior->suf(), nblocks);
+    draw_groups(number_of_groups, [&](int group, int block) {
+      GammaModel *data_model = model_->data_model(group);
+      data_model->sample_posterior();
+      mean_suf[block]->update_raw(data_model->mean());
+      shape_suf[block]->update_raw(data_model->alpha());
+    });
+    combine_partial_sufstats(mean_prior->suf(), mean_suf);
+    combine_partial_sufstats(shape_prior->suf(), shape_suf);
 
-    model_->prior_for_mean_parameters()->sample_posterior();
-    model_->prior_for_shape_parameters()->sample_posterior();
+    mean_prior->sample_posterior();
+    shape_prior->sample_posterior();
   }
 
   void HierarchicalGammaSampler::ensure_posterior_sampling_method(
@@ -71,7 +81,7 @@ namespace BOOM {
     if (data_model->number_of_sampling_methods() == 0) {
       NEW(GammaPosteriorSampler, sampler)
       (data_model, model_->prior_for_mean_parameters(),
-       model_->prior_for_shape_parameters());
+       model_->prior_for_shape_parameters(), rng());
       data_model->set_method(sampler);
     }
   }
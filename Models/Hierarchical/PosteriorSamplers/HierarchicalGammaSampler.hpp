@@ -22,12 +22,14 @@
 
 #include "Models/DoubleModel.hpp"
 #include "Models/Hierarchical/HierarchicalGammaModel.hpp"
+#include "Models/Hierarchical/PosteriorSamplers/GroupLevelThreading.hpp"
 #include "Models/PosteriorSamplers/GammaPosteriorSampler.hpp"
 #include "Models/PosteriorSamplers/PosteriorSampler.hpp"
 
 namespace BOOM {
 
-  class HierarchicalGammaSampler : public PosteriorSampler {
+  class HierarchicalGammaSampler : public PosteriorSampler,
+                                   public GroupLevelThreading {
    public:
     // The constructor takes the model to be sampled (as usual) and four
     // independent distributions defining the prior.
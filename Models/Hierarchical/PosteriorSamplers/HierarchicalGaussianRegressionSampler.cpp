@@ -20,6 +20,8 @@
 #include "Models/Hierarchical/PosteriorSamplers/HierarchicalGaussianRegressionSampler.hpp"
 #include "Models/Glm/PosteriorSamplers/RegressionCoefficientSampler.hpp"
 
+#include <vector>
+
 namespace BOOM {
   namespace {
     typedef HierarchicalGaussianRegressionSampler HGRS;
@@ -34,22 +36,36 @@ namespace BOOM {
         residual_variance_prior_(residual_precision_prior),
         residual_variance_sampler_(residual_variance_prior_) {}
 
-  // TODO:  Consider threads here.
+  // Each group draws its coefficients from its own Philox stream, keyed by a
+  // draw from rng(), so the draws do not depend on the number of threads.
   void HGRS::draw() {
-    double sample_size = 0;
-    double residual_sum_of_squares = 0;
     MvnModel *prior = model_->prior();
     prior->clear_data();
-    for (int i = 0; i < model_->number_of_groups(); ++i) {
-      RegressionModel *reg = model_->data_model(i);
-      RegressionCoefficientSampler::sample_regression_coefficients(rng(), reg,
-                                                                   *prior);
-      prior->suf()->update_raw(reg->Beta());
-      sample_size += reg->suf()->n();
-      residual_sum_of_squares += reg->suf()->relative_sse(reg->coef());
-    }
+    // The prior precision is computed lazily.  Compute it here, before the
+    // worker threads read it.
+    prior->siginv();
+
+    int number_of_groups = model_->number_of_groups();
+    int nblocks = number_of_blocks(number_of_groups);
+    std::vector<Ptr<MvnSuf>> partial_suf = partial_sufstats(prior->suf(),
+                                                            nblocks);
+    Vector sample_size(nblocks, 0.0);
+    Vector residual_sum_of_squares(nblocks, 0.0);
+    RNG::RngIntType key = rng().random_bits();
+    std::vector<RNG> block_rngs(nblocks, RNG(key, RNG::PHILOX));
+    draw_groups(number_of_groups, [&](int group, int block) {
+      RNG &group_rng(block_rngs[block]);
+      group_rng.jump(group);
+      RegressionModel *reg = model_->data_model(group);
+      RegressionCoefficientSampler::sample_regression_coefficients(
+          group_rng, reg, *prior);
+      partial_suf[block]->update_raw(reg->Beta());
+      sample_size[block] += reg->suf()->n();
+      residual_sum_of_squares[block] += reg->suf()->relative_sse(reg->coef());
+    });
+    combine_partial_sufstats(prior->suf(), partial_suf);
     model_->set_residual_variance(residual_variance_sampler_.draw(
-        rng(), sample_size, residual_sum_of_squares));
+        rng(), sum(sample_size), sum(residual_sum_of_squares)));
     prior->sample_posterior();
   }
 
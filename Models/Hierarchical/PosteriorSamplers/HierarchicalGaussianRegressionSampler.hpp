@@ -22,12 +22,14 @@
 
 #include "Models/GammaModel.hpp"
 #include "Models/Hierarchical/HierarchicalGaussianRegressionModel.hpp"
+#include "Models/Hierarchical/PosteriorSamplers/GroupLevelThreading.hpp"
 #include "Models/PosteriorSamplers/GenericGaussianVarianceSampler.hpp"
 #include "Models/PosteriorSamplers/PosteriorSampler.hpp"
 
 namespace BOOM {
 
-  class HierarchicalGaussianRegressionSampler : public PosteriorSampler {
+  class HierarchicalGaussianRegressionSampler : public PosteriorSampler,
+                                                public GroupLevelThreading {
    public:
     HierarchicalGaussianRegressionSampler(
         HierarchicalGaussianRegressionModel *model,
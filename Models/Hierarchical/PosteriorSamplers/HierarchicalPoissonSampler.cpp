@@ -46,14 +46,12 @@ namespace BOOM {
   void HierarchicalPoissonSampler::draw() {
     GammaModel *prior = model_->prior_model();
     prior->clear_data();
-    for (int i = 0; i < model_->number_of_groups(); ++i) {
-      PoissonModel *data_model = model_->data_model(i);
-      if (data_model->number_of_sampling_methods() != 1) {
-        data_model->clear_methods();
-        NEW(PoissonGammaSampler, data_model_sampler)
-        (data_model, Ptr<GammaModel>(prior), rng());
-        data_model->set_method(data_model_sampler);
-      }
+    ensure_data_model_samplers();
+    int number_of_groups = model_->number_of_groups();
+    std::vector<Ptr<GammaSuf>> partial_suf =
+        partial_sufstats(prior->suf(), number_of_blocks(number_of_groups));
+    draw_groups(number_of_groups, [&](int group, int block) {
+      PoissonModel *data_model = model_->data_model(group);
       int number_attempts = 0;
       do {
         data_model->sample_posterior();
@@ -63,9 +61,23 @@ namespace BOOM {
               "HierarchicalPoissonSampler::draw");
         }
       } while (data_model->lam() == 0);
-      prior->suf()->update_raw(data_model->lam());
-    }
+      partial_suf[block]->update_raw(data_model->lam());
+    });
+    combine_partial_sufstats(prior->suf(), partial_suf);
     prior->sample_posterior();
   }
 
+  void HierarchicalPoissonSampler::ensure_data_model_samplers() {
+    GammaModel *prior = model_->prior_model();
+    for (int i = 0; i < model_->number_of_groups(); ++i) {
+      PoissonModel *data_model = model_->data_model(i);
+      if (data_model->number_of_sampling_methods() != 1) {
+        data_model->clear_methods();
+        NEW(PoissonGammaSampler, data_model_sampler)
+        (data_model, Ptr<GammaModel>(prior), rng());
+        data_model->set_method(data_model_sampler);
+      }
+    }
+  }
+
 }  // namespace BOOM
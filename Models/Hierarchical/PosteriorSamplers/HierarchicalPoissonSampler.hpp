@@ -22,10 +22,12 @@
 
 #include "Models/DoubleModel.hpp"
 #include "Models/Hierarchical/HierarchicalPoissonModel.hpp"
+#include "Models/Hierarchical/PosteriorSamplers/GroupLevelThreading.hpp"
 
 namespace BOOM {
 
-  class HierarchicalPoissonSampler : public PosteriorSampler {
+  class HierarchicalPoissonSampler : public PosteriorSampler,
+                                     public GroupLevelThreading {
    public:
     // The top level of the HierarchicalPoissonModel is a gamma
     // distribution, which is assumed to model the Poisson rate
@@ -54,6 +56,9 @@ namespace BOOM {
     void draw() override;
 
    private:
+    // Give each data model its own PoissonGammaSampler, seeded from rng().
+    void ensure_data_model_samplers();
+
     HierarchicalPoissonModel *model_;
     Ptr<DoubleModel> gamma_mean_prior_;
     Ptr<DoubleModel> gamma_sample_size_prior_;
@@ -53,19 +53,29 @@ namespace BOOM {
     BetaModel *zero_probability_prior = model_->prior_for_zero_probability();
     zero_probability_prior->clear_data();
 
-    for (int i = 0; i < model_->number_of_groups(); ++i) {
+    int number_of_groups = model_->number_of_groups();
+    for (int i = 0; i < number_of_groups; ++i) {
       ZeroInflatedPoissonModel *data_level_model = model_->data_model(i);
       if (data_level_model->number_of_sampling_methods() == 0) {
         NEW(ZeroInflatedPoissonSampler, sampler)
         (data_level_model, lambda_prior, zero_probability_prior, rng());
         data_level_model->set_method(sampler);
       }
+    }
+
+    int nblocks = number_of_blocks(number_of_groups);
+    std::vector<Ptr<GammaSuf>> lambda_suf =
+        partial_sufstats(lambda_prior->suf(), nblocks);
+    std::vector<Ptr<BetaSuf>> zero_probability_suf =
+        partial_sufstats(zero_probability_prior->suf(), nblocks);
+    draw_groups(number_of_groups, [&](int group, int block) {
+      ZeroInflatedPoissonModel *data_level_model = model_->data_model(group);
       data_level_model->sample_posterior();
       double lambda = data_level_model->lambda();
       if (lambda <= 0.0) {
         report_error("Data level model had zero value for lambda.");
       }
-      lambda_prior->suf()->update_raw(lambda);
+      lambda_suf[block]->update_raw(lambda);
 
       double zero_probability = data_level_model->zero_probability();
       if (zero_probability <= 0.0) {
@@ -73,9 +83,11 @@ namespace BOOM {
       } else if (zero_probability >= 1.0) {
         report_error("data_level_model had a zero_probability of 1.0");
       }
-      zero_probability_prior->suf()->update_raw(
-          data_level_model->zero_probability());
-    }
+      zero_probability_suf[block]->update_raw(zero_probability);
+    });
+    combine_partial_sufstats(lambda_prior->suf(), lambda_suf);
+    combine_partial_sufstats(zero_probability_prior->suf(),
+                             zero_probability_suf);
 
     lambda_prior_sampler_.draw();
     zero_probability_prior_sampler_.draw();
@@ -22,6 +22,7 @@
 
 #include "Models/DoubleModel.hpp"
 #include "Models/Hierarchical/HierarchicalZeroInflatedPoissonModel.hpp"
+#include "Models/Hierarchical/PosteriorSamplers/GroupLevelThreading.hpp"
 #include "Models/PosteriorSamplers/BetaPosteriorSampler.hpp"
 #include "Models/PosteriorSamplers/GammaPosteriorSampler.hpp"
 #include "Models/PosteriorSamplers/PosteriorSampler.hpp"
@@ -30,7 +31,8 @@
 
 namespace BOOM {
 
-  class HierarchicalZeroInflatedPoissonSampler : public PosteriorSampler {
+  class HierarchicalZeroInflatedPoissonSampler : public PosteriorSampler,
+                                                 public GroupLevelThreading {
    public:
     HierarchicalZeroInflatedPoissonSampler(
         HierarchicalZeroInflatedPoissonModel *model,
@@ -0,0 +1,213 @@
+#include "gtest/gtest.h"
+#include "Models/Glm/RegressionModel.hpp"
+#include "Models/Hierarchical/HierarchicalDirichletModel.hpp"
+#include "Models/Hierarchical/HierarchicalGammaModel.hpp"
+#include "Models/Hierarchical/HierarchicalGaussianRegressionModel.hpp"
+#include "Models/Hierarchical/HierarchicalPoissonModel.hpp"
+#include "Models/Hierarchical/HierarchicalZeroInflatedPoissonModel.hpp"
+#include "Models/Hierarchical/PosteriorSamplers/HierarchicalDirichletPosteriorSampler.hpp"
+#include "Models/Hierarchical/PosteriorSamplers/HierarchicalGammaSampler.hpp"
+#include "Models/Hierarchical/PosteriorSamplers/HierarchicalGaussianRegressionSampler.hpp"
+#include "Models/Hierarchical/PosteriorSamplers/HierarchicalPoissonSampler.hpp"
+#include "Models/Hierarchical/PosteriorSamplers/HierarchicalZeroInflatedPoissonSampler.hpp"
+#include "Models/ChisqModel.hpp"
+#include "Models/DirichletModel.hpp"
+#include "Models/GammaModel.hpp"
+#include "Models/MvnModel.hpp"
+#include "Models/PosteriorSamplers/MvnConjSampler.hpp"
+#include "Models/UniformModel.hpp"
+#include "distributions.hpp"
+
+#include "test_utils/test_utils.hpp"
+
+namespace {
+  using namespace BOOM;
+  using std::endl;
+
+  // Enough groups to fill several blocks, with a partial block at the end.
+  const int kNumberOfGroups = 150;
+  const int kNumberOfIterations = 5;
+
+  class HierarchicalSamplerThreadsTest : public ::testing::Test {
+   protected:
+    HierarchicalSamplerThreadsTest() {
+      GlobalRng::rng.seed(8675309);
+    }
+
+    // Run an MCMC chain with each thread count, and check that the draws
+    // are the same.  'run_chain' seeds, builds and runs a chain with the
+    // given number of threads, and returns the final parameter values.
+    template <class FUNCTION>
+    void CheckThreadCountDoesNotMatter(const FUNCTION &run_chain) {
+      Vector serial = run_chain(1);
+      EXPECT_GT(serial.size(), kNumberOfGroups);
+      EXPECT_TRUE(serial.all_finite());
+      for (int threads : {2, 4}) {
+        Vector threaded = run_chain(threads);
+        ASSERT_EQ(serial.size(), threaded.size());
+        EXPECT_DOUBLE_EQ(0.0, (serial - threaded).max_abs())
+            << "threads = " << threads;
+      }
+    }
+  };
+
+  TEST_F(HierarchicalSamplerThreadsTest, Poisson) {
+    CheckThreadCountDoesNotMatter([](int threads) {
+      GlobalRng::rng.seed(31337);
+      NEW(HierarchicalPoissonModel, model)(1.0, 2.0);
+      for (int i = 0; i < kNumberOfGroups; ++i) {
+        double exposure = 1 + rpois(10);
+        double lambda = rgamma(4.0, 2.0);
+        NEW(HierarchicalPoissonData, data_point)(
+            rpois(exposure * lambda), exposure);
+        model->add_data(data_point);
+      }
+      NEW(UniformModel, mean_prior)(0.0, 10.0);
+      NEW(UniformModel, sample_size_prior)(0.0, 100.0);
+      NEW(HierarchicalPoissonSampler, sampler)(
+          model.get(), mean_prior, sample_size_prior);
+      sampler->set_number_of_threads(threads);
+      model->set_method(sampler);
+      for (int i = 0; i < kNumberOfIterations; ++i) {
+        model->sample_posterior();
+      }
+      return model->vectorize_params(true);
+    });
+  }
+
+  TEST_F(HierarchicalSamplerThreadsTest, GaussianRegression) {
+    CheckThreadCountDoesNotMatter([](int threads) {
+      GlobalRng::rng.seed(31337);
+      int xdim = 3;
+      int nobs = 20;
+      NEW(MvnModel, prior)(Vector(xdim, 0.0), SpdMatrix(xdim, 1.0));
+      NEW(MvnConjSampler, prior_sampler)(
+          prior.get(), Vector(xdim, 0.0), 1.0, SpdMatrix(xdim, 1.0), xdim + 1);
+      prior->set_method(prior_sampler);
+      NEW(HierarchicalGaussianRegressionModel, model)(prior);
+      Vector beta(xdim);
+      beta.randomize_gaussian();
+      for (int i = 0; i < kNumberOfGroups; ++i) {
+        Matrix X(nobs, xdim);
+        X.randomize_gaussian();
+        Vector group_beta = rmvn(beta, SpdMatrix(xdim, 0.25));
+        Vector y = X * group_beta;
+        for (int j = 0; j < nobs; ++j) y[j] += rnorm();
+        model->add_data(Ptr<RegSuf>(new NeRegSuf(X, y)));
+      }
+      NEW(ChisqModel, residual_precision_prior)(1.0, 1.0);
+      NEW(HierarchicalGaussianRegressionSampler, sampler)(
+          model.get(), residual_precision_prior);
+      sampler->set_number_of_threads(threads);
+      model->set_method(sampler);
+      for (int i = 0; i < kNumberOfIterations; ++i) {
+        model->sample_posterior();
+      }
+      Vector ans = model->vectorize_params(true);
+      for (int i = 0; i < model->number_of_groups(); ++i) {
+        ans.concat(model->data_model(i)->Beta());
+      }
+      return ans;
+    });
+  }
+
+  TEST_F(HierarchicalSamplerThreadsTest, Gamma) {
+    CheckThreadCountDoesNotMatter([](int threads) {
+      GlobalRng::rng.seed(31337);
+      std::vector<int> counts;
+      std::vector<double> sums;
+      std::vector<double> sum_logs;
+      for (int i = 0; i < kNumberOfGroups; ++i) {
+        double mean = rgamma(6.0, 2.0);
+        double shape = rgamma(4.0, 1.0);
+        int n = 5 + rpois(5);
+        double sum = 0;
+        double sum_log = 0;
+        for (int j = 0; j < n; ++j) {
+          double y = rgamma(shape, shape / mean);
+          sum += y;
+          sum_log += log(y);
+        }
+        counts.push_back(n);
+        sums.push_back(sum);
+        sum_logs.push_back(sum_log);
+      }
+      NEW(HierarchicalGammaModel, model)(counts, sums, sum_logs);
+      NEW(GammaModel, mean_mean_prior)(1.0, 1.0);
+      NEW(GammaModel, mean_shape_prior)(1.0, 1.0);
+      NEW(GammaModel, shape_mean_prior)(1.0, 1.0);
+      NEW(GammaModel, shape_shape_prior)(1.0, 1.0);
+      NEW(HierarchicalGammaSampler, sampler)(
+          model.get(), mean_mean_prior, mean_shape_prior, shape_mean_prior,
+          shape_shape_prior);
+      sampler->set_number_of_threads(threads);
+      model->set_method(sampler);
+      for (int i = 0; i < kNumberOfIterations; ++i) {
+        model->sample_posterior();
+      }
+      return model->vectorize_params(true);
+    });
+  }
+
+  TEST_F(HierarchicalSamplerThreadsTest, ZeroInflatedPoisson) {
+    CheckThreadCountDoesNotMatter([](int threads) {
+      GlobalRng::rng.seed(31337);
+      Vector trials(kNumberOfGroups);
+      Vector events(kNumberOfGroups);
+      Vector zeros(kNumberOfGroups);
+      for (int i = 0; i < kNumberOfGroups; ++i) {
+        double lambda = rgamma(6.0, 2.0);
+        double zero_probability = rbeta(3.0, 7.0);
+        trials[i] = 20 + rpois(10);
+        events[i] = zeros[i] = 0;
+        for (int j = 0; j < trials[i]; ++j) {
+          int y = runif() < zero_probability ? 0 : rpois(lambda);
+          events[i] += y;
+          zeros[i] += (y == 0);
+        }
+      }
+      NEW(HierarchicalZeroInflatedPoissonModel, model)(trials, events, zeros);
+      NEW(UniformModel, lambda_mean_prior)(0.0, 20.0);
+      NEW(UniformModel, lambda_sample_size_prior)(0.0, 100.0);
+      NEW(UniformModel, zero_probability_mean_prior)(0.0, 1.0);
+      NEW(UniformModel, zero_probability_sample_size_prior)(0.0, 100.0);
+      NEW(HierarchicalZeroInflatedPoissonSampler, sampler)(
+          model.get(), lambda_mean_prior, lambda_sample_size_prior,
+          zero_probability_mean_prior, zero_probability_sample_size_prior);
+      sampler->set_number_of_threads(threads);
+      model->set_method(sampler);
+      for (int i = 0; i < kNumberOfIterations; ++i) {
+        model->sample_posterior();
+      }
+      return model->vectorize_params(true);
+    });
+  }
+
+  TEST_F(HierarchicalSamplerThreadsTest, Dirichlet) {
+    CheckThreadCountDoesNotMatter([](int threads) {
+      GlobalRng::rng.seed(31337);
+      Vector mean = {0.2, 0.3, 0.5};
+      NEW(HierarchicalDirichletModel, model)(10.0, mean);
+      for (int i = 0; i < kNumberOfGroups; ++i) {
+        Vector probs = rdirichlet(mean * 10.0);
+        Vector counts(3, 0.0);
+        for (int j = 0; j < 25; ++j) {
+          counts[rmulti(probs)] += 1;
+        }
+        NEW(HierarchicalDirichletData, data_point)(MultinomialSuf(counts));
+        model->add_data(data_point);
+      }
+      NEW(DirichletModel, mean_prior)(Vector(3, 1.0));
+      NEW(GammaModel, sample_size_prior)(1.0, 0.1);
+      NEW(HierarchicalDirichletPosteriorSampler, sampler)(
+          model.get(), mean_prior, sample_size_prior);
+      sampler->set_number_of_threads(threads);
+      model->set_method(sampler);
+      for (int i = 0; i < kNumberOfIterations; ++i) {
+        model->sample_posterior();
+      }
+      return model->vectorize_params(true);
+    });
+  }
+
+}  // namespace
@@ -0,0 +1,131 @@
+#include "gtest/gtest.h"
+#include "distributions.hpp"
+
+#include "Models/FiniteMixtureModel.hpp"
+#include "Models/GaussianModel.hpp"
+#include "Models/MultinomialModel.hpp"
+#include "Models/MvnModel.hpp"
+#include "Models/PoissonModel.hpp"
+
+#include "test_utils/test_utils.hpp"
+
+namespace {
+  using namespace BOOM;
+  using std::endl;
+
+  class FiniteMixtureTest : public ::testing::Test {
+   protected:
+    FiniteMixtureTest() {
+      GlobalRng::rng.seed(8675309);
+    }
+
+    // Check that batch_logp agrees with pdf, one observation at a time.  The
+    // second observation in 'data' is marked missing.
+    void CheckBatchLogp(const MixtureComponent &model,
+                        std::vector<Ptr<Data>> &data) {
+      data[1]->set_missing_status(Data::completely_missing);
+      int begin = 1;
+      Vector ans(data.size() - begin, -1.0);
+      model.batch_logp(data, begin, VectorView(ans));
+      EXPECT_DOUBLE_EQ(ans[0], 0.0);
+      for (int i = 1; i < ans.size(); ++i) {
+        EXPECT_NEAR(ans[i], model.pdf(data[begin + i].get(), true), 1e-8)
+            << "observation " << begin + i;
+      }
+    }
+
+    // A mixture of three Gaussians with well separated means.
+    Ptr<FiniteMixtureModel> SimulateGaussianMixture(int sample_size) {
+      Vector mu = {-3, 0, 4};
+      std::vector<Ptr<GaussianModel>> components;
+      for (int s = 0; s < mu.size(); ++s) {
+        components.push_back(new GaussianModel(mu[s], 1.0));
+      }
+      NEW(MultinomialModel, mixing_distribution)(Vector{.2, .3, .5});
+      NEW(FiniteMixtureModel, model)(components, mixing_distribution);
+      for (int i = 0; i < sample_size; ++i) {
+        int s = rmulti(mixing_distribution->pi());
+        model->add_data(new DoubleData(rnorm(mu[s], 1.0)));
+      }
+      return model;
+    }
+  };
+
+  TEST_F(FiniteMixtureTest, BatchLogpMatchesPdf) {
+    std::vector<Ptr<Data>> data;
+    for (int i = 0; i < 10; ++i) {
+      data.push_back(new DoubleData(rnorm(1, 2)));
+    }
+    CheckBatchLogp(GaussianModel(1.2, 1.7), data);
+
+    data.clear();
+    for (int i = 0; i < 10; ++i) {
+      data.push_back(new IntData(rpois(3.0)));
+    }
+    CheckBatchLogp(PoissonModel(2.5), data);
+
+    data.clear();
+    for (int i = 0; i < 10; ++i) {
+      data.push_back(new CategoricalData(random_int(0, 2), 3));
+    }
+    CheckBatchLogp(MultinomialModel(Vector{.2, .3, .5}), data);
+
+    // Use more observations than the block size in MvnModel::batch_logp.
+    data.clear();
+    SpdMatrix Sigma(3, .4);
+    Sigma.diag() = 1.0;
+    Vector mu = {1, 2, 3};
+    for (int i = 0; i < 600; ++i) {
+      data.push_back(new VectorData(rmvn(mu, Sigma)));
+    }
+    CheckBatchLogp(MvnModel(mu, Sigma), data);
+  }
+
+  // Threaded imputation should not depend on the number of threads, and it
+  // should leave each component with the data assigned to it.
+  TEST_F(FiniteMixtureTest, ThreadedImputation) {
+    Ptr<FiniteMixtureModel> model = SimulateGaussianMixture(1000);
+    model->add_data(new DoubleData(0.0));
+    model->dat().back()->set_missing_status(Data::completely_missing);
+
+    model->impute_latent_data(GlobalRng::rng);
+    Matrix sequential_probs = model->class_membership_probability();
+    double sequential_loglike = model->last_loglike();
+
+    model->set_number_of_threads(2);
+    RNG rng2(12345);
+    model->impute_latent_data(rng2);
+    Vector two_thread_classes = model->class_assignment();
+    EXPECT_TRUE(MatrixEquals(sequential_probs,
+                             model->class_membership_probability()));
+    EXPECT_NEAR(sequential_loglike, model->last_loglike(), 1e-6);
+    EXPECT_TRUE(VectorEquals(
+        model->class_membership_probability().row(model->dat().size() - 1),
+        model->pi()));
+
+    model->set_number_of_threads(3);
+    RNG rng3(12345);
+    model->impute_latent_data(rng3);
+    EXPECT_TRUE(VectorEquals(two_thread_classes, model->class_assignment()));
+
+    for (int s = 0; s < model->number_of_mixture_components(); ++s) {
+      GaussianModel *component =
+          dynamic_cast<GaussianModel *>(model->mixture_component(s).get());
+      double n = 0;
+      double sum = 0;
+      for (int i = 0; i < two_thread_classes.size(); ++i) {
+        if (two_thread_classes[i] == s) {
+          ++n;
+          const Ptr<Data> &dp(model->dat()[i]);
+          if (dp->missing() == Data::observed) {
+            sum += dp.dcast<DoubleData>()->value();
+          }
+        }
+      }
+      EXPECT_EQ(component->number_of_observations(), n);
+      EXPECT_NEAR(component->suf()->sum(), sum, 1e-8);
+      EXPECT_DOUBLE_EQ(model->mixing_distribution()->suf()->n()[s], n);
+    }
+  }
+
+}  // namespace
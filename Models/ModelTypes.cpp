@@ -231,4 +231,13 @@ namespace BOOM {
     return Logp(x, g, h, 2);
   }
 
+  //============================================================
+  void MixtureComponent::batch_logp(const std::vector<Ptr<Data>> &data,
+                                    int begin, VectorView ans) const {
+    for (int i = 0; i < ans.size(); ++i) {
+      const Data *dp = data[begin + i].get();
+      ans[i] = dp->missing() == Data::observed ? pdf(dp, true) : 0.0;
+    }
+  }
+
 }  // namespace BOOM
@@ -285,6 +285,21 @@ namespace BOOM {
 
     virtual double pdf(const Data *, bool logscale) const = 0;
 
+    // Evaluate the log density of a contiguous block of observations.
+    // Args:
+    //   data:  The full set of observations.
+    //   begin:  The index in 'data' of the first observation in the block.
+    //   ans: On output ans[i] is pdf(data[begin + i], true), or 0 if
+    //     data[begin + i] is missing.  The size of ans determines the size
+    //     of the block.
+    //
+    // The default implementation calls pdf() once per observation.  Models
+    // that can share work across observations should override it.  Like
+    // pdf(), this function may touch cached values of the model parameters,
+    // so it should not be called on the same model from multiple threads.
+    virtual void batch_logp(const std::vector<Ptr<Data>> &data, int begin,
+                            VectorView ans) const;
+
     // The number of data points that have been allocated to this model.  This
     // might have been called "sample_size", but that sometimes refers to
     // certain model parameters, such as the beta distribution.
@@ -228,6 +228,24 @@ namespace BOOM {
     return logscale ? logp_[i] : pi(i);
   }
 
+  void MM::batch_logp(const std::vector<Ptr<Data>> &data, int begin,
+                      VectorView ans) const {
+    check_logp();
+    for (int i = 0; i < ans.size(); ++i) {
+      const Data *dp = data[begin + i].get();
+      if (dp->missing() == Data::observed) {
+        uint level = DAT(dp)->value();
+        if (level >= dim()) {
+          report_error(
+              "too large a value passed to MultinomialModel::batch_logp");
+        }
+        ans[i] = logp_[level];
+      } else {
+        ans[i] = 0.0;
+      }
+    }
+  }
+
   double MM::pdf(const Ptr<Data> &dp, bool logscale) const {
     check_logp();
     uint i = DAT(dp)->value();
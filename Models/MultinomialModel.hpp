@@ -100,6 +100,8 @@ namespace BOOM {
     double log_likelihood() const override { return loglike(pi()); }
     void mle() override;
     double pdf(const Data *dp, bool logscale) const override;
+    void batch_logp(const std::vector<Ptr<Data>> &data, int begin,
+                    VectorView ans) const override;
     double pdf(const Ptr<Data> &dp, bool logscale) const;
     void add_mixture_data(const Ptr<Data> &, double prob);
     int number_of_observations() const override { return suf()->n().sum(); }
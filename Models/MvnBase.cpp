@@ -99,6 +99,10 @@ namespace BOOM {
   }
 
   void MvnSuf::remove_data(const Vector &y) {
+    remove_data(ConstVectorView(y));
+  }
+
+  void MvnSuf::remove_data(const ConstVectorView &y) {
     if (n_ <= 0.0) {
       report_error("Sufficient statistics already empty.");
     }
@@ -107,7 +111,9 @@ namespace BOOM {
     if (n_ > 1.0) {
       ybar_ /= (n_ - 1);
     }
-    sumsq_.add_outer(y - ybar_, -(n_ - 1) / n_, false);
+    wsp_ = y;
+    wsp_ -= ybar_;
+    sumsq_.add_outer(wsp_, -(n_ - 1) / n_, false);
     n_ -= 1.0;
     sym_ = false;
   }
@@ -50,6 +50,17 @@ namespace BOOM {
     // Remove the vector x from the set of sufficient statistics,
     // assuming that x was previously added.
     void remove_data(const Vector &x);
+    void remove_data(const ConstVectorView &x);
+    bool can_remove() const override { return true; }
+    void Remove(const VectorData &x) override { remove_data(x.value()); }
+    int removal_size(const VectorData &x) const override { return x.dim(); }
+    void store_removal_values(const VectorData &x,
+                              VectorView dest) const override {
+      dest = x.value();
+    }
+    void remove_stored_values(const ConstVectorView &values) override {
+      remove_data(values);
+    }
 
     Vector sum() const;
     SpdMatrix sumsq() const;  // Un-centered sum of squares
@@ -18,6 +18,7 @@
 */
 
 #include "Models/MvnModel.hpp"
+#include <algorithm>
 #include <cmath>
 #include "LinAlg/SpdMatrix.hpp"
 #include "LinAlg/Vector.hpp"
@@ -25,6 +26,7 @@
 #include "Models/PosteriorSamplers/HierarchicalPosteriorSampler.hpp"
 #include "Models/PosteriorSamplers/MvnConjSampler.hpp"
 #include "Models/WishartModel.hpp"
+#include "cpputil/Constants.hpp"
 #include "cpputil/math_utils.hpp"
 #include "distributions.hpp"
 
@@ -53,6 +55,43 @@ namespace BOOM {
     return logscale ? ans : exp(ans);
   }
 
+  // With siginv = L * L^T, the Mahalanobis distance of y from mu is
+  // |L^T (y - mu)|^2.  Observations are processed in blocks, so the
+  // distances for a block come from a single matrix product.
+  void MvnModel::batch_logp(const std::vector<Ptr<Data>> &data, int begin,
+                            VectorView ans) const {
+    const int block_size = 256;
+    int p = dim();
+    const Vector &mean(mu());
+    Matrix L = siginv().chol();
+    double normalizing_constant = 0.5 * ldsi() - p * Constants::log_root_2pi;
+    Matrix residuals;
+    Matrix scaled_residuals;
+    for (int start = 0; start < ans.size(); start += block_size) {
+      int size = std::min<int>(block_size, ans.size() - start);
+      residuals.resize(p, size);
+      scaled_residuals.resize(p, size);
+      for (int j = 0; j < size; ++j) {
+        const Data *dp = data[begin + start + j].get();
+        if (dp->missing() == Data::observed) {
+          residuals.col(j) = DAT(dp)->value();
+          residuals.col(j) -= mean;
+        } else {
+          residuals.col(j) = 0.0;
+        }
+      }
+      L.Tmult(residuals, scaled_residuals);
+      for (int j = 0; j < size; ++j) {
+        if (data[begin + start + j]->missing() == Data::observed) {
+          ans[start + j] =
+              normalizing_constant - 0.5 * scaled_residuals.col(j).normsq();
+        } else {
+          ans[start + j] = 0.0;
+        }
+      }
+    }
+  }
+
   double MvnModel::pdf(const Vector &x, bool logscale) const {
     double ans = logp(x);
     return logscale ? ans : exp(ans);
@@ -76,6 +76,8 @@ namespace BOOM {
 
     double pdf(const Ptr<Data> &dp, bool logscale) const;
     double pdf(const Data *, bool logscale) const override;
+    void batch_logp(const std::vector<Ptr<Data>> &data, int begin,
+                    VectorView ans) const override;
     double pdf(const Vector &x, bool logscale) const;
     int number_of_observations() const override { return dat().size(); }
 
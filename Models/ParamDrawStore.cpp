@@ -0,0 +1,104 @@
+/*
+  Copyright (C) 2019 Steven L. Scott
+
+  This library is free software; you can redistribute it and/or modify it under
+  the terms of the GNU Lesser General Public License as published by the Free
+  Software Foundation; either version 2.1 of the License, or (at your option)
+  any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT
+  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+  FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+  details.
+
+  You should have received a copy of the GNU Lesser General Public License along
+  with this library; if not, write to the Free Software Foundation, Inc., 51
+  Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+*/
+
+#include "Models/ParamDrawStore.hpp"
+
+#include <sstream>
+
+#include "Models/SpdData.hpp"
+#include "cpputil/report_error.hpp"
+
+namespace BOOM {
+
+  namespace {
+    std::vector<std::string> default_parameter_names(int number_of_names) {
+      std::vector<std::string> ans;
+      for (int i = 0; i < number_of_names; ++i) {
+        std::ostringstream name;
+        name << "parameter_" << i;
+        ans.push_back(name.str());
+      }
+      return ans;
+    }
+
+    std::vector<std::vector<int>> parameter_dims(
+        const std::vector<Ptr<Params>> &parameters) {
+      std::vector<std::vector<int>> ans;
+      for (const auto &parameter : parameters) {
+        ans.push_back(draw_store_dims(*parameter));
+      }
+      return ans;
+    }
+  }  // namespace
+
+  std::vector<int> draw_store_dims(const Params &parameter) {
+    const MatrixData *matrix = dynamic_cast<const MatrixData *>(&parameter);
+    if (matrix) {
+      return {static_cast<int>(matrix->nrow()),
+              static_cast<int>(matrix->ncol())};
+    }
+    const SpdData *variance = dynamic_cast<const SpdData *>(&parameter);
+    if (variance) {
+      int dim = variance->dim();
+      return {dim, dim};
+    }
+    return {static_cast<int>(parameter.size(false))};
+  }
+
+  ParamDrawStoreWriter::ParamDrawStoreWriter(
+      const std::string &filename, const std::vector<Ptr<Params>> &parameters,
+      const std::vector<std::string> &parameter_names, int chunk_size,
+      bool append)
+      : parameters_(parameters),
+        draw_(parameters.size()),
+        writer_(filename, parameter_names, parameter_dims(parameters),
+                chunk_size, append) {}
+
+  ParamDrawStoreWriter::ParamDrawStoreWriter(const std::string &filename,
+                                             const Ptr<Model> &model,
+                                             int chunk_size, bool append)
+      : parameters_(model->parameter_vector()),
+        draw_(parameters_.size()),
+        writer_(filename, default_parameter_names(parameters_.size()),
+                parameter_dims(parameters_), chunk_size, append) {}
+
+  void ParamDrawStoreWriter::write() {
+    for (int i = 0; i < parameters_.size(); ++i) {
+      draw_[i] = parameters_[i]->vectorize(false);
+    }
+    writer_.write(draw_);
+  }
+
+  void restore_from_draw_store(const DrawStoreReader &draws,
+                               const std::vector<Ptr<Params>> &parameters,
+                               std::int64_t iteration) {
+    if (parameters.size() != draws.number_of_parameters()) {
+      report_error("Wrong number of parameters passed to "
+                   "restore_from_draw_store.");
+    }
+    for (int i = 0; i < parameters.size(); ++i) {
+      if (draw_store_dims(*parameters[i]) != draws.parameter_dims(i)) {
+        report_error("Parameter " + draws.parameter_name(i) +
+                     " does not match the dimensions recorded in the draw "
+                     "store.");
+      }
+      parameters[i]->unvectorize(Vector(draws.draw(i, iteration)), false);
+    }
+  }
+
+}  // namespace BOOM
@@ -0,0 +1,84 @@
+#ifndef BOOM_MODELS_PARAM_DRAW_STORE_HPP_
+#define BOOM_MODELS_PARAM_DRAW_STORE_HPP_
+/*
+  Copyright (C) 2019 Steven L. Scott
+
+  This library is free software; you can redistribute it and/or modify it under
+  the terms of the GNU Lesser General Public License as published by the Free
+  Software Foundation; either version 2.1 of the License, or (at your option)
+  any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT
+  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+  FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+  details.
+
+  You should have received a copy of the GNU Lesser General Public License along
+  with this library; if not, write to the Free Software Foundation, Inc., 51
+  Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+*/
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Models/ModelTypes.hpp"
+#include "Models/ParamTypes.hpp"
+#include "cpputil/DrawStore.hpp"
+
+namespace BOOM {
+
+  // The dimensions under which 'parameter' is recorded in a draw store:
+  // {nrow, ncol} for matrix valued parameters (including variance matrices),
+  // and {size} for everything else.
+  std::vector<int> draw_store_dims(const Params &parameter);
+
+  // Records MCMC draws of a set of Params in a draw store (see
+  // cpputil/DrawStore.hpp).  A draw is the value of
+  // parameter->vectorize(false), so matrix valued parameters are stored in
+  // full, and can be rebuilt from the dimensions in the file header.
+  class ParamDrawStoreWriter {
+   public:
+    // Args:
+    //   filename:  The name of the file to write.
+    //   parameters:  The parameters whose values are to be recorded.
+    //   parameter_names:  Names for each element of 'parameters'.
+    //   chunk_size: The number of iterations to buffer before handing a chunk
+    //     to the writer thread.
+    //   append: If true and 'filename' already contains a draw store, then new
+    //     draws are appended to it (e.g. when restarting an MCMC run).
+    ParamDrawStoreWriter(const std::string &filename,
+                         const std::vector<Ptr<Params>> &parameters,
+                         const std::vector<std::string> &parameter_names,
+                         int chunk_size = 1000,
+                         bool append = false);
+
+    // Record the parameters of 'model', as given by model->parameter_vector().
+    // The parameters are named "parameter_0", "parameter_1", ...
+    ParamDrawStoreWriter(const std::string &filename, const Ptr<Model> &model,
+                         int chunk_size = 1000, bool append = false);
+
+    // Record the current values of the parameters.
+    void write();
+
+    // Wait until all recorded draws have been written to disk.
+    void flush() { writer_.flush(); }
+
+    std::int64_t number_of_draws() const { return writer_.number_of_draws(); }
+
+   private:
+    std::vector<Ptr<Params>> parameters_;
+    std::vector<Vector> draw_;
+    DrawStoreWriter writer_;
+  };
+
+  // Set each element of 'parameters' to its value at the given iteration of
+  // 'draws', e.g. to restart an MCMC run from the last stored draw.  The
+  // dimensions of the parameters must match those in the file.
+  void restore_from_draw_store(const DrawStoreReader &draws,
+                               const std::vector<Ptr<Params>> &parameters,
+                               std::int64_t iteration);
+
+}  // namespace BOOM
+
+#endif  // BOOM_MODELS_PARAM_DRAW_STORE_HPP_
@@ -188,6 +188,25 @@ namespace BOOM {
   double PoissonModel::pdf(const Data *dp, bool logscale) const {
     return dpois(DAT(dp)->value(), lam(), logscale);
   }
+  void PoissonModel::batch_logp(const std::vector<Ptr<Data>> &data,
+                                int begin, VectorView ans) const {
+    double lambda = lam();
+    if (lambda <= 0) {
+      MixtureComponent::batch_logp(data, begin, ans);
+      return;
+    }
+    double log_lambda = log(lambda);
+    for (int i = 0; i < ans.size(); ++i) {
+      const Data *dp = data[begin + i].get();
+      if (dp->missing() == Data::observed) {
+        int y = DAT(dp)->value();
+        ans[i] = y < 0 ? negative_infinity()
+                       : y * log_lambda - lambda - lgamma(y + 1.0);
+      } else {
+        ans[i] = 0.0;
+      }
+    }
+  }
   double PoissonModel::mean() const { return lam(); }
   double PoissonModel::var() const { return lam(); }
   double PoissonModel::sd() const { return sqrt(lam()); }
@@ -101,6 +101,8 @@ namespace BOOM {
     // probability calculations
     virtual double pdf(const Ptr<Data> &dp, bool logscale) const;
     double pdf(const Data *x, bool logscale) const override;
+    void batch_logp(const std::vector<Ptr<Data>> &data, int begin,
+                    VectorView ans) const override;
     double pdf(uint x, bool logscale) const;
     double logp(int x) const override;
     int number_of_observations() const override { return dat().size(); }
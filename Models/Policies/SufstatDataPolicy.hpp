@@ -19,12 +19,37 @@
 #ifndef BOOM_IID_SUFSTAT_DATA_POLICY_HPP
 #define BOOM_IID_SUFSTAT_DATA_POLICY_HPP
 
+#include <cstdint>
+#include <mutex>
 #include "Models/Policies/IID_DataPolicy.hpp"
 #include "Models/Sufstat.hpp"
 #include "cpputil/Ptr.hpp"
 
 namespace BOOM {
 
+  namespace SufstatDataPolicyDetails {
+    // The SufstatDetails<D> interface of 'suf', or nullptr if it has none.
+    // Some models hold their sufficient statistics through an abstract base
+    // class (e.g. RegSuf) that does not inherit from SufstatDetails, so the
+    // interface is found with a cross cast.
+    template <class D, class S>
+    SufstatDetails<D> *details(S *suf) {
+      return dynamic_cast<SufstatDetails<D> *>(suf);
+    }
+
+    template <class D, class S>
+    bool can_remove(S *suf) {
+      SufstatDetails<D> *suf_details = details<D>(suf);
+      return suf_details && suf_details->can_remove();
+    }
+
+
+    // An incremental refresh removes and re-adds each changed observation, so
+    // once more than this fraction of the data has changed it is cheaper to
+    // recompute the sufficient statistics from scratch.
+    const double kMaxIncrementalFraction = 0.5;
+  }  // namespace SufstatDataPolicyDetails
+
   template <class D, class S>
   class SufstatDataPolicy : public IID_DataPolicy<D> {
    public:
@@ -38,6 +63,7 @@ namespace BOOM {
     template <class FwdIt>
     SufstatDataPolicy(const Ptr<S> &, FwdIt Begin, FwdIt End);
     SufstatDataPolicy(const SufstatDataPolicy &);
+    ~SufstatDataPolicy() override { stop_tracking(); }
     SufstatDataPolicy *clone() const = 0;
     SufstatDataPolicy &operator=(const SufstatDataPolicy &);
 
@@ -70,34 +96,239 @@ namespace BOOM {
     void refresh_suf();
     void set_suf(const Ptr<S> &s) { suf_ = s; }
 
+    // Controls incremental updating of the sufficient statistics.  When
+    // enabled, refresh_suf() only revisits the observations that have
+    // signalled a change since the previous call, removing each one's old
+    // contribution to the sufficient statistics and adding the new one.  This
+    // makes refresh_suf() cost O(number of changed observations) rather than
+    // O(sample size).  Adding, removing, or clearing data causes the next
+    // refresh to start from scratch, as does a change to more than half the
+    // observations.  Only the values that Remove() needs are kept for each
+    // observation, not a copy of the data point.
+    //
+    // Args:
+    //   incremental: Whether incremental updates should be used.  Requires
+    //     sufficient statistics that implement Remove().
+    //   full_refresh_interval: The sufficient statistics are recomputed from
+    //     scratch after this many incremental updates, to keep rounding error
+    //     from accumulating.
+    //
+    // Changes are detected through Data::signal(), so data modified without
+    // signalling (e.g. set(value, false)), or elements of dat() replaced by
+    // direct assignment, will not be noticed.
+    void set_incremental_suf_updates(bool incremental = true,
+                                     int full_refresh_interval = 100);
+    bool incremental_suf_updates() const { return incremental_; }
+
    private:
+    // Register observers on each data point, and record the values that
+    // Remove() needs from each one as it entered the sufficient statistics.
+    void start_tracking();
+
+    // Remove the observers placed by start_tracking().
+    void stop_tracking();
+
+    // The key identifying the observers placed by this object.  The address
+    // of a data member is used instead of 'this' so the key cannot coincide
+    // with one used by the model containing the policy.
+    void *observer_key() { return &changed_; }
+
+    // Called by the observer on data point i.
+    void mark_changed(int i) {
+      std::lock_guard<std::mutex> lock(changed_mutex_);
+      changed_.push_back(i);
+    }
+
+    // Replace the contributions of the observations that changed since the
+    // last refresh.  Returns false, leaving suf_ in an undefined state, if a
+    // full refresh is needed instead.
+    bool incremental_refresh();
+
+    // The stored values for observation i.
+    VectorView stored_values(int i) {
+      return VectorView(stored_values_.data() + stored_value_offsets_[i],
+                        stored_value_offsets_[i + 1] - stored_value_offsets_[i],
+                        1);
+    }
+
+    // Register an observer with the data policy so that tracking stops when
+    // the data set changes.
+    void observe_data_set() {
+      DPBase::add_observer([this]() { this->stop_tracking(); });
+    }
+
     Ptr<S> suf_;
     bool only_keep_suf_;
+
+    bool incremental_;
+    int full_refresh_interval_;
+    int incremental_refresh_count_;
+    bool tracking_;
+    // The data points carrying observers placed by this object, the values
+    // Remove() needs from each one as it was last added to suf_, and their
+    // versions at that time.  The values are stored in a flat array, with
+    // those for observation i in positions stored_value_offsets_[i] up to
+    // stored_value_offsets_[i + 1].
+    std::vector<Ptr<DataType>> watched_;
+    std::vector<double> stored_values_;
+    std::vector<int> stored_value_offsets_;
+    std::vector<std::uint64_t> stored_versions_;
+    // Indices of the data points that have signalled a change since the last
+    // refresh.  Data can be modified from worker threads, so access is
+    // guarded by a mutex.
+    std::vector<int> changed_;
+    std::mutex changed_mutex_;
   };
   //======================================================================
   template <class D, class S>
   void SufstatDataPolicy<D, S>::refresh_suf() {
     if (only_keep_suf_) return;
+    if (tracking_ && stored_versions_.size() == this->dat().size() &&
+        incremental_refresh_count_ < full_refresh_interval_ &&
+        incremental_refresh()) {
+      return;
+    }
     suf()->clear();
     const DatasetType &d(this->dat());
     for (uint i = 0; i < d.size(); ++i) suf_->update(d[i]);
+    if (incremental_) start_tracking();
+  }
+
+  template <class D, class S>
+  void SufstatDataPolicy<D, S>::set_incremental_suf_updates(
+      bool incremental, int full_refresh_interval) {
+    if (incremental && !SufstatDataPolicyDetails::can_remove<DataType>(
+            suf_.get())) {
+      report_error("Incremental updates require sufficient statistics that "
+                   "support Remove().");
+    }
+    incremental_ = incremental;
+    full_refresh_interval_ = full_refresh_interval;
+    if (!incremental_) stop_tracking();
+  }
+
+  template <class D, class S>
+  void SufstatDataPolicy<D, S>::start_tracking() {
+    // The sufficient statistics may have been replaced by set_suf().
+    if (!SufstatDataPolicyDetails::can_remove<DataType>(suf_.get())) {
+      stop_tracking();
+      return;
+    }
+    SufstatDetails<DataType> *suf_details =
+        SufstatDataPolicyDetails::details<DataType>(suf_.get());
+    const DatasetType &d(this->dat());
+    if (!tracking_ || watched_.size() != d.size()) {
+      stop_tracking();
+      watched_ = d;
+      for (int i = 0; i < d.size(); ++i) {
+        d[i]->add_observer(observer_key(),
+                           [this, i]() { this->mark_changed(i); });
+      }
+      tracking_ = true;
+    }
+    stored_value_offsets_.resize(d.size() + 1);
+    stored_value_offsets_[0] = 0;
+    for (int i = 0; i < d.size(); ++i) {
+      stored_value_offsets_[i + 1] =
+          stored_value_offsets_[i] + suf_details->removal_size(*d[i]);
+    }
+    stored_values_.resize(stored_value_offsets_.back());
+    stored_versions_.resize(d.size());
+    for (int i = 0; i < d.size(); ++i) {
+      suf_details->store_removal_values(*d[i], stored_values(i));
+      stored_versions_[i] = d[i]->version();
+    }
+    std::lock_guard<std::mutex> lock(changed_mutex_);
+    changed_.clear();
+    incremental_refresh_count_ = 0;
+  }
+
+  template <class D, class S>
+  void SufstatDataPolicy<D, S>::stop_tracking() {
+    if (!tracking_) return;
+    for (auto &data_point : watched_) {
+      data_point->remove_observer(observer_key());
+    }
+    watched_.clear();
+    stored_values_.clear();
+    stored_value_offsets_.clear();
+    stored_versions_.clear();
+    tracking_ = false;
+    std::lock_guard<std::mutex> lock(changed_mutex_);
+    changed_.clear();
+  }
+
+  template <class D, class S>
+  bool SufstatDataPolicy<D, S>::incremental_refresh() {
+    std::vector<int> changed;
+    {
+      std::lock_guard<std::mutex> lock(changed_mutex_);
+      changed.swap(changed_);
+    }
+    const DatasetType &d(this->dat());
+    if (changed.size() >
+        SufstatDataPolicyDetails::kMaxIncrementalFraction * d.size()) {
+      return false;
+    }
+    SufstatDetails<DataType> *suf_details =
+        SufstatDataPolicyDetails::details<DataType>(suf_.get());
+    if (!suf_details || !suf_details->can_remove()) return false;
+    for (int i : changed) {
+      // An observation that changed several times appears more than once in
+      // 'changed', but only needs to be processed once.
+      if (d[i]->version() == stored_versions_[i]) continue;
+      VectorView old_values(stored_values(i));
+      suf_details->remove_stored_values(old_values);
+      suf_->update(d[i]);
+      if (suf_details->removal_size(*d[i]) != old_values.size()) {
+        // The new values do not fit in the old slot (e.g. the dimension of a
+        // predictor changed), so the storage must be rebuilt.
+        return false;
+      }
+      suf_details->store_removal_values(*d[i], old_values);
+      stored_versions_[i] = d[i]->version();
+    }
+    ++incremental_refresh_count_;
+    return true;
   }
 
   template <class D, class S>
   SufstatDataPolicy<D, S>::SufstatDataPolicy(const Ptr<S> &s)
-      : DPBase(), suf_(s), only_keep_suf_(false) {}
+      : DPBase(),
+        suf_(s),
+        only_keep_suf_(false),
+        incremental_(false),
+        full_refresh_interval_(100),
+        incremental_refresh_count_(0),
+        tracking_(false) {
+    observe_data_set();
+  }
 
   template <class D, class S>
   SufstatDataPolicy<D, S>::SufstatDataPolicy(const Ptr<S> &s,
                                              const DatasetType &d)
-      : DPBase(d), suf_(s), only_keep_suf_(false) {
+      : DPBase(d),
+        suf_(s),
+        only_keep_suf_(false),
+        incremental_(false),
+        full_refresh_interval_(100),
+        incremental_refresh_count_(0),
+        tracking_(false) {
+    observe_data_set();
     refresh_suf();
   }
 
   template <class D, class S>
   template <class FwdIt>
   SufstatDataPolicy<D, S>::SufstatDataPolicy(const Ptr<S> &s, FwdIt b, FwdIt e)
-      : DPBase(b, e), suf_(s), only_keep_suf_(false) {
+      : DPBase(b, e),
+        suf_(s),
+        only_keep_suf_(false),
+        incremental_(false),
+        full_refresh_interval_(100),
+        incremental_refresh_count_(0),
+        tracking_(false) {
+    observe_data_set();
     refresh_suf();
   }
 
@@ -106,7 +337,12 @@ namespace BOOM {
       : Model(rhs),
         DPBase(rhs),
         suf_(rhs.suf_->clone()),
-        only_keep_suf_(rhs.only_keep_suf_) {
+        only_keep_suf_(rhs.only_keep_suf_),
+        incremental_(rhs.incremental_),
+        full_refresh_interval_(rhs.full_refresh_interval_),
+        incremental_refresh_count_(0),
+        tracking_(false) {
+    observe_data_set();
     refresh_suf();
   }
 
@@ -114,9 +350,12 @@ namespace BOOM {
   SufstatDataPolicy<D, S> &SufstatDataPolicy<D, S>::operator=(
       const SufstatDataPolicy &rhs) {
     if (&rhs != this) {
+      stop_tracking();
       DPBase::operator=(rhs);
       suf_ = rhs.suf_->clone();
       only_keep_suf_ = rhs.only_keep_suf_;
+      incremental_ = rhs.incremental_;
+      full_refresh_interval_ = rhs.full_refresh_interval_;
       refresh_suf();
     }
     return *this;
@@ -0,0 +1,223 @@
+#include "gtest/gtest.h"
+#include "Models/GaussianModel.hpp"
+#include "Models/MvnModel.hpp"
+#include "Models/Glm/RegressionModel.hpp"
+#include "Models/PoissonModel.hpp"
+#include "distributions.hpp"
+
+#include "test_utils/test_utils.hpp"
+
+namespace {
+  using namespace BOOM;
+  using std::endl;
+
+  class SufstatDataPolicyTest : public ::testing::Test {
+   protected:
+    SufstatDataPolicyTest() {
+      GlobalRng::rng.seed(8675309);
+    }
+  };
+
+  TEST_F(SufstatDataPolicyTest, DataVersion) {
+    NEW(DoubleData, y)(1.0);
+    EXPECT_EQ(0, y->version());
+    y->set(2.0);
+    EXPECT_EQ(1, y->version());
+    y->set(3.0, false);
+    EXPECT_EQ(1, y->version());
+    y->set_missing_status(Data::completely_missing);
+    EXPECT_EQ(2, y->version());
+    Ptr<DoubleData> copy(y->clone());
+    EXPECT_EQ(0, copy->version());
+  }
+
+  // Changing the missing status notifies observers, so incremental refreshes
+  // see the data point again.  Setting the current status is not a change.
+  TEST_F(SufstatDataPolicyTest, MissingStatus) {
+    NEW(DoubleData, y)(1.0);
+    int notifications = 0;
+    y->add_observer(this, [&notifications]() { ++notifications; });
+    y->set_missing_status(Data::completely_missing);
+    EXPECT_EQ(1, notifications);
+    y->set_missing_status(Data::completely_missing);
+    EXPECT_EQ(1, notifications);
+    y->set_missing_status(Data::observed);
+    EXPECT_EQ(2, notifications);
+    y->remove_observer(this);
+
+    GaussianModel model;
+    std::vector<Ptr<DoubleData>> data;
+    for (int i = 0; i < 20; ++i) {
+      NEW(DoubleData, data_point)(rnorm());
+      data.push_back(data_point);
+      model.add_data(data_point);
+    }
+    model.set_incremental_suf_updates(true);
+    model.refresh_suf();
+
+    // The new value is set without a signal, and is only picked up because
+    // the change in missing status signals.
+    data[4]->set(12.0, false);
+    data[4]->set_missing_status(Data::partly_missing);
+    model.refresh_suf();
+    GaussianSuf expected;
+    for (const auto &data_point : data) expected.update(data_point);
+    EXPECT_NEAR(expected.n(), model.suf()->n(), 1e-10);
+    EXPECT_NEAR(expected.sum(), model.suf()->sum(), 1e-10);
+    EXPECT_NEAR(expected.sumsq(), model.suf()->sumsq(), 1e-10);
+
+    data[4]->set(-3.0, false);
+    data[4]->set_missing_status(Data::observed);
+    model.refresh_suf();
+    expected.clear();
+    for (const auto &data_point : data) expected.update(data_point);
+    EXPECT_NEAR(expected.sum(), model.suf()->sum(), 1e-10);
+    EXPECT_NEAR(expected.sumsq(), model.suf()->sumsq(), 1e-10);
+  }
+
+  TEST_F(SufstatDataPolicyTest, GaussianIncremental) {
+    GaussianModel model;
+    std::vector<Ptr<DoubleData>> data;
+    for (int i = 0; i < 100; ++i) {
+      NEW(DoubleData, y)(rnorm());
+      data.push_back(y);
+      model.add_data(y);
+    }
+    model.set_incremental_suf_updates(true);
+    EXPECT_TRUE(model.incremental_suf_updates());
+    model.refresh_suf();
+
+    for (int iteration = 0; iteration < 5; ++iteration) {
+      for (int i = 0; i < 10; ++i) {
+        data[random_int(0, 99)]->set(rnorm(3, 1));
+      }
+      model.refresh_suf();
+      GaussianSuf expected;
+      for (const auto &y : data) expected.update(y);
+      EXPECT_NEAR(expected.n(), model.suf()->n(), 1e-10);
+      EXPECT_NEAR(expected.sum(), model.suf()->sum(), 1e-10);
+      EXPECT_NEAR(expected.sumsq(), model.suf()->sumsq(), 1e-10);
+    }
+
+    // Adding data switches back to a full refresh.
+    NEW(DoubleData, extra)(17.0);
+    data.push_back(extra);
+    model.add_data(extra);
+    data[3]->set(-4.0);
+    model.refresh_suf();
+    GaussianSuf expected;
+    for (const auto &y : data) expected.update(y);
+    EXPECT_NEAR(expected.n(), model.suf()->n(), 1e-10);
+    EXPECT_NEAR(expected.sum(), model.suf()->sum(), 1e-10);
+    EXPECT_NEAR(expected.sumsq(), model.suf()->sumsq(), 1e-10);
+
+    // Changes are picked up after the full refresh.
+    extra->set(0.0);
+    model.refresh_suf();
+    EXPECT_NEAR(expected.sum() - 17.0, model.suf()->sum(), 1e-10);
+  }
+
+  TEST_F(SufstatDataPolicyTest, RegressionIncremental) {
+    int n = 200;
+    int p = 4;
+    RegressionModel model(p);
+    for (int i = 0; i < n; ++i) {
+      Vector x(p);
+      x.randomize();
+      model.add_data(new RegressionData(rnorm(), x));
+    }
+    model.set_incremental_suf_updates(true, 3);
+    model.refresh_suf();
+
+    for (int iteration = 0; iteration < 7; ++iteration) {
+      for (int i = 0; i < 5; ++i) {
+        int which = random_int(0, n - 1);
+        model.dat()[which]->set_y(rnorm());
+        if (i == 0) {
+          Vector x(p);
+          x.randomize();
+          model.dat()[which]->set_x(x);
+        }
+      }
+      model.refresh_suf();
+      NeRegSuf expected(p);
+      for (const auto &data_point : model.dat()) expected.update(data_point);
+      EXPECT_TRUE(MatrixEquals(expected.xtx(), model.suf()->xtx(), 1e-8));
+      EXPECT_TRUE(VectorEquals(expected.xty(), model.suf()->xty(), 1e-8));
+      EXPECT_NEAR(expected.yty(), model.suf()->yty(), 1e-8);
+      EXPECT_NEAR(expected.n(), model.suf()->n(), 1e-8);
+    }
+  }
+
+  TEST_F(SufstatDataPolicyTest, MvnIncremental) {
+    MvnModel model(3);
+    std::vector<Ptr<VectorData>> data;
+    for (int i = 0; i < 50; ++i) {
+      Vector x(3);
+      x.randomize();
+      NEW(VectorData, data_point)(x);
+      data.push_back(data_point);
+      model.add_data(data_point);
+    }
+    model.set_incremental_suf_updates(true);
+    model.refresh_suf();
+    for (int i = 0; i < 8; ++i) {
+      Vector x(3);
+      x.randomize();
+      data[5 * i]->set(x);
+    }
+    model.refresh_suf();
+    MvnSuf expected(3);
+    for (const auto &x : data) expected.update(x);
+    EXPECT_NEAR(expected.n(), model.suf()->n(), 1e-10);
+    EXPECT_TRUE(VectorEquals(expected.ybar(), model.suf()->ybar(), 1e-10));
+    EXPECT_TRUE(MatrixEquals(expected.center_sumsq(),
+                             model.suf()->center_sumsq(), 1e-8));
+  }
+
+  // Changing most of the data falls back to a full refresh, which must give
+  // the same answer.
+  TEST_F(SufstatDataPolicyTest, ManyChanges) {
+    GaussianModel model;
+    std::vector<Ptr<DoubleData>> data;
+    for (int i = 0; i < 20; ++i) {
+      NEW(DoubleData, y)(rnorm());
+      data.push_back(y);
+      model.add_data(y);
+    }
+    model.set_incremental_suf_updates(true);
+    model.refresh_suf();
+    for (int iteration = 0; iteration < 3; ++iteration) {
+      for (int i = 0; i < 15; ++i) {
+        data[i]->set(rnorm(5, 1));
+      }
+      model.refresh_suf();
+      data[17]->set(rnorm());
+      model.refresh_suf();
+      GaussianSuf expected;
+      for (const auto &y : data) expected.update(y);
+      EXPECT_NEAR(expected.n(), model.suf()->n(), 1e-10);
+      EXPECT_NEAR(expected.sum(), model.suf()->sum(), 1e-10);
+      EXPECT_NEAR(expected.sumsq(), model.suf()->sumsq(), 1e-10);
+    }
+  }
+
+  TEST_F(SufstatDataPolicyTest, RequiresRemovableSufstats) {
+    PoissonModel model(1.0);
+    EXPECT_THROW(model.set_incremental_suf_updates(true), std::exception);
+  }
+
+  TEST_F(SufstatDataPolicyTest, ObserversRemovedOnDestruction) {
+    NEW(DoubleData, y)(1.0);
+    {
+      GaussianModel model;
+      model.add_data(y);
+      model.set_incremental_suf_updates(true);
+      model.refresh_suf();
+    }
+    // The model is gone, so the data must not try to notify it.
+    y->set(2.0);
+    EXPECT_DOUBLE_EQ(2.0, y->value());
+  }
+
+}  // namespace
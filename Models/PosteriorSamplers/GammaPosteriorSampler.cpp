@@ -131,9 +131,9 @@ namespace BOOM {
         mean_prior_(mean_prior),
         alpha_prior_(alpha_prior),
         mean_sampler_(GammaMeanAlphaLogPosterior(model_, mean_prior_.get()),
-                      true, 1.0, &seeding_rng),
+                      true, 1.0, &rng()),
         alpha_sampler_(GammaAlphaLogPosterior(model_, alpha_prior_.get()), true,
-                       1.0, &seeding_rng) {
+                       1.0, &rng()) {
     mean_sampler_.set_lower_limit(0);
     alpha_sampler_.set_lower_limit(0);
   }
@@ -0,0 +1,76 @@
+/*
+  Copyright (C) 2019 Steven L. Scott
+
+  This library is free software; you can redistribute it and/or modify it under
+  the terms of the GNU Lesser General Public License as published by the Free
+  Software Foundation; either version 2.1 of the License, or (at your option)
+  any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT
+  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+  FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+  details.
+
+  You should have received a copy of the GNU Lesser General Public License along
+  with this library; if not, write to the Free Software Foundation, Inc., 51
+  Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+*/
+
+#include "Models/PosteriorSamplers/HamiltonianMonteCarloPosteriorSampler.hpp"
+#include "cpputil/math_utils.hpp"
+
+namespace BOOM {
+
+  namespace {
+    // The log posterior density of the vectorized model parameters.
+    class LogPosterior : public dTargetFun {
+     public:
+      LogPosterior(dLoglikeModel *model, const Ptr<dVectorModel> &prior)
+          : model_(model), prior_(prior) {}
+
+      double operator()(const Vector &x) const override {
+        double ans = prior_->logp(x);
+        if (ans == negative_infinity()) return ans;
+        return ans + model_->loglike(x);
+      }
+
+      double operator()(const Vector &x, Vector &gradient) const override {
+        Vector prior_gradient(x.size(), 0.0);
+        double ans = prior_->dlogp(x, prior_gradient);
+        if (ans == negative_infinity()) return ans;
+        gradient.resize(x.size());
+        gradient = 0.0;
+        ans += model_->dloglike(x, gradient);
+        gradient += prior_gradient;
+        return ans;
+      }
+
+     private:
+      dLoglikeModel *model_;
+      Ptr<dVectorModel> prior_;
+    };
+  }  // namespace
+
+  HamiltonianMonteCarloPosteriorSampler::HamiltonianMonteCarloPosteriorSampler(
+      dLoglikeModel *model, const Ptr<dVectorModel> &prior, RNG &seeding_rng)
+      : PosteriorSampler(seeding_rng),
+        model_(model),
+        prior_(prior),
+        sampler_(new LogPosterior(model, prior), 0.1, &rng()) {}
+
+  void HamiltonianMonteCarloPosteriorSampler::draw() {
+    Vector parameters = model_->vectorize_params(true);
+    parameters = sampler_.draw(parameters);
+    model_->unvectorize_params(parameters, true);
+  }
+
+  double HamiltonianMonteCarloPosteriorSampler::logpri() const {
+    return prior_->logp(model_->vectorize_params(true));
+  }
+
+  double HamiltonianMonteCarloPosteriorSampler::log_prior_density(
+      const ConstVectorView &parameters) const {
+    return prior_->logp(Vector(parameters));
+  }
+
+}  // namespace BOOM
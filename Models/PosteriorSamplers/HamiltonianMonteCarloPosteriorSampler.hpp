@@ -0,0 +1,67 @@
+#ifndef BOOM_HAMILTONIAN_MONTE_CARLO_POSTERIOR_SAMPLER_HPP_
+#define BOOM_HAMILTONIAN_MONTE_CARLO_POSTERIOR_SAMPLER_HPP_
+
+/*
+  Copyright (C) 2019 Steven L. Scott
+
+  This library is free software; you can redistribute it and/or modify it under
+  the terms of the GNU Lesser General Public License as published by the Free
+  Software Foundation; either version 2.1 of the License, or (at your option)
+  any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT
+  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+  FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+  details.
+
+  You should have received a copy of the GNU Lesser General Public License along
+  with this library; if not, write to the Free Software Foundation, Inc., 51
+  Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+*/
+
+#include "Models/ModelTypes.hpp"
+#include "Models/PosteriorSamplers/PosteriorSampler.hpp"
+#include "Models/VectorModel.hpp"
+#include "Samplers/HamiltonianMonteCarlo.hpp"
+
+namespace BOOM {
+
+  // A posterior sampler for any model that can compute the gradient of its log
+  // likelihood.  The model parameters, as given by
+  // model->vectorize_params(true), are drawn jointly by Hamiltonian Monte
+  // Carlo (by default NUTS).  The parameter vector must be unconstrained, so
+  // models with constrained parameters (e.g. variances) need to be
+  // reparameterized before using this sampler.
+  //
+  // The step size and mass matrix of the underlying sampler can be adapted
+  // during burn-in.  See HamiltonianMonteCarlo::set_adaptation, which is
+  // available through sampler().
+  class HamiltonianMonteCarloPosteriorSampler : public PosteriorSampler {
+   public:
+    // Args:
+    //   model:  The model to be sampled.
+    //   prior: The prior distribution for the vectorized model parameters.
+    //   seeding_rng: The random number generator used to seed the RNG owned by
+    //     this sampler.
+    HamiltonianMonteCarloPosteriorSampler(dLoglikeModel *model,
+                                          const Ptr<dVectorModel> &prior,
+                                          RNG &seeding_rng = GlobalRng::rng);
+
+    void draw() override;
+    double logpri() const override;
+
+    bool can_evaluate_log_prior_density() const override { return true; }
+    double log_prior_density(const ConstVectorView &parameters) const override;
+
+    HamiltonianMonteCarlo &sampler() { return sampler_; }
+    const HamiltonianMonteCarlo &sampler() const { return sampler_; }
+
+   private:
+    dLoglikeModel *model_;
+    Ptr<dVectorModel> prior_;
+    HamiltonianMonteCarlo sampler_;
+  };
+
+}  // namespace BOOM
+
+#endif  // BOOM_HAMILTONIAN_MONTE_CARLO_POSTERIOR_SAMPLER_HPP_
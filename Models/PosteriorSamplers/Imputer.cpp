@@ -19,33 +19,55 @@
 
 #include "Models/PosteriorSamplers/Imputer.hpp"
 #include "cpputil/report_error.hpp"
+#include <algorithm>
 
 namespace BOOM {
 
   // This function must appear in a cpp file because the exception handling that
   // it does caused problems when it appeared in the header file.
+  void ParallelLatentDataImputer::set_observation_streams() {
+    if (!stream_key_rng_) return;
+    RNG::RngIntType key = stream_key_rng_->random_bits();
+    std::uint64_t first_observation = 0;
+    for (int i = 0; i < workers_.size(); ++i) {
+      workers_[i]->set_observation_streams(key, first_observation);
+      first_observation += workers_[i]->number_of_observations_managed();
+    }
+  }
+
   void ParallelLatentDataImputer::impute_latent_data() {
-    if (pool_.no_threads()) {
+    set_observation_streams();
+    if (number_of_threads_ == 0) {
       for (int i = 0; i < workers_.size(); ++i) {
         workers_[i]->impute_latent_data();
         workers_[i]->combine_complete_data();
       }
     } else {
-      std::vector<std::future<void>> jobs;
-      jobs.reserve(workers_.size());
-      for (int i = 0; i < workers_.size(); ++i) {
-        jobs.emplace_back(
-            pool_.submit(workers_[i]->data_imputation_callback()));
-      }
+      // Each worker records its own error message, so that all of them can be
+      // reported.
+      std::vector<std::string> worker_errors(workers_.size());
+      // The global pool may hold more threads than were requested here, so
+      // the workers are dealt into at most number_of_threads_ tasks.  That
+      // way no more than number_of_threads_ threads impute at once.
+      int number_of_tasks =
+          std::min<int>(number_of_threads_, workers_.size());
+      WorkStealingThreadPool::global().parallel_for(
+          0, number_of_tasks, 1,
+          [this, number_of_tasks, &worker_errors](int task) {
+            for (int i = task; i < workers_.size(); i += number_of_tasks) {
+              try {
+                workers_[i]->impute_and_combine_complete_data();
+              } catch (std::exception &e) {
+                worker_errors[i] = e.what();
+              } catch (...) {
+                worker_errors[i] = "Unknown exception.";
+              }
+            }
+          });
       std::vector<std::string> error_messages;
-      for (int i = 0; i < jobs.size(); ++i) {
-        try {
-          jobs[i].get();
-        } catch (std::exception &e) {
-          std::string message = e.what();
-          error_messages.push_back(message);
-        } catch (...) {
-          error_messages.push_back("Unknown exception.");
+      for (int i = 0; i < worker_errors.size(); ++i) {
+        if (!worker_errors[i].empty()) {
+          error_messages.push_back(worker_errors[i]);
         }
       }
       if (!error_messages.empty()) {
@@ -21,6 +21,7 @@
 #define BOOM_LATENT_DATA_IMPUTER_HPP
 
 #include <cstddef>
+#include <cstdint>
 #include <future>
 #include <memory>
 
@@ -29,6 +30,7 @@
 
 #include "cpputil/RefCounted.hpp"
 #include "cpputil/ThreadTools.hpp"
+#include "distributions/rng.hpp"
 
 // The main class implemented in this file is ParallelLatentDataImputer.
 //
@@ -81,15 +83,34 @@ namespace BOOM {
     // may have changed.
     virtual int number_of_observations_managed() const = 0;
 
+    // Requests that the next call to impute_latent_data() draw the latent data
+    // for each observation from its own random number stream, determined by
+    // 'key' and the observation's position in the full data set.  The imputed
+    // values then do not depend on how the data are divided among workers.
+    //
+    // Args:
+    //   key: The seed for the family of streams used on this iteration.
+    //   first_observation: The position in the full data set of the first
+    //     observation managed by this worker.
+    //
+    // The default implementation ignores the request, and the worker keeps
+    // using its own random number generator.
+    virtual void set_observation_streams(RNG::RngIntType key,
+                                         std::uint64_t first_observation) {}
+
     // Wraps this object in a callback which imputes the latent data and stores
     // it in a local repository.  The local repository is then combined with the
     // global repository in a thread-safe way.
     std::function<void(void)> data_imputation_callback() {
-      return [this]() {
-        this->impute_latent_data();
-        std::unique_lock<std::mutex> lock(shared_resource_mutex_);
-        this->combine_complete_data();
-      };
+      return [this]() { this->impute_and_combine_complete_data(); };
+    }
+
+    // Impute the latent data, then combine it with the global repository
+    // while holding the shared resource mutex.
+    void impute_and_combine_complete_data() {
+      impute_latent_data();
+      std::unique_lock<std::mutex> lock(shared_resource_mutex_);
+      combine_complete_data();
     }
 
    private:
@@ -136,7 +157,10 @@ namespace BOOM {
                         RNG &seeding_rng = GlobalRng::rng)
         : LatentDataImputerWorker(global_suf_mutex),
           suf_(global_suf.clone()),
-          global_suf_(global_suf) {
+          global_suf_(global_suf),
+          use_observation_streams_(false),
+          first_observation_(0),
+          observation_rng_(0, RNG::PHILOX) {
       if (!rng) {
         rng_storage_.reset(new RNG(seed_rng(seeding_rng)));
         rng_ = rng_storage_.get();
@@ -174,13 +198,31 @@ namespace BOOM {
 
     void impute_latent_data() override {
       suf_->clear();
-      for (Iterator it = observed_data_begin_; it != observed_data_end_; ++it) {
-        impute_latent_data_point(**it, suf_.get(), *rng_);
+      if (use_observation_streams_) {
+        std::uint64_t observation = first_observation_;
+        for (Iterator it = observed_data_begin_; it != observed_data_end_;
+             ++it) {
+          observation_rng_.jump(observation++);
+          impute_latent_data_point(**it, suf_.get(), observation_rng_);
+        }
+        use_observation_streams_ = false;
+      } else {
+        for (Iterator it = observed_data_begin_; it != observed_data_end_;
+             ++it) {
+          impute_latent_data_point(**it, suf_.get(), *rng_);
+        }
       }
     };
 
     void combine_complete_data() override { global_suf_.combine(*suf_); }
 
+    void set_observation_streams(RNG::RngIntType key,
+                                 std::uint64_t first_observation) override {
+      observation_rng_.seed(key);
+      first_observation_ = first_observation;
+      use_observation_streams_ = true;
+    }
+
    private:
     Ptr<SUFFICIENT_STATISTICS> suf_;
     SUFFICIENT_STATISTICS &global_suf_;
@@ -188,20 +230,34 @@ namespace BOOM {
     Iterator observed_data_end_;
     RNG *rng_;
     std::unique_ptr<RNG> rng_storage_;
+
+    // Per-observation streams requested by set_observation_streams().
+    bool use_observation_streams_;
+    std::uint64_t first_observation_;
+    RNG observation_rng_;
   };
 
   //======================================================================
-  // An object that manages the thread pool and the vector of workers
-  // responsible for imputing latent data.  Clients will typically not deal with
-  // this class directly.  It is part of the implementation for
-  // LatentDataSampler.
+  // An object that manages the vector of workers responsible for imputing
+  // latent data, and runs them on the global WorkStealingThreadPool.  Clients
+  // will typically not deal with this class directly.  It is part of the
+  // implementation for LatentDataSampler.
   class ParallelLatentDataImputer {
    public:
-    ParallelLatentDataImputer() {}
-
-    // Set the number of background threads to use for data augmentation.  If n
-    // <= 0 then no background threads are created.
-    void set_number_of_threads(int n) { pool_.set_number_of_threads(n); }
+    ParallelLatentDataImputer() : number_of_threads_(0) {}
+
+    // Set the number of threads to use for data augmentation.  If n <= 0 then
+    // the workers run sequentially in the calling thread.  Otherwise the
+    // global thread pool is grown (if needed) to at least n threads, and
+    // impute_latent_data() runs the workers on at most n of them, even if
+    // other clients have grown the pool further.
+    void set_number_of_threads(int n) {
+      number_of_threads_ = n > 0 ? n : 0;
+      if (number_of_threads_ > 0) {
+        WorkStealingThreadPool::global().set_minimum_number_of_threads(
+            number_of_threads_);
+      }
+    }
 
     // Add a worker.  The number of workers need not be the same as the number
     // of threads.
@@ -221,13 +277,30 @@ namespace BOOM {
       return ans;
     }
 
-    // Impute the latent data.  If the pool contains any threads then the work
-    // is done by the worker pool.  Otherwise it is done by the workers,
-    // sequentially.
+    // Give each observation its own counter based random number stream, so
+    // that the imputed latent data do not depend on the number of workers or
+    // threads.  Each call to impute_latent_data() draws a new key for the
+    // streams from a generator seeded with 'seed'.  Workers that do not
+    // support observation streams (see
+    // LatentDataImputerWorker::set_observation_streams) are unaffected.
+    void use_observation_streams(RNG::RngIntType seed) {
+      stream_key_rng_.reset(new RNG(seed, RNG::PHILOX));
+    }
+
+    // Impute the latent data.  If threads have been requested then the work
+    // is done by the global thread pool.  Otherwise it is done by the
+    // workers, sequentially.
     void impute_latent_data();
 
    private:
-    ThreadWorkerPool pool_;
+    // If observation streams are in use, pass a fresh key to the workers, along
+    // with the position of each worker's data in the full data set.  Assumes
+    // the data are divided among the workers in order, as in
+    // assign_data_to_workers().
+    void set_observation_streams();
+
+    int number_of_threads_;
+    std::unique_ptr<RNG> stream_key_rng_;
     std::vector<Ptr<LatentDataImputerWorker>> workers_;
   };
 
@@ -272,6 +345,12 @@ namespace BOOM {
       assign_data_to_workers();
     }
 
+    // Make the imputed latent data reproducible regardless of the number of
+    // workers.  See ParallelLatentDataImputer::use_observation_streams.
+    void use_observation_streams(RNG::RngIntType seed) {
+      imputer_.use_observation_streams(seed);
+    }
+
     // By default, this class updates its own latent data through a call to
     // impute_latent_data().  Calling this function with a 'true' argument (the
     // default), sets a flag that turns impute_latent_data into a no-op.  The
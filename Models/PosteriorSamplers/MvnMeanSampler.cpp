@@ -54,11 +54,13 @@ namespace BOOM {
     double n = s->n();
     double k = kappa->value();
     const SpdMatrix &Siginv(mvn->siginv());
-    SpdMatrix ivar = (n + k) * Siginv;
+    ivar_ = Siginv;
+    ivar_ *= n + k;
     double w = n / (n + k);
-    Vector mu = w * s->ybar() + (1.0 - w) * mu0->value();
-    mu = rmvn_ivar_mt(rng(), mu, ivar);
-    mvn->set_mu(mu);
+    mean_ = s->ybar();
+    mean_ *= w;
+    mean_.axpy(mu0->value(), 1.0 - w);
+    mvn->set_mu(rmvn_ivar_mt(rng(), mean_, ivar_));
   }
 
   double MCS::logpri() const {
@@ -103,9 +105,15 @@ namespace BOOM {
     double n = s->n();
     const SpdMatrix &siginv(mvn->siginv());
     const SpdMatrix &ominv(mu_prior_->siginv());
-    SpdMatrix Ivar = n * siginv + ominv;
-    Vector mu = Ivar.solve(n * (siginv * s->ybar()) + ominv * mu_prior_->mu());
-    mu = rmvn_ivar(mu, Ivar);
-    mvn->set_mu(mu);
+    ivar_ = siginv;
+    ivar_ *= n;
+    ivar_ += ominv;
+    // ivar_mu_ = n * siginv * ybar + ominv * mu0, accumulated in place.
+    ivar_mu_.resize(siginv.nrow());
+    prior_ivar_mu_.resize(ominv.nrow());
+    siginv.mult(s->ybar(), ivar_mu_, n);
+    ominv.mult(mu_prior_->mu(), prior_ivar_mu_);
+    ivar_mu_ += prior_ivar_mu_;
+    mvn->set_mu(rmvn_ivar(ivar_.solve(ivar_mu_), ivar_));
   }
 }  // namespace BOOM
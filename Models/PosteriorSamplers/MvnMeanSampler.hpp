@@ -51,6 +51,10 @@ namespace BOOM {
     MvnModel *mvn;
     Ptr<VectorParams> mu0;
     Ptr<UnivParams> kappa;
+
+    // Workspace reused across calls to draw().
+    SpdMatrix ivar_;
+    Vector mean_;
   };
   //____________________________________________________________
 
@@ -77,6 +81,11 @@ namespace BOOM {
    private:
     MvnModel *mvn;
     Ptr<MvnBase> mu_prior_;
+
+    // Workspace reused across calls to draw().
+    SpdMatrix ivar_;
+    Vector ivar_mu_;
+    Vector prior_ivar_mu_;
   };
   //____________________________________________________________
 }  // namespace BOOM
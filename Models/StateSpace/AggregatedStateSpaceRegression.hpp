@@ -311,6 +311,9 @@ namespace BOOM {
 
     SparseVector observation_matrix(int t) const override;
 
+    // The accumulator makes the model matrices depend on t.
+    bool is_time_invariant() const override { return false; }
+
     AccumulatorStateVarianceMatrix *state_variance_matrix(
         int t) const override;
 
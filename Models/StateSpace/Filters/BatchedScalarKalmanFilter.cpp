@@ -0,0 +1,423 @@
+/*
+  Copyright (C) 2019 Steven L. Scott
+
+  This library is free software; you can redistribute it and/or modify it under
+  the terms of the GNU Lesser General Public License as published by the Free
+  Software Foundation; either version 2.1 of the License, or (at your option)
+  any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT
+  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+  FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+  details.
+
+  You should have received a copy of the GNU Lesser General Public License along
+  with this library; if not, write to the Free Software Foundation, Inc., 51
+  Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+*/
+
+#include "Models/StateSpace/Filters/BatchedScalarKalmanFilter.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "Models/StateSpace/StateSpaceModelBase.hpp"
+#include "cpputil/Constants.hpp"
+#include "cpputil/report_error.hpp"
+
+namespace BOOM {
+
+  BatchedScalarKalmanFilter::BatchedScalarKalmanFilter(
+      const std::vector<ScalarStateSpaceModelBase *> &models)
+      : models_(models),
+        state_dimension_(0),
+        time_dimension_(0),
+        time_invariant_(true),
+        filled_time_(-1) {
+    if (models_.empty()) {
+      report_error("BatchedScalarKalmanFilter needs at least one model.");
+    }
+    state_dimension_ = models_[0]->state_dimension();
+    time_dimension_ = models_[0]->time_dimension();
+    for (const auto *model : models_) {
+      if (model->state_dimension() != state_dimension_ ||
+          model->time_dimension() != time_dimension_) {
+        report_error("All models in a BatchedScalarKalmanFilter must have the "
+                     "same state and time dimensions.");
+      }
+      time_invariant_ = time_invariant_ && model->is_time_invariant();
+    }
+
+    int N = number_of_series();
+    int m = state_dimension_;
+    int T = time_dimension_;
+    transition_matrices_.resize(m * m * N);
+    state_variance_matrices_.resize(m * m * N);
+    observation_coefficients_.resize(m * N);
+    observation_variances_.resize(N);
+    data_.resize(T * N);
+    observed_.resize(T * N);
+    prediction_errors_.resize(T * N);
+    inverse_prediction_variances_.resize(T * N);
+    kalman_gains_.resize(T * m * N);
+    log_likelihood_.resize(N);
+    scaled_state_errors_.resize((T + 1) * m * N);
+    state_mean_.resize(m * N);
+    state_variance_.resize(m * m * N);
+    variance_times_coefficients_.resize(m * N);
+    transition_times_variance_.resize(m * m * N);
+    new_state_mean_.resize(m * N);
+  }
+
+  //---------------------------------------------------------------------------
+  void BatchedScalarKalmanFilter::fill_model_matrices(int t) {
+    int N = number_of_series();
+    int m = state_dimension_;
+    bool matrices_current =
+        filled_time_ >= 0 && (time_invariant_ || filled_time_ == t);
+    if (!matrices_current) {
+      for (int n = 0; n < N; ++n) {
+        const ScalarStateSpaceModelBase &model(*models_[n]);
+        Matrix transition = model.state_transition_matrix(t)->dense();
+        Matrix state_variance = model.state_variance_matrix(t)->dense();
+        Vector coefficients = model.observation_matrix(t).dense();
+        for (int i = 0; i < m; ++i) {
+          observation_coefficients_[vector_index(i, n)] = coefficients[i];
+          for (int j = 0; j < m; ++j) {
+            transition_matrices_[matrix_index(i, j, n)] = transition(i, j);
+            state_variance_matrices_[matrix_index(i, j, n)] =
+                state_variance(i, j);
+          }
+        }
+      }
+    }
+    if (filled_time_ != t) {
+      // The observation variance is allowed to vary over time even in time
+      // invariant models.
+      for (int n = 0; n < N; ++n) {
+        observation_variances_[n] = models_[n]->observation_variance(t);
+      }
+    }
+    filled_time_ = t;
+  }
+
+  //---------------------------------------------------------------------------
+  void BatchedScalarKalmanFilter::load_observed_data() {
+    int N = number_of_series();
+    for (int n = 0; n < N; ++n) {
+      const ScalarStateSpaceModelBase &model(*models_[n]);
+      for (int t = 0; t < time_dimension_; ++t) {
+        bool missing = model.is_missing_observation(t);
+        observed_[t * N + n] = !missing;
+        data_[t * N + n] = missing ? 0.0 : model.adjusted_observation(t);
+      }
+    }
+  }
+
+  //---------------------------------------------------------------------------
+  const Vector &BatchedScalarKalmanFilter::filter() {
+    load_observed_data();
+    run_filter(false);
+    return log_likelihood_;
+  }
+
+  //---------------------------------------------------------------------------
+  std::vector<Matrix> BatchedScalarKalmanFilter::smoothed_state_means() {
+    filter();
+    run_disturbance_smoother();
+    return propagate_smoothed_means(false);
+  }
+
+  //---------------------------------------------------------------------------
+  // Durbin and Koopman (2002) show that a draw of the state given y can be
+  // obtained by simulating (alpha+, y+) from the model and adding E(alpha | y
+  // - y+) to alpha+, where the expectation is computed as if the initial state
+  // mean were zero.  This needs only one filter and smoother pass, where
+  // impute_state() in the model classes uses two.
+  //
+  // Series whose state has been permanently set keep their state, as they do
+  // in StateSpaceModelBase::impute_state().  They still occupy a slot in the
+  // batch, but are filtered as if all their data were missing.
+  void BatchedScalarKalmanFilter::impute_state(RNG &rng) {
+    int N = number_of_series();
+    for (int n = 0; n < N; ++n) {
+      ScalarStateSpaceModelBase &model(*models_[n]);
+      if (model.state_is_fixed()) {
+        model.set_state_model_behavior(StateModel::MIXTURE);
+        model.observe_fixed_state();
+        for (int t = 0; t < time_dimension_; ++t) {
+          observed_[t * N + n] = false;
+          data_[t * N + n] = 0.0;
+        }
+        continue;
+      }
+      Vector residuals = model.simulate_state_and_data_residuals(rng);
+      for (int t = 0; t < time_dimension_; ++t) {
+        observed_[t * N + n] = !model.is_missing_observation(t);
+        data_[t * N + n] = residuals[t];
+      }
+    }
+    run_filter(true);
+    run_disturbance_smoother();
+    std::vector<Matrix> smoothed_means = propagate_smoothed_means(true);
+    for (int n = 0; n < N; ++n) {
+      if (!models_[n]->state_is_fixed()) {
+        models_[n]->add_smoothed_state_mean(smoothed_means[n]);
+      }
+    }
+  }
+
+  //---------------------------------------------------------------------------
+  void BatchedScalarKalmanFilter::run_filter(bool zero_initial_mean) {
+    int N = number_of_series();
+    int m = state_dimension_;
+    double *a = state_mean_.data();
+    double *P = state_variance_.data();
+    double *PZ = variance_times_coefficients_.data();
+    double *TP = transition_times_variance_.data();
+    double *new_a = new_state_mean_.data();
+    const double *Z = observation_coefficients_.data();
+    const double *Tmat = transition_matrices_.data();
+    const double *RQR = state_variance_matrices_.data();
+    const double *H = observation_variances_.data();
+
+    // Model parameters may have changed since the last pass (and simulating
+    // the state sets state models to their MIXTURE behavior), so the stored
+    // model matrices must be refreshed.
+    filled_time_ = -1;
+
+    for (int n = 0; n < N; ++n) {
+      const ScalarStateSpaceModelBase &model(*models_[n]);
+      Vector a0 = zero_initial_mean ? Vector(m, 0.0)
+                                    : model.initial_state_mean();
+      SpdMatrix P0 = model.initial_state_variance();
+      for (int i = 0; i < m; ++i) {
+        a[vector_index(i, n)] = a0[i];
+        for (int j = 0; j < m; ++j) {
+          P[matrix_index(i, j, n)] = P0(i, j);
+        }
+      }
+    }
+    log_likelihood_ = 0.0;
+
+    for (int t = 0; t < time_dimension_; ++t) {
+      fill_model_matrices(t);
+      const unsigned char *observed = observed_.data() + t * N;
+      const double *y = data_.data() + t * N;
+      double *v = prediction_errors_.data() + t * N;
+      double *Finv = inverse_prediction_variances_.data() + t * N;
+      double *K = kalman_gains_.data() + t * m * N;
+
+      // PZ = P * Z.
+      std::fill(PZ, PZ + m * N, 0.0);
+      for (int i = 0; i < m; ++i) {
+        for (int j = 0; j < m; ++j) {
+          const double *Pij = P + matrix_index(i, j, 0);
+          const double *Zj = Z + vector_index(j, 0);
+          double *PZi = PZ + vector_index(i, 0);
+          for (int n = 0; n < N; ++n) {
+            PZi[n] += Pij[n] * Zj[n];
+          }
+        }
+      }
+
+      // Prediction variance F = Z'PZ + H, and prediction error v = y - Z'a.
+      // Finv holds 1/F, or zero for missing observations.
+      for (int n = 0; n < N; ++n) {
+        Finv[n] = H[n];
+        v[n] = y[n];
+      }
+      for (int i = 0; i < m; ++i) {
+        const double *Zi = Z + vector_index(i, 0);
+        const double *PZi = PZ + vector_index(i, 0);
+        const double *ai = a + vector_index(i, 0);
+        for (int n = 0; n < N; ++n) {
+          Finv[n] += Zi[n] * PZi[n];
+          v[n] -= Zi[n] * ai[n];
+        }
+      }
+      for (int n = 0; n < N; ++n) {
+        if (observed[n]) {
+          double F = Finv[n];
+          if (F <= 0) {
+            report_error("Found a zero (or negative) forecast variance!");
+          }
+          log_likelihood_[n] -=
+              Constants::log_root_2pi + 0.5 * (log(F) + v[n] * v[n] / F);
+          Finv[n] = 1.0 / F;
+        } else {
+          Finv[n] = 0.0;
+          v[n] = 0.0;
+        }
+      }
+
+      // K = T * PZ / F, and the new state mean T * a + K * v.
+      for (int i = 0; i < m; ++i) {
+        double *Ki = K + vector_index(i, 0);
+        double *new_ai = new_a + vector_index(i, 0);
+        std::fill(Ki, Ki + N, 0.0);
+        std::fill(new_ai, new_ai + N, 0.0);
+        for (int j = 0; j < m; ++j) {
+          const double *Tij = Tmat + matrix_index(i, j, 0);
+          const double *PZj = PZ + vector_index(j, 0);
+          const double *aj = a + vector_index(j, 0);
+          for (int n = 0; n < N; ++n) {
+            Ki[n] += Tij[n] * PZj[n];
+            new_ai[n] += Tij[n] * aj[n];
+          }
+        }
+        for (int n = 0; n < N; ++n) {
+          Ki[n] *= Finv[n];
+          new_ai[n] += Ki[n] * v[n];
+        }
+      }
+      std::swap(a, new_a);
+
+      // The new state variance is T P T' - F K K' + RQR.  Note that F K = T
+      // PZ.  Only the upper triangle is computed, and then copied.
+      std::fill(TP, TP + m * m * N, 0.0);
+      for (int i = 0; i < m; ++i) {
+        for (int k = 0; k < m; ++k) {
+          const double *Tik = Tmat + matrix_index(i, k, 0);
+          for (int j = 0; j < m; ++j) {
+            const double *Pkj = P + matrix_index(k, j, 0);
+            double *TPij = TP + matrix_index(i, j, 0);
+            for (int n = 0; n < N; ++n) {
+              TPij[n] += Tik[n] * Pkj[n];
+            }
+          }
+        }
+      }
+      for (int i = 0; i < m; ++i) {
+        const double *Ki = K + vector_index(i, 0);
+        for (int j = i; j < m; ++j) {
+          const double *Kj = K + vector_index(j, 0);
+          double *Pij = P + matrix_index(i, j, 0);
+          const double *RQRij = RQR + matrix_index(i, j, 0);
+          for (int n = 0; n < N; ++n) {
+            double F = Finv[n] > 0 ? 1.0 / Finv[n] : 0.0;
+            Pij[n] = RQRij[n] - F * Ki[n] * Kj[n];
+          }
+          for (int k = 0; k < m; ++k) {
+            const double *TPik = TP + matrix_index(i, k, 0);
+            const double *Tjk = Tmat + matrix_index(j, k, 0);
+            for (int n = 0; n < N; ++n) {
+              Pij[n] += TPik[n] * Tjk[n];
+            }
+          }
+        }
+        for (int j = 0; j < i; ++j) {
+          std::copy(P + matrix_index(j, i, 0), P + matrix_index(j, i, 0) + N,
+                    P + matrix_index(i, j, 0));
+        }
+      }
+    }
+    // Leave the final state mean in state_mean_ for consistency.
+    if (a != state_mean_.data()) {
+      std::copy(a, a + m * N, state_mean_.data());
+    }
+  }
+
+  //---------------------------------------------------------------------------
+  // r[t - 1] = Z[t] * u[t] + T[t]' * r[t], where u[t] = v[t] / F[t] - K[t]' *
+  // r[t], starting from r[T - 1] = 0.
+  void BatchedScalarKalmanFilter::run_disturbance_smoother() {
+    int N = number_of_series();
+    int m = state_dimension_;
+    double *r_last = scaled_state_errors_.data() + time_dimension_ * m * N;
+    std::fill(r_last, r_last + m * N, 0.0);
+    std::vector<double> u(N);
+    for (int t = time_dimension_ - 1; t >= 0; --t) {
+      fill_model_matrices(t);
+      const double *r = scaled_state_errors_.data() + (t + 1) * m * N;
+      double *r_previous = scaled_state_errors_.data() + t * m * N;
+      const double *v = prediction_errors_.data() + t * N;
+      const double *Finv = inverse_prediction_variances_.data() + t * N;
+      const double *K = kalman_gains_.data() + t * m * N;
+      const double *Z = observation_coefficients_.data();
+      const double *Tmat = transition_matrices_.data();
+
+      for (int n = 0; n < N; ++n) {
+        u[n] = v[n] * Finv[n];
+      }
+      for (int i = 0; i < m; ++i) {
+        const double *Ki = K + vector_index(i, 0);
+        const double *ri = r + vector_index(i, 0);
+        for (int n = 0; n < N; ++n) {
+          u[n] -= Ki[n] * ri[n];
+        }
+      }
+      for (int i = 0; i < m; ++i) {
+        double *rpi = r_previous + vector_index(i, 0);
+        const double *Zi = Z + vector_index(i, 0);
+        for (int n = 0; n < N; ++n) {
+          rpi[n] = Zi[n] * u[n];
+        }
+        for (int j = 0; j < m; ++j) {
+          const double *Tji = Tmat + matrix_index(j, i, 0);
+          const double *rj = r + vector_index(j, 0);
+          for (int n = 0; n < N; ++n) {
+            rpi[n] += Tji[n] * rj[n];
+          }
+        }
+      }
+    }
+  }
+
+  //---------------------------------------------------------------------------
+  // alpha_hat[0] = a[0] + P[0] * r[-1], and alpha_hat[t] = T[t-1] *
+  // alpha_hat[t-1] + RQR[t-1] * r[t-1].
+  std::vector<Matrix> BatchedScalarKalmanFilter::propagate_smoothed_means(
+      bool zero_initial_mean) {
+    int N = number_of_series();
+    int m = state_dimension_;
+    std::vector<Matrix> ans(N, Matrix(m, time_dimension_));
+    if (time_dimension_ == 0) return ans;
+    double *alpha = state_mean_.data();
+    double *new_alpha = new_state_mean_.data();
+
+    const double *r = scaled_state_errors_.data();
+    for (int n = 0; n < N; ++n) {
+      const ScalarStateSpaceModelBase &model(*models_[n]);
+      Vector a0 = zero_initial_mean ? Vector(m, 0.0)
+                                    : model.initial_state_mean();
+      SpdMatrix P0 = model.initial_state_variance();
+      for (int i = 0; i < m; ++i) {
+        double value = a0[i];
+        for (int j = 0; j < m; ++j) {
+          value += P0(i, j) * r[vector_index(j, n)];
+        }
+        alpha[vector_index(i, n)] = value;
+        ans[n](i, 0) = value;
+      }
+    }
+
+    for (int t = 1; t < time_dimension_; ++t) {
+      fill_model_matrices(t - 1);
+      r = scaled_state_errors_.data() + t * m * N;
+      const double *Tmat = transition_matrices_.data();
+      const double *RQR = state_variance_matrices_.data();
+      for (int i = 0; i < m; ++i) {
+        double *new_alphai = new_alpha + vector_index(i, 0);
+        std::fill(new_alphai, new_alphai + N, 0.0);
+        for (int j = 0; j < m; ++j) {
+          const double *Tij = Tmat + matrix_index(i, j, 0);
+          const double *RQRij = RQR + matrix_index(i, j, 0);
+          const double *alphaj = alpha + vector_index(j, 0);
+          const double *rj = r + vector_index(j, 0);
+          for (int n = 0; n < N; ++n) {
+            new_alphai[n] += Tij[n] * alphaj[n] + RQRij[n] * rj[n];
+          }
+        }
+      }
+      std::swap(alpha, new_alpha);
+      for (int n = 0; n < N; ++n) {
+        for (int i = 0; i < m; ++i) {
+          ans[n](i, t) = alpha[vector_index(i, n)];
+        }
+      }
+    }
+    return ans;
+  }
+
+}  // namespace BOOM
@@ -0,0 +1,149 @@
+#ifndef BOOM_STATE_SPACE_BATCHED_SCALAR_KALMAN_FILTER_HPP_
+#define BOOM_STATE_SPACE_BATCHED_SCALAR_KALMAN_FILTER_HPP_
+/*
+  Copyright (C) 2019 Steven L. Scott
+
+  This library is free software; you can redistribute it and/or modify it under
+  the terms of the GNU Lesser General Public License as published by the Free
+  Software Foundation; either version 2.1 of the License, or (at your option)
+  any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT
+  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+  FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+  details.
+
+  You should have received a copy of the GNU Lesser General Public License along
+  with this library; if not, write to the Free Software Foundation, Inc., 51
+  Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+*/
+
+#include <vector>
+#include "LinAlg/Matrix.hpp"
+#include "LinAlg/Vector.hpp"
+#include "distributions/rng.hpp"
+
+namespace BOOM {
+
+  class ScalarStateSpaceModelBase;
+
+  // Runs the Kalman filter and smoother for many independent scalar state
+  // space models at once.  This is useful when fitting a large number of small
+  // models with the same state dimension (e.g. the same set of state
+  // components applied to different series), where the cost of running each
+  // model's own ScalarKalmanFilter is dominated by the overhead of many small
+  // matrix operations.
+  //
+  // The model matrices, filter state, and filter output are stored in
+  // structure-of-arrays form, with the series index varying fastest.  Each
+  // step of the filter is then a collection of loops over the series, which
+  // the compiler can vectorize.  The model matrices may differ between series.
+  // Only the state and time dimensions must agree.
+  //
+  // The models are not owned by the filter, and must outlive it.
+  class BatchedScalarKalmanFilter {
+   public:
+    // Args:
+    //   models: The models to be filtered.  All must have the same
+    //     state_dimension() and time_dimension().
+    explicit BatchedScalarKalmanFilter(
+        const std::vector<ScalarStateSpaceModelBase *> &models);
+
+    int number_of_series() const { return models_.size(); }
+    int state_dimension() const { return state_dimension_; }
+    int time_dimension() const { return time_dimension_; }
+
+    // Run the Kalman filter over the observed data for each model.  Returns
+    // the log likelihood of each series.
+    const Vector &filter();
+
+    // The log likelihood of each series, as computed by the most recent call
+    // to filter().
+    const Vector &log_likelihood() const { return log_likelihood_; }
+
+    // Returns the mean of the state given the observed data, for each series.
+    // Element n of the returned vector has state_dimension() rows and
+    // time_dimension() columns.
+    std::vector<Matrix> smoothed_state_means();
+
+    // Replace the state of each model with a draw from its posterior
+    // distribution given the observed data and current model parameters.
+    // This is the batched equivalent of calling impute_state(rng) on each
+    // model, and updates the complete data sufficient statistics of each
+    // model in the same way.
+    void impute_state(RNG &rng);
+
+   private:
+    // Copy the model matrices for time t into the structure-of-arrays
+    // storage, unless they are already there.
+    void fill_model_matrices(int t);
+
+    // Copy the (adjusted) observed data from each model into data_.
+    void load_observed_data();
+
+    // Run the Kalman filter over the contents of data_, filling
+    // prediction_errors_, inverse_prediction_variances_, kalman_gains_, and
+    // log_likelihood_.  If zero_initial_mean is true the initial state mean
+    // is taken to be zero.  Otherwise the models' initial state means are
+    // used.
+    void run_filter(bool zero_initial_mean);
+
+    // Run the fast disturbance smoother over the output of run_filter(),
+    // filling scaled_state_errors_.
+    void run_disturbance_smoother();
+
+    // Propagate the output of run_disturbance_smoother() forward in time to
+    // obtain the smoothed state means.
+    std::vector<Matrix> propagate_smoothed_means(bool zero_initial_mean);
+
+    // Positions of element i of a vector, and element (i, j) of a matrix, for
+    // series n.
+    int vector_index(int i, int n) const {
+      return i * number_of_series() + n;
+    }
+    int matrix_index(int i, int j, int n) const {
+      return (i * state_dimension_ + j) * number_of_series() + n;
+    }
+
+    std::vector<ScalarStateSpaceModelBase *> models_;
+    int state_dimension_;
+    int time_dimension_;
+    bool time_invariant_;
+
+    // The time index of the model matrices currently stored, or -1 if none
+    // are stored.
+    int filled_time_;
+
+    // Model matrices for the time index filled_time_.
+    std::vector<double> transition_matrices_;
+    std::vector<double> state_variance_matrices_;
+    std::vector<double> observation_coefficients_;
+    std::vector<double> observation_variances_;
+
+    // The data being filtered, indexed by [t][n], with observed_ indicating
+    // which observations are present.
+    std::vector<double> data_;
+    std::vector<unsigned char> observed_;
+
+    // Filter output.  Prediction errors and inverse prediction variances are
+    // indexed by [t][n].  Kalman gains are indexed by [t][i][n].
+    std::vector<double> prediction_errors_;
+    std::vector<double> inverse_prediction_variances_;
+    std::vector<double> kalman_gains_;
+    Vector log_likelihood_;
+
+    // Durbin and Koopman's r[t - 1] is stored in slot t, for t = 0, ...,
+    // time_dimension().
+    std::vector<double> scaled_state_errors_;
+
+    // Workspace for the filter.
+    std::vector<double> state_mean_;
+    std::vector<double> state_variance_;
+    std::vector<double> variance_times_coefficients_;
+    std::vector<double> transition_times_variance_;
+    std::vector<double> new_state_mean_;
+  };
+
+}  // namespace BOOM
+
+#endif  // BOOM_STATE_SPACE_BATCHED_SCALAR_KALMAN_FILTER_HPP_
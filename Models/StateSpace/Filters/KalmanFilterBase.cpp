@@ -17,7 +17,10 @@
 */
 
 #include "Models/StateSpace/Filters/KalmanFilterBase.hpp"
+#include <algorithm>
+#include <cmath>
 #include "Models/StateSpace/StateSpaceModelBase.hpp"
+#include "cpputil/ThreadTools.hpp"
 
 namespace BOOM {
   namespace Kalman {
@@ -53,7 +56,11 @@ namespace BOOM {
 
   //===========================================================================
   KalmanFilterBase::KalmanFilterBase()
-      : status_(NOT_CURRENT), log_likelihood_(negative_infinity()) {}
+      : status_(NOT_CURRENT),
+        log_likelihood_(negative_infinity()),
+        steady_state_tolerance_(0.0),
+        steady_state_time_(-1),
+        parallel_threads_(1) {}
 
   std::ostream &KalmanFilterBase::print(std::ostream &out) const {
     for (int i = 0; i < size(); ++i) {
@@ -102,6 +109,31 @@ namespace BOOM {
   }
 
 
+  void KalmanFilterBase::set_parallel_threads(int threads) {
+    parallel_threads_ = std::max<int>(threads, 1);
+    if (parallel_threads_ > 1) {
+      WorkStealingThreadPool::global().set_minimum_number_of_threads(
+          parallel_threads_);
+    }
+    set_status(NOT_CURRENT);
+  }
+
+  bool KalmanFilterBase::variance_has_converged(
+      const SpdMatrix &previous, const SpdMatrix &current) const {
+    if (steady_state_tolerance_ <= 0 || previous.nrow() != current.nrow()) {
+      return false;
+    }
+    double scale = previous.max_abs();
+    if (!std::isfinite(scale)) return false;
+    const double *p = previous.data();
+    const double *c = current.data();
+    double threshold = steady_state_tolerance_ * scale;
+    for (int i = 0; i < previous.size(); ++i) {
+      if (!(fabs(p[i] - c[i]) <= threshold)) return false;
+    }
+    return true;
+  }
+
   void KalmanFilterBase::clear_loglikelihood() {
     log_likelihood_ = 0;
     status_ = NOT_CURRENT;
@@ -95,6 +95,7 @@ namespace BOOM {
       }
 
      protected:
+      Vector & mutable_state_mean() {return state_mean_;}
       SpdMatrix & mutable_state_variance() {return state_variance_;}
       void check_variance(const SpdMatrix &v) const;
 
@@ -182,7 +183,75 @@ namespace BOOM {
     // Run the Durbin and Koopman fast disturbance smoother.
     virtual void fast_disturbance_smooth() = 0;
 
+    //--------------------------------------------------------------------------
+    // Steady state
+    //--------------------------------------------------------------------------
+    // If the model matrices do not vary over time then the state variance
+    // P[t] converges to the solution of a Riccati equation after a moderate
+    // number of time steps, after which the Kalman gain, the forecast
+    // variance, and P[t] itself are constant.  A filter that detects
+    // convergence can "freeze" these quantities and propagate only the state
+    // mean, which avoids the dense matrix products needed to update P[t].
+    // Time points where the model departs from its steady state (e.g. missing
+    // observations) are handled by falling back to the full update, after
+    // which convergence is checked again.
+    //
+    // Concrete filters are free to ignore the steady state settings.
+
+    // Args:
+    //   tolerance: The filter is considered to have converged once no
+    //     element of P[t+1] - P[t] exceeds 'tolerance' times the largest
+    //     absolute element of P[t].  A non-positive value disables the
+    //     steady state calculations.  The default is 0, so the steady
+    //     state approximation is only used if a caller asks for it
+    //     (e.g. 1e-10).
+    void set_steady_state_tolerance(double tolerance) {
+      steady_state_tolerance_ = tolerance;
+      set_status(NOT_CURRENT);
+    }
+    double steady_state_tolerance() const { return steady_state_tolerance_; }
+
+    // The first time point handled with frozen steady state quantities in
+    // the most recent run of the filter, or -1 if the filter never reached a
+    // steady state.
+    int steady_state_time() const { return steady_state_time_; }
+
+    //--------------------------------------------------------------------------
+    // Parallel in time filtering
+    //--------------------------------------------------------------------------
+    // The forward filter and the disturbance smoother can be run in parallel
+    // over segments of the time axis, using the associative scan described
+    // in ParallelKalmanScan.hpp.  Each segment is first summarized by a
+    // single scan element, the summaries are combined sequentially to give
+    // the filter's starting values for each segment, and then the ordinary
+    // recursions are run on all segments at once.  The results match the
+    // sequential filter up to rounding error.
+    //
+    // The summaries cost O(S^3) per time point for state dimension S, so
+    // the parallel filter does roughly twice the work of the sequential
+    // filter, and the parallel smoother roughly S times the work of the
+    // sequential smoother.  It pays off for long series with small state
+    // dimension.
+    //
+    // Concrete filters are free to ignore the parallel settings, and fall
+    // back to the sequential algorithm in cases they do not support.
+
+    // Args:
+    //   threads: The number of threads to use.  Values less than 2 select the
+    //     sequential algorithms.  The global WorkStealingThreadPool is grown
+    //     to have at least this many threads.
+    void set_parallel_threads(int threads);
+    int parallel_threads() const { return parallel_threads_; }
+
    protected:
+    // Returns true if the change from 'previous' to 'current' is small
+    // enough (relative to steady_state_tolerance()) that the state variance
+    // can be considered converged.
+    bool variance_has_converged(const SpdMatrix &previous,
+                                const SpdMatrix &current) const;
+
+    void set_steady_state_time(int t) { steady_state_time_ = t; }
+
     // Set log likelihood to zero and status to NOT_CURRENT.
     void clear_loglikelihood();
 
@@ -202,6 +271,11 @@ namespace BOOM {
     // The log likelihood of the data as computed by the last forward update.
     double log_likelihood_;
 
+    double steady_state_tolerance_;
+    int steady_state_time_;
+
+    int parallel_threads_;
+
     // Durbin and Koopman's r0 from the fast disturbance smoother (see equation
     // (5) in Durbin and Koopman (2002, Biometrika), or equation 4.32 in Durbin
     // and Koopman (2001, first edition)).
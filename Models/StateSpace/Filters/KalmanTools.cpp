@@ -25,25 +25,44 @@ namespace BOOM {
                               double &F, double &v, bool missing,
                               const Vector &Z, double H, const Matrix &T,
                               Matrix &L, const SpdMatrix &RQR) {
+    KalmanUpdateWorkspace workspace;
+    return scalar_kalman_update(y, a, P, K, F, v, missing, Z, H, T, L, RQR,
+                                workspace);
+  }
+
+  double scalar_kalman_update(double y, Vector &a, SpdMatrix &P, Vector &K,
+                              double &F, double &v, bool missing,
+                              const Vector &Z, double H, const Matrix &T,
+                              Matrix &L, const SpdMatrix &RQR,
+                              KalmanUpdateWorkspace &workspace) {
     F = P.Mdist(Z) + H;
     double ans = 0;
+    K.resize(T.nrow());
     if (!missing) {
-      K = T * (P * Z);
-      K /= F;
+      // K = T * P * Z / F
+      workspace.PZ.resize(P.nrow());
+      P.mult(Z, workspace.PZ);
+      T.mult(workspace.PZ, K, 1.0 / F);
       double mu = Z.dot(a);
       v = y - mu;
       ans = dnorm(y, mu, sqrt(F), true);
     } else {
-      K = Z * 0;
+      K = 0.0;
       v = 0;
     }
 
-    a = T * a;
-    a += K * v;
+    workspace.Ta.resize(T.nrow());
+    T.mult(a, workspace.Ta);
+    a = workspace.Ta;
+    a.axpy(K, v);
 
     L = T.transpose();
     L.add_outer(Z, K, -1);  // L is the transpose of Durbin and Koopman's L
-    P = T * P * L + RQR;
+    // P = T * P * L + RQR, accumulated in place.
+    workspace.TP.resize(T.nrow(), P.ncol());
+    T.mult(P, workspace.TP);
+    P = RQR;
+    P.add_mult(workspace.TP, L);
 
     return ans;
   }
@@ -60,19 +79,52 @@ namespace BOOM {
                               const Matrix &T,
                               Matrix &L,
                               const SpdMatrix &RQR) {
+    KalmanUpdateWorkspace workspace;
+    return vector_kalman_update(y, a, P, K, F, v, observed, Z, H, T, L, RQR,
+                                workspace);
+  }
+
+  double vector_kalman_update(const Vector &y,
+                              Vector &a,
+                              SpdMatrix &P,
+                              Matrix &K,
+                              SpdMatrix &F,
+                              Vector &v,
+                              const Selector &observed,
+                              Matrix Z,
+                              SpdMatrix H,
+                              const Matrix &T,
+                              Matrix &L,
+                              const SpdMatrix &RQR,
+                              KalmanUpdateWorkspace &workspace) {
     Vector Y = observed.select(y);
     Z = observed.select_rows(Z);
     H = observed.select(H);
 
     v = Y - Z * a;
-    F = Z * P * Z.transpose() + H;
+    // Z * P is shared by F, K, and the variance update.
+    Matrix &ZP(workspace.ZP);
+    ZP.resize(Z.nrow(), P.ncol());
+    Z.mult(P, ZP);
+    F = H;
+    F.Matrix::add_outer(ZP, Z, 1.0);  // F = Z * P * Z^T + H
     SpdMatrix Finv = F.inv();
-    K = T * P * Z.transpose() * Finv;
-    Vector a_contemp = a + P * Z.Tmult(Finv * v);
+    // K = T * P * Z^T * Finv
+    workspace.TP.resize(T.nrow(), ZP.nrow());
+    T.multT(ZP, workspace.TP);
+    K.resize(T.nrow(), Finv.ncol());
+    workspace.TP.mult(Finv, K);
+    Vector a_contemp = a + ZP.Tmult(Finv * v);
     a = T * a_contemp;
 
-    SpdMatrix Pcontemp = P - P * (Z.Tmult(Finv * Z)) * P;
-    P = T * Pcontemp * T.transpose() + RQR;
+    // Pcontemp = P - P * Z^T * Finv * Z * P
+    SpdMatrix &Pcontemp(workspace.Pcontemp);
+    sandwich_transpose(ZP, Finv, Pcontemp, workspace.sandwich);
+    Pcontemp *= -1.0;
+    Pcontemp += P;
+    // P = T * Pcontemp * T^T + RQR
+    sandwich(T, Pcontemp, P, workspace.sandwich);
+    P += RQR;
 
     L = T - K * Z;
 
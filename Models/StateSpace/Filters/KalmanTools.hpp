@@ -23,6 +23,19 @@
 #include "LinAlg/SpdMatrix.hpp"
 
 namespace BOOM {
+  // Storage for the intermediate products computed by the Kalman update
+  // functions below.  A caller running many updates can keep one of these and
+  // pass it to each call, so the products are not reallocated at every time
+  // point.
+  struct KalmanUpdateWorkspace {
+    Vector PZ;     // P * Z
+    Vector Ta;     // T * a
+    Matrix TP;     // T * P, or T * P * Z^T
+    Matrix ZP;     // Z * P
+    Matrix sandwich;
+    SpdMatrix Pcontemp;
+  };
+
   // Returns the likelihood contribution of y given previous y's.
   // Uses notation from Durbin and Koopman (2001).
   // y is y[t]
@@ -40,6 +53,13 @@ namespace BOOM {
                               bool missing, const Vector &Z, double H,
                               const Matrix &T, Matrix &L, const SpdMatrix &RQR);
 
+  // As above, but the intermediate products are stored in 'workspace'.
+  double scalar_kalman_update(double y, Vector &a, SpdMatrix &P, Vector &K,
+                              double &F, double &v, bool missing,
+                              const Vector &Z, double H, const Matrix &T,
+                              Matrix &L, const SpdMatrix &RQR,
+                              KalmanUpdateWorkspace &workspace);
+
   // Kalman filter update for vector valued response.  This function is written
   // for simplicity, not speed.  Please consider MultivariateKalmanFilterBase
   // and its children for efficient filtering, especially in high dimensional
@@ -66,6 +86,21 @@ namespace BOOM {
                               Matrix &L,
                               const SpdMatrix &RQR);
 
+  // As above, but the intermediate products are stored in 'workspace'.
+  double vector_kalman_update(const Vector &y,
+                              Vector &a,
+                              SpdMatrix &P,
+                              Matrix &K,
+                              SpdMatrix &F,
+                              Vector &v,
+                              const Selector &observed,
+                              Matrix Z,
+                              SpdMatrix H,
+                              const Matrix &T,
+                              Matrix &L,
+                              const SpdMatrix &RQR,
+                              KalmanUpdateWorkspace &workspace);
+
   // The Kalman filter as implemented above computes the predictive
   // distribution of the state at time t+1 given data up to time t.
   // This function takes the outputs of scalar_kalman_update and
@@ -0,0 +1,81 @@
+/*
+  Copyright (C) 2019 Steven L. Scott
+
+  This library is free software; you can redistribute it and/or modify it under
+  the terms of the GNU Lesser General Public License as published by the Free
+  Software Foundation; either version 2.1 of the License, or (at your option)
+  any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT
+  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+  FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+  details.
+
+  You should have received a copy of the GNU Lesser General Public License along
+  with this library; if not, write to the Free Software Foundation, Inc., 51
+  Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+*/
+
+#include "Models/StateSpace/Filters/ParallelKalmanScan.hpp"
+#include <algorithm>
+
+namespace BOOM {
+  namespace Kalman {
+
+    FilterElement::FilterElement(const Vector &mean, const SpdMatrix &variance)
+        : A(mean.size(), mean.size(), 0.0),
+          b(mean),
+          C(variance),
+          eta(mean.size(), 0.0),
+          J(mean.size(), 0.0) {}
+
+    // With i = earlier, j = later, and M = (I + C_i J_j)^{-1}, Lemma 8 of
+    // Sarkka and Garcia-Fernandez gives
+    //
+    //   A  = A_j M A_i
+    //   b  = A_j M (b_i + C_i eta_j) + b_j
+    //   C  = A_j M C_i A_j' + C_j
+    //   eta = A_i' M' (eta_j - J_j b_i) + eta_i
+    //   J  = A_i' M' J_j A_i + J_i.
+    //
+    // C_i and J_j are positive semidefinite, so the eigenvalues of C_i J_j
+    // are non-negative and M always exists.
+    FilterElement combine(const FilterElement &earlier,
+                          const FilterElement &later) {
+      const FilterElement &i(earlier);
+      const FilterElement &j(later);
+      Matrix I_plus_CJ = i.C * j.J;
+      I_plus_CJ.diag() += 1.0;
+      Matrix M = I_plus_CJ.inv();
+      Matrix AjM = j.A * M;
+
+      FilterElement ans;
+      ans.A = AjM * i.A;
+      ans.b = AjM * (i.b + i.C * j.eta) + j.b;
+      ans.C = SpdMatrix((AjM * i.C).multT(j.A), false);
+      ans.C += j.C;
+      ans.C.fix_near_symmetry();
+
+      ans.eta = i.A.Tmult(M.Tmult(j.eta - j.J * i.b)) + i.eta;
+      Matrix MtJ = M.Tmult(j.J);
+      ans.J = SpdMatrix(i.A.Tmult(MtJ * i.A), false);
+      ans.J += i.J;
+      ans.J.fix_near_symmetry();
+      return ans;
+    }
+
+    std::vector<int> time_chunks(int time_dimension, int max_chunks,
+                                 int min_chunk_length) {
+      int number_of_chunks = std::max<int>(
+          1, std::min<int>(max_chunks,
+                           time_dimension / std::max<int>(
+                               min_chunk_length, 1)));
+      std::vector<int> ans(number_of_chunks + 1);
+      for (int i = 0; i <= number_of_chunks; ++i) {
+        ans[i] = static_cast<long>(time_dimension) * i / number_of_chunks;
+      }
+      return ans;
+    }
+
+  }  // namespace Kalman
+}  // namespace BOOM
@@ -0,0 +1,87 @@
+#ifndef BOOM_STATE_SPACE_PARALLEL_KALMAN_SCAN_HPP_
+#define BOOM_STATE_SPACE_PARALLEL_KALMAN_SCAN_HPP_
+/*
+  Copyright (C) 2019 Steven L. Scott
+
+  This library is free software; you can redistribute it and/or modify it under
+  the terms of the GNU Lesser General Public License as published by the Free
+  Software Foundation; either version 2.1 of the License, or (at your option)
+  any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT
+  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+  FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+  details.
+
+  You should have received a copy of the GNU Lesser General Public License along
+  with this library; if not, write to the Free Software Foundation, Inc., 51
+  Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+*/
+
+#include <vector>
+#include "LinAlg/Matrix.hpp"
+#include "LinAlg/SpdMatrix.hpp"
+#include "LinAlg/Vector.hpp"
+
+namespace BOOM {
+  namespace Kalman {
+
+    // The Kalman filter can be written as a prefix scan with an associative
+    // operator (Sarkka and Garcia-Fernandez, 2021, "Temporal parallelization
+    // of Bayesian smoothers", IEEE Transactions on Automatic Control).  A
+    // FilterElement summarizes the information about the state contributed
+    // by a contiguous block of time points, in the form of two conditional
+    // distributions.  For the block of time points s, ..., t
+    //
+    //   p(alpha[t+1] | alpha[s], y[s:t]) = N(A * alpha[s] + b, C)
+    //   p(y[s:t] | alpha[s]) \propto exp(-.5 * alpha[s]' J alpha[s]
+    //                                    + eta' alpha[s]).
+    //
+    // For a single time point t in a model with transition matrix T[t],
+    // state error variance RQR[t], observation coefficients Z[t] and
+    // observation variance H[t], the element is A = T[t], b = 0, C = RQR[t],
+    // eta = Z[t] * y[t] / H[t], and J = Z[t] * Z[t]' / H[t].  Missing
+    // observations have eta = 0 and J = 0.
+    //
+    // Combining an element holding the distribution of alpha[s] (A = 0, with
+    // b and C the mean and variance) with the element for s, ..., t gives an
+    // element holding the distribution of alpha[t+1] given y[s:t], i.e. the
+    // Kalman filter's a[t+1] and P[t+1].
+    struct FilterElement {
+      FilterElement() {}
+
+      // An element holding a fixed distribution for the state, which does not
+      // depend on the state at earlier times.
+      FilterElement(const Vector &mean, const SpdMatrix &variance);
+
+      Matrix A;
+      Vector b;
+      SpdMatrix C;
+      Vector eta;
+      SpdMatrix J;
+    };
+
+    // Returns the element describing the time points in 'earlier' followed by
+    // those in 'later'.  The operation is associative, but not commutative.
+    FilterElement combine(const FilterElement &earlier,
+                          const FilterElement &later);
+
+    // Divide the time points [0, time_dimension) into contiguous chunks for
+    // parallel processing.
+    //
+    // Args:
+    //   time_dimension:  The number of time points to divide.
+    //   max_chunks:  The largest number of chunks to produce.
+    //   min_chunk_length:  The smallest number of time points in a chunk.
+    //
+    // Returns:
+    //   A vector of chunk boundaries.  Chunk i is [ans[i], ans[i+1]).  The
+    //   first element is 0 and the last is time_dimension.  If only one chunk
+    //   is possible the returned vector has two elements.
+    std::vector<int> time_chunks(int time_dimension, int max_chunks,
+                                 int min_chunk_length);
+
+  }  // namespace Kalman
+}  // namespace BOOM
+
+#endif  // BOOM_STATE_SPACE_PARALLEL_KALMAN_SCAN_HPP_
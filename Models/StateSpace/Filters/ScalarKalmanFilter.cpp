@@ -17,7 +17,9 @@
 */
 
 #include "Models/StateSpace/Filters/ScalarKalmanFilter.hpp"
+#include "Models/StateSpace/Filters/ParallelKalmanScan.hpp"
 #include "Models/StateSpace/StateSpaceModelBase.hpp"
+#include "cpputil/ThreadTools.hpp"
 #include "distributions.hpp"
 
 namespace BOOM {
@@ -36,28 +38,40 @@ namespace BOOM {
           filter_(filter),
           prediction_error_(0),
           prediction_variance_(0),
-          kalman_gain_(model_->state_dimension(), 0) {}
+          kalman_gain_(model_->state_dimension(), 0),
+          in_steady_state_(false) {}
 
     double Marginal::update(double y, bool missing, int t,
                             double observation_variance_scale_factor) {
-      const SparseVector observation_coefficients = model_->observation_matrix(t);
+      return update(
+          y, missing, model_->observation_matrix(t),
+          model_->observation_variance(t) * observation_variance_scale_factor,
+          *model_->state_transition_matrix(t),
+          *model_->state_variance_matrix(t));
+    }
+
+    double Marginal::update(double y, bool missing,
+                            const SparseVector &observation_coefficients,
+                            double observation_variance,
+                            const SparseKalmanMatrix &state_transition_matrix,
+                            const SparseKalmanMatrix &state_variance_matrix) {
+      in_steady_state_ = false;
       Vector PZ = state_variance() * observation_coefficients;
 
       prediction_variance_ =
-          observation_coefficients.dot(PZ) +
-          model_->observation_variance(t) * observation_variance_scale_factor;
+          observation_coefficients.dot(PZ) + observation_variance;
       if (prediction_variance_ <= 0) {
         std::ostringstream err;
         err << "Found a zero (or negative) forecast variance!";
         report_error(err.str());
       }
-      const SparseKalmanMatrix &state_transition_matrix(
-          *model_->state_transition_matrix(t));
-      Vector TPZ = state_transition_matrix * PZ;
 
       double loglike = 0;
       if (!missing) {
-        kalman_gain_ = TPZ / prediction_variance_;
+        // K = T * P * Z / F, computed in the storage for K.
+        kalman_gain_ = PZ;
+        state_transition_matrix.multiply_inplace(VectorView(kalman_gain_));
+        kalman_gain_ /= prediction_variance_;
         double mu = observation_coefficients.dot(state_mean());
         prediction_error_ = y - mu;
         loglike = dnorm(y, mu, sqrt(prediction_variance_), true);
@@ -66,22 +80,39 @@ namespace BOOM {
         prediction_error_ = 0;
       }
 
-      if (!missing) {
-        set_state_mean(state_transition_matrix * state_mean()
-                       + kalman_gain_ * prediction_error_);
-      } else {
-        set_state_mean(state_transition_matrix * state_mean());
-      }
+      // a[t+1] = T * a[t] + K * v.
+      state_transition_matrix.multiply_inplace(
+          VectorView(mutable_state_mean()));
+      if (!missing) mutable_state_mean().axpy(kalman_gain_, prediction_error_);
 
+      // P[t+1] = T * P * T' - T * P * Z * K' + RQR, where T * P * Z = F * K.
       state_transition_matrix.sandwich_inplace(mutable_state_variance());
       if (!missing) {
-        mutable_state_variance().Matrix::add_outer(TPZ, kalman_gain_, -1);
+        mutable_state_variance().add_outer(kalman_gain_,
+                                           -prediction_variance_);
       }
-      model_->state_variance_matrix(t)->add_to(mutable_state_variance());
+      state_variance_matrix.add_to(mutable_state_variance());
       mutable_state_variance().fix_near_symmetry();
       return loglike;
     }
 
+    double Marginal::steady_state_update(
+        double y, int t, const SparseVector &observation_coefficients,
+        const SparseKalmanMatrix &state_transition_matrix,
+        const Vector &kalman_gain, double prediction_variance,
+        const SpdMatrix &state_variance) {
+      in_steady_state_ = true;
+      prediction_variance_ = prediction_variance;
+      kalman_gain_ = kalman_gain;
+      double mu = observation_coefficients.dot(state_mean());
+      prediction_error_ = y - mu;
+      state_transition_matrix.multiply_inplace(
+          VectorView(mutable_state_mean()));
+      mutable_state_mean().axpy(kalman_gain_, prediction_error_);
+      mutable_state_variance() = state_variance;
+      return dnorm(y, mu, sqrt(prediction_variance_), true);
+    }
+
     const Marginal *Marginal::previous() const {
       if (time_index() < 1) {
         return nullptr;
@@ -125,8 +156,18 @@ namespace BOOM {
 
   }  // namespace Kalman
 
+  namespace {
+    // Segments of the time axis handled by the parallel algorithms must
+    // contain at least this many time points.  The algorithms require at
+    // least two.
+    const int kMinimumChunkLength = 16;
+  }  // namespace
+
   ScalarKalmanFilter::ScalarKalmanFilter(ScalarStateSpaceModelBase *model)
-      : model_(model)
+      : model_(model),
+        steady_transition_matrix_(nullptr),
+        steady_prediction_variance_(0),
+        steady_observation_variance_(0)
   {}
 
   void ScalarKalmanFilter::update() {
@@ -142,16 +183,49 @@ namespace BOOM {
       nodes_[0].set_state_mean(model_->initial_state_mean());
       nodes_[0].set_state_variance(model_->initial_state_variance());
     }
+    if (use_parallel_algorithms()) {
+      parallel_update();
+      return;
+    }
+
+    // Steady state calculations are only possible if the model matrices do
+    // not vary over time.  The observation variance can still change (e.g.
+    // with multiplexed data), so it is checked at each time point.
+    bool check_steady_state =
+        steady_state_tolerance() > 0 && model_->is_time_invariant();
+    bool steady = false;
+    set_steady_state_time(-1);
 
     for (int t = 0; t < model_->time_dimension(); ++t) {
       if (t > 0) {
         nodes_[t].set_state_mean(nodes_[t-1].state_mean());
-        nodes_[t].set_state_variance(nodes_[t-1].state_variance());
+        if (!steady) {
+          nodes_[t].set_state_variance(nodes_[t-1].state_variance());
+        }
+      }
+      bool missing = model_->is_missing_observation(t);
+      if (steady && (missing || model_->observation_variance(t) !=
+                     steady_observation_variance_)) {
+        steady = false;
+        nodes_[t].set_state_variance(steady_state_variance_);
+      }
+
+      if (steady) {
+        increment_log_likelihood(nodes_[t].steady_state_update(
+            model_->adjusted_observation(t), t,
+            steady_observation_coefficients_, *steady_transition_matrix_,
+            steady_gain_, steady_prediction_variance_,
+            steady_state_variance_));
+      } else {
+        increment_log_likelihood(nodes_[t].update(
+            model_->adjusted_observation(t), missing, t));
+        if (check_steady_state && !missing && t > 0 &&
+            variance_has_converged(nodes_[t - 1].state_variance(),
+                                   nodes_[t].state_variance())) {
+          freeze_steady_state(t);
+          steady = true;
+        }
       }
-      increment_log_likelihood(nodes_[t].update(
-          model_->adjusted_observation(t),
-          model_->is_missing_observation(t),
-          t));
       if (!std::isfinite(log_likelihood())) {
         set_status(NOT_CURRENT);
         return;
@@ -160,6 +234,18 @@ namespace BOOM {
     set_status(CURRENT);
   }
 
+  void ScalarKalmanFilter::freeze_steady_state(int t) {
+    steady_observation_coefficients_ = model_->observation_matrix(t);
+    steady_transition_matrix_ = model_->state_transition_matrix(t);
+    steady_gain_ = nodes_[t].kalman_gain();
+    steady_prediction_variance_ = nodes_[t].prediction_variance();
+    steady_observation_variance_ = model_->observation_variance(t);
+    steady_state_variance_ = nodes_[t].state_variance();
+    if (steady_state_time() < 0) {
+      set_steady_state_time(t + 1);
+    }
+  }
+
   // Disturbance smoother replaces Durbin and Koopman's K[t] with r[t].  The
   // disturbance smoother is equation (5) in Durbin and Koopman (2002).
   //
@@ -170,6 +256,11 @@ namespace BOOM {
       report_error("Model must be set before calling fast_disturbance_smooth().");
     }
 
+    if (use_parallel_algorithms()) {
+      parallel_fast_disturbance_smooth();
+      return;
+    }
+
     int n = model_->time_dimension();
     Vector r(model_->state_dimension(), 0.0);
     for (int t = n - 1; t >= 0; --t) {
@@ -186,15 +277,205 @@ namespace BOOM {
       double F = nodes_[t].prediction_variance();
       double coefficient = (v / F) - nodes_[t].kalman_gain().dot(r);
 
-      // Now produce r[t-1]
-      Vector rt_1 = model_->state_transition_matrix(t)->Tmult(r);
-      model_->observation_matrix(t).add_this_to(rt_1, coefficient);
+      // Now produce r[t-1].  Nodes updated in the steady state can use the
+      // frozen model matrices instead of building them from the state
+      // models.
+      Vector rt_1;
+      if (nodes_[t].in_steady_state()) {
+        rt_1 = steady_transition_matrix_->Tmult(r);
+        steady_observation_coefficients_.add_this_to(rt_1, coefficient);
+      } else {
+        rt_1 = model_->state_transition_matrix(t)->Tmult(r);
+        model_->observation_matrix(t).add_this_to(rt_1, coefficient);
+      }
       nodes_[t].set_scaled_state_error(r);
       r = rt_1;
     }
     set_initial_scaled_state_error(r);
   }
 
+  bool ScalarKalmanFilter::use_parallel_algorithms() const {
+    return parallel_threads() > 1 &&
+           model_->time_dimension() >= 2 * kMinimumChunkLength &&
+           model_->is_time_invariant();
+  }
+
+  void ScalarKalmanFilter::freeze_parallel_matrices() {
+    parallel_observation_coefficients_ = model_->observation_matrix(0);
+    parallel_transition_matrix_.reset(
+        new DenseMatrix(model_->state_transition_matrix(0)->dense()));
+    parallel_state_variance_matrix_.reset(
+        new DenseSpd(model_->state_variance_matrix(0)->dense()));
+  }
+
+  // The time axis is divided into segments, one per thread.
+  //   1) In parallel, each segment but the last is summarized by combining
+  //      the scan elements for its time points.
+  //   2) The summaries are combined sequentially with the initial state
+  //      distribution, giving the predictive distribution of the state at
+  //      the start of each segment.  These are stored in the node preceding
+  //      each segment.
+  //   3) In parallel, the ordinary filter is run on each segment, except for
+  //      its final node, which is the one read by the following segment.
+  //   4) In parallel, the final node of each segment is updated.
+  void ScalarKalmanFilter::parallel_update() {
+    set_steady_state_time(-1);
+    int time_dimension = model_->time_dimension();
+    std::vector<int> chunks = Kalman::time_chunks(
+        time_dimension, parallel_threads(), kMinimumChunkLength);
+    int number_of_chunks = chunks.size() - 1;
+    freeze_parallel_matrices();
+
+    const Matrix &transition(parallel_transition_matrix_->matrix());
+    const SpdMatrix &state_variance(parallel_state_variance_matrix_->value());
+    Vector observation_coefficients =
+        parallel_observation_coefficients_.dense();
+    int state_dimension = observation_coefficients.size();
+    SpdMatrix coefficient_outer_product(state_dimension, 0.0);
+    coefficient_outer_product.add_outer(observation_coefficients);
+
+    WorkStealingThreadPool &pool(WorkStealingThreadPool::global());
+    std::vector<Kalman::FilterElement> summaries(number_of_chunks - 1);
+    pool.parallel_for(0, number_of_chunks - 1, 1, [&](int chunk) {
+        Kalman::FilterElement element;
+        element.A = transition;
+        element.b = Vector(state_dimension, 0.0);
+        element.C = state_variance;
+        for (int t = chunks[chunk]; t < chunks[chunk + 1]; ++t) {
+          if (model_->is_missing_observation(t)) {
+            element.eta = Vector(state_dimension, 0.0);
+            element.J = SpdMatrix(state_dimension, 0.0);
+          } else {
+            double observation_variance = model_->observation_variance(t);
+            if (observation_variance <= 0) {
+              report_error("The parallel Kalman filter requires a positive "
+                           "observation variance.");
+            }
+            element.eta = observation_coefficients
+                * (model_->adjusted_observation(t) / observation_variance);
+            element.J = coefficient_outer_product / observation_variance;
+          }
+          if (t == chunks[chunk]) {
+            summaries[chunk] = element;
+          } else {
+            summaries[chunk] = Kalman::combine(summaries[chunk], element);
+          }
+        }
+      });
+
+    Kalman::FilterElement carry(model_->initial_state_mean(),
+                                model_->initial_state_variance());
+    for (int chunk = 1; chunk < number_of_chunks; ++chunk) {
+      carry = Kalman::combine(carry, summaries[chunk - 1]);
+      nodes_[chunks[chunk] - 1].set_state_mean(carry.b);
+      nodes_[chunks[chunk] - 1].set_state_variance(carry.C);
+    }
+
+    std::vector<double> loglike(number_of_chunks, 0.0);
+    pool.parallel_for(0, number_of_chunks, 1, [&](int chunk) {
+        loglike[chunk] = filter_range(chunks[chunk], chunks[chunk + 1] - 1);
+      });
+    pool.parallel_for(0, number_of_chunks, 1, [&](int chunk) {
+        loglike[chunk] += filter_range(chunks[chunk + 1] - 1,
+                                       chunks[chunk + 1]);
+      });
+
+    for (int chunk = 0; chunk < number_of_chunks; ++chunk) {
+      increment_log_likelihood(loglike[chunk]);
+    }
+    if (!std::isfinite(log_likelihood())) {
+      set_status(NOT_CURRENT);
+    } else {
+      set_status(CURRENT);
+    }
+  }
+
+  double ScalarKalmanFilter::filter_range(int begin, int end) {
+    double loglike = 0;
+    for (int t = begin; t < end; ++t) {
+      if (t > 0) {
+        nodes_[t].set_state_mean(nodes_[t - 1].state_mean());
+        nodes_[t].set_state_variance(nodes_[t - 1].state_variance());
+      }
+      loglike += nodes_[t].update(
+          model_->adjusted_observation(t),
+          model_->is_missing_observation(t),
+          parallel_observation_coefficients_,
+          model_->observation_variance(t),
+          *parallel_transition_matrix_,
+          *parallel_state_variance_matrix_);
+    }
+    return loglike;
+  }
+
+  // The disturbance smoother recursion
+  //   r[t-1] = T' r[t] + Z * (v[t] / F[t] - K[t]' r[t])
+  // is affine in r[t], so a segment of the time axis can be summarized by
+  // the affine map taking r at the end of the segment to r just before its
+  // start.  The maps are computed in parallel, applied sequentially starting
+  // from r[n-1] = 0, and then the ordinary recursion is run on each segment
+  // in parallel.
+  void ScalarKalmanFilter::parallel_fast_disturbance_smooth() {
+    int time_dimension = model_->time_dimension();
+    std::vector<int> chunks = Kalman::time_chunks(
+        time_dimension, parallel_threads(), kMinimumChunkLength);
+    int number_of_chunks = chunks.size() - 1;
+    freeze_parallel_matrices();
+
+    const Matrix &transition(parallel_transition_matrix_->matrix());
+    Vector observation_coefficients =
+        parallel_observation_coefficients_.dense();
+    int state_dimension = observation_coefficients.size();
+
+    // maps[chunk] holds the linear part, and offsets[chunk] the constant part,
+    // of the map for chunk.  Chunk 0 does not need a map.
+    WorkStealingThreadPool &pool(WorkStealingThreadPool::global());
+    std::vector<Matrix> maps(number_of_chunks);
+    std::vector<Vector> offsets(number_of_chunks);
+    pool.parallel_for(1, number_of_chunks, 1, [&](int chunk) {
+        Matrix linear(state_dimension, state_dimension, 0.0);
+        linear.diag() = 1.0;
+        Vector offset(state_dimension, 0.0);
+        for (int t = chunks[chunk + 1] - 1; t >= chunks[chunk]; --t) {
+          const Vector &gain(nodes_[t].kalman_gain());
+          double coefficient = nodes_[t].prediction_error()
+              / nodes_[t].prediction_variance() - gain.dot(offset);
+          Vector gain_linear = linear.Tmult(gain);
+          linear = transition.Tmult(linear);
+          linear.add_outer(observation_coefficients, gain_linear, -1);
+          offset = transition.Tmult(offset);
+          offset.axpy(observation_coefficients, coefficient);
+        }
+        maps[chunk] = linear;
+        offsets[chunk] = offset;
+      });
+
+    std::vector<Vector> starting_values(number_of_chunks);
+    starting_values.back() = Vector(state_dimension, 0.0);
+    for (int chunk = number_of_chunks - 1; chunk > 0; --chunk) {
+      starting_values[chunk - 1] =
+          maps[chunk] * starting_values[chunk] + offsets[chunk];
+    }
+
+    pool.parallel_for(0, number_of_chunks, 1, [&](int chunk) {
+        smooth_range(chunks[chunk], chunks[chunk + 1],
+                     starting_values[chunk]);
+      });
+    set_initial_scaled_state_error(starting_values[0]);
+  }
+
+  void ScalarKalmanFilter::smooth_range(int begin, int end, Vector &r) {
+    for (int t = end - 1; t >= begin; --t) {
+      double coefficient =
+          nodes_[t].prediction_error() / nodes_[t].prediction_variance()
+          - nodes_[t].kalman_gain().dot(r);
+      Vector rt_1 = parallel_transition_matrix_->Tmult(r);
+      parallel_observation_coefficients_.add_this_to(rt_1, coefficient);
+      nodes_[t].set_scaled_state_error(r);
+      r = rt_1;
+    }
+  }
+
   void ScalarKalmanFilter::update(double y, int t, bool missing) {
     if (!model_) {
       report_error("Model must be set before calling update().");
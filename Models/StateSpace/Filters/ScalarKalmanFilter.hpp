@@ -20,6 +20,8 @@
 */
 
 #include "Models/StateSpace/Filters/KalmanFilterBase.hpp"
+#include "Models/StateSpace/Filters/SparseMatrix.hpp"
+#include "Models/StateSpace/Filters/SparseVector.hpp"
 #include "LinAlg/Vector.hpp"
 
 namespace BOOM {
@@ -57,6 +59,56 @@ namespace BOOM {
                     int t,
                     double observation_variance_scale_factor = 1.0);
 
+      // Update this marginal distribution using model matrices supplied by
+      // the caller, rather than obtained from the model.  This allows the
+      // update to run on a thread other than the one that owns the model.
+      //
+      // Args:
+      //   y:  The observed data point.
+      //   missing: If true then the value of y is ignored, and the state is
+      //     simply propagated forward.
+      //   observation_coefficients: The observation matrix Z[t].
+      //   observation_variance: The variance of the observation error at
+      //     time t.
+      //   state_transition_matrix: The transition matrix T[t].
+      //   state_variance_matrix: The variance of the state innovation,
+      //     RQR[t].
+      //
+      // Returns:
+      //   The log likelihood contribution of y.
+      double update(double y, bool missing,
+                    const SparseVector &observation_coefficients,
+                    double observation_variance,
+                    const SparseKalmanMatrix &state_transition_matrix,
+                    const SparseKalmanMatrix &state_variance_matrix);
+
+      // Update this marginal distribution using frozen steady state values
+      // of the Kalman gain, forecast variance, and state variance.  Only the
+      // state mean is propagated.  The observation at time t must not be
+      // missing.
+      //
+      // Args:
+      //   y:  The observed data point.
+      //   t:  The time index associated with this marginal distribution.
+      //   observation_coefficients: The observation matrix Z[t].
+      //   state_transition_matrix: The transition matrix T[t].
+      //   kalman_gain: The steady state Kalman gain.
+      //   prediction_variance: The steady state forecast variance.
+      //   state_variance: The steady state variance of the state at time
+      //     t+1 given data to time t.
+      //
+      // Returns:
+      //   The log likelihood contribution of y.
+      double steady_state_update(
+          double y, int t, const SparseVector &observation_coefficients,
+          const SparseKalmanMatrix &state_transition_matrix,
+          const Vector &kalman_gain, double prediction_variance,
+          const SpdMatrix &state_variance);
+
+      // Returns true if the most recent update of this node used frozen
+      // steady state quantities.
+      bool in_steady_state() const {return in_steady_state_;}
+
       // After the call to update(), state_mean() and state_variance() refer to
       // the predictive mean and variance of the state at time_dimension() + 1
       // given data to time_dimension().
@@ -88,6 +140,7 @@ namespace BOOM {
       double prediction_error_;
       double prediction_variance_;
       Vector kalman_gain_;
+      bool in_steady_state_;
     };
   }  // namespace Kalman
 
@@ -124,8 +177,55 @@ namespace BOOM {
     int size() const override {return nodes_.size();}
 
    private:
+    // Record the quantities computed by the update at time t as the steady
+    // state of the filter.
+    void freeze_steady_state(int t);
+
+    // Returns true if update() and fast_disturbance_smooth() should use the
+    // parallel in time algorithms.  These require more than one thread, a
+    // series long enough to split, and a time invariant model.
+    bool use_parallel_algorithms() const;
+
+    // Store dense copies of the (time invariant) model matrices, which can
+    // be shared by several threads.
+    void freeze_parallel_matrices();
+
+    // Parallel in time implementations of update() and
+    // fast_disturbance_smooth().  See the comments in KalmanFilterBase.
+    void parallel_update();
+    void parallel_fast_disturbance_smooth();
+
+    // Run the filter sequentially over the time points in [begin, end).  The
+    // state mean and variance of node begin - 1 (or the initial state
+    // distribution, if begin == 0) must already be available.  Only the
+    // frozen parallel matrices are used, so several threads can run this
+    // function at once on disjoint ranges.
+    //
+    // Returns:
+    //   The log likelihood contribution of the data in [begin, end).
+    double filter_range(int begin, int end);
+
+    // Run the disturbance smoother backward over the time points in [begin,
+    // end), starting with r = r[end - 1].  On exit r is r[begin - 1].  Like
+    // filter_range, this function uses only the frozen parallel matrices.
+    void smooth_range(int begin, int end, Vector &r);
+
     ScalarStateSpaceModelBase *model_;
     std::vector<Kalman::ScalarMarginalDistribution> nodes_;
+
+    // The frozen quantities used once the filter has reached a steady state.
+    // The transition matrix is owned by the model.
+    SparseVector steady_observation_coefficients_;
+    const SparseKalmanMatrix *steady_transition_matrix_;
+    Vector steady_gain_;
+    double steady_prediction_variance_;
+    double steady_observation_variance_;
+    SpdMatrix steady_state_variance_;
+
+    // Dense copies of the model matrices used by the parallel algorithms.
+    SparseVector parallel_observation_coefficients_;
+    Ptr<DenseMatrix> parallel_transition_matrix_;
+    Ptr<DenseSpd> parallel_state_variance_matrix_;
   };
 
 }  // namespace BOOM
@@ -1745,6 +1745,12 @@ namespace BOOM {
     return ans;
   }
 
+  void SparseKalmanMatrix::multiply_inplace(VectorView x) const {
+    conforms_to_rows(x.size());
+    conforms_to_cols(x.size());
+    x = (*this) * x;
+  }
+
   void SparseKalmanMatrix::sandwich_inplace(SpdMatrix &P) const {
     // First replace P with *this * P, which corresponds to *this
     // multiplying each column of P.
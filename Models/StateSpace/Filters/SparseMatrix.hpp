@@ -62,6 +62,11 @@ namespace BOOM {
     virtual Vector Tmult(const ConstVectorView &v) const = 0;
     virtual Matrix Tmult(const Matrix &rhs) const;
 
+    // Replace x with this * x.  This only works with square matrices.  The
+    // default implementation builds a temporary, so child classes that can
+    // do the multiplication in place should override.
+    virtual void multiply_inplace(VectorView x) const;
+
     // Replace the argument P with
     //   this * P * this.transpose()
     // This only works with square matrices.  Non-square matrices will throw.
@@ -422,7 +427,7 @@ namespace BOOM {
     Matrix Tmult(const Matrix &rhs) const override;
 
     // Replace x with this * x.  Assumes *this is square.
-    virtual void multiply_inplace(VectorView x) const = 0;
+    void multiply_inplace(VectorView x) const override = 0;
 
     // m = this * m
     virtual void matrix_multiply_inplace(SubMatrix m) const;
@@ -0,0 +1,88 @@
+/*
+  Copyright (C) 2019 Steven L. Scott
+
+  This library is free software; you can redistribute it and/or modify it under
+  the terms of the GNU Lesser General Public License as published by the Free
+  Software Foundation; either version 2.1 of the License, or (at your option)
+  any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT
+  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+  FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+  details.
+
+  You should have received a copy of the GNU Lesser General Public License along
+  with this library; if not, write to the Free Software Foundation, Inc., 51
+  Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+*/
+
+// Timings for ScalarKalmanFilter::update on a local level plus seasonal
+// model.  The first benchmark argument is the length of the time series, and
+// the second is the number of seasons, which sets the state dimension.
+
+#include "benchmark/benchmark.h"
+#include "distributions.hpp"
+#include "Models/StateSpace/StateSpaceModel.hpp"
+#include "Models/StateSpace/Filters/ScalarKalmanFilter.hpp"
+#include "Models/StateSpace/StateModels/LocalLevelStateModel.hpp"
+#include "Models/StateSpace/StateModels/SeasonalStateModel.hpp"
+
+namespace {
+  using namespace BOOM;
+
+  // A local level plus seasonal model, with data simulated from a fixed seed.
+  Ptr<StateSpaceModel> simulate_model(int time_dimension, int nseasons) {
+    GlobalRng::rng.seed(8675309);
+    Vector y(time_dimension);
+    double level = 0;
+    for (int t = 0; t < time_dimension; ++t) {
+      level += rnorm(0, .3);
+      y[t] = level + (t % nseasons) + rnorm(0, 1.0);
+    }
+    std::vector<bool> observed(time_dimension, true);
+    NEW(StateSpaceModel, model)(y, observed);
+    NEW(LocalLevelStateModel, level_model)(square(.3));
+    NEW(SeasonalStateModel, seasonal)(nseasons, 1);
+    seasonal->set_sigsq(square(.1));
+    seasonal->set_initial_state_mean(Vector(nseasons - 1, 0.0));
+    seasonal->set_initial_state_variance(SpdMatrix(nseasons - 1, 1.0));
+    model->add_state(level_model);
+    model->add_state(seasonal);
+    model->observation_model()->set_sigsq(1.0);
+    return model;
+  }
+
+  void run_filter(benchmark::State &state, double steady_state_tolerance) {
+    int time_dimension = state.range(0);
+    Ptr<StateSpaceModel> model = simulate_model(time_dimension,
+                                                state.range(1));
+    ScalarKalmanFilter &filter(model->get_filter());
+    filter.set_steady_state_tolerance(steady_state_tolerance);
+    for (auto _ : state) {
+      filter.update();
+      benchmark::DoNotOptimize(filter.log_likelihood());
+    }
+    state.SetItemsProcessed(state.iterations() * time_dimension);
+  }
+
+  // Every time step does the full covariance update.
+  void BM_ScalarKalmanFilterUpdate(benchmark::State &state) {
+    run_filter(state, 0.0);
+  }
+
+  // Once the state variance converges the covariance update is skipped.
+  void BM_ScalarKalmanFilterSteadyState(benchmark::State &state) {
+    run_filter(state, 1e-8);
+  }
+
+  void KalmanArgs(benchmark::internal::Benchmark *benchmark) {
+    benchmark->ArgsProduct({{1000, 10000}, {4, 12, 52}})
+        ->Unit(benchmark::kMicrosecond);
+  }
+
+  BENCHMARK(BM_ScalarKalmanFilterUpdate)->Apply(KalmanArgs);
+  BENCHMARK(BM_ScalarKalmanFilterSteadyState)->Apply(KalmanArgs);
+
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,146 @@
+#include "gtest/gtest.h"
+#include "distributions.hpp"
+#include "Models/StateSpace/StateSpaceModel.hpp"
+#include "Models/StateSpace/Filters/BatchedScalarKalmanFilter.hpp"
+#include "Models/StateSpace/Filters/ScalarKalmanFilter.hpp"
+#include "Models/StateSpace/StateModels/LocalLevelStateModel.hpp"
+#include "Models/StateSpace/StateModels/SeasonalStateModel.hpp"
+
+#include "test_utils/test_utils.hpp"
+
+namespace {
+  using namespace BOOM;
+  using std::endl;
+
+  class BatchedKalmanFilterTest : public ::testing::Test {
+   protected:
+    BatchedKalmanFilterTest() {
+      GlobalRng::rng.seed(8675309);
+      for (int n = 0; n < number_of_series_; ++n) {
+        models_.push_back(build_model(n));
+      }
+      for (const auto &model : models_) {
+        model_pointers_.push_back(model.get());
+      }
+    }
+
+    // A local level plus seasonal model.  The parameters differ from one
+    // series to the next, and each series has a different block of missing
+    // data.
+    Ptr<StateSpaceModel> build_model(int n) {
+      double level_sd = .2 + .1 * n;
+      double observation_sd = .5 + .25 * n;
+      Vector y(time_dimension_);
+      double level = n;
+      for (int t = 0; t < time_dimension_; ++t) {
+        level += rnorm(0, level_sd);
+        y[t] = level + (t % 4) + rnorm(0, observation_sd);
+      }
+      std::vector<bool> observed(time_dimension_, true);
+      for (int t = 10 + 5 * n; t < 15 + 5 * n; ++t) {
+        observed[t] = false;
+      }
+      NEW(StateSpaceModel, model)(y, observed);
+      NEW(LocalLevelStateModel, level_model)(square(level_sd));
+      NEW(SeasonalStateModel, seasonal)(4, 1);
+      seasonal->set_sigsq(square(.1));
+      seasonal->set_initial_state_mean(Vector(3, 0.0));
+      seasonal->set_initial_state_variance(SpdMatrix(3, 1.0));
+      level_model->set_initial_state_mean(n);
+      level_model->set_initial_state_variance(1.0);
+      model->add_state(level_model);
+      model->add_state(seasonal);
+      model->observation_model()->set_sigsq(square(observation_sd));
+      return model;
+    }
+
+    // The smoothed state mean computed by the model's own filter.
+    Matrix scalar_smoothed_state_mean(StateSpaceModel &model) {
+      ScalarKalmanFilter &filter(model.get_filter());
+      filter.update();
+      filter.fast_disturbance_smooth();
+      Matrix ans(model.state_dimension(), model.time_dimension());
+      Vector mean = model.initial_state_mean() +
+          model.initial_state_variance() * filter.initial_scaled_state_error();
+      ans.col(0) = mean;
+      for (int t = 1; t < model.time_dimension(); ++t) {
+        mean = (*model.state_transition_matrix(t - 1)) * mean +
+            (*model.state_variance_matrix(t - 1)) *
+            filter[t - 1].scaled_state_error();
+        ans.col(t) = mean;
+      }
+      return ans;
+    }
+
+    int number_of_series_ = 4;
+    int time_dimension_ = 60;
+    std::vector<Ptr<StateSpaceModel>> models_;
+    std::vector<ScalarStateSpaceModelBase *> model_pointers_;
+  };
+
+  TEST_F(BatchedKalmanFilterTest, MatchesScalarFilter) {
+    BatchedScalarKalmanFilter batch(model_pointers_);
+    EXPECT_EQ(number_of_series_, batch.number_of_series());
+    EXPECT_EQ(4, batch.state_dimension());
+    EXPECT_EQ(time_dimension_, batch.time_dimension());
+
+    const Vector &loglike(batch.filter());
+    std::vector<Matrix> smoothed_means = batch.smoothed_state_means();
+    for (int n = 0; n < number_of_series_; ++n) {
+      EXPECT_NEAR(models_[n]->log_likelihood(), loglike[n], 1e-8)
+          << "series " << n;
+      EXPECT_TRUE(MatrixEquals(scalar_smoothed_state_mean(*models_[n]),
+                               smoothed_means[n], 1e-8))
+          << "series " << n << endl
+          << scalar_smoothed_state_mean(*models_[n]) << endl
+          << smoothed_means[n];
+    }
+  }
+
+  TEST_F(BatchedKalmanFilterTest, ImputeStateCentersOnSmoothedMean) {
+    BatchedScalarKalmanFilter batch(model_pointers_);
+    std::vector<Matrix> smoothed_means = batch.smoothed_state_means();
+    int niter = 500;
+    std::vector<Matrix> state_sums(
+        number_of_series_, Matrix(batch.state_dimension(), time_dimension_,
+                                  0.0));
+    RNG rng(12345);
+    for (int i = 0; i < niter; ++i) {
+      batch.impute_state(rng);
+      for (int n = 0; n < number_of_series_; ++n) {
+        state_sums[n] += models_[n]->state();
+      }
+    }
+    for (int n = 0; n < number_of_series_; ++n) {
+      Matrix state_mean = state_sums[n] / niter;
+      EXPECT_TRUE(MatrixEquals(state_mean, smoothed_means[n], .2))
+          << "series " << n << endl
+          << state_mean - smoothed_means[n];
+    }
+  }
+
+  // A series whose state has been permanently set keeps it, while the other
+  // series are imputed as usual.
+  TEST_F(BatchedKalmanFilterTest, ImputeStateKeepsFixedState) {
+    BatchedScalarKalmanFilter batch(model_pointers_);
+    Matrix fixed_state(batch.state_dimension(), time_dimension_);
+    fixed_state.randomize_gaussian();
+    models_[1]->permanently_set_state(fixed_state);
+    RNG rng(12345);
+    for (int i = 0; i < 3; ++i) {
+      batch.impute_state(rng);
+      EXPECT_DOUBLE_EQ(0.0, (models_[1]->state() - fixed_state).max_abs());
+      EXPECT_TRUE(models_[0]->state().all_finite());
+    }
+  }
+
+  TEST_F(BatchedKalmanFilterTest, RejectsMismatchedModels) {
+    NEW(StateSpaceModel, other)(Vector(time_dimension_, 1.0));
+    NEW(LocalLevelStateModel, level_model)(1.0);
+    other->add_state(level_model);
+    model_pointers_.push_back(other.get());
+    EXPECT_THROW(BatchedScalarKalmanFilter batch(model_pointers_),
+                 std::exception);
+  }
+
+}  // namespace
@@ -1,6 +1,8 @@
 #include "gtest/gtest.h"
 #include "distributions.hpp"
 #include "Models/StateSpace/StateSpaceModel.hpp"
+#include "Models/StateSpace/Filters/ParallelKalmanScan.hpp"
+#include "Models/StateSpace/Filters/ScalarKalmanFilter.hpp"
 #include "Models/StateSpace/StateModels/LocalLevelStateModel.hpp"
 #include "Models/StateSpace/StateModels/SeasonalStateModel.hpp"
 
@@ -71,4 +73,154 @@ namespace {
     // TODO(finish this later)
   }
 
+  // Checks that freezing the Kalman gain once the filter reaches a steady
+  // state gives the same answers as running the full filter, including
+  // around a block of missing observations.
+  TEST_F(KalmanFilterTest, SteadyState) {
+    int time_dimension = 1000;
+    Vector y(time_dimension);
+    double level = 0;
+    for (int t = 0; t < time_dimension; ++t) {
+      level += rnorm(0, .3);
+      y[t] = level + (t % 4) + rnorm(0, 1.0);
+    }
+    std::vector<bool> observed(time_dimension, true);
+    for (int t = 600; t < 610; ++t) {
+      observed[t] = false;
+    }
+
+    NEW(StateSpaceModel, model)(y, observed);
+    NEW(LocalLevelStateModel, level_model)(square(.3));
+    NEW(SeasonalStateModel, seasonal)(4, 1);
+    seasonal->set_sigsq(square(.1));
+    seasonal->set_initial_state_mean(Vector(3, 0.0));
+    seasonal->set_initial_state_variance(SpdMatrix(3, 1.0));
+    model->add_state(level_model);
+    model->add_state(seasonal);
+    model->observation_model()->set_sigsq(1.0);
+    EXPECT_TRUE(model->is_time_invariant());
+
+    ScalarKalmanFilter &filter(model->get_filter());
+    filter.set_steady_state_tolerance(0.0);
+    filter.update();
+    filter.fast_disturbance_smooth();
+    EXPECT_EQ(-1, filter.steady_state_time());
+    double full_loglike = filter.log_likelihood();
+    Matrix full_state_mean = filter.state_mean();
+    Vector full_r0 = filter.initial_scaled_state_error();
+    std::vector<Vector> full_scaled_errors;
+    for (int t = 0; t < time_dimension; ++t) {
+      full_scaled_errors.push_back(filter[t].scaled_state_error());
+    }
+    SpdMatrix full_final_variance = filter[time_dimension - 1].state_variance();
+
+    filter.set_steady_state_tolerance(1e-10);
+    filter.update();
+    filter.fast_disturbance_smooth();
+    EXPECT_GT(filter.steady_state_time(), 0);
+    EXPECT_LT(filter.steady_state_time(), 600);
+    EXPECT_TRUE(filter[599].in_steady_state());
+    EXPECT_FALSE(filter[600].in_steady_state());
+    EXPECT_TRUE(filter[time_dimension - 1].in_steady_state());
+
+    EXPECT_NEAR(full_loglike, filter.log_likelihood(), 1e-6);
+    EXPECT_TRUE(MatrixEquals(full_state_mean, filter.state_mean(), 1e-6));
+    EXPECT_TRUE(VectorEquals(full_r0, filter.initial_scaled_state_error(),
+                             1e-6));
+    for (int t = 0; t < time_dimension; ++t) {
+      EXPECT_TRUE(VectorEquals(full_scaled_errors[t],
+                               filter[t].scaled_state_error(), 1e-6))
+          << "t = " << t;
+    }
+    EXPECT_TRUE(MatrixEquals(full_final_variance,
+                             filter[time_dimension - 1].state_variance(),
+                             1e-6));
+  }
+
+  TEST_F(KalmanFilterTest, ParallelMatchesSequential) {
+    int time_dimension = 2000;
+    Vector y(time_dimension);
+    double level = 0;
+    for (int t = 0; t < time_dimension; ++t) {
+      level += rnorm(0, .3);
+      y[t] = level + (t % 7) + rnorm(0, 1.0);
+    }
+    // The missing values straddle the boundary between the first two
+    // segments of the parallel filter.
+    std::vector<bool> observed(time_dimension, true);
+    for (int t = 490; t < 520; ++t) {
+      observed[t] = false;
+    }
+
+    NEW(StateSpaceModel, model)(y, observed);
+    NEW(LocalLevelStateModel, level_model)(square(.3));
+    NEW(SeasonalStateModel, seasonal)(7, 1);
+    seasonal->set_sigsq(square(.1));
+    seasonal->set_initial_state_mean(Vector(6, 0.0));
+    seasonal->set_initial_state_variance(SpdMatrix(6, 1.0));
+    model->add_state(level_model);
+    model->add_state(seasonal);
+    model->observation_model()->set_sigsq(1.0);
+
+    ScalarKalmanFilter &filter(model->get_filter());
+    filter.set_steady_state_tolerance(0.0);
+    filter.update();
+    filter.fast_disturbance_smooth();
+    double sequential_loglike = filter.log_likelihood();
+    Matrix sequential_state_mean = filter.state_mean();
+    Vector sequential_r0 = filter.initial_scaled_state_error();
+    std::vector<Vector> sequential_scaled_errors;
+    std::vector<double> sequential_prediction_errors;
+    for (int t = 0; t < time_dimension; ++t) {
+      sequential_scaled_errors.push_back(filter[t].scaled_state_error());
+      sequential_prediction_errors.push_back(filter[t].prediction_error());
+    }
+    SpdMatrix sequential_final_variance =
+        filter[time_dimension - 1].state_variance();
+
+    filter.set_parallel_threads(4);
+    EXPECT_EQ(4, filter.parallel_threads());
+    filter.update();
+    filter.fast_disturbance_smooth();
+    EXPECT_NEAR(sequential_loglike, filter.log_likelihood(), 1e-6);
+    EXPECT_TRUE(MatrixEquals(sequential_state_mean, filter.state_mean(),
+                             1e-6));
+    EXPECT_TRUE(VectorEquals(sequential_r0,
+                             filter.initial_scaled_state_error(), 1e-6));
+    for (int t = 0; t < time_dimension; ++t) {
+      EXPECT_NEAR(sequential_prediction_errors[t],
+                  filter[t].prediction_error(), 1e-6)
+          << "t = " << t;
+      EXPECT_TRUE(VectorEquals(sequential_scaled_errors[t],
+                               filter[t].scaled_state_error(), 1e-6))
+          << "t = " << t;
+    }
+    EXPECT_TRUE(MatrixEquals(sequential_final_variance,
+                             filter[time_dimension - 1].state_variance(),
+                             1e-6));
+
+    // The scan elements are associative.
+    Kalman::FilterElement initial(model->initial_state_mean(),
+                                  model->initial_state_variance());
+    std::vector<Kalman::FilterElement> elements(3);
+    Vector Z = model->observation_matrix(0).dense();
+    for (int i = 0; i < 3; ++i) {
+      elements[i].A = model->state_transition_matrix(0)->dense();
+      elements[i].b = Vector(Z.size(), 0.0);
+      elements[i].C = model->state_variance_matrix(0)->dense();
+      elements[i].eta = Z * y[i];
+      elements[i].J = SpdMatrix(Z.size(), 0.0);
+      elements[i].J.add_outer(Z);
+    }
+    Kalman::FilterElement left = Kalman::combine(
+        Kalman::combine(Kalman::combine(initial, elements[0]), elements[1]),
+        elements[2]);
+    Kalman::FilterElement right = Kalman::combine(
+        initial, Kalman::combine(elements[0],
+                                 Kalman::combine(elements[1], elements[2])));
+    EXPECT_TRUE(VectorEquals(left.b, right.b, 1e-6));
+    EXPECT_TRUE(MatrixEquals(left.C, right.C, 1e-6));
+    EXPECT_TRUE(VectorEquals(left.b, filter[2].state_mean(), 1e-6));
+  }
+
 }  // namespace
@@ -231,7 +231,8 @@ namespace BoomStateSpaceTesting {
 
     double update(const Vector &y, const Selector &observed) {
       return vector_kalman_update(y, state_mean_, state_variance_, K_, F_, v_,
-                                  observed, Z_, H_, T_, L_, RQR_);
+                                  observed, Z_, H_, T_, L_, RQR_,
+                                  workspace_);
     }
 
     const Vector &state_mean() const {return state_mean_;}
@@ -266,6 +267,8 @@ namespace BoomStateSpaceTesting {
     Matrix L_;
 
     Vector r_;
+
+    KalmanUpdateWorkspace workspace_;
   };
 
   //===========================================================================
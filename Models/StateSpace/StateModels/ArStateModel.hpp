@@ -77,6 +77,7 @@ namespace BOOM {
     Ptr<SparseMatrixBlock> state_error_variance(int t) const override;
 
     SparseVector observation_matrix(int t) const override;
+    bool is_time_invariant() const override { return true; }
 
     Vector initial_state_mean() const override;
     SpdMatrix initial_state_variance() const override;
@@ -124,6 +124,10 @@ namespace BOOM {
 
     int season_duration() const {return duration_;}
 
+    // The transition matrix only changes at the start of a new season, so
+    // the model is time invariant if every period starts a new season.
+    bool is_time_invariant() const override { return duration_ == 1; }
+
    private:
     uint duration_;
     int time_of_first_observation_;
@@ -145,6 +145,13 @@ namespace BOOM {
     virtual Vector initial_state_mean() const = 0;
     virtual SpdMatrix initial_state_variance() const = 0;
 
+    // Returns true if the state transition matrix, the state variance
+    // matrix, and the observation matrix (or observation coefficients) do
+    // not depend on t.  Kalman filters can exploit time invariance by
+    // detecting when the state variance has reached a steady state.  The
+    // default is the conservative answer of false.
+    virtual bool is_time_invariant() const { return false; }
+
     // Some state models can behave differently in different contexts.
     // E.g. they can be viewed as conditionally normal when fitting,
     // but as T or normal mixtures when forecasting.  These virtual
@@ -0,0 +1,141 @@
+/*
+  Copyright (C) 2019 Steven L. Scott
+
+  This library is free software; you can redistribute it and/or modify it under
+  the terms of the GNU Lesser General Public License as published by the Free
+  Software Foundation; either version 2.1 of the License, or (at your option)
+  any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT
+  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+  FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+  details.
+
+  You should have received a copy of the GNU Lesser General Public License along
+  with this library; if not, write to the Free Software Foundation, Inc., 51
+  Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+*/
+
+#include "Models/StateSpace/StateSpaceForecaster.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "Models/StateSpace/Filters/KalmanTools.hpp"
+#include "cpputil/ThreadTools.hpp"
+#include "cpputil/report_error.hpp"
+#include "distributions.hpp"
+
+namespace BOOM {
+
+  StateSpaceForecaster::StateSpaceForecaster(
+      const Ptr<ScalarStateSpaceModelBase> &model, const Simulator &simulator)
+      : model_(model),
+        simulator_(simulator),
+        number_of_threads_(0),
+        refilter_(false) {
+    if (!model_) {
+      report_error("StateSpaceForecaster needs a model.");
+    }
+    if (!simulator_) {
+      report_error("StateSpaceForecaster needs a simulator.");
+    }
+  }
+
+  StateSpaceForecaster::StateSpaceForecaster(const Ptr<StateSpaceModel> &model)
+      : StateSpaceForecaster(
+            model,
+            [](ScalarStateSpaceModelBase *worker, RNG &rng, int horizon,
+               const Vector &final_state) {
+              return dynamic_cast<StateSpaceModel *>(worker)
+                  ->simulate_forecast(rng, horizon, final_state);
+            }) {}
+
+  void StateSpaceForecaster::set_number_of_threads(int n) {
+    number_of_threads_ = std::max(n, 0);
+    if (number_of_threads_ > 1) {
+      WorkStealingThreadPool::global().set_minimum_number_of_threads(
+          number_of_threads_);
+    }
+  }
+
+  Matrix StateSpaceForecaster::forecast(const Matrix &parameter_draws,
+                                        const Matrix &final_states,
+                                        int horizon,
+                                        RNG &seeding_rng) {
+    int ndraws = parameter_draws.nrow();
+    if (!refilter_ && final_states.nrow() != ndraws) {
+      report_error("There must be one final state for each parameter draw.");
+    }
+    if (horizon < 0) {
+      report_error("The forecast horizon must be non-negative.");
+    }
+    Matrix ans(ndraws, horizon);
+    if (ndraws == 0) return ans;
+
+    int number_of_blocks = std::max<int>(
+        1, std::min<int>(number_of_threads_, ndraws));
+    int max_time = model_->time_dimension() + horizon;
+    std::vector<Ptr<ScalarStateSpaceModelBase>> workers;
+    for (int block = 0; block < number_of_blocks; ++block) {
+      workers.push_back(model_->clone());
+      for (int s = 0; s < workers.back()->number_of_state_models(); ++s) {
+        workers.back()->state_model(s)->observe_time_dimension(max_time);
+      }
+    }
+
+    RNG::RngIntType key = seeding_rng.random_bits();
+    auto run_block = [&](int block) {
+      RNG draw_rng(key, RNG::PHILOX);
+      int begin = static_cast<std::int64_t>(block) * ndraws / number_of_blocks;
+      int end =
+          static_cast<std::int64_t>(block + 1) * ndraws / number_of_blocks;
+      for (int i = begin; i < end; ++i) {
+        draw_rng.jump(i);
+        forecast_one_draw(workers[block].get(), i, parameter_draws,
+                          final_states, draw_rng, ans);
+      }
+    };
+    if (number_of_blocks > 1) {
+      WorkStealingThreadPool::global().parallel_for(
+          0, number_of_blocks, 1, run_block);
+    } else {
+      run_block(0);
+    }
+    return ans;
+  }
+
+  void StateSpaceForecaster::forecast_one_draw(
+      ScalarStateSpaceModelBase *worker,
+      int i,
+      const Matrix &parameter_draws,
+      const Matrix &final_states,
+      RNG &rng,
+      Matrix &ans) const {
+    worker->unvectorize_params(parameter_draws.row(i), true);
+    Vector final_state;
+    if (refilter_) {
+      worker->kalman_filter();
+      const Kalman::ScalarMarginalDistribution &marg(
+          worker->get_filter().back());
+      Vector state_mean = marg.state_mean();
+      SpdMatrix state_variance = marg.state_variance();
+      make_contemporaneous(
+          state_mean,
+          state_variance,
+          marg.prediction_variance(),
+          marg.prediction_error(),
+          worker->observation_matrix(worker->time_dimension()).dense());
+      final_state = rmvn_mt(rng, state_mean, state_variance);
+    } else {
+      final_state = final_states.row(i);
+    }
+    Vector forecast = simulator_(worker, rng, ans.ncol(), final_state);
+    if (forecast.size() != ans.ncol()) {
+      report_error("The simulated forecast does not match the horizon.");
+    }
+    ans.row(i) = forecast;
+  }
+
+}  // namespace BOOM
@@ -0,0 +1,136 @@
+#ifndef BOOM_STATE_SPACE_FORECASTER_HPP_
+#define BOOM_STATE_SPACE_FORECASTER_HPP_
+/*
+  Copyright (C) 2019 Steven L. Scott
+
+  This library is free software; you can redistribute it and/or modify it under
+  the terms of the GNU Lesser General Public License as published by the Free
+  Software Foundation; either version 2.1 of the License, or (at your option)
+  any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT
+  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+  FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+  details.
+
+  You should have received a copy of the GNU Lesser General Public License along
+  with this library; if not, write to the Free Software Foundation, Inc., 51
+  Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+*/
+
+#include <functional>
+
+#include "Models/StateSpace/StateSpaceModel.hpp"
+#include "Models/StateSpace/StateSpaceModelBase.hpp"
+#include "LinAlg/Matrix.hpp"
+#include "LinAlg/Vector.hpp"
+#include "distributions/rng.hpp"
+#include "cpputil/Ptr.hpp"
+
+namespace BOOM {
+
+  // Simulates the posterior predictive distribution of a scalar state space
+  // model from a stored sequence of MCMC draws.  Each draw consists of a
+  // vector of model parameters, in the format produced by
+  // model->vectorize_params(true), and (optionally) the value of the state
+  // vector at the end of the training data.
+  //
+  // The draws are divided into contiguous blocks, one per thread.  Each block
+  // is handled by a private clone of the model, so the model passed to the
+  // constructor is not modified.  Draw i is simulated using its own stream of
+  // random numbers, so the forecasts depend on the seeding RNG but not on the
+  // number of threads.
+  //
+  // Typical use:
+  //   StateSpaceForecaster forecaster(model, StateSpaceForecaster::Simulator(
+  //       [&newX](ScalarStateSpaceModelBase *model, RNG &rng, int horizon,
+  //               const Vector &final_state) {
+  //         return dynamic_cast<StateSpaceRegressionModel *>(model)
+  //             ->simulate_forecast(rng, newX, final_state);
+  //       }));
+  //   forecaster.set_number_of_threads(8);
+  //   Matrix forecast = forecaster.forecast(
+  //       parameter_draws, final_states, newX.nrow(), GlobalRng::rng);
+  class StateSpaceForecaster {
+   public:
+    // A function that simulates one draw from the predictive distribution.
+    //
+    // Args:
+    //   model: A clone of the model passed to the constructor, with
+    //     parameters set to a posterior draw.
+    //   rng: The random number generator to use for the simulation.
+    //   horizon: The number of time periods to forecast.
+    //   final_state: The value of the state vector at the end of the
+    //     training data.
+    //
+    // Returns:
+    //   A simulated time series of length 'horizon'.
+    using Simulator = std::function<Vector(
+        ScalarStateSpaceModelBase *model, RNG &rng, int horizon,
+        const Vector &final_state)>;
+
+    // Args:
+    //   model: The model to be forecast.  The model is cloned once per
+    //     thread each time forecast() is called.  Any external data needed by
+    //     the state models over the forecast horizon (e.g. predictors for a
+    //     dynamic regression) must be present in the model.
+    //   simulator: Simulates a single forecast from a clone of 'model'.
+    StateSpaceForecaster(const Ptr<ScalarStateSpaceModelBase> &model,
+                         const Simulator &simulator);
+
+    // Forecast a StateSpaceModel using StateSpaceModel::simulate_forecast.
+    explicit StateSpaceForecaster(const Ptr<StateSpaceModel> &model);
+
+    // Split the work among 'n' threads from the global thread pool.  Values
+    // of 0 or 1 run the simulation in the calling thread.
+    void set_number_of_threads(int n);
+    int number_of_threads() const { return number_of_threads_; }
+
+    // If 'refilter' is true then the final state for each draw is simulated
+    // by running the Kalman filter through the model's data, rather than
+    // taken from the stored draw.  This is needed when the model's data
+    // differs from the data used to fit the model.  Refiltering is only
+    // appropriate for Gaussian models.
+    void set_refilter(bool refilter) { refilter_ = refilter; }
+    bool refilter() const { return refilter_; }
+
+    // Simulate the predictive distribution.
+    //
+    // Args:
+    //   parameter_draws: Each row is a posterior draw of the model
+    //     parameters, in the format produced by vectorize_params(true).
+    //   final_states: Row i is the value of the state vector at the end of
+    //     the training data in MCMC iteration i.  Ignored (and may be empty)
+    //     if refilter() is true.
+    //   horizon: The number of time periods to forecast.
+    //   seeding_rng: The random number generator used to seed the streams
+    //     for the individual draws.
+    //
+    // Returns:
+    //   A matrix with one row per posterior draw and 'horizon' columns.
+    //   Row i is a draw from the predictive distribution given the
+    //   parameters in row i of parameter_draws.
+    Matrix forecast(const Matrix &parameter_draws,
+                    const Matrix &final_states,
+                    int horizon,
+                    RNG &seeding_rng);
+
+   private:
+    // Simulate a forecast for draw i using 'worker', writing it to
+    // ans.row(i).
+    void forecast_one_draw(ScalarStateSpaceModelBase *worker,
+                           int i,
+                           const Matrix &parameter_draws,
+                           const Matrix &final_states,
+                           RNG &rng,
+                           Matrix &ans) const;
+
+    Ptr<ScalarStateSpaceModelBase> model_;
+    Simulator simulator_;
+    int number_of_threads_;
+    bool refilter_;
+  };
+
+}  // namespace BOOM
+
+#endif  // BOOM_STATE_SPACE_FORECASTER_HPP_
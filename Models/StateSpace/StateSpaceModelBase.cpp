@@ -673,6 +673,16 @@ namespace BOOM {
     }
     return ans;
   }
+  //----------------------------------------------------------------------
+  bool ScalarBase::is_time_invariant() const {
+    for (int s = 0; s < number_of_state_models(); ++s) {
+      if (!state_model(s)->is_time_invariant()) {
+        return false;
+      }
+    }
+    return true;
+  }
+
   //----------------------------------------------------------------------
   void ScalarBase::kalman_filter() {
     filter_.update();
@@ -851,6 +861,43 @@ namespace BOOM {
     return rnorm_mt(rng, mu, sqrt(observation_variance(t)));
   }
 
+  //----------------------------------------------------------------------
+  Vector ScalarBase::simulate_state_and_data_residuals(RNG &rng) {
+    if (number_of_state_models() == 0) {
+      report_error("No state has been defined.");
+    }
+    set_state_model_behavior(StateModel::MIXTURE);
+    resize_state();
+    clear_client_data();
+    Vector ans(time_dimension(), 0.0);
+    for (int t = 0; t < time_dimension(); ++t) {
+      if (t == 0) {
+        simulate_initial_state(rng, mutable_state().col(0));
+      } else {
+        simulate_next_state(rng, mutable_state().col(t - 1),
+                            mutable_state().col(t), t);
+      }
+      double simulated_observation = simulate_adjusted_observation(rng, t);
+      if (!is_missing_observation(t)) {
+        ans[t] = adjusted_observation(t) - simulated_observation;
+      }
+    }
+    return ans;
+  }
+
+  //----------------------------------------------------------------------
+  void ScalarBase::add_smoothed_state_mean(const Matrix &smoothed_state_mean) {
+    if (smoothed_state_mean.nrow() != state_dimension() ||
+        smoothed_state_mean.ncol() != time_dimension()) {
+      report_error("Smoothed state mean has the wrong dimensions.");
+    }
+    mutable_state() += smoothed_state_mean;
+    for (int t = 0; t < time_dimension(); ++t) {
+      observe_state(t);
+      observe_data_given_state(t);
+    }
+  }
+
   //---------------------------------------------------------------------------
   // The call to simulate_forward fills the state matrix with simulated state
   // values that have the right variance but the wrong mean.  This function
@@ -890,6 +937,18 @@ namespace BOOM {
     }
   }
 
+  namespace {
+    // Point each sampler owned by 'model' at its own stream from 'streams'.
+    void assign_sampler_streams(Model *model, const RNG &streams,
+                                std::uint64_t &stream_id) {
+      for (int s = 0; s < model->number_of_sampling_methods(); ++s) {
+        RNG &rng(model->sampler(s)->rng());
+        rng = streams;
+        rng.jump(stream_id++);
+      }
+    }
+  }  // namespace
+
   namespace StateSpaceUtils {
 
     // Compute one-step prediction errors on one or more holdout sets.
@@ -901,9 +960,11 @@ namespace BOOM {
       std::vector<Matrix> prediction_errors(cutpoints.size(),
                                             Matrix(niter, model.time_dimension()));
       std::vector<std::future<void>> futures;
-      int desired_threads = std::min<int>(
+      // hardware_concurrency() can return 0 or 1, but the pool needs at least
+      // one thread to make progress.
+      int desired_threads = std::max<int>(1, std::min<int>(
           cutpoints.size(),
-          std::thread::hardware_concurrency() - 1);
+          static_cast<int>(std::thread::hardware_concurrency()) - 1));
       BOOM::ThreadWorkerPool pool;
       pool.add_threads(desired_threads);
       std::vector<Ptr<ScalarStateSpaceModelBase>> workers;
@@ -935,8 +996,19 @@ namespace BOOM {
         Matrix &output_;
       };
 
+      // Each worker's samplers get their own streams, so the simulation for
+      // each holdout set is reproducible regardless of thread scheduling.
+      RNG streams(seed_rng(), RNG::PHILOX);
+      std::uint64_t stream_id = 0;
       for (int i = 0; i < cutpoints.size(); ++i) {
         workers.push_back(model.deepclone());
+        ScalarStateSpaceModelBase *worker = workers.back().get();
+        assign_sampler_streams(worker, streams, stream_id);
+        assign_sampler_streams(worker->observation_model(), streams,
+                               stream_id);
+        for (int s = 0; s < worker->number_of_state_models(); ++s) {
+          assign_sampler_streams(worker->state_model(s), streams, stream_id);
+        }
         futures.emplace_back(pool.submit(WorkWrapper(
             workers[i],
             niter,
@@ -195,6 +195,7 @@ namespace BOOM {
     // in an actual data analysis.
     void permanently_set_state(const Matrix &state);
     void observe_fixed_state();
+    bool state_is_fixed() const { return state_is_fixed_; }
 
     // Parameters of initial state distribution, specified in the state models
     // given to add_state.  The initial state refers to the state at time 0
@@ -654,6 +655,11 @@ namespace BOOM {
     // Durbin and Koopman's Z[t].transpose() built from state models.
     virtual SparseVector observation_matrix(int t) const;
 
+    // Returns true if Z[t], T[t], and RQR[t] do not depend on t, which is
+    // the case if each state model is time invariant.  The observation
+    // variance is allowed to vary.
+    virtual bool is_time_invariant() const;
+
     //----------------- Access to data -----------------
     // Returns y[t], after adjusting for regression effects that are not
     // included in the state vector.  This is the value that the time series
@@ -705,6 +711,27 @@ namespace BOOM {
     ScalarKalmanFilter &get_simulation_filter() override;
     const ScalarKalmanFilter &get_simulation_filter() const override;
 
+    //------------- Support for batched state imputation ----------------
+    // BatchedScalarKalmanFilter imputes the state of many models at once using
+    // the Durbin and Koopman (2002) simulation smoother: simulate the state
+    // and a fake data set, then add the smoothed state mean of the difference
+    // between the real and fake data (computed under a zero initial state
+    // mean) to the simulated state.  The first and last steps are carried out
+    // by the two functions below.  The smoothing step is done by the batched
+    // filter.
+    //
+    // Simulates the state and a fake data set from the model, storing the
+    // simulated state in the state matrix.  Returns the difference between the
+    // adjusted observations and the fake data.  Elements corresponding to
+    // missing observations are zero.
+    Vector simulate_state_and_data_residuals(RNG &rng);
+
+    // Adds 'smoothed_state_mean' (with state_dimension() rows and
+    // time_dimension() columns) to the simulated state, and updates the
+    // complete data sufficient statistics for the state and observation
+    // models.
+    void add_smoothed_state_mean(const Matrix &smoothed_state_mean);
+
    protected:
 
     StateSpaceUtils::StateModelVector<StateModel> &
@@ -0,0 +1,155 @@
+#include "gtest/gtest.h"
+#include "Models/StateSpace/StateSpaceForecaster.hpp"
+#include "Models/StateSpace/StateSpaceModel.hpp"
+#include "Models/StateSpace/PosteriorSamplers/StateSpacePosteriorSampler.hpp"
+#include "Models/StateSpace/StateModels/LocalLevelStateModel.hpp"
+#include "Models/StateSpace/StateModels/SeasonalStateModel.hpp"
+#include "Models/ZeroMeanGaussianModel.hpp"
+#include "Models/PosteriorSamplers/ZeroMeanGaussianConjSampler.hpp"
+#include "distributions.hpp"
+#include "stats/moments.hpp"
+
+#include "test_utils/test_utils.hpp"
+
+namespace {
+  using namespace BOOM;
+  using std::endl;
+
+  class StateSpaceForecasterTest : public ::testing::Test {
+   protected:
+    StateSpaceForecasterTest()
+        : niter_(40),
+          horizon_(8)
+    {
+      GlobalRng::rng.seed(8675309);
+    }
+
+    // Simulate a local level + seasonal time series, fit a model to it, and
+    // store the MCMC draws.
+    void SetUp() override {
+      int time_dimension = 100;
+      int nseasons = 4;
+      Vector seasonal_pattern = {2.0, -1.0, 0.5, -1.5};
+      Vector y(time_dimension);
+      double level = 10;
+      for (int t = 0; t < time_dimension; ++t) {
+        level += rnorm(0, .2);
+        y[t] = level + seasonal_pattern[t % nseasons] + rnorm(0, .5);
+      }
+
+      NEW(LocalLevelStateModel, trend)(1.0);
+      trend->set_initial_state_mean(y[0]);
+      trend->set_initial_state_variance(1.0);
+      NEW(ZeroMeanGaussianConjSampler, trend_sampler)(trend.get(), 1, .2);
+      trend->set_method(trend_sampler);
+
+      NEW(SeasonalStateModel, seasonal)(nseasons);
+      seasonal->set_initial_state_mean(Vector(nseasons - 1, 0.0));
+      seasonal->set_initial_state_variance(SpdMatrix(nseasons - 1, 4.0));
+      NEW(ZeroMeanGaussianConjSampler, seasonal_sampler)(
+          seasonal.get(), 1, .1);
+      seasonal->set_method(seasonal_sampler);
+
+      model_.reset(new StateSpaceModel(y));
+      model_->add_state(trend);
+      model_->add_state(seasonal);
+      NEW(ZeroMeanGaussianConjSampler, observation_model_sampler)(
+          model_->observation_model(), 1, .5);
+      model_->observation_model()->set_method(observation_model_sampler);
+      NEW(StateSpacePosteriorSampler, sampler)(model_.get());
+      model_->set_method(sampler);
+
+      for (int i = 0; i < niter_; ++i) {
+        model_->sample_posterior();
+        Vector params = model_->vectorize_params(true);
+        Vector state = model_->final_state();
+        if (i == 0) {
+          parameter_draws_.resize(niter_, params.size());
+          final_states_.resize(niter_, state.size());
+        }
+        parameter_draws_.row(i) = params;
+        final_states_.row(i) = state;
+      }
+      last_level_ = level;
+    }
+
+    int niter_;
+    int horizon_;
+    double last_level_;
+    Ptr<StateSpaceModel> model_;
+    Matrix parameter_draws_;
+    Matrix final_states_;
+  };
+
+  // The forecasts should depend on the seed, but not on the number of threads,
+  // and the model passed to the forecaster should not be changed.
+  TEST_F(StateSpaceForecasterTest, ThreadCountDoesNotMatter) {
+    Vector original_params = model_->vectorize_params(true);
+    StateSpaceForecaster forecaster(model_);
+
+    RNG rng1(12345);
+    Matrix sequential = forecaster.forecast(
+        parameter_draws_, final_states_, horizon_, rng1);
+    EXPECT_EQ(sequential.nrow(), niter_);
+    EXPECT_EQ(sequential.ncol(), horizon_);
+
+    forecaster.set_number_of_threads(3);
+    RNG rng3(12345);
+    Matrix threaded = forecaster.forecast(
+        parameter_draws_, final_states_, horizon_, rng3);
+    EXPECT_TRUE(MatrixEquals(sequential, threaded));
+    EXPECT_TRUE(VectorEquals(original_params, model_->vectorize_params(true)));
+
+    RNG other_seed(54321);
+    Matrix other = forecaster.forecast(
+        parameter_draws_, final_states_, horizon_, other_seed);
+    EXPECT_FALSE(MatrixEquals(sequential, other));
+
+    // The forecasts should be centered near the end of the simulated series.
+    EXPECT_NEAR(mean(sequential.col(0)), last_level_, 3.0);
+  }
+
+  // Each draw should be the forecast that the model would produce with the
+  // stored parameters and final state, using the draw's own RNG stream.
+  TEST_F(StateSpaceForecasterTest, MatchesSerialForecast) {
+    StateSpaceForecaster forecaster(model_);
+    forecaster.set_number_of_threads(2);
+    RNG seeding_rng(999);
+    Matrix forecast = forecaster.forecast(
+        parameter_draws_, final_states_, horizon_, seeding_rng);
+
+    RNG key_rng(999);
+    RNG draw_rng(key_rng.random_bits(), RNG::PHILOX);
+    Ptr<StateSpaceModel> reference = model_->clone();
+    for (int s = 0; s < reference->number_of_state_models(); ++s) {
+      reference->state_model(s)->observe_time_dimension(
+          reference->time_dimension() + horizon_);
+    }
+    for (int i = 0; i < niter_; ++i) {
+      draw_rng.jump(i);
+      reference->unvectorize_params(parameter_draws_.row(i), true);
+      Vector draw = reference->simulate_forecast(
+          draw_rng, horizon_, final_states_.row(i));
+      EXPECT_TRUE(VectorEquals(draw, forecast.row(i)))
+          << "draw " << i << endl
+          << draw << endl
+          << forecast.row(i);
+    }
+  }
+
+  TEST_F(StateSpaceForecasterTest, Refilter) {
+    StateSpaceForecaster forecaster(model_);
+    forecaster.set_refilter(true);
+    RNG rng1(12345);
+    Matrix sequential = forecaster.forecast(
+        parameter_draws_, Matrix(), horizon_, rng1);
+
+    forecaster.set_number_of_threads(4);
+    RNG rng4(12345);
+    Matrix threaded = forecaster.forecast(
+        parameter_draws_, Matrix(), horizon_, rng4);
+    EXPECT_TRUE(MatrixEquals(sequential, threaded));
+    EXPECT_NEAR(mean(sequential.col(0)), last_level_, 3.0);
+  }
+
+}  // namespace
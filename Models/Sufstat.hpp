@@ -22,6 +22,7 @@
 #include <string>
 
 #include "LinAlg/Vector.hpp"
+#include "LinAlg/VectorView.hpp"
 #include "Models/DataTypes.hpp"
 #include "cpputil/Ptr.hpp"
 #include "cpputil/report_error.hpp"
@@ -83,6 +84,38 @@ namespace BOOM {
     void update(const Data &d) override {
       Update(dynamic_cast<const DataType &>(d));
     }
+
+    // Sufficient statistics that can remove the contribution of a data point
+    // previously passed to Update() override Remove(), and return true from
+    // can_remove().  This lets data policies update the sufficient statistics
+    // incrementally when only a few observations change.
+    virtual bool can_remove() const { return false; }
+    virtual void Remove(const DataType &) {
+      report_error("These sufficient statistics do not support removing "
+                   "data.");
+    }
+
+    // Sufficient statistics that support Remove() also describe the values
+    // Remove() reads from a data point, so that a data policy can store those
+    // values in a flat array instead of keeping a copy of each data point.
+    //
+    // removal_size(d) is the number of values stored for d.
+    // store_removal_values(d, dest) writes them to dest, which has
+    // removal_size(d) elements.  remove_stored_values(values) removes the
+    // contribution of the data point whose stored values are 'values'.
+    virtual int removal_size(const DataType &) const {
+      report_error("These sufficient statistics do not support removing "
+                   "data.");
+      return 0;
+    }
+    virtual void store_removal_values(const DataType &, VectorView) const {
+      report_error("These sufficient statistics do not support removing "
+                   "data.");
+    }
+    virtual void remove_stored_values(const ConstVectorView &) {
+      report_error("These sufficient statistics do not support removing "
+                   "data.");
+    }
   };
 
   //==================================================================
@@ -0,0 +1,95 @@
+#include "gtest/gtest.h"
+#include "Models/GaussianModel.hpp"
+#include "Models/ParamDrawStore.hpp"
+#include "Models/SpdParams.hpp"
+#include "distributions.hpp"
+#include "test_utils/test_utils.hpp"
+
+#include <cstdio>
+
+namespace {
+  using namespace BOOM;
+  using std::endl;
+
+  class ParamDrawStoreTest : public ::testing::Test {
+   protected:
+    ParamDrawStoreTest()
+        : filename_("param_draw_store_test.bin"),
+          scalar_(new UnivParams(0.0)),
+          matrix_(new MatrixParams(2, 3)),
+          variance_(new SpdParams(3)) {
+      GlobalRng::rng.seed(8675309);
+      parameters_ = {scalar_, matrix_, variance_};
+      names_ = {"scalar", "matrix", "variance"};
+    }
+
+    ~ParamDrawStoreTest() { std::remove(filename_.c_str()); }
+
+    // Set the parameters to random values, and record them.
+    void write_draws(int number_of_draws, bool append) {
+      ParamDrawStoreWriter writer(filename_, parameters_, names_, 4, append);
+      for (int i = 0; i < number_of_draws; ++i) {
+        scalar_->set(rnorm());
+        Matrix matrix(2, 3);
+        matrix.randomize_gaussian();
+        matrix_->set(matrix);
+        SpdMatrix variance(3);
+        variance.randomize();
+        variance_->set_var(variance);
+        writer.write();
+      }
+      EXPECT_EQ(number_of_draws, writer.number_of_draws());
+    }
+
+    std::string filename_;
+    Ptr<UnivParams> scalar_;
+    Ptr<MatrixParams> matrix_;
+    Ptr<SpdParams> variance_;
+    std::vector<Ptr<Params>> parameters_;
+    std::vector<std::string> names_;
+  };
+
+  // Matrix valued parameters are recorded with their shape, so they can be
+  // rebuilt from the file, and the last draw can be used for a restart.
+  TEST_F(ParamDrawStoreTest, MatricesAndRestore) {
+    write_draws(10, false);
+    Matrix last_matrix = matrix_->value();
+    SpdMatrix last_variance = variance_->var();
+    double last_scalar = scalar_->value();
+    write_draws(5, true);
+
+    DrawStoreReader reader(filename_);
+    EXPECT_EQ(15, reader.number_of_draws());
+    EXPECT_EQ(std::vector<int>({1}), reader.parameter_dims(0));
+    EXPECT_EQ(std::vector<int>({2, 3}), reader.parameter_dims(1));
+    EXPECT_EQ(std::vector<int>({3, 3}), reader.parameter_dims(2));
+    EXPECT_TRUE(MatrixEquals(reader.matrix_draw(1, 14), matrix_->value()));
+    EXPECT_TRUE(MatrixEquals(reader.matrix_draw(2, 14), variance_->var()));
+
+    restore_from_draw_store(reader, parameters_, 9);
+    EXPECT_DOUBLE_EQ(last_scalar, scalar_->value());
+    EXPECT_TRUE(MatrixEquals(last_matrix, matrix_->value()));
+    EXPECT_TRUE(MatrixEquals(last_variance, variance_->var()));
+
+    std::vector<Ptr<Params>> wrong_shape = {
+        scalar_, new MatrixParams(3, 2), variance_};
+    EXPECT_THROW(restore_from_draw_store(reader, wrong_shape, 9),
+                 std::exception);
+  }
+
+  TEST_F(ParamDrawStoreTest, ModelParameters) {
+    NEW(GaussianModel, model)(1.0, 2.0);
+    {
+      ParamDrawStoreWriter writer(filename_, model, 10);
+      writer.write();
+      model->set_mu(3.0);
+      writer.write();
+    }
+    DrawStoreReader reader(filename_);
+    EXPECT_EQ(2, reader.number_of_draws());
+    EXPECT_EQ("parameter_0", reader.parameter_name(0));
+    EXPECT_DOUBLE_EQ(1.0, reader.draw(0, 0)[0]);
+    EXPECT_DOUBLE_EQ(3.0, reader.draw(0, 1)[0]);
+  }
+
+}  // namespace
@@ -0,0 +1,478 @@
+/*
+  Copyright (C) 2019 Steven L. Scott
+
+  This library is free software; you can redistribute it and/or modify it under
+  the terms of the GNU Lesser General Public License as published by the Free
+  Software Foundation; either version 2.1 of the License, or (at your option)
+  any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT
+  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+  FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+  details.
+
+  You should have received a copy of the GNU Lesser General Public License along
+  with this library; if not, write to the Free Software Foundation, Inc., 51
+  Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+*/
+
+#include "Samplers/HamiltonianMonteCarlo.hpp"
+#include <cmath>
+#include "LinAlg/Cholesky.hpp"
+#include "cpputil/lse.hpp"
+#include "cpputil/math_utils.hpp"
+#include "cpputil/report_error.hpp"
+#include "distributions.hpp"
+
+namespace BOOM {
+
+  namespace {
+    // Tuning constants for dual averaging, from Hoffman and Gelman (2014).
+    const double kDualAveragingGamma = 0.05;
+    const double kDualAveragingT0 = 10;
+    const double kDualAveragingKappa = 0.75;
+
+    // A trajectory is declared divergent if the Hamiltonian grows by more than
+    // this amount.
+    const double kMaxEnergyError = 1000;
+  }  // namespace
+
+  HamiltonianMonteCarlo::HamiltonianMonteCarlo(
+      const Ptr<dTargetFun> &log_density, double step_size, RNG *rng)
+      : Sampler(rng),
+        log_density_(log_density),
+        nuts_(true),
+        max_tree_depth_(10),
+        number_of_leapfrog_steps_(10),
+        step_size_(step_size),
+        dense_(false),
+        target_acceptance_rate_(0.8),
+        dual_averaging_mu_(0),
+        dual_averaging_h_bar_(0),
+        log_step_size_bar_(0),
+        dual_averaging_count_(0),
+        mass_matrix_adaptation_(NO_MASS_MATRIX_ADAPTATION),
+        adaptation_draws_remaining_(0),
+        adaptation_draw_count_(0),
+        initial_buffer_(0),
+        terminal_buffer_(0),
+        window_size_(0),
+        window_end_(0),
+        window_count_(0),
+        step_size_initialized_(false),
+        sum_acceptance_probability_(0),
+        last_acceptance_statistic_(0),
+        last_number_of_leapfrog_steps_(0),
+        last_draw_diverged_(false),
+        number_of_divergences_(0) {
+    if (!log_density_) {
+      report_error("HamiltonianMonteCarlo needs a log density.");
+    }
+    set_step_size(step_size);
+  }
+
+  Vector HamiltonianMonteCarlo::draw(const Vector &old) {
+    // The log density and gradient at 'old' are always recomputed.  In a
+    // Gibbs sampler the other parameters of the model may have changed since
+    // the last draw, so values saved from the last draw can be stale.
+    PhasePoint current;
+    current.position = old;
+    evaluate(current);
+    if (!std::isfinite(current.log_density)) {
+      report_error("HamiltonianMonteCarlo was started from a point with "
+                   "zero density.");
+    }
+
+    if (dense_) {
+      if (inverse_mass_.nrow() != old.size()) {
+        report_error("The mass matrix is the wrong size.");
+      }
+    } else if (inverse_mass_diagonal_.size() != old.size()) {
+      inverse_mass_diagonal_ = Vector(old.size(), 1.0);
+    }
+
+    if (adapting() && !step_size_initialized_) {
+      find_reasonable_step_size(current);
+      start_dual_averaging();
+      step_size_initialized_ = true;
+    }
+
+    current.momentum = sample_momentum();
+    if (nuts_) {
+      nuts_transition(current);
+    } else {
+      fixed_length_transition(current);
+    }
+    if (last_draw_diverged_) {
+      ++number_of_divergences_;
+    }
+
+    if (adapting()) {
+      adapt(current.position, last_acceptance_statistic_);
+    }
+    return current.position;
+  }
+
+  void HamiltonianMonteCarlo::set_number_of_leapfrog_steps(
+      int number_of_steps) {
+    if (number_of_steps < 1) {
+      report_error("The number of leapfrog steps must be positive.");
+    }
+    number_of_leapfrog_steps_ = number_of_steps;
+    nuts_ = false;
+  }
+
+  void HamiltonianMonteCarlo::use_nuts(int max_tree_depth) {
+    if (max_tree_depth < 1) {
+      report_error("The maximum tree depth must be positive.");
+    }
+    max_tree_depth_ = max_tree_depth;
+    nuts_ = true;
+  }
+
+  void HamiltonianMonteCarlo::set_adaptation(
+      int number_of_adaptation_draws, double target_acceptance_rate,
+      MassMatrixAdaptation mass_matrix_adaptation) {
+    if (number_of_adaptation_draws < 0) {
+      report_error("The number of adaptation draws must be non-negative.");
+    }
+    if (target_acceptance_rate <= 0 || target_acceptance_rate >= 1) {
+      report_error("The target acceptance rate must be in (0, 1).");
+    }
+    int n = number_of_adaptation_draws;
+    adaptation_draws_remaining_ = n;
+    adaptation_draw_count_ = 0;
+    target_acceptance_rate_ = target_acceptance_rate;
+    step_size_initialized_ = false;
+
+    // Too few draws to estimate a variance.
+    mass_matrix_adaptation_ = n < 20 ? NO_MASS_MATRIX_ADAPTATION
+                                     : mass_matrix_adaptation;
+
+    // The default window schedule follows Stan: a 75 draw initial buffer, a
+    // 50 draw terminal buffer, and windows that start at 25 draws and double
+    // in size.  Short warm-up periods are divided proportionally.
+    initial_buffer_ = 75;
+    terminal_buffer_ = 50;
+    window_size_ = 25;
+    if (initial_buffer_ + terminal_buffer_ + window_size_ > n) {
+      initial_buffer_ = lround(0.15 * n);
+      terminal_buffer_ = lround(0.1 * n);
+      window_size_ = n - initial_buffer_ - terminal_buffer_;
+    }
+    window_end_ = initial_buffer_ + window_size_;
+    if (window_end_ + 2 * window_size_ > n - terminal_buffer_) {
+      window_end_ = n - terminal_buffer_;
+    }
+    window_count_ = 0;
+    window_sum_.clear();
+    window_sumsq_ = SpdMatrix();
+
+    if (mass_matrix_adaptation_ == DENSE_MASS_MATRIX && !dense_ &&
+        inverse_mass_diagonal_.size() > 0) {
+      set_inverse_mass_matrix(SpdMatrix(inverse_mass_diagonal_.size(), 1.0));
+    } else if (mass_matrix_adaptation_ == DIAGONAL_MASS_MATRIX && dense_) {
+      set_inverse_mass_matrix(Vector(inverse_mass_.diag()));
+    }
+  }
+
+  void HamiltonianMonteCarlo::set_step_size(double step_size) {
+    if (!(step_size > 0) || !std::isfinite(step_size)) {
+      report_error("The step size must be positive and finite.");
+    }
+    step_size_ = step_size;
+  }
+
+  void HamiltonianMonteCarlo::set_inverse_mass_matrix(const Vector &diagonal) {
+    for (double d : diagonal) {
+      if (!(d > 0)) {
+        report_error("The inverse mass matrix must be positive definite.");
+      }
+    }
+    dense_ = false;
+    inverse_mass_diagonal_ = diagonal;
+    inverse_mass_ = SpdMatrix();
+    inverse_mass_cholesky_ = Matrix();
+  }
+
+  void HamiltonianMonteCarlo::set_inverse_mass_matrix(
+      const SpdMatrix &inverse_mass_matrix) {
+    Cholesky cholesky(inverse_mass_matrix);
+    if (!cholesky.is_pos_def()) {
+      report_error("The inverse mass matrix must be positive definite.");
+    }
+    dense_ = true;
+    inverse_mass_ = inverse_mass_matrix;
+    inverse_mass_cholesky_ = cholesky.getL(false);
+    inverse_mass_diagonal_.clear();
+  }
+
+  Vector HamiltonianMonteCarlo::inverse_mass_diagonal() const {
+    return dense_ ? Vector(inverse_mass_.diag()) : inverse_mass_diagonal_;
+  }
+
+  //===========================================================================
+  void HamiltonianMonteCarlo::evaluate(PhasePoint &point) const {
+    point.gradient.resize(point.position.size());
+    point.gradient = 0.0;
+    point.log_density = (*log_density_)(point.position, point.gradient);
+  }
+
+  void HamiltonianMonteCarlo::leapfrog(PhasePoint &point,
+                                       double epsilon) const {
+    point.momentum.axpy(point.gradient, 0.5 * epsilon);
+    point.position.axpy(velocity(point.momentum), epsilon);
+    evaluate(point);
+    point.momentum.axpy(point.gradient, 0.5 * epsilon);
+  }
+
+  double HamiltonianMonteCarlo::kinetic_energy(const Vector &momentum) const {
+    return 0.5 * momentum.dot(velocity(momentum));
+  }
+
+  Vector HamiltonianMonteCarlo::velocity(const Vector &momentum) const {
+    if (dense_) {
+      return inverse_mass_ * momentum;
+    }
+    return inverse_mass_diagonal_ * momentum;
+  }
+
+  // If M^{-1} = LL' then L^{-T} z has variance (LL')^{-1} = M.
+  Vector HamiltonianMonteCarlo::sample_momentum() const {
+    int dim = dense_ ? inverse_mass_.nrow() : inverse_mass_diagonal_.size();
+    Vector ans(dim);
+    rnorm_mt(rng(), ans);
+    if (dense_) {
+      LTsolve_inplace(inverse_mass_cholesky_, ans);
+    } else {
+      for (int i = 0; i < dim; ++i) {
+        ans[i] /= sqrt(inverse_mass_diagonal_[i]);
+      }
+    }
+    return ans;
+  }
+
+  //===========================================================================
+  void HamiltonianMonteCarlo::fixed_length_transition(PhasePoint &current) {
+    double initial_hamiltonian = hamiltonian(current);
+    PhasePoint proposal = current;
+    for (int i = 0; i < number_of_leapfrog_steps_; ++i) {
+      leapfrog(proposal, step_size_);
+    }
+    double log_acceptance_ratio =
+        initial_hamiltonian - hamiltonian(proposal);
+    if (!std::isfinite(log_acceptance_ratio)) {
+      log_acceptance_ratio = negative_infinity();
+    }
+    last_number_of_leapfrog_steps_ = number_of_leapfrog_steps_;
+    last_draw_diverged_ = log_acceptance_ratio < -kMaxEnergyError;
+    last_acceptance_statistic_ = std::min<double>(
+        1.0, exp(log_acceptance_ratio));
+    if (log(runif_mt(rng())) < log_acceptance_ratio) {
+      current = proposal;
+    }
+  }
+
+  //---------------------------------------------------------------------------
+  // The trajectory is grown by repeatedly doubling in a random direction.  The
+  // state returned is chosen by "biased progressive sampling" (Betancourt
+  // 2017): after each doubling the proposal moves to a state in the new
+  // subtree with probability min(1, weight(new) / weight(old)), which favors
+  // states far from the starting point.
+  void HamiltonianMonteCarlo::nuts_transition(PhasePoint &current) {
+    double initial_hamiltonian = hamiltonian(current);
+    PhasePoint forward = current;
+    PhasePoint backward = current;
+    PhasePoint proposal = current;
+    Vector rho = current.momentum;
+    Vector velocity_forward = velocity(current.momentum);
+    Vector velocity_backward = velocity_forward;
+    double log_sum_weight = 0;
+
+    sum_acceptance_probability_ = 0;
+    last_number_of_leapfrog_steps_ = 0;
+    last_draw_diverged_ = false;
+
+    for (int depth = 0; depth < max_tree_depth_; ++depth) {
+      int direction = runif_mt(rng()) < 0.5 ? -1 : 1;
+      Subtree tree;
+      bool valid = build_tree(depth, direction > 0 ? forward : backward,
+                              direction, initial_hamiltonian, tree);
+      if (!valid) break;
+
+      if (log(runif_mt(rng())) < tree.log_sum_weight - log_sum_weight) {
+        proposal = tree.proposal;
+      }
+      log_sum_weight = lse2(log_sum_weight, tree.log_sum_weight);
+      rho += tree.rho;
+      if (direction > 0) {
+        velocity_forward = tree.velocity_end;
+      } else {
+        velocity_backward = tree.velocity_end;
+      }
+      if (!no_u_turn(velocity_backward, velocity_forward, rho)) break;
+    }
+
+    current = proposal;
+    last_acceptance_statistic_ =
+        last_number_of_leapfrog_steps_ > 0
+            ? sum_acceptance_probability_ / last_number_of_leapfrog_steps_
+            : 0.0;
+  }
+
+  //---------------------------------------------------------------------------
+  bool HamiltonianMonteCarlo::build_tree(int depth, PhasePoint &edge,
+                                         int direction,
+                                         double initial_hamiltonian,
+                                         Subtree &tree) {
+    if (depth == 0) {
+      leapfrog(edge, direction * step_size_);
+      ++last_number_of_leapfrog_steps_;
+      double energy_change = hamiltonian(edge) - initial_hamiltonian;
+      if (!std::isfinite(energy_change)) {
+        energy_change = infinity();
+      }
+      bool diverged = energy_change > kMaxEnergyError;
+      if (diverged) {
+        last_draw_diverged_ = true;
+      }
+      sum_acceptance_probability_ +=
+          energy_change < 0 ? 1.0 : exp(-energy_change);
+      tree.log_sum_weight = -energy_change;
+      tree.proposal = edge;
+      tree.rho = edge.momentum;
+      tree.velocity_begin = velocity(edge.momentum);
+      tree.velocity_end = tree.velocity_begin;
+      return !diverged;
+    }
+
+    Subtree first;
+    if (!build_tree(depth - 1, edge, direction, initial_hamiltonian, first)) {
+      return false;
+    }
+    Subtree second;
+    if (!build_tree(depth - 1, edge, direction, initial_hamiltonian, second)) {
+      return false;
+    }
+
+    tree.log_sum_weight = lse2(first.log_sum_weight, second.log_sum_weight);
+    if (log(runif_mt(rng())) < second.log_sum_weight - tree.log_sum_weight) {
+      tree.proposal = second.proposal;
+    } else {
+      tree.proposal = first.proposal;
+    }
+    tree.rho = first.rho + second.rho;
+    tree.velocity_begin = first.velocity_begin;
+    tree.velocity_end = second.velocity_end;
+    return no_u_turn(tree.velocity_begin, tree.velocity_end, tree.rho);
+  }
+
+  //===========================================================================
+  void HamiltonianMonteCarlo::find_reasonable_step_size(
+      const PhasePoint &point) {
+    PhasePoint start = point;
+    start.momentum = sample_momentum();
+    double initial_hamiltonian = hamiltonian(start);
+    const double log_half = log(0.5);
+
+    PhasePoint trial = start;
+    leapfrog(trial, step_size_);
+    double delta = initial_hamiltonian - hamiltonian(trial);
+    int direction = delta > log_half ? 1 : -1;
+
+    for (int i = 0; i < 100; ++i) {
+      double candidate = direction > 0 ? 2 * step_size_ : 0.5 * step_size_;
+      trial = start;
+      leapfrog(trial, candidate);
+      delta = initial_hamiltonian - hamiltonian(trial);
+      if (!std::isfinite(delta)) {
+        delta = negative_infinity();
+      }
+      if (direction > 0 && !(delta > log_half)) break;
+      step_size_ = candidate;
+      if (direction < 0 && delta > log_half) break;
+    }
+  }
+
+  void HamiltonianMonteCarlo::start_dual_averaging() {
+    dual_averaging_mu_ = log(10 * step_size_);
+    dual_averaging_h_bar_ = 0;
+    log_step_size_bar_ = 0;
+    dual_averaging_count_ = 0;
+  }
+
+  void HamiltonianMonteCarlo::update_dual_averaging(
+      double acceptance_statistic) {
+    ++dual_averaging_count_;
+    double count = dual_averaging_count_;
+    double eta = 1.0 / (count + kDualAveragingT0);
+    dual_averaging_h_bar_ = (1 - eta) * dual_averaging_h_bar_ +
+        eta * (target_acceptance_rate_ - acceptance_statistic);
+    double log_step_size = dual_averaging_mu_ -
+        sqrt(count) / kDualAveragingGamma * dual_averaging_h_bar_;
+    double weight = pow(count, -kDualAveragingKappa);
+    log_step_size_bar_ =
+        weight * log_step_size + (1 - weight) * log_step_size_bar_;
+    step_size_ = exp(log_step_size);
+  }
+
+  void HamiltonianMonteCarlo::adapt(const Vector &position,
+                                    double acceptance_statistic) {
+    update_dual_averaging(acceptance_statistic);
+
+    if (mass_matrix_adaptation_ != NO_MASS_MATRIX_ADAPTATION &&
+        adaptation_draw_count_ >= initial_buffer_ &&
+        adaptation_draw_count_ < window_end_) {
+      if (window_sum_.size() != position.size()) {
+        window_sum_ = Vector(position.size(), 0.0);
+        window_sumsq_ = SpdMatrix(position.size(), 0.0);
+      }
+      window_sum_ += position;
+      window_sumsq_.add_outer(position, 1.0, false);
+      ++window_count_;
+      if (adaptation_draw_count_ + 1 == window_end_) {
+        update_mass_matrix();
+        // The next window is twice as long, unless the window after it would
+        // not fit before the terminal buffer, in which case the next window
+        // absorbs the remainder.
+        int last = adaptation_draw_count_ + adaptation_draws_remaining_ -
+            terminal_buffer_;
+        window_size_ *= 2;
+        window_end_ += window_size_;
+        if (window_end_ + 2 * window_size_ > last) {
+          window_end_ = last;
+        }
+      }
+    }
+
+    ++adaptation_draw_count_;
+    if (--adaptation_draws_remaining_ == 0) {
+      step_size_ = exp(log_step_size_bar_);
+    }
+  }
+
+  // The variance estimate is shrunk towards a small multiple of the identity,
+  // as in Stan, to keep it well conditioned when the window is short.
+  void HamiltonianMonteCarlo::update_mass_matrix() {
+    double n = window_count_;
+    if (n > 2) {
+      window_sumsq_.reflect();
+      Vector mean = window_sum_ / n;
+      SpdMatrix variance = window_sumsq_;
+      variance.add_outer(mean, -n);
+      variance /= n - 1;
+      variance *= n / (n + 5.0);
+      variance.diag() += 1e-3 * 5.0 / (n + 5.0);
+      if (mass_matrix_adaptation_ == DENSE_MASS_MATRIX) {
+        set_inverse_mass_matrix(variance);
+      } else {
+        set_inverse_mass_matrix(Vector(variance.diag()));
+      }
+    }
+    window_count_ = 0;
+    window_sum_ = 0.0;
+    window_sumsq_ = 0.0;
+    start_dual_averaging();
+  }
+
+}  // namespace BOOM
@@ -0,0 +1,250 @@
+#ifndef BOOM_SAMPLERS_HAMILTONIAN_MONTE_CARLO_HPP_
+#define BOOM_SAMPLERS_HAMILTONIAN_MONTE_CARLO_HPP_
+
+/*
+  Copyright (C) 2019 Steven L. Scott
+
+  This library is free software; you can redistribute it and/or modify it under
+  the terms of the GNU Lesser General Public License as published by the Free
+  Software Foundation; either version 2.1 of the License, or (at your option)
+  any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT
+  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+  FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+  details.
+
+  You should have received a copy of the GNU Lesser General Public License along
+  with this library; if not, write to the Free Software Foundation, Inc., 51
+  Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+*/
+
+#include "LinAlg/Matrix.hpp"
+#include "LinAlg/SpdMatrix.hpp"
+#include "LinAlg/Vector.hpp"
+#include "Samplers/Sampler.hpp"
+#include "TargetFun/TargetFun.hpp"
+#include "cpputil/Ptr.hpp"
+
+namespace BOOM {
+
+  // Hamiltonian Monte Carlo (Neal 2011) for a differentiable log density.
+  //
+  // The log density plays the role of (negative) potential energy.  Each draw
+  // samples a momentum vector r ~ N(0, M) and follows the dynamics of the
+  // Hamiltonian H(x, r) = -log p(x) + r' M^{-1} r / 2 using the leapfrog
+  // integrator.  The "mass matrix" M should approximate the posterior
+  // precision, so that the dynamics move equally quickly in all directions.
+  //
+  // Two trajectory lengths are supported.  By default the sampler uses the
+  // No-U-Turn sampler (NUTS) of Hoffman and Gelman (2014), which extends the
+  // trajectory in both directions until it starts to double back on itself,
+  // and chooses the next state by multinomial sampling along the trajectory.
+  // Alternatively, a fixed number of leapfrog steps can be followed by a
+  // Metropolis accept/reject step.
+  //
+  // The step size and mass matrix can be adapted during an initial set of
+  // "warm-up" draws, which should be discarded.  The step size is tuned by the
+  // dual averaging algorithm of Hoffman and Gelman to hit a target average
+  // acceptance probability.  The (inverse) mass matrix is set to a regularized
+  // estimate of the variance of the draws in a sequence of expanding windows.
+  // Once adaptation ends the sampler is a valid MCMC transition.
+  //
+  // The target must be defined on all of R^n.  Parameters with constrained
+  // support should be transformed before they are sampled.
+  class HamiltonianMonteCarlo : public Sampler {
+   public:
+    enum MassMatrixAdaptation {
+      NO_MASS_MATRIX_ADAPTATION,
+      DIAGONAL_MASS_MATRIX,
+      DENSE_MASS_MATRIX
+    };
+
+    // Args:
+    //   log_density: The log of the target density (up to an additive
+    //     constant), and its gradient.  A d2TargetFun may be supplied, but only
+    //     first derivatives are used.
+    //   step_size:  The initial leapfrog step size.
+    //   rng: The random number generator used by the sampler.  If nullptr then
+    //     GlobalRng::rng is used.
+    explicit HamiltonianMonteCarlo(const Ptr<dTargetFun> &log_density,
+                                   double step_size = 0.1,
+                                   RNG *rng = nullptr);
+
+    Vector draw(const Vector &old) override;
+
+    // Follow a trajectory of exactly 'number_of_steps' leapfrog steps, then
+    // accept or reject its end point.
+    void set_number_of_leapfrog_steps(int number_of_steps);
+
+    // Use the No-U-Turn sampler (the default).
+    // Args:
+    //   max_tree_depth: The trajectory contains at most 2^max_tree_depth
+    //     leapfrog steps.
+    void use_nuts(int max_tree_depth = 10);
+    bool using_nuts() const { return nuts_; }
+
+    // Adapt the step size (and possibly the mass matrix) during the next
+    // 'number_of_adaptation_draws' calls to draw().
+    //
+    // Args:
+    //   number_of_adaptation_draws: The number of warm-up draws.
+    //   target_acceptance_rate: The step size is adjusted so that the average
+    //     acceptance probability approaches this value.
+    //   mass_matrix_adaptation:  Whether, and how, to adapt the mass matrix.
+    void set_adaptation(
+        int number_of_adaptation_draws,
+        double target_acceptance_rate = 0.8,
+        MassMatrixAdaptation mass_matrix_adaptation = DIAGONAL_MASS_MATRIX);
+    bool adapting() const { return adaptation_draws_remaining_ > 0; }
+
+    double step_size() const { return step_size_; }
+    void set_step_size(double step_size);
+
+    // Set the inverse of the mass matrix, which should approximate the
+    // posterior variance of the target.
+    void set_inverse_mass_matrix(const Vector &diagonal);
+    void set_inverse_mass_matrix(const SpdMatrix &inverse_mass_matrix);
+    bool dense_mass_matrix() const { return dense_; }
+
+    // The diagonal of the inverse mass matrix.
+    Vector inverse_mass_diagonal() const;
+
+    //------------ Diagnostics from the most recent draw.
+
+    // For fixed-length trajectories, the Metropolis acceptance probability.
+    // For NUTS, the average of the acceptance probabilities of the states on
+    // the trajectory.
+    double last_acceptance_statistic() const {
+      return last_acceptance_statistic_;
+    }
+
+    int last_number_of_leapfrog_steps() const {
+      return last_number_of_leapfrog_steps_;
+    }
+
+    // A divergence indicates the leapfrog integrator has become unstable,
+    // usually because the step size is too big for a region of high curvature.
+    bool last_draw_diverged() const { return last_draw_diverged_; }
+    int number_of_divergences() const { return number_of_divergences_; }
+
+   private:
+    // A point in phase space, along with the log density and gradient at its
+    // position.
+    struct PhasePoint {
+      Vector position;
+      Vector momentum;
+      Vector gradient;
+      double log_density;
+    };
+
+    // A summary of a subtree in the NUTS trajectory.
+    struct Subtree {
+      // The sum of the momenta of all states in the subtree.
+      Vector rho;
+      // M^{-1} times the momentum at the first and last states in the subtree,
+      // in the order they were visited.
+      Vector velocity_begin;
+      Vector velocity_end;
+      // The log of the sum of the multinomial weights of the states in the
+      // subtree, relative to the weight of the initial state.
+      double log_sum_weight;
+      // The state selected from the subtree.
+      PhasePoint proposal;
+    };
+
+    // Set log_density and gradient for the position in 'point'.
+    void evaluate(PhasePoint &point) const;
+
+    // One leapfrog step of size 'epsilon' (which may be negative).
+    void leapfrog(PhasePoint &point, double epsilon) const;
+
+    double kinetic_energy(const Vector &momentum) const;
+    double hamiltonian(const PhasePoint &point) const {
+      return kinetic_energy(point.momentum) - point.log_density;
+    }
+
+    // M^{-1} * momentum.
+    Vector velocity(const Vector &momentum) const;
+    Vector sample_momentum() const;
+
+    // Take one transition from 'current', overwriting it with the next state.
+    void nuts_transition(PhasePoint &current);
+    void fixed_length_transition(PhasePoint &current);
+
+    // Recursively build a subtree of 2^depth leapfrog steps, starting from
+    // 'edge' in the given direction.  On exit 'edge' holds the last state in
+    // the subtree.  Returns false if the subtree diverged or made a U-turn, in
+    // which case the trajectory should stop growing.
+    bool build_tree(int depth, PhasePoint &edge, int direction,
+                    double initial_hamiltonian, Subtree &tree);
+
+    // True if a trajectory with the given ends and momentum sum is still
+    // moving away from its starting point.
+    static bool no_u_turn(const Vector &velocity_begin,
+                          const Vector &velocity_end, const Vector &rho) {
+      return velocity_begin.dot(rho) > 0 && velocity_end.dot(rho) > 0;
+    }
+
+    // Heuristic from Hoffman and Gelman for finding an initial step size: the
+    // step size is halved or doubled until the acceptance probability of a
+    // single leapfrog step crosses 1/2.
+    void find_reasonable_step_size(const PhasePoint &point);
+
+    //------------ Adaptation
+    void start_dual_averaging();
+    void update_dual_averaging(double acceptance_statistic);
+    void adapt(const Vector &position, double acceptance_statistic);
+    void update_mass_matrix();
+
+    Ptr<dTargetFun> log_density_;
+
+    bool nuts_;
+    int max_tree_depth_;
+    int number_of_leapfrog_steps_;
+
+    double step_size_;
+
+    // The inverse mass matrix.  If dense_ is false then only the diagonal is
+    // used.  Otherwise inverse_mass_cholesky_ is the lower Cholesky triangle of
+    // inverse_mass_.
+    bool dense_;
+    Vector inverse_mass_diagonal_;
+    SpdMatrix inverse_mass_;
+    Matrix inverse_mass_cholesky_;
+
+    // Dual averaging state.
+    double target_acceptance_rate_;
+    double dual_averaging_mu_;
+    double dual_averaging_h_bar_;
+    double log_step_size_bar_;
+    int dual_averaging_count_;
+
+    // Mass matrix adaptation proceeds in windows during which the draws are
+    // accumulated.  The windows are separated from the start and end of the
+    // warm-up period by buffers in which only the step size is adapted.
+    MassMatrixAdaptation mass_matrix_adaptation_;
+    int adaptation_draws_remaining_;
+    int adaptation_draw_count_;
+    int initial_buffer_;
+    int terminal_buffer_;
+    int window_size_;
+    int window_end_;
+    int window_count_;
+    Vector window_sum_;
+    SpdMatrix window_sumsq_;
+    bool step_size_initialized_;
+
+    // The sum of the acceptance probabilities of the states visited during
+    // the current NUTS transition.
+    double sum_acceptance_probability_;
+
+    double last_acceptance_statistic_;
+    int last_number_of_leapfrog_steps_;
+    bool last_draw_diverged_;
+    int number_of_divergences_;
+  };
+
+}  // namespace BOOM
+
+#endif  // BOOM_SAMPLERS_HAMILTONIAN_MONTE_CARLO_HPP_
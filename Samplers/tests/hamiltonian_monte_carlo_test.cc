@@ -0,0 +1,227 @@
+#include "gtest/gtest.h"
+#include "Samplers/HamiltonianMonteCarlo.hpp"
+#include "Models/Glm/PoissonRegressionModel.hpp"
+#include "Models/MvnModel.hpp"
+#include "Models/PosteriorSamplers/HamiltonianMonteCarloPosteriorSampler.hpp"
+#include "distributions.hpp"
+#include "cpputil/math_utils.hpp"
+#include "stats/moments.hpp"
+
+#include "test_utils/test_utils.hpp"
+
+namespace {
+  using namespace BOOM;
+  using std::endl;
+
+  class HamiltonianMonteCarloTest : public ::testing::Test {
+   protected:
+    HamiltonianMonteCarloTest() {
+      GlobalRng::rng.seed(8675309);
+    }
+  };
+
+  // A multivariate normal log density, with gradient.
+  class MvnLogDensity : public dTargetFun {
+   public:
+    MvnLogDensity(const Vector &mu, const SpdMatrix &Sigma)
+        : mu_(mu), siginv_(Sigma.inv()) {}
+
+    double operator()(const Vector &x) const override {
+      Vector g;
+      return (*this)(x, g);
+    }
+
+    double operator()(const Vector &x, Vector &g) const override {
+      Vector residual = x - mu_;
+      g = -(siginv_ * residual);
+      return 0.5 * residual.dot(g);
+    }
+
+   private:
+    Vector mu_;
+    SpdMatrix siginv_;
+  };
+
+  // A standard normal density truncated to x[0] < upper.  The truncation
+  // point can be changed between draws, as the other parameters of a model
+  // change between steps of a Gibbs sampler.
+  class TruncatedNormalLogDensity : public dTargetFun {
+   public:
+    explicit TruncatedNormalLogDensity(double upper) : upper_(upper) {}
+    void set_upper(double upper) { upper_ = upper; }
+
+    double operator()(const Vector &x) const override {
+      Vector g;
+      return (*this)(x, g);
+    }
+
+    double operator()(const Vector &x, Vector &g) const override {
+      g = -1 * x;
+      if (x[0] >= upper_) return negative_infinity();
+      return -0.5 * x.normsq();
+    }
+
+   private:
+    double upper_;
+  };
+
+  // A badly scaled, correlated normal target.
+  void MakeTarget(Vector &mu, SpdMatrix &Sigma) {
+    mu = Vector{3, -2, 1};
+    SpdMatrix correlation(3, 1.0);
+    correlation(0, 1) = correlation(1, 0) = .8;
+    correlation(1, 2) = correlation(2, 1) = -.5;
+    correlation(0, 2) = correlation(2, 0) = -.3;
+    Vector sd = {1.0, 10.0, 0.1};
+    Sigma = correlation;
+    for (int i = 0; i < 3; ++i) {
+      for (int j = 0; j < 3; ++j) {
+        Sigma(i, j) *= sd[i] * sd[j];
+      }
+    }
+  }
+
+  Matrix RunSampler(HamiltonianMonteCarlo &sampler, int burn, int niter,
+                    int dim) {
+    Vector x(dim, 0.0);
+    for (int i = 0; i < burn; ++i) {
+      x = sampler.draw(x);
+    }
+    EXPECT_FALSE(sampler.adapting());
+    Matrix draws(niter, dim);
+    for (int i = 0; i < niter; ++i) {
+      x = sampler.draw(x);
+      draws.row(i) = x;
+    }
+    return draws;
+  }
+
+  void CheckMoments(const Matrix &draws, const Vector &mu,
+                    const SpdMatrix &Sigma) {
+    Vector sample_mean = mean(draws);
+    SpdMatrix sample_variance = var(draws);
+    for (int i = 0; i < mu.size(); ++i) {
+      double sd = sqrt(Sigma(i, i));
+      EXPECT_NEAR(sample_mean[i], mu[i], .15 * sd)
+          << "coordinate " << i << endl << sample_mean;
+      EXPECT_NEAR(sqrt(sample_variance(i, i)), sd, .15 * sd)
+          << "coordinate " << i << endl << sample_variance;
+    }
+  }
+
+  TEST_F(HamiltonianMonteCarloTest, NutsDiagonalAdaptation) {
+    Vector mu;
+    SpdMatrix Sigma;
+    MakeTarget(mu, Sigma);
+    HamiltonianMonteCarlo sampler(new MvnLogDensity(mu, Sigma));
+    EXPECT_TRUE(sampler.using_nuts());
+    sampler.set_adaptation(1000, .8,
+                           HamiltonianMonteCarlo::DIAGONAL_MASS_MATRIX);
+    Matrix draws = RunSampler(sampler, 1000, 4000, 3);
+    CheckMoments(draws, mu, Sigma);
+    EXPECT_FALSE(sampler.dense_mass_matrix());
+
+    // The adapted inverse mass matrix should track the marginal variances.
+    Vector inverse_mass = sampler.inverse_mass_diagonal();
+    EXPECT_NEAR(inverse_mass[1] / inverse_mass[2], 10000, 5000);
+    EXPECT_LT(sampler.number_of_divergences(), 20);
+  }
+
+  TEST_F(HamiltonianMonteCarloTest, NutsDenseAdaptation) {
+    Vector mu;
+    SpdMatrix Sigma;
+    MakeTarget(mu, Sigma);
+    HamiltonianMonteCarlo sampler(new MvnLogDensity(mu, Sigma));
+    sampler.set_adaptation(1000, .8, HamiltonianMonteCarlo::DENSE_MASS_MATRIX);
+    Matrix draws = RunSampler(sampler, 1000, 3000, 3);
+    CheckMoments(draws, mu, Sigma);
+    EXPECT_TRUE(sampler.dense_mass_matrix());
+
+    // With a good dense metric the target looks like a standard normal, so
+    // only short trajectories are needed.
+    int total_steps = 0;
+    Vector x = draws.row(draws.nrow() - 1);
+    for (int i = 0; i < 100; ++i) {
+      x = sampler.draw(x);
+      total_steps += sampler.last_number_of_leapfrog_steps();
+    }
+    EXPECT_LT(total_steps / 100.0, 16);
+  }
+
+  TEST_F(HamiltonianMonteCarloTest, FixedLengthTrajectories) {
+    Vector mu;
+    SpdMatrix Sigma;
+    MakeTarget(mu, Sigma);
+    HamiltonianMonteCarlo sampler(new MvnLogDensity(mu, Sigma));
+    sampler.set_number_of_leapfrog_steps(20);
+    EXPECT_FALSE(sampler.using_nuts());
+    sampler.set_inverse_mass_matrix(Sigma);
+    sampler.set_adaptation(500, .65,
+                           HamiltonianMonteCarlo::NO_MASS_MATRIX_ADAPTATION);
+    Matrix draws = RunSampler(sampler, 500, 4000, 3);
+    CheckMoments(draws, mu, Sigma);
+    EXPECT_EQ(20, sampler.last_number_of_leapfrog_steps());
+  }
+
+  // If the target changes between two draws, the second draw must use the
+  // new target at its starting point, even though it starts where the first
+  // draw ended.
+  TEST_F(HamiltonianMonteCarloTest, TargetChangesBetweenDraws) {
+    NEW(TruncatedNormalLogDensity, target)(infinity());
+    HamiltonianMonteCarlo sampler(target, .5);
+    sampler.set_number_of_leapfrog_steps(5);
+    Vector x = sampler.draw(Vector(2, 0.0));
+    EXPECT_TRUE(x.all_finite());
+
+    // The last draw is now outside the support of the target.
+    target->set_upper(x[0] - 1.0);
+    EXPECT_THROW(sampler.draw(x), std::exception);
+
+    target->set_upper(x[0] + 1.0);
+    Vector y = sampler.draw(x);
+    EXPECT_LT(y[0], x[0] + 1.0);
+  }
+
+  TEST_F(HamiltonianMonteCarloTest, PoissonRegressionPosterior) {
+    int n = 500;
+    Vector beta = {1.0, -0.5, 0.25};
+    NEW(PoissonRegressionModel, model)(beta.size());
+    for (int i = 0; i < n; ++i) {
+      Vector x(beta.size());
+      x[0] = 1.0;
+      x[1] = rnorm();
+      x[2] = rnorm();
+      model->add_data(new PoissonRegressionData(rpois(exp(x.dot(beta))), x));
+    }
+
+    NEW(MvnModel, prior)(Vector(beta.size(), 0.0),
+                         SpdMatrix(beta.size(), 100.0));
+    NEW(HamiltonianMonteCarloPosteriorSampler, sampler)(model.get(), prior);
+    sampler->sampler().set_adaptation(300);
+    model->set_method(sampler);
+
+    int burn = 300;
+    int niter = 1000;
+    Matrix draws(niter, beta.size());
+    for (int i = 0; i < burn; ++i) {
+      model->sample_posterior();
+    }
+    for (int i = 0; i < niter; ++i) {
+      model->sample_posterior();
+      draws.row(i) = model->Beta();
+    }
+    // With a vague prior and plenty of data the posterior mean should be close
+    // to the MLE, relative to the posterior standard deviation.
+    Vector posterior_mean = mean(draws);
+    Vector posterior_sd = sqrt(var(draws).diag());
+    model->mle();
+    for (int j = 0; j < beta.size(); ++j) {
+      EXPECT_NEAR(posterior_mean[j], model->Beta()[j], .25 * posterior_sd[j])
+          << "coefficient " << j;
+      EXPECT_NEAR(posterior_mean[j], beta[j], 4 * posterior_sd[j])
+          << "coefficient " << j;
+    }
+    EXPECT_TRUE(std::isfinite(sampler->logpri()));
+  }
+
+}  // namespace
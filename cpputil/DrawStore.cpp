@@ -0,0 +1,524 @@
+/*
+  Copyright (C) 2019 Steven L. Scott
+
+  This library is free software; you can redistribute it and/or modify it under
+  the terms of the GNU Lesser General Public License as published by the Free
+  Software Foundation; either version 2.1 of the License, or (at your option)
+  any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT
+  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+  FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+  details.
+
+  You should have received a copy of the GNU Lesser General Public License along
+  with this library; if not, write to the Free Software Foundation, Inc., 51
+  Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+*/
+
+#include "cpputil/DrawStore.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "cpputil/report_error.hpp"
+
+namespace BOOM {
+
+  namespace {
+    const char kMagic[8] = {'B', 'O', 'O', 'M', 'D', 'R', 'A', 'W'};
+    const std::uint32_t kVersion = 2;
+    const std::uint32_t kByteOrderMark = 0x01020304;
+
+    // The number of full chunks that may wait for the writer thread before
+    // write() blocks.
+    const int kMaxPendingChunks = 2;
+
+    // Round n up to the next multiple of 8, so that the doubles following the
+    // header are aligned.
+    std::size_t pad8(std::size_t n) { return (n + 7) / 8 * 8; }
+
+    template <class T>
+    void append_bytes(std::vector<char> &buffer, const T &value) {
+      const char *bytes = reinterpret_cast<const char *>(&value);
+      buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+    }
+
+    template <class T>
+    T read_value(const char *data, std::size_t file_size,
+                 std::size_t &offset) {
+      if (offset + sizeof(T) > file_size) {
+        report_error("Draw store file is truncated.");
+      }
+      T ans;
+      std::memcpy(&ans, data + offset, sizeof(T));
+      offset += sizeof(T);
+      return ans;
+    }
+
+    // The number of doubles in a parameter with the given dimensions.
+    int product(const std::vector<int> &dims) {
+      int ans = 1;
+      for (int dim : dims) ans *= dim;
+      return ans;
+    }
+  }  // namespace
+
+  DrawStoreWriter::DrawStoreWriter(
+      const std::string &filename,
+      const std::vector<std::string> &parameter_names,
+      const std::vector<std::vector<int>> &parameter_dims, int chunk_size,
+      bool append)
+      : parameter_names_(parameter_names),
+        parameter_dims_(parameter_dims),
+        chunk_size_(chunk_size),
+        number_of_draws_(0),
+        file_(nullptr),
+        chunk_in_progress_(false),
+        done_(false) {
+    if (chunk_size <= 0) {
+      report_error("Chunk size must be positive in DrawStoreWriter.");
+    }
+    if (parameter_names_.size() != parameter_dims_.size()) {
+      report_error("Each parameter in a DrawStoreWriter needs a name.");
+    }
+    for (const auto &dims : parameter_dims_) {
+      if (dims.empty() || *std::min_element(dims.begin(), dims.end()) <= 0) {
+        report_error("Each parameter in a DrawStoreWriter needs at least one "
+                     "dimension, and all dimensions must be positive.");
+      }
+      parameter_sizes_.push_back(product(dims));
+    }
+
+    bool existing_file = false;
+    if (append) {
+      std::ifstream test(filename.c_str());
+      existing_file = test.good();
+    }
+    if (existing_file) {
+      check_header(filename);
+      file_ = std::fopen(filename.c_str(), "ab");
+    } else {
+      file_ = std::fopen(filename.c_str(), "wb");
+    }
+    if (!file_) {
+      report_error("Could not open draw store file " + filename);
+    }
+    // The destructor does not run if the constructor throws, so the file must
+    // be closed here if anything below fails.
+    try {
+      if (!existing_file) {
+        write_header();
+      }
+      reset_current_chunk();
+      writer_thread_ = std::thread([this]() { this->writer_loop(); });
+    } catch (...) {
+      std::fclose(file_);
+      file_ = nullptr;
+      throw;
+    }
+  }
+
+  DrawStoreWriter::~DrawStoreWriter() {
+    try {
+      flush();
+    } catch (...) {
+      // Destructors must not throw.  The error has already been reported to
+      // any caller of write() or flush().
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      done_ = true;
+    }
+    work_available_.notify_all();
+    if (writer_thread_.joinable()) {
+      writer_thread_.join();
+    }
+    if (file_) {
+      std::fclose(file_);
+    }
+  }
+
+  void DrawStoreWriter::write_header() {
+    std::vector<char> header(kMagic, kMagic + 8);
+    append_bytes(header, kVersion);
+    append_bytes(header, kByteOrderMark);
+    append_bytes(header, static_cast<std::uint32_t>(parameter_names_.size()));
+    append_bytes(header, static_cast<std::uint32_t>(0));
+    for (int i = 0; i < parameter_names_.size(); ++i) {
+      append_bytes(header,
+                   static_cast<std::uint32_t>(parameter_dims_[i].size()));
+      for (int dim : parameter_dims_[i]) {
+        append_bytes(header, static_cast<std::uint32_t>(dim));
+      }
+      append_bytes(header,
+                   static_cast<std::uint32_t>(parameter_names_[i].size()));
+      header.insert(header.end(), parameter_names_[i].begin(),
+                    parameter_names_[i].end());
+    }
+    header.resize(pad8(header.size()), 0);
+    if (std::fwrite(header.data(), 1, header.size(), file_) != header.size()) {
+      report_error("Could not write draw store header.");
+    }
+  }
+
+  // Appending to an existing file requires that the parameters match.  If the
+  // previous run ended part way through writing a chunk, the partial chunk is
+  // removed so that the new draws follow the last complete one.
+  void DrawStoreWriter::check_header(const std::string &filename) {
+    std::size_t valid_size = 0;
+    std::size_t file_size = 0;
+    {
+      DrawStoreReader existing(filename);
+      if (existing.number_of_parameters() != parameter_names_.size()) {
+        report_error("Cannot append to draw store " + filename +
+                     ": the number of parameters does not match.");
+      }
+      for (int i = 0; i < parameter_names_.size(); ++i) {
+        if (existing.parameter_name(i) != parameter_names_[i] ||
+            existing.parameter_dims(i) != parameter_dims_[i]) {
+          report_error("Cannot append to draw store " + filename +
+                       ": parameter names or dimensions do not match.");
+        }
+      }
+      valid_size = existing.valid_size();
+      file_size = existing.file_size();
+    }
+    if (file_size > valid_size) {
+#ifndef _WIN32
+      if (::truncate(filename.c_str(), valid_size) != 0) {
+        report_error("Could not remove a partial chunk from " + filename);
+      }
+#else
+      report_error("Cannot append to draw store " + filename +
+                   ": it ends with a partial chunk, which cannot be "
+                   "removed on this platform.");
+#endif
+    }
+  }
+
+  void DrawStoreWriter::reset_current_chunk() {
+    current_chunk_.number_of_iterations = 0;
+    current_chunk_.values.resize(parameter_sizes_.size());
+    for (int i = 0; i < parameter_sizes_.size(); ++i) {
+      current_chunk_.values[i].clear();
+      current_chunk_.values[i].reserve(
+          static_cast<std::size_t>(chunk_size_) * parameter_sizes_[i]);
+    }
+  }
+
+  void DrawStoreWriter::write(const std::vector<Vector> &draw) {
+    check_writer_error();
+    if (draw.size() != parameter_sizes_.size()) {
+      report_error("Wrong number of parameters passed to "
+                   "DrawStoreWriter::write.");
+    }
+    for (int i = 0; i < draw.size(); ++i) {
+      if (draw[i].size() != parameter_sizes_[i]) {
+        report_error("The size of a draw passed to DrawStoreWriter::write "
+                     "does not match the dimensions of parameter " +
+                     parameter_names_[i] + ".");
+      }
+      std::vector<double> &column(current_chunk_.values[i]);
+      column.insert(column.end(), draw[i].begin(), draw[i].end());
+    }
+    ++current_chunk_.number_of_iterations;
+    ++number_of_draws_;
+    if (current_chunk_.number_of_iterations >= chunk_size_) {
+      submit_current_chunk();
+    }
+  }
+
+  void DrawStoreWriter::submit_current_chunk() {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      work_finished_.wait(lock, [this]() {
+        return pending_chunks_.size() < kMaxPendingChunks;
+      });
+      pending_chunks_.push_back(std::move(current_chunk_));
+    }
+    work_available_.notify_one();
+    current_chunk_ = Chunk();
+    reset_current_chunk();
+  }
+
+  void DrawStoreWriter::flush() {
+    if (current_chunk_.number_of_iterations > 0) {
+      submit_current_chunk();
+    }
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      work_finished_.wait(lock, [this]() {
+        return pending_chunks_.empty() && !chunk_in_progress_;
+      });
+    }
+    check_writer_error();
+  }
+
+  void DrawStoreWriter::writer_loop() {
+    while (true) {
+      Chunk chunk;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        work_available_.wait(lock, [this]() {
+          return done_ || !pending_chunks_.empty();
+        });
+        if (pending_chunks_.empty()) return;
+        chunk = std::move(pending_chunks_.front());
+        pending_chunks_.pop_front();
+        chunk_in_progress_ = true;
+      }
+      try {
+        if (!writer_error_) {
+          write_chunk(chunk);
+        }
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        writer_error_ = std::current_exception();
+      }
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        chunk_in_progress_ = false;
+      }
+      work_finished_.notify_all();
+    }
+  }
+
+  void DrawStoreWriter::write_chunk(const Chunk &chunk) {
+    if (std::fwrite(&chunk.number_of_iterations, sizeof(std::int64_t), 1,
+                    file_) != 1) {
+      report_error("Could not write to draw store file.");
+    }
+    for (const auto &column : chunk.values) {
+      if (std::fwrite(column.data(), sizeof(double), column.size(), file_) !=
+          column.size()) {
+        report_error("Could not write to draw store file.");
+      }
+    }
+    if (std::fflush(file_) != 0) {
+      report_error("Could not write to draw store file.");
+    }
+  }
+
+  void DrawStoreWriter::check_writer_error() {
+    std::exception_ptr error;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      error = writer_error_;
+    }
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+
+  //===========================================================================
+  DrawStoreReader::DrawStoreReader(const std::string &filename)
+      : data_(nullptr), file_size_(0), mapped_(false), number_of_draws_(0) {
+#ifndef _WIN32
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+      report_error("Could not open draw store file " + filename);
+    }
+    struct stat file_status;
+    if (::fstat(fd, &file_status) != 0) {
+      ::close(fd);
+      report_error("Could not determine the size of " + filename);
+    }
+    file_size_ = file_status.st_size;
+    if (file_size_ > 0) {
+      void *address =
+          ::mmap(nullptr, file_size_, PROT_READ, MAP_PRIVATE, fd, 0);
+      ::close(fd);
+      if (address == MAP_FAILED) {
+        report_error("Could not map draw store file " + filename);
+      }
+      data_ = static_cast<const char *>(address);
+      mapped_ = true;
+    } else {
+      ::close(fd);
+    }
+#else
+    std::ifstream input(filename.c_str(), std::ios::binary);
+    if (!input) {
+      report_error("Could not open draw store file " + filename);
+    }
+    buffer_.assign(std::istreambuf_iterator<char>(input),
+                   std::istreambuf_iterator<char>());
+    file_size_ = buffer_.size();
+    data_ = buffer_.data();
+#endif
+
+    try {
+      if (file_size_ < 8 || std::memcmp(data_, kMagic, 8) != 0) {
+        report_error(filename + " is not a draw store file.");
+      }
+      std::size_t offset = 8;
+      std::uint32_t version =
+          read_value<std::uint32_t>(data_, file_size_, offset);
+      if (version != kVersion) {
+        report_error("Unsupported draw store version in " + filename);
+      }
+      std::uint32_t byte_order =
+          read_value<std::uint32_t>(data_, file_size_, offset);
+      if (byte_order != kByteOrderMark) {
+        report_error(filename + " was written on a machine with a different "
+                     "byte order.");
+      }
+      std::uint32_t number_of_parameters =
+          read_value<std::uint32_t>(data_, file_size_, offset);
+      read_value<std::uint32_t>(data_, file_size_, offset);
+      std::size_t draw_size = 0;
+      for (int i = 0; i < number_of_parameters; ++i) {
+        std::uint32_t number_of_dims =
+            read_value<std::uint32_t>(data_, file_size_, offset);
+        std::vector<int> dims;
+        for (int j = 0; j < number_of_dims; ++j) {
+          dims.push_back(read_value<std::uint32_t>(data_, file_size_, offset));
+        }
+        int size = product(dims);
+        std::uint32_t name_length =
+            read_value<std::uint32_t>(data_, file_size_, offset);
+        if (offset + name_length > file_size_) {
+          report_error("Draw store file is truncated.");
+        }
+        parameter_names_.push_back(std::string(data_ + offset, name_length));
+        parameter_dims_.push_back(dims);
+        parameter_sizes_.push_back(size);
+        offset += name_length;
+        draw_size += size;
+      }
+      offset = pad8(offset);
+      valid_size_ = std::min(offset, file_size_);
+
+      // Index the chunks.  A partial chunk at the end of the file (e.g. from
+      // a run that was interrupted while writing) is ignored.
+      while (offset + sizeof(std::int64_t) <= file_size_) {
+        std::int64_t chunk_size =
+            read_value<std::int64_t>(data_, file_size_, offset);
+        std::size_t chunk_bytes = chunk_size * draw_size * sizeof(double);
+        if (chunk_size <= 0 || offset + chunk_bytes > file_size_) {
+          break;
+        }
+        chunk_first_iteration_.push_back(number_of_draws_);
+        chunk_size_.push_back(chunk_size);
+        std::vector<std::size_t> block_offsets(number_of_parameters);
+        for (int i = 0; i < number_of_parameters; ++i) {
+          block_offsets[i] = offset;
+          offset += chunk_size * parameter_sizes_[i] * sizeof(double);
+        }
+        chunk_offsets_.push_back(block_offsets);
+        number_of_draws_ += chunk_size;
+        valid_size_ = offset;
+      }
+    } catch (...) {
+#ifndef _WIN32
+      if (mapped_) {
+        ::munmap(const_cast<char *>(data_), file_size_);
+      }
+#endif
+      throw;
+    }
+  }
+
+  DrawStoreReader::~DrawStoreReader() {
+#ifndef _WIN32
+    if (mapped_) {
+      ::munmap(const_cast<char *>(data_), file_size_);
+    }
+#endif
+  }
+
+  int DrawStoreReader::parameter_index(const std::string &name) const {
+    auto it = std::find(parameter_names_.begin(), parameter_names_.end(),
+                        name);
+    return it == parameter_names_.end() ? -1 : it - parameter_names_.begin();
+  }
+
+  void DrawStoreReader::check_parameter(int parameter) const {
+    if (parameter < 0 || parameter >= number_of_parameters()) {
+      report_error("Parameter index out of range in DrawStoreReader.");
+    }
+  }
+
+  void DrawStoreReader::check_iteration(std::int64_t iteration) const {
+    if (iteration < 0 || iteration >= number_of_draws_) {
+      report_error("Iteration out of range in DrawStoreReader.");
+    }
+  }
+
+  int DrawStoreReader::find_chunk(std::int64_t iteration) const {
+    auto it = std::upper_bound(chunk_first_iteration_.begin(),
+                               chunk_first_iteration_.end(), iteration);
+    return (it - chunk_first_iteration_.begin()) - 1;
+  }
+
+  ConstVectorView DrawStoreReader::draw(int parameter,
+                                        std::int64_t iteration) const {
+    check_parameter(parameter);
+    check_iteration(iteration);
+    int chunk = find_chunk(iteration);
+    int size = parameter_sizes_[parameter];
+    const double *block = reinterpret_cast<const double *>(
+        data_ + chunk_offsets_[chunk][parameter]);
+    std::int64_t position = iteration - chunk_first_iteration_[chunk];
+    return ConstVectorView(block + position * size, size, 1);
+  }
+
+  Matrix DrawStoreReader::matrix_draw(int parameter,
+                                     std::int64_t iteration) const {
+    check_parameter(parameter);
+    const std::vector<int> &dims(parameter_dims_[parameter]);
+    if (dims.size() != 2) {
+      report_error("Parameter " + parameter_names_[parameter] +
+                   " is not a matrix.");
+    }
+    ConstVectorView values = draw(parameter, iteration);
+    return Matrix(values.begin(), values.end(), dims[0], dims[1]);
+  }
+
+  Matrix DrawStoreReader::draws(int parameter, std::int64_t burn,
+                                int thin) const {
+    check_parameter(parameter);
+    if (thin < 1) {
+      report_error("Thinning interval must be positive.");
+    }
+    burn = std::max<std::int64_t>(burn, 0);
+    std::int64_t number_kept =
+        burn >= number_of_draws_ ? 0
+                                 : (number_of_draws_ - burn + thin - 1) / thin;
+    Matrix ans(number_kept, parameter_sizes_[parameter]);
+    for (std::int64_t i = 0; i < number_kept; ++i) {
+      ans.row(i) = draw(parameter, burn + i * thin);
+    }
+    return ans;
+  }
+
+  Vector DrawStoreReader::mean(int parameter, std::int64_t burn,
+                               int thin) const {
+    check_parameter(parameter);
+    if (thin < 1) {
+      report_error("Thinning interval must be positive.");
+    }
+    Vector ans(parameter_sizes_[parameter], 0.0);
+    std::int64_t count = 0;
+    for (std::int64_t i = std::max<std::int64_t>(burn, 0);
+         i < number_of_draws_; i += thin) {
+      ans += draw(parameter, i);
+      ++count;
+    }
+    if (count > 0) {
+      ans /= count;
+    }
+    return ans;
+  }
+
+}  // namespace BOOM
@@ -0,0 +1,235 @@
+#ifndef BOOM_CPPUTIL_DRAW_STORE_HPP_
+#define BOOM_CPPUTIL_DRAW_STORE_HPP_
+/*
+  Copyright (C) 2019 Steven L. Scott
+
+  This library is free software; you can redistribute it and/or modify it under
+  the terms of the GNU Lesser General Public License as published by the Free
+  Software Foundation; either version 2.1 of the License, or (at your option)
+  any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT
+  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+  FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+  details.
+
+  You should have received a copy of the GNU Lesser General Public License along
+  with this library; if not, write to the Free Software Foundation, Inc., 51
+  Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+*/
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "LinAlg/Matrix.hpp"
+#include "LinAlg/Vector.hpp"
+#include "LinAlg/VectorView.hpp"
+
+namespace BOOM {
+
+  // A binary file format for storing MCMC draws of model parameters.
+  //
+  // The file begins with a header listing the name of each parameter and its
+  // dimensions (e.g. {nrow, ncol} for a matrix).  A draw of a parameter is a
+  // vector of doubles, with size equal to the product of the dimensions.
+  // Matrices are stored in column-major order.  The draws follow in chunks.
+  // Each chunk begins with the number of iterations it contains, followed by
+  // one column block per parameter.  The block for a parameter of size p in a
+  // chunk of n iterations holds n * p doubles, with the draws from
+  // consecutive iterations stored consecutively.  Thus every draw of every
+  // parameter is a contiguous array of doubles, that can be viewed in place
+  // once the file is mapped into memory.
+  //
+  // All numbers are stored in the native byte order of the machine that wrote
+  // the file.  The header records the byte order, and files written on a
+  // machine with a different byte order are rejected.
+  //
+  // Writing is done by a DrawStoreWriter, which hands full chunks to a
+  // background thread so that MCMC iterations are not held up by disk I/O.
+  // Reading is done by a DrawStoreReader, which maps the file into memory,
+  // so that individual draws or parameters can be accessed without reading
+  // the whole file.
+  //
+  // These classes know nothing about Params.  ParamDrawStoreWriter in
+  // Models/ParamDrawStore.hpp records the values of a set of Params.
+  class DrawStoreWriter {
+   public:
+    // Args:
+    //   filename:  The name of the file to write.
+    //   parameter_names:  The name of each parameter.
+    //   parameter_dims: The dimensions of each parameter.  Each parameter must
+    //     have at least one dimension, and all dimensions must be positive.
+    //   chunk_size: The number of iterations to buffer before handing a chunk
+    //     to the writer thread.
+    //   append: If true and 'filename' already contains a draw store, then new
+    //     draws are appended to it (e.g. when restarting an MCMC run).  The
+    //     parameter names and dimensions must match those in the file.  If
+    //     false, any existing file is overwritten.
+    DrawStoreWriter(const std::string &filename,
+                    const std::vector<std::string> &parameter_names,
+                    const std::vector<std::vector<int>> &parameter_dims,
+                    int chunk_size = 1000,
+                    bool append = false);
+
+    // Writes any buffered draws, and waits for the writer thread to finish.
+    ~DrawStoreWriter();
+
+    DrawStoreWriter(const DrawStoreWriter &rhs) = delete;
+    DrawStoreWriter &operator=(const DrawStoreWriter &rhs) = delete;
+
+    // Record one draw.  Element i of 'draw' is the value of parameter i, and
+    // its size must match the parameter's dimensions.  The values are copied
+    // into the current chunk.  If the chunk is full it is handed to the
+    // writer thread.  If the writer thread has fallen more than a few chunks
+    // behind, this call blocks until it catches up, so memory use is bounded.
+    void write(const std::vector<Vector> &draw);
+
+    // Hand any buffered draws to the writer thread, and wait until all draws
+    // have been written to disk.
+    void flush();
+
+    // The number of draws recorded by this writer (not counting any draws in
+    // the file before it was opened for appending).
+    std::int64_t number_of_draws() const { return number_of_draws_; }
+
+   private:
+    // The draws for 'number_of_iterations' consecutive iterations, with
+    // values[parameter] holding the column block for each parameter.
+    struct Chunk {
+      std::int64_t number_of_iterations;
+      std::vector<std::vector<double>> values;
+    };
+
+    void write_header();
+    void check_header(const std::string &filename);
+
+    // Hand the current chunk to the writer thread.
+    void submit_current_chunk();
+
+    // Start a new, empty current chunk.
+    void reset_current_chunk();
+
+    // The body of the writer thread.
+    void writer_loop();
+    void write_chunk(const Chunk &chunk);
+
+    // Rethrow any error encountered by the writer thread.
+    void check_writer_error();
+
+    std::vector<std::string> parameter_names_;
+    std::vector<std::vector<int>> parameter_dims_;
+    std::vector<int> parameter_sizes_;
+    int chunk_size_;
+    std::int64_t number_of_draws_;
+
+    Chunk current_chunk_;
+
+    std::FILE *file_;
+
+    // Chunks waiting for the writer thread.
+    std::deque<Chunk> pending_chunks_;
+    bool chunk_in_progress_;
+    bool done_;
+    std::exception_ptr writer_error_;
+    std::mutex mutex_;
+    std::condition_variable work_available_;
+    std::condition_variable work_finished_;
+    std::thread writer_thread_;
+  };
+
+  //===========================================================================
+  // Provides read access to a file written by a DrawStoreWriter.  The file is
+  // mapped into memory, so opening it is cheap, and only the pages holding
+  // the requested draws are read from disk.
+  class DrawStoreReader {
+   public:
+    explicit DrawStoreReader(const std::string &filename);
+    ~DrawStoreReader();
+
+    DrawStoreReader(const DrawStoreReader &rhs) = delete;
+    DrawStoreReader &operator=(const DrawStoreReader &rhs) = delete;
+
+    int number_of_parameters() const { return parameter_names_.size(); }
+    const std::string &parameter_name(int parameter) const {
+      return parameter_names_[parameter];
+    }
+    const std::vector<int> &parameter_dims(int parameter) const {
+      return parameter_dims_[parameter];
+    }
+    // The number of doubles in each draw of 'parameter': the product of its
+    // dimensions.
+    int parameter_size(int parameter) const {
+      return parameter_sizes_[parameter];
+    }
+
+    // Returns the index of the parameter with the given name, or -1 if there
+    // is no such parameter.
+    int parameter_index(const std::string &name) const;
+
+    std::int64_t number_of_draws() const { return number_of_draws_; }
+
+    // A view of the draw of 'parameter' at the given iteration.  The view
+    // points into the mapped file, and remains valid for the lifetime of
+    // *this.
+    ConstVectorView draw(int parameter, std::int64_t iteration) const;
+
+    // The draw of a two dimensional 'parameter' at the given iteration,
+    // arranged as a matrix.
+    Matrix matrix_draw(int parameter, std::int64_t iteration) const;
+
+    // Returns a matrix with one row per retained iteration, and one column
+    // per element of 'parameter'.
+    //
+    // Args:
+    //   parameter:  The index of the desired parameter.
+    //   burn:  The number of initial iterations to discard.
+    //   thin:  Keep every thin'th iteration after the burn-in.
+    Matrix draws(int parameter, std::int64_t burn = 0, int thin = 1) const;
+
+    // The posterior mean of 'parameter', computed in a single pass over the
+    // retained draws.
+    Vector mean(int parameter, std::int64_t burn = 0, int thin = 1) const;
+
+    // The number of bytes at the start of the file occupied by the header
+    // and the complete chunks.  Anything after this is a partial chunk.
+    std::size_t valid_size() const { return valid_size_; }
+
+    // The size of the file in bytes.
+    std::size_t file_size() const { return file_size_; }
+
+   private:
+    // Locate the chunk containing 'iteration'.
+    int find_chunk(std::int64_t iteration) const;
+    void check_parameter(int parameter) const;
+    void check_iteration(std::int64_t iteration) const;
+
+    const char *data_;
+    std::size_t file_size_;
+    // True if data_ was obtained from mmap, rather than read into a buffer.
+    bool mapped_;
+    std::vector<char> buffer_;
+
+    std::vector<std::string> parameter_names_;
+    std::vector<std::vector<int>> parameter_dims_;
+    std::vector<int> parameter_sizes_;
+    std::int64_t number_of_draws_;
+    std::size_t valid_size_;
+
+    // For each chunk: the first iteration in the chunk, the number of
+    // iterations, and the byte offsets of the column blocks for each
+    // parameter.
+    std::vector<std::int64_t> chunk_first_iteration_;
+    std::vector<std::int64_t> chunk_size_;
+    std::vector<std::vector<std::size_t>> chunk_offsets_;
+  };
+
+}  // namespace BOOM
+
+#endif  // BOOM_CPPUTIL_DRAW_STORE_HPP_
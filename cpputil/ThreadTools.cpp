@@ -95,4 +95,149 @@ namespace BOOM {
     }
   }
 
+  //======================================================================
+  namespace {
+    // The pool owning the current thread, if the current thread is a worker
+    // in a WorkStealingThreadPool, and the index of its queue.
+    thread_local const WorkStealingThreadPool *current_pool = nullptr;
+    thread_local int current_queue = -1;
+
+    // The number of times a worker looks for work before parking.
+    const int kSpinsBeforeParking = 64;
+  }  // namespace
+
+  const int WorkStealingThreadPool::kMaxThreads;
+
+  WorkStealingThreadPool::WorkStealingThreadPool(int number_of_threads)
+      : done_(false),
+        queues_(new WorkQueue[kMaxThreads]),
+        number_of_threads_(0),
+        pending_tasks_(0),
+        next_queue_(0),
+        number_of_parked_workers_(0) {
+    if (number_of_threads > 0) {
+      add_threads(number_of_threads);
+    }
+  }
+
+  WorkStealingThreadPool::~WorkStealingThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock(park_mutex_);
+      done_ = true;
+    }
+    work_available_.notify_all();
+    threads_.join_threads();
+    for (int i = 0; i < number_of_threads_; ++i) {
+      for (auto &task : queues_[i].tasks) {
+        if (task.submitted) {
+          delete task.body;
+        }
+      }
+    }
+  }
+
+  WorkStealingThreadPool &WorkStealingThreadPool::global() {
+    static WorkStealingThreadPool pool;
+    return pool;
+  }
+
+  void WorkStealingThreadPool::add_threads(int number_of_additional_threads) {
+    std::lock_guard<std::mutex> lock(thread_creation_mutex_);
+    int target = std::min<int>(kMaxThreads,
+                               number_of_threads_ + number_of_additional_threads);
+    while (number_of_threads_ < target) {
+      int queue_index = number_of_threads_;
+      threads_.push_back(std::thread(&WorkStealingThreadPool::worker_thread,
+                                     this, queue_index));
+      ++number_of_threads_;
+    }
+  }
+
+  void WorkStealingThreadPool::set_minimum_number_of_threads(
+      int number_of_threads) {
+    int shortfall = number_of_threads - number_of_threads_;
+    if (shortfall > 0) {
+      add_threads(shortfall);
+    }
+  }
+
+  void WorkStealingThreadPool::push(const Task &task, int queue_index) {
+    {
+      std::lock_guard<std::mutex> lock(queues_[queue_index].mutex);
+      queues_[queue_index].tasks.push_back(task);
+      ++pending_tasks_;
+    }
+  }
+
+  // A worker parks only after registering in number_of_parked_workers_ and
+  // then seeing pending_tasks_ == 0, both with park_mutex_ held.  A producer
+  // increments pending_tasks_ before reading number_of_parked_workers_.  With
+  // sequentially consistent atomics at least one side sees the other's
+  // write, so a task is never left waiting while every worker sleeps.
+  void WorkStealingThreadPool::wake_workers(bool all) {
+    if (number_of_parked_workers_ > 0) {
+      std::lock_guard<std::mutex> lock(park_mutex_);
+      if (all) {
+        work_available_.notify_all();
+      } else {
+        work_available_.notify_one();
+      }
+    }
+  }
+
+  bool WorkStealingThreadPool::find_task(int home_queue, Task &task) {
+    if (pending_tasks_ == 0) return false;
+    if (home_queue >= 0) {
+      WorkQueue &queue(queues_[home_queue]);
+      std::lock_guard<std::mutex> lock(queue.mutex);
+      if (!queue.tasks.empty()) {
+        task = queue.tasks.back();
+        queue.tasks.pop_back();
+        --pending_tasks_;
+        return true;
+      }
+    }
+    int nqueues = number_of_threads_;
+    int start = home_queue >= 0 ? home_queue + 1 : 0;
+    for (int i = 0; i < nqueues; ++i) {
+      int victim = (start + i) % nqueues;
+      if (victim == home_queue) continue;
+      WorkQueue &queue(queues_[victim]);
+      std::lock_guard<std::mutex> lock(queue.mutex);
+      if (!queue.tasks.empty()) {
+        task = queue.tasks.front();
+        queue.tasks.pop_front();
+        --pending_tasks_;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  int WorkStealingThreadPool::current_queue_index() const {
+    return current_pool == this ? current_queue : -1;
+  }
+
+  void WorkStealingThreadPool::worker_thread(int queue_index) {
+    current_pool = this;
+    current_queue = queue_index;
+    int failed_attempts = 0;
+    while (!done_) {
+      Task task;
+      if (find_task(queue_index, task)) {
+        failed_attempts = 0;
+        task.body->run(task.begin, task.end);
+      } else if (++failed_attempts < kSpinsBeforeParking) {
+        std::this_thread::yield();
+      } else {
+        failed_attempts = 0;
+        std::unique_lock<std::mutex> lock(park_mutex_);
+        ++number_of_parked_workers_;
+        work_available_.wait(
+            lock, [this]() { return done_ || pending_tasks_ > 0; });
+        --number_of_parked_workers_;
+      }
+    }
+  }
+
 }  // namespace BOOM
@@ -20,16 +20,23 @@
   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
 */
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <deque>
+#include <exception>
 #include <functional>
 #include <future>
+#include <memory>
 #include <mutex>
 #include <queue>
 #include <thread>
+#include <vector>
 
-// The main object defined here is the ThreadWorkerPool.  Before defining that
-// object, we must first define some building blocks.
+// The main objects defined here are the ThreadWorkerPool and the
+// WorkStealingThreadPool.  Before defining them, we must first define some
+// building blocks.
 
 namespace BOOM {
 
@@ -234,6 +241,306 @@ namespace BOOM {
     void worker_thread();
   };
 
+  //======================================================================
+  // A thread pool designed for many short tasks, such as the per-iteration
+  // data augmentation steps in an MCMC algorithm.
+  //
+  // Each worker thread owns a double ended queue of tasks.  A worker takes
+  // tasks from the back of its own queue, and when its queue is empty it
+  // "steals" from the front of the queues owned by other workers.  Each queue
+  // has its own lock, so there is no single point of contention as there is in
+  // ThreadWorkerPool.  Workers with nothing to do park on a condition variable
+  // and are woken when work arrives, rather than polling on a timer.
+  //
+  // The main entry point is parallel_for, which divides a range of indices
+  // into chunks and runs the chunks on the pool.  The calling thread takes
+  // part in the work, so a pool with N threads runs parallel_for on up to N+1
+  // threads, and parallel_for may safely be called from inside a task running
+  // on the pool.  parallel_for does no heap allocation per task.
+  //
+  // A process-wide pool is available through global().  Creating threads is
+  // expensive relative to the work done in a typical MCMC iteration, so
+  // models should share the global pool rather than owning pools of their
+  // own.
+  //
+  // The idiom for using this is:
+  //
+  // WorkStealingThreadPool &pool(WorkStealingThreadPool::global());
+  // pool.set_minimum_number_of_threads(4);
+  // std::vector<double> answers(100);
+  // pool.parallel_for(0, 100, 10, [&answers](int i) {
+  //   answers[i] = do_some_work(i);
+  // });
+  class WorkStealingThreadPool {
+   public:
+    // The largest number of threads a pool can hold.
+    static const int kMaxThreads = 256;
+
+    // Start a pool with the given number of threads.
+    explicit WorkStealingThreadPool(int number_of_threads = 0);
+
+    // Wakes and joins all worker threads.  Tasks that have not started are
+    // discarded.
+    ~WorkStealingThreadPool();
+
+    WorkStealingThreadPool(const WorkStealingThreadPool &rhs) = delete;
+    WorkStealingThreadPool &operator=(const WorkStealingThreadPool &rhs) =
+        delete;
+
+    // The process-wide pool.  It starts with no threads.  Clients wanting
+    // parallelism call set_minimum_number_of_threads().
+    static WorkStealingThreadPool &global();
+
+    // Add the specified number of threads to the pool.  The total number of
+    // threads is capped at kMaxThreads.
+    void add_threads(int number_of_additional_threads);
+
+    // Add threads to the pool, if needed, so that it contains at least
+    // 'number_of_threads' threads.  Threads are never removed from a running
+    // pool, because the pool may be shared with other clients.
+    void set_minimum_number_of_threads(int number_of_threads);
+
+    int number_of_threads() const { return number_of_threads_; }
+    bool no_threads() const { return number_of_threads_ == 0; }
+
+    // Call body(i) for each i in [begin, end).  The indices are split into
+    // chunks of 'grain' consecutive values, and the chunks are distributed
+    // among the threads in the pool.  This function returns after all calls
+    // to 'body' have completed.  If any call to body() throws an exception
+    // then the first exception caught is rethrown here, after the remaining
+    // chunks have finished.  Indices in a chunk following a throwing call are
+    // skipped.
+    //
+    // If the pool has no threads then the loop is run on the calling thread.
+    template <class FUNCTION>
+    void parallel_for(int begin, int end, int grain, const FUNCTION &body);
+
+    // Submit a job to the pool.  This allocates, so parallel_for is preferred
+    // for fine grained work.
+    //
+    // Args:
+    //   work: A function-like object with signature void(void).
+    //
+    // Returns:
+    //   A future that can be used to wait for the task to complete, and which
+    //   passes back any exception thrown by the task.
+    template <class FUNCTION>
+    std::future<void> submit(FUNCTION work);
+
+   private:
+    // An interface for the work done by a Task.
+    class TaskBody {
+     public:
+      virtual ~TaskBody() {}
+      // Run the work for indices [begin, end).
+      virtual void run(int begin, int end) = 0;
+    };
+
+    // A unit of work in a queue.  Tasks are small and trivially copyable, so
+    // moving them through the queues does not allocate (apart from the
+    // occasional growth of a deque).
+    struct Task {
+      TaskBody *body;
+      int begin;
+      int end;
+      // True if the task was created by submit(), in which case 'body' is
+      // owned by the task and deletes itself when run.  Bodies of tasks
+      // created by parallel_for live on the caller's stack.
+      bool submitted;
+    };
+
+    // The work done by a call to parallel_for.  This object lives on the stack
+    // of the thread calling parallel_for.  It keeps track of the number of
+    // chunks remaining, and the first exception thrown.
+    template <class FUNCTION>
+    class RangeTaskBody : public TaskBody {
+     public:
+      RangeTaskBody(const FUNCTION &body, int number_of_chunks)
+          : body_(body), chunks_remaining_(number_of_chunks) {}
+
+      // The counter is only touched with the mutex held.  Otherwise the
+      // thread that called parallel_for could see the count reach zero and
+      // destroy this object while the last worker was still notifying.
+      void run(int begin, int end) override {
+        std::exception_ptr exception;
+        try {
+          for (int i = begin; i < end; ++i) {
+            body_(i);
+          }
+        } catch (...) {
+          exception = std::current_exception();
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (exception && !exception_) {
+          exception_ = exception;
+        }
+        if (--chunks_remaining_ == 0) {
+          finished_.notify_all();
+        }
+      }
+
+      bool done() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return chunks_remaining_ == 0;
+      }
+
+      // Block until all chunks have finished.
+      void wait() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        finished_.wait(lock, [this]() { return chunks_remaining_ == 0; });
+      }
+
+      void rethrow_exception() {
+        if (exception_) std::rethrow_exception(exception_);
+      }
+
+     private:
+      const FUNCTION &body_;
+      int chunks_remaining_;
+      std::mutex mutex_;
+      std::condition_variable finished_;
+      std::exception_ptr exception_;
+    };
+
+    // The work done by a call to submit().  Owns the packaged task, and
+    // deletes itself after it runs.
+    class SubmittedTaskBody : public TaskBody {
+     public:
+      explicit SubmittedTaskBody(std::packaged_task<void()> &&task)
+          : task_(std::move(task)) {}
+      void run(int, int) override {
+        task_();
+        delete this;
+      }
+
+     private:
+      std::packaged_task<void()> task_;
+    };
+
+    // A queue of tasks owned by one worker.  The owner pushes and pops at the
+    // back.  Thieves pop from the front.
+    struct WorkQueue {
+      std::mutex mutex;
+      std::deque<Task> tasks;
+    };
+
+    // Place 'task' on the queue with the given index, and wake a parked worker
+    // if there is one.
+    void push(const Task &task, int queue_index);
+
+    // Wake parked workers, if any are parked.  If 'all' is false only one
+    // worker is woken.
+    void wake_workers(bool all);
+
+    // Look for a task, first on the queue with the given index (if it is a
+    // valid index), then on the other queues.  Returns true and fills 'task'
+    // if work was found.
+    bool find_task(int home_queue, Task &task);
+
+    // The index of the calling thread's queue if the calling thread is a
+    // worker in this pool, and -1 otherwise.
+    int current_queue_index() const;
+
+    // The main loop for each worker thread.
+    void worker_thread(int queue_index);
+
+    // Help with work in the pool until 'body' has finished.  This is the
+    // non-template part of parallel_for.
+    template <class FUNCTION>
+    void run_until_done(RangeTaskBody<FUNCTION> &body);
+
+    std::atomic<bool> done_;
+
+    // The queues are allocated once, with room for kMaxThreads workers, so
+    // that they never move while other threads are looking at them.
+    std::unique_ptr<WorkQueue[]> queues_;
+    std::atomic<int> number_of_threads_;
+
+    // The number of tasks currently sitting in queues.
+    std::atomic<int> pending_tasks_;
+
+    // Used to spread tasks from non-worker threads across the queues.
+    std::atomic<unsigned> next_queue_;
+
+    // Workers with nothing to do wait on 'work_available_'.
+    std::mutex park_mutex_;
+    std::condition_variable work_available_;
+    std::atomic<int> number_of_parked_workers_;
+
+    // Guards changes to threads_.
+    std::mutex thread_creation_mutex_;
+    ThreadVector threads_;
+  };
+
+  //----------------------------------------------------------------------
+  template <class FUNCTION>
+  void WorkStealingThreadPool::parallel_for(int begin, int end, int grain,
+                                            const FUNCTION &body) {
+    if (end <= begin) return;
+    if (grain < 1) grain = 1;
+    if (number_of_threads_ == 0 || end - begin <= grain) {
+      for (int i = begin; i < end; ++i) {
+        body(i);
+      }
+      return;
+    }
+    int number_of_chunks = (end - begin + grain - 1) / grain;
+    RangeTaskBody<FUNCTION> range_body(body, number_of_chunks);
+
+    // Spread the chunks across the queues, starting with the caller's own
+    // queue if the caller is a worker.  The first chunk is kept back for the
+    // calling thread.
+    int home = current_queue_index();
+    int nqueues = number_of_threads_;
+    int start = home >= 0 ? home : next_queue_++ % nqueues;
+    for (int chunk = 1; chunk < number_of_chunks; ++chunk) {
+      Task task;
+      task.body = &range_body;
+      task.begin = begin + chunk * grain;
+      task.end = std::min<int>(end, task.begin + grain);
+      task.submitted = false;
+      push(task, (start + chunk) % nqueues);
+    }
+    wake_workers(number_of_chunks > 2);
+    range_body.run(begin, std::min<int>(end, begin + grain));
+    run_until_done(range_body);
+    range_body.rethrow_exception();
+  }
+
+  template <class FUNCTION>
+  void WorkStealingThreadPool::run_until_done(RangeTaskBody<FUNCTION> &body) {
+    int home = current_queue_index();
+    while (!body.done()) {
+      Task task;
+      if (find_task(home, task)) {
+        task.body->run(task.begin, task.end);
+      } else {
+        // All remaining chunks are running on other threads.
+        body.wait();
+        return;
+      }
+    }
+  }
+
+  template <class FUNCTION>
+  std::future<void> WorkStealingThreadPool::submit(FUNCTION work) {
+    std::packaged_task<void()> packaged(std::move(work));
+    std::future<void> ans(packaged.get_future());
+    if (number_of_threads_ == 0) {
+      packaged();
+      return ans;
+    }
+    Task task;
+    task.body = new SubmittedTaskBody(std::move(packaged));
+    task.begin = 0;
+    task.end = 0;
+    task.submitted = true;
+    int home = current_queue_index();
+    push(task, home >= 0 ? home : next_queue_++ % number_of_threads_);
+    wake_workers(false);
+    return ans;
+  }
+
 }  // namespace BOOM
 
 #endif  //  BOOM_CPPUTIL_THREAD_TOOLS_HPP_
@@ -0,0 +1,150 @@
+#include "gtest/gtest.h"
+#include "cpputil/DrawStore.hpp"
+#include "test_utils/test_utils.hpp"
+
+#include <cstdio>
+
+namespace {
+  using namespace BOOM;
+  using std::endl;
+
+  class DrawStoreTest : public ::testing::Test {
+   protected:
+    DrawStoreTest()
+        : filename_("draw_store_test.bin"),
+          names_({"scalar", "vector", "matrix"}),
+          dims_({{1}, {3}, {2, 3}}) {}
+
+    ~DrawStoreTest() { std::remove(filename_.c_str()); }
+
+    // The draw at iteration i is a deterministic function of i.
+    std::vector<Vector> draw(int i) {
+      Matrix matrix(2, 3);
+      for (int col = 0; col < 3; ++col) {
+        for (int row = 0; row < 2; ++row) {
+          matrix(row, col) = i + 10 * row + 100 * col;
+        }
+      }
+      return {Vector(1, i), Vector{i + 0.5, -1.0 * i, i * 0.25},
+              Vector(matrix.begin(), matrix.end())};
+    }
+
+    void write_draws(int first, int last, int chunk_size, bool append) {
+      DrawStoreWriter writer(filename_, names_, dims_, chunk_size, append);
+      for (int i = first; i < last; ++i) {
+        writer.write(draw(i));
+      }
+    }
+
+    std::string filename_;
+    std::vector<std::string> names_;
+    std::vector<std::vector<int>> dims_;
+  };
+
+  TEST_F(DrawStoreTest, RoundTrip) {
+    // 25 draws in chunks of 10, so the last chunk is partial.
+    write_draws(0, 25, 10, false);
+    DrawStoreReader reader(filename_);
+    EXPECT_EQ(3, reader.number_of_parameters());
+    EXPECT_EQ(25, reader.number_of_draws());
+    EXPECT_EQ(1, reader.parameter_size(0));
+    EXPECT_EQ(3, reader.parameter_size(1));
+    EXPECT_EQ(6, reader.parameter_size(2));
+    EXPECT_EQ(std::vector<int>({2, 3}), reader.parameter_dims(2));
+    EXPECT_EQ(1, reader.parameter_index("vector"));
+    EXPECT_EQ(-1, reader.parameter_index("nothing"));
+
+    for (int i = 0; i < 25; ++i) {
+      EXPECT_DOUBLE_EQ(i, reader.draw(0, i)[0]);
+      EXPECT_TRUE(VectorEquals(Vector(reader.draw(1, i)),
+                               Vector{i + 0.5, -1.0 * i, i * 0.25}))
+          << "iteration " << i << endl;
+      Matrix matrix = reader.matrix_draw(2, i);
+      EXPECT_EQ(2, matrix.nrow());
+      EXPECT_EQ(3, matrix.ncol());
+      EXPECT_DOUBLE_EQ(i + 210, matrix(1, 2));
+    }
+    EXPECT_THROW(reader.draw(0, 25), std::exception);
+    EXPECT_THROW(reader.matrix_draw(1, 0), std::exception);
+  }
+
+  TEST_F(DrawStoreTest, BurnThinAndMean) {
+    write_draws(0, 20, 7, false);
+    DrawStoreReader reader(filename_);
+    Matrix draws = reader.draws(1, 5, 3);
+    // Iterations 5, 8, 11, 14, 17.
+    EXPECT_EQ(5, draws.nrow());
+    EXPECT_EQ(3, draws.ncol());
+    EXPECT_DOUBLE_EQ(11.5, draws(2, 0));
+    EXPECT_DOUBLE_EQ(-17.0, draws(4, 1));
+
+    Vector mean = reader.mean(0, 5, 3);
+    EXPECT_DOUBLE_EQ(11.0, mean[0]);
+    EXPECT_EQ(0, reader.draws(0, 100).nrow());
+  }
+
+  TEST_F(DrawStoreTest, Append) {
+    write_draws(0, 12, 5, false);
+    write_draws(12, 30, 5, true);
+    DrawStoreReader reader(filename_);
+    EXPECT_EQ(30, reader.number_of_draws());
+    EXPECT_DOUBLE_EQ(17, reader.draw(0, 17)[0]);
+    EXPECT_TRUE(VectorEquals(Vector(reader.draw(1, 29)),
+                             Vector{29.5, -29, 7.25}));
+  }
+
+  TEST_F(DrawStoreTest, AppendRequiresMatchingParameters) {
+    write_draws(0, 3, 10, false);
+    std::vector<std::string> other_names = {"scalar", "other", "matrix"};
+    EXPECT_THROW(DrawStoreWriter(filename_, other_names, dims_, 10, true),
+                 std::exception);
+    std::vector<std::vector<int>> other_dims = {{1}, {3}, {3, 2}};
+    EXPECT_THROW(DrawStoreWriter(filename_, names_, other_dims, 10, true),
+                 std::exception);
+    std::vector<std::string> fewer_names = {"scalar"};
+    std::vector<std::vector<int>> fewer_dims = {{1}};
+    EXPECT_THROW(DrawStoreWriter(filename_, fewer_names, fewer_dims, 10, true),
+                 std::exception);
+  }
+
+  TEST_F(DrawStoreTest, RejectsDrawsOfTheWrongSize) {
+    DrawStoreWriter writer(filename_, names_, dims_, 10, false);
+    std::vector<Vector> bad_draw = draw(0);
+    bad_draw[2].push_back(1.0);
+    EXPECT_THROW(writer.write(bad_draw), std::exception);
+    bad_draw.pop_back();
+    EXPECT_THROW(writer.write(bad_draw), std::exception);
+    std::vector<std::vector<int>> bad_dims = {{1}, {3}, {2, 0}};
+    EXPECT_THROW(DrawStoreWriter(filename_, names_, bad_dims, 10, false),
+                 std::exception);
+  }
+
+  TEST_F(DrawStoreTest, PartialChunkIsIgnored) {
+    write_draws(0, 10, 4, false);
+    // Chop the end off the file, as if a run had been interrupted while
+    // writing the last chunk.
+    std::size_t full_size;
+    {
+      DrawStoreReader reader(filename_);
+      full_size = reader.valid_size();
+    }
+    std::FILE *file = std::fopen(filename_.c_str(), "r+b");
+    ASSERT_TRUE(file != nullptr);
+    std::vector<char> contents(full_size);
+    ASSERT_EQ(full_size, std::fread(contents.data(), 1, full_size, file));
+    std::fclose(file);
+    file = std::fopen(filename_.c_str(), "wb");
+    std::fwrite(contents.data(), 1, full_size - 8, file);
+    std::fclose(file);
+
+    {
+      DrawStoreReader reader(filename_);
+      EXPECT_EQ(8, reader.number_of_draws());
+    }
+    write_draws(8, 10, 4, true);
+    DrawStoreReader reader(filename_);
+    EXPECT_EQ(10, reader.number_of_draws());
+    EXPECT_DOUBLE_EQ(9, reader.draw(0, 9)[0]);
+  }
+
+}  // namespace
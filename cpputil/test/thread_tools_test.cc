@@ -1,4 +1,7 @@
 #include "gtest/gtest.h"
+#include <atomic>
+#include <numeric>
+#include <stdexcept>
 #include "cpputil/ThreadTools.hpp"
 #include "test_utils/test_utils.hpp"
 
@@ -69,4 +72,102 @@ namespace {
     // }
   }
 
+  TEST(WorkStealingThreadPoolTest, parallel_for) {
+    WorkStealingThreadPool pool(3);
+    EXPECT_EQ(3, pool.number_of_threads());
+    std::vector<int> answers(1000, -1);
+    pool.parallel_for(0, answers.size(), 7, [&answers](int i) {
+      answers[i] = i;
+    });
+    for (int i = 0; i < answers.size(); ++i) {
+      EXPECT_EQ(i, answers[i]);
+    }
+
+    // Repeated calls should not leave work behind.
+    for (int rep = 0; rep < 100; ++rep) {
+      std::atomic<int> total(0);
+      pool.parallel_for(0, 50, 1, [&total](int i) { total += i; });
+      EXPECT_EQ(50 * 49 / 2, total);
+    }
+
+    // An empty range is a no-op.
+    pool.parallel_for(5, 5, 1, [](int i) { FAIL(); });
+  }
+
+  TEST(WorkStealingThreadPoolTest, no_threads) {
+    WorkStealingThreadPool pool;
+    EXPECT_TRUE(pool.no_threads());
+    std::vector<int> answers(20, 0);
+    pool.parallel_for(0, 20, 3, [&answers](int i) { answers[i] = i; });
+    for (int i = 0; i < answers.size(); ++i) {
+      EXPECT_EQ(i, answers[i]);
+    }
+    std::future<void> result = pool.submit([&answers]() { answers[0] = 17; });
+    result.get();
+    EXPECT_EQ(17, answers[0]);
+  }
+
+  TEST(WorkStealingThreadPoolTest, nested) {
+    WorkStealingThreadPool pool(2);
+    std::vector<std::vector<int>> answers(8, std::vector<int>(25, 0));
+    pool.parallel_for(0, answers.size(), 1, [&pool, &answers](int i) {
+      pool.parallel_for(0, answers[i].size(), 2, [&answers, i](int j) {
+        answers[i][j] = i * j;
+      });
+    });
+    for (int i = 0; i < answers.size(); ++i) {
+      for (int j = 0; j < answers[i].size(); ++j) {
+        EXPECT_EQ(i * j, answers[i][j]);
+      }
+    }
+  }
+
+  TEST(WorkStealingThreadPoolTest, exceptions) {
+    WorkStealingThreadPool pool(2);
+    std::atomic<int> count(0);
+    EXPECT_THROW(pool.parallel_for(0, 100, 1, [&count](int i) {
+          ++count;
+          if (i == 37) {
+            throw std::runtime_error("Thirty seven");
+          }
+        }),
+      std::runtime_error);
+    EXPECT_EQ(100, count);
+
+    // The pool is still usable afterward.
+    std::vector<int> answers(10, 0);
+    pool.parallel_for(0, 10, 1, [&answers](int i) { answers[i] = 1; });
+    EXPECT_EQ(10, std::accumulate(answers.begin(), answers.end(), 0));
+  }
+
+  TEST(WorkStealingThreadPoolTest, submit) {
+    WorkStealingThreadPool pool(3);
+    int num_tasks = 7;
+    std::vector<std::future<void>> futures;
+    std::vector<int> answers(num_tasks);
+    for (int i = 0; i < num_tasks; ++i) {
+      futures.emplace_back(pool.submit([i, &answers]() { answers[i] = i; }));
+    }
+    futures.emplace_back(pool.submit([]() {
+          throw std::runtime_error("oops");
+        }));
+    for (int i = 0; i < num_tasks; ++i) {
+      futures[i].get();
+      EXPECT_EQ(i, answers[i]);
+    }
+    EXPECT_THROW(futures.back().get(), std::runtime_error);
+  }
+
+  TEST(WorkStealingThreadPoolTest, global) {
+    WorkStealingThreadPool &pool(WorkStealingThreadPool::global());
+    EXPECT_EQ(&pool, &WorkStealingThreadPool::global());
+    pool.set_minimum_number_of_threads(2);
+    EXPECT_GE(pool.number_of_threads(), 2);
+    pool.set_minimum_number_of_threads(1);
+    EXPECT_GE(pool.number_of_threads(), 2);
+    std::atomic<int> total(0);
+    pool.parallel_for(0, 1000, 10, [&total](int i) { ++total; });
+    EXPECT_EQ(1000, total);
+  }
+
 }  // namespace
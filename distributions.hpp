@@ -185,6 +185,25 @@ namespace BOOM {
   double rgig_mt(RNG &rng, double lambda, double psi, double chi);
   double gig_mean(double lambda, double psi, double chi);
 
+  // The Polya-Gamma PG(b, c) distribution of Polson, Scott, and Windle (2013)
+  // is the distribution of
+  //
+  //   (1 / 2 pi^2) sum_k g_k / ((k - 1/2)^2 + c^2 / (4 pi^2)),
+  //
+  // where the g_k are independent Ga(b, 1).  It is the conditional
+  // distribution of the latent variables in the Polya-Gamma data augmentation
+  // scheme for logistic and negative binomial models.
+  //
+  // Draws are exact when b is an integer smaller than 200, in which case
+  // PG(b, c) is simulated as a sum of b exact PG(1, c) draws.  If b >= 200 a
+  // normal approximation with the exact mean and variance is used.  The
+  // fractional part of a non-integer b is handled by a truncated version of
+  // the series above, with the tail replaced by its mean.
+  double rpolya_gamma_mt(RNG &rng, double b, double c);
+  double rpolya_gamma(double b, double c);
+  double polya_gamma_mean(double b, double c);
+  double polya_gamma_variance(double b, double c);
+
   //===========================================================================
   // extreme value distribution with centrality parameter 'mu + gamma', where
   // gamma is Euler's constant -0.5772157... and variance 'sigma^2 * pi^2/6'.
@@ -210,6 +229,39 @@ namespace BOOM {
     return ans;
   }
 
+  //======================================================================
+  // Bulk deviate generation.
+  //
+  // The scalar generators above (rnorm_mt, rexp_mt, etc) follow the
+  // algorithms in R's nmath library, which are accurate but branchy and
+  // expensive per draw.  The functions below fill a Vector with deviates in
+  // one call.  They are intended for data augmentation samplers, which need
+  // very many draws per MCMC iteration.  They do not reproduce the sequence of
+  // values returned by repeated calls to the scalar generators.
+
+  // A standard normal (resp. standard exponential) deviate generated by the
+  // 256 layer ziggurat algorithm of Marsaglia and Tsang (2000).  All 64 bits
+  // of rng.random_bits() are used, so the layer index and the abscissa are
+  // drawn from disjoint bits.
+  double rnorm_ziggurat_mt(RNG &rng);
+  double rexp_ziggurat_mt(RNG &rng);
+
+  // Fill 'output' with independent N(mu, sigma^2) deviates.
+  void rnorm_mt(RNG &rng, Vector &output, double mu = 0, double sigma = 1);
+
+  // Fill 'output' with independent U[lo, hi) deviates.
+  void runif_mt(RNG &rng, Vector &output, double lo = 0, double hi = 1);
+
+  // Fill 'output' with independent exponential deviates with the given rate.
+  void rexp_mt(RNG &rng, Vector &output, double rate = 1);
+
+  // Fill 'output' with independent Gamma(shape, rate) deviates, with mean
+  // shape / rate.  Uses the Marsaglia and Tsang (2000) squeeze method, with
+  // all the normal and uniform proposals for a batch drawn up front.  Shape
+  // parameters less than 1 are handled with the "boost" Ga(a) = Ga(a + 1) *
+  // U^(1/a).
+  void rgamma_mt(RNG &rng, Vector &output, double shape, double rate = 1);
+
   //======================================================================
   // Several varieties of multivariate normal generation.
   //
@@ -0,0 +1,181 @@
+/*
+  Copyright (C) 2019 Steven L. Scott
+
+  This library is free software; you can redistribute it and/or modify it under
+  the terms of the GNU Lesser General Public License as published by the Free
+  Software Foundation; either version 2.1 of the License, or (at your option)
+  any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT
+  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+  FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+  details.
+
+  You should have received a copy of the GNU Lesser General Public License along
+  with this library; if not, write to the Free Software Foundation, Inc., 51
+  Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+*/
+
+// Throughput of the random number generators and the deviate generators
+// built on them.  The benchmark argument is the number of draws per
+// iteration.  Scalar benchmarks call the one-draw-at-a-time generators in a
+// loop, and "Bulk" benchmarks fill a Vector with one call, so the two can be
+// compared directly.  Each benchmark seeds its own RNG.
+
+#include "benchmark/benchmark.h"
+#include "distributions.hpp"
+#include "LinAlg/SpdMatrix.hpp"
+#include "LinAlg/Vector.hpp"
+
+namespace {
+  using namespace BOOM;
+
+  const unsigned long kSeed = 8675309;
+
+  void set_draws(benchmark::State &state) {
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+
+  void BM_RandomBits(benchmark::State &state) {
+    RNG rng(kSeed);
+    int n = state.range(0);
+    for (auto _ : state) {
+      for (int i = 0; i < n; ++i) {
+        benchmark::DoNotOptimize(rng.random_bits());
+      }
+    }
+    set_draws(state);
+  }
+
+  void BM_Runif(benchmark::State &state) {
+    RNG rng(kSeed);
+    int n = state.range(0);
+    for (auto _ : state) {
+      for (int i = 0; i < n; ++i) {
+        benchmark::DoNotOptimize(runif_mt(rng, 0, 1));
+      }
+    }
+    set_draws(state);
+  }
+
+  void BM_Rnorm(benchmark::State &state) {
+    RNG rng(kSeed);
+    int n = state.range(0);
+    for (auto _ : state) {
+      for (int i = 0; i < n; ++i) {
+        benchmark::DoNotOptimize(rnorm_mt(rng, 0, 1));
+      }
+    }
+    set_draws(state);
+  }
+
+  void BM_RnormBulk(benchmark::State &state) {
+    RNG rng(kSeed);
+    Vector draws(state.range(0));
+    for (auto _ : state) {
+      rnorm_mt(rng, draws, 0, 1);
+      benchmark::DoNotOptimize(draws.data());
+    }
+    set_draws(state);
+  }
+
+  void BM_Rexp(benchmark::State &state) {
+    RNG rng(kSeed);
+    int n = state.range(0);
+    for (auto _ : state) {
+      for (int i = 0; i < n; ++i) {
+        benchmark::DoNotOptimize(rexp_mt(rng, 1.0));
+      }
+    }
+    set_draws(state);
+  }
+
+  void BM_RexpBulk(benchmark::State &state) {
+    RNG rng(kSeed);
+    Vector draws(state.range(0));
+    for (auto _ : state) {
+      rexp_mt(rng, draws, 1.0);
+      benchmark::DoNotOptimize(draws.data());
+    }
+    set_draws(state);
+  }
+
+  // The shape parameter is passed as the second argument, in tenths, so that
+  // both the a < 1 and a >= 1 branches are covered.
+  void BM_Rgamma(benchmark::State &state) {
+    RNG rng(kSeed);
+    int n = state.range(0);
+    double shape = state.range(1) / 10.0;
+    for (auto _ : state) {
+      for (int i = 0; i < n; ++i) {
+        benchmark::DoNotOptimize(rgamma_mt(rng, shape, 1.0));
+      }
+    }
+    set_draws(state);
+  }
+
+  void BM_RgammaBulk(benchmark::State &state) {
+    RNG rng(kSeed);
+    Vector draws(state.range(0));
+    double shape = state.range(1) / 10.0;
+    for (auto _ : state) {
+      rgamma_mt(rng, draws, shape, 1.0);
+      benchmark::DoNotOptimize(draws.data());
+    }
+    set_draws(state);
+  }
+
+  void BM_Rbeta(benchmark::State &state) {
+    RNG rng(kSeed);
+    int n = state.range(0);
+    for (auto _ : state) {
+      for (int i = 0; i < n; ++i) {
+        benchmark::DoNotOptimize(rbeta_mt(rng, 2.0, 3.0));
+      }
+    }
+    set_draws(state);
+  }
+
+  void BM_Rpois(benchmark::State &state) {
+    RNG rng(kSeed);
+    int n = state.range(0);
+    for (auto _ : state) {
+      for (int i = 0; i < n; ++i) {
+        benchmark::DoNotOptimize(rpois_mt(rng, 4.0));
+      }
+    }
+    set_draws(state);
+  }
+
+  // The argument is the dimension of the multivariate normal.
+  void BM_Rmvn(benchmark::State &state) {
+    RNG rng(kSeed);
+    int dim = state.range(0);
+    Matrix X(2 * dim, dim);
+    X.randomize(rng);
+    SpdMatrix Sigma = X.inner();
+    Sigma.diag() += 1.0;
+    Vector mu(dim, 0.0);
+    for (auto _ : state) {
+      Vector draw = rmvn_mt(rng, mu, Sigma);
+      benchmark::DoNotOptimize(draw.data());
+    }
+  }
+
+  const int kDraws = 1 << 16;
+
+  BENCHMARK(BM_RandomBits)->Arg(kDraws);
+  BENCHMARK(BM_Runif)->Arg(kDraws);
+  BENCHMARK(BM_Rnorm)->Arg(kDraws);
+  BENCHMARK(BM_RnormBulk)->Arg(kDraws);
+  BENCHMARK(BM_Rexp)->Arg(kDraws);
+  BENCHMARK(BM_RexpBulk)->Arg(kDraws);
+  BENCHMARK(BM_Rgamma)->ArgsProduct({{kDraws}, {5, 20, 100}});
+  BENCHMARK(BM_RgammaBulk)->ArgsProduct({{kDraws}, {5, 20, 100}});
+  BENCHMARK(BM_Rbeta)->Arg(kDraws);
+  BENCHMARK(BM_Rpois)->Arg(kDraws);
+  BENCHMARK(BM_Rmvn)->Arg(5)->Arg(50);
+
+}  // namespace
+
+BENCHMARK_MAIN();
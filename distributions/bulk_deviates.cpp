@@ -0,0 +1,326 @@
+/*
+  Copyright (C) 2019 Steven L. Scott
+
+  This library is free software; you can redistribute it and/or modify it under
+  the terms of the GNU Lesser General Public License as published by the Free
+  Software Foundation; either version 2.1 of the License, or (at your option)
+  any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT
+  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+  FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+  details.
+
+  You should have received a copy of the GNU Lesser General Public License along
+  with this library; if not, write to the Free Software Foundation, Inc., 51
+  Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+*/
+
+#include <cmath>
+#include <cstdint>
+#include "distributions.hpp"
+#include "cpputil/report_error.hpp"
+
+namespace BOOM {
+
+  namespace {
+    const int kNumberOfLayers = 256;
+
+    // The right edge of the outermost layer, and the common area of each
+    // layer (including the tail in the case of the base layer), for the
+    // 256 layer ziggurats.
+    const double kNormalR = 3.6541528853610088;
+    const double kNormalV = 0.00492867323399;
+    const double kExponentialR = 7.69711747013104972;
+    const double kExponentialV = 0.0039496598225815571993;
+
+    // 2^52 and 2^53: the ranges of the integer abscissae used by the normal
+    // and exponential generators.
+    const double kTwo52 = 4503599627370496.0;
+    const double kTwo53 = 9007199254740992.0;
+
+    // Layer i covers [0, x[i]) x [f[i], f[i-1]).  Layer 0 is the base layer,
+    // which includes the tail.  An integer abscissa j (scaled so the layer
+    // maps to [0, 2^k)) lies entirely beneath the density if j < k[i].
+    struct Ziggurat {
+      std::uint64_t k[kNumberOfLayers];
+      double w[kNumberOfLayers];
+      double f[kNumberOfLayers];
+    };
+
+    Ziggurat build_normal_ziggurat() {
+      Ziggurat ans;
+      double dn = kNormalR;
+      double tn = dn;
+      double q = kNormalV / exp(-0.5 * dn * dn);
+      ans.k[0] = static_cast<std::uint64_t>((dn / q) * kTwo52);
+      ans.k[1] = 0;
+      ans.w[0] = q / kTwo52;
+      ans.w[kNumberOfLayers - 1] = dn / kTwo52;
+      ans.f[0] = 1.0;
+      ans.f[kNumberOfLayers - 1] = exp(-0.5 * dn * dn);
+      for (int i = kNumberOfLayers - 2; i >= 1; --i) {
+        dn = sqrt(-2 * log(kNormalV / dn + exp(-0.5 * dn * dn)));
+        ans.k[i + 1] = static_cast<std::uint64_t>((dn / tn) * kTwo52);
+        tn = dn;
+        ans.f[i] = exp(-0.5 * dn * dn);
+        ans.w[i] = dn / kTwo52;
+      }
+      return ans;
+    }
+
+    Ziggurat build_exponential_ziggurat() {
+      Ziggurat ans;
+      double de = kExponentialR;
+      double te = de;
+      double q = kExponentialV / exp(-de);
+      ans.k[0] = static_cast<std::uint64_t>((de / q) * kTwo53);
+      ans.k[1] = 0;
+      ans.w[0] = q / kTwo53;
+      ans.w[kNumberOfLayers - 1] = de / kTwo53;
+      ans.f[0] = 1.0;
+      ans.f[kNumberOfLayers - 1] = exp(-de);
+      for (int i = kNumberOfLayers - 2; i >= 1; --i) {
+        de = -log(kExponentialV / de + exp(-de));
+        ans.k[i + 1] = static_cast<std::uint64_t>((de / te) * kTwo53);
+        te = de;
+        ans.f[i] = exp(-de);
+        ans.w[i] = de / kTwo53;
+      }
+      return ans;
+    }
+
+    // The tables are built on first use.  Initialization of function local
+    // statics is thread safe.
+    const Ziggurat &normal_ziggurat() {
+      static const Ziggurat ziggurat(build_normal_ziggurat());
+      return ziggurat;
+    }
+
+    const Ziggurat &exponential_ziggurat() {
+      static const Ziggurat ziggurat(build_exponential_ziggurat());
+      return ziggurat;
+    }
+
+    // A U(0, 1] deviate, safe to take logs of.
+    inline double positive_uniform(RNG &rng) { return 1.0 - rng(); }
+
+    // Called when the fast path of the normal ziggurat fails, which happens
+    // about 1% of the time.  'layer' and 'x' are the rejected layer and
+    // (absolute) abscissa.  Returns true and fills *ans with the absolute
+    // value of the deviate if the draw is accepted.
+    bool normal_ziggurat_slow_path(RNG &rng, const Ziggurat &ziggurat,
+                                   int layer, double x, double *ans) {
+      if (layer == 0) {
+        // The tail beyond R, using Marsaglia's (1964) method.
+        double xx, yy;
+        do {
+          xx = -log(positive_uniform(rng)) / kNormalR;
+          yy = -log(positive_uniform(rng));
+        } while (yy + yy <= xx * xx);
+        *ans = kNormalR + xx;
+        return true;
+      }
+      double y = ziggurat.f[layer] +
+                 rng() * (ziggurat.f[layer - 1] - ziggurat.f[layer]);
+      if (y < exp(-0.5 * x * x)) {
+        *ans = x;
+        return true;
+      }
+      return false;
+    }
+
+    bool exponential_ziggurat_slow_path(RNG &rng, const Ziggurat &ziggurat,
+                                        int layer, double x, double *ans) {
+      if (layer == 0) {
+        // The exponential distribution is memoryless, so the tail beyond R
+        // is R plus another exponential.
+        *ans = kExponentialR + rexp_ziggurat_mt(rng);
+        return true;
+      }
+      double y = ziggurat.f[layer] +
+                 rng() * (ziggurat.f[layer - 1] - ziggurat.f[layer]);
+      if (y < exp(-x)) {
+        *ans = x;
+        return true;
+      }
+      return false;
+    }
+
+    // The low 8 bits of 'bits' choose the layer, the next bit the sign, and
+    // the top 52 bits the abscissa.
+    inline double normal_ziggurat(RNG &rng, const Ziggurat &ziggurat) {
+      while (true) {
+        std::uint64_t bits = rng.random_bits();
+        int layer = bits & 0xff;
+        bool negative = (bits >> 8) & 1;
+        std::uint64_t abscissa = bits >> 12;
+        double x = abscissa * ziggurat.w[layer];
+        if (abscissa < ziggurat.k[layer]) {
+          return negative ? -x : x;
+        }
+        double ans;
+        if (normal_ziggurat_slow_path(rng, ziggurat, layer, x, &ans)) {
+          return negative ? -ans : ans;
+        }
+      }
+    }
+
+    // The low 8 bits of 'bits' choose the layer, and the top 53 bits the
+    // abscissa.
+    inline double exponential_ziggurat(RNG &rng, const Ziggurat &ziggurat) {
+      while (true) {
+        std::uint64_t bits = rng.random_bits();
+        int layer = bits & 0xff;
+        std::uint64_t abscissa = bits >> 11;
+        double x = abscissa * ziggurat.w[layer];
+        if (abscissa < ziggurat.k[layer]) {
+          return x;
+        }
+        double ans;
+        if (exponential_ziggurat_slow_path(rng, ziggurat, layer, x, &ans)) {
+          return ans;
+        }
+      }
+    }
+
+    // Marsaglia and Tsang's acceptance test for Ga(d + 1/3, 1).  'v' is (1 +
+    // c * z)^3.  The squeeze is checked first, because it avoids two logs.
+    inline bool accept_gamma(double d, double z, double v, double u) {
+      double zsq = z * z;
+      if (u < 1 - 0.0331 * zsq * zsq) return true;
+      return log(u) < 0.5 * zsq + d * (1 - v + log(v));
+    }
+
+    // A single Ga(d + 1/3, 1) deviate, used to fill the holes left by
+    // rejections in the batch.
+    double marsaglia_tsang(RNG &rng, double d, double c) {
+      while (true) {
+        double z = rnorm_ziggurat_mt(rng);
+        double v = 1 + c * z;
+        if (v <= 0) continue;
+        v = v * v * v;
+        if (accept_gamma(d, z, v, positive_uniform(rng))) {
+          return d * v;
+        }
+      }
+    }
+  }  // namespace
+
+  double rnorm_ziggurat_mt(RNG &rng) {
+    return normal_ziggurat(rng, normal_ziggurat());
+  }
+
+  double rexp_ziggurat_mt(RNG &rng) {
+    return exponential_ziggurat(rng, exponential_ziggurat());
+  }
+
+  void rnorm_mt(RNG &rng, Vector &output, double mu, double sigma) {
+    if (sigma < 0) {
+      report_error("Negative standard deviation in rnorm_mt.");
+    }
+    const Ziggurat &ziggurat(normal_ziggurat());
+    double *data = output.data();
+    int n = output.size();
+    for (int i = 0; i < n; ++i) {
+      data[i] = normal_ziggurat(rng, ziggurat);
+    }
+    if (mu != 0 || sigma != 1) {
+      for (int i = 0; i < n; ++i) {
+        data[i] = mu + sigma * data[i];
+      }
+    }
+  }
+
+  void runif_mt(RNG &rng, Vector &output, double lo, double hi) {
+    if (hi < lo) {
+      report_error("Upper limit less than lower limit in runif_mt.");
+    }
+    int n = output.size();
+    double *data = output.data();
+    rng.fill_uniform(data, n);
+    if (lo != 0 || hi != 1) {
+      double width = hi - lo;
+      for (int i = 0; i < n; ++i) {
+        data[i] = lo + width * data[i];
+      }
+    }
+  }
+
+  void rexp_mt(RNG &rng, Vector &output, double rate) {
+    if (rate <= 0) {
+      report_error("Rate parameter must be positive in rexp_mt.");
+    }
+    const Ziggurat &ziggurat(exponential_ziggurat());
+    double *data = output.data();
+    int n = output.size();
+    for (int i = 0; i < n; ++i) {
+      data[i] = exponential_ziggurat(rng, ziggurat);
+    }
+    if (rate != 1) {
+      double scale = 1.0 / rate;
+      for (int i = 0; i < n; ++i) {
+        data[i] *= scale;
+      }
+    }
+  }
+
+  void rgamma_mt(RNG &rng, Vector &output, double shape, double rate) {
+    if (shape <= 0 || rate <= 0) {
+      report_error("Shape and rate parameters must be positive in rgamma_mt.");
+    }
+    int n = output.size();
+    if (n == 0) return;
+    bool boost = shape < 1;
+    double d = (boost ? shape + 1 : shape) - 1.0 / 3;
+    double c = 1.0 / sqrt(9 * d);
+
+    Vector z(n);
+    Vector u(n);
+    rnorm_mt(rng, z);
+    rng.fill_uniform(u.data(), n);
+
+    // First pass: the squeeze test for each proposal.  There are no
+    // data-dependent branches here, so the loop can be vectorized.
+    // Rejected elements are marked with -1.
+    double *data = output.data();
+    for (int i = 0; i < n; ++i) {
+      double v = 1 + c * z[i];
+      double vcubed = v * v * v;
+      double zsq = z[i] * z[i];
+      bool accepted = v > 0 && (1 - u[i]) < 1 - 0.0331 * zsq * zsq;
+      data[i] = accepted ? d * vcubed : -1.0;
+    }
+
+    // Second pass: give the proposals that failed the squeeze the full
+    // acceptance test, and replace the ones that fail it with fresh draws.
+    // Only a few percent of proposals reach this point.
+    for (int i = 0; i < n; ++i) {
+      if (data[i] >= 0) continue;
+      double v = 1 + c * z[i];
+      if (v > 0) {
+        v = v * v * v;
+        if (accept_gamma(d, z[i], v, 1 - u[i])) {
+          data[i] = d * v;
+          continue;
+        }
+      }
+      data[i] = marsaglia_tsang(rng, d, c);
+    }
+
+    if (boost) {
+      rng.fill_uniform(u.data(), n);
+      double inverse_shape = 1.0 / shape;
+      for (int i = 0; i < n; ++i) {
+        data[i] *= pow(1 - u[i], inverse_shape);
+      }
+    }
+    if (rate != 1) {
+      double scale = 1.0 / rate;
+      for (int i = 0; i < n; ++i) {
+        data[i] *= scale;
+      }
+    }
+  }
+
+}  // namespace BOOM
@@ -24,16 +24,158 @@
 
 namespace BOOM {
 
-  RNG::RNG()
-      : generator_(std::random_device()())
-  {}
+  namespace {
+    // Multipliers and Weyl constants from Salmon et al. (2011).
+    const std::uint32_t kPhiloxM0 = 0xD2511F53;
+    const std::uint32_t kPhiloxM1 = 0xCD9E8D57;
+    const std::uint32_t kPhiloxW0 = 0x9E3779B9;
+    const std::uint32_t kPhiloxW1 = 0xBB67AE85;
 
-  RNG::RNG(RngIntType seed)
-      : generator_(seed)
-  {}
+    inline void mulhilo(std::uint32_t a, std::uint32_t b, std::uint32_t &hi,
+                        std::uint32_t &lo) {
+      std::uint64_t product = static_cast<std::uint64_t>(a) * b;
+      hi = static_cast<std::uint32_t>(product >> 32);
+      lo = static_cast<std::uint32_t>(product);
+    }
+
+    // The "splitmix64" finalizer, used to turn (seed, stream) pairs into well
+    // mixed Mersenne twister seeds.
+    std::uint64_t mix_bits(std::uint64_t x) {
+      x += 0x9E3779B97F4A7C15ULL;
+      x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+      x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+      return x ^ (x >> 31);
+    }
+  }  // namespace
+
+  PhiloxEngine::PhiloxEngine(std::uint64_t key, std::uint64_t stream)
+      : key_(key), stream_(stream), position_(0), buffer_position_(2) {}
+
+  void PhiloxEngine::seed(std::uint64_t key) {
+    key_ = key;
+    set_stream(0);
+  }
+
+  void PhiloxEngine::set_stream(std::uint64_t stream) {
+    stream_ = stream;
+    position_ = 0;
+    buffer_position_ = 2;
+  }
+
+  void PhiloxEngine::generate_block(const std::uint32_t counter[4],
+                                    const std::uint32_t key[2],
+                                    std::uint32_t output[4]) {
+    std::uint32_t c0 = counter[0], c1 = counter[1], c2 = counter[2],
+                  c3 = counter[3];
+    std::uint32_t k0 = key[0], k1 = key[1];
+    for (int round = 0; round < 10; ++round) {
+      std::uint32_t hi0, lo0, hi1, lo1;
+      mulhilo(kPhiloxM0, c0, hi0, lo0);
+      mulhilo(kPhiloxM1, c2, hi1, lo1);
+      c0 = hi1 ^ c1 ^ k0;
+      c1 = lo1;
+      c2 = hi0 ^ c3 ^ k1;
+      c3 = lo0;
+      k0 += kPhiloxW0;
+      k1 += kPhiloxW1;
+    }
+    output[0] = c0;
+    output[1] = c1;
+    output[2] = c2;
+    output[3] = c3;
+  }
+
+  void PhiloxEngine::compute_block(std::uint64_t position,
+                                   std::uint64_t *output) const {
+    const std::uint32_t counter[4] = {
+      static_cast<std::uint32_t>(position),
+      static_cast<std::uint32_t>(position >> 32),
+      static_cast<std::uint32_t>(stream_),
+      static_cast<std::uint32_t>(stream_ >> 32)};
+    const std::uint32_t key[2] = {
+      static_cast<std::uint32_t>(key_),
+      static_cast<std::uint32_t>(key_ >> 32)};
+    std::uint32_t block[4];
+    generate_block(counter, key, block);
+    output[0] = block[0] | (static_cast<std::uint64_t>(block[1]) << 32);
+    output[1] = block[2] | (static_cast<std::uint64_t>(block[3]) << 32);
+  }
+
+  void PhiloxEngine::refill() {
+    compute_block(position_++, buffer_);
+    buffer_position_ = 0;
+  }
+
+  void PhiloxEngine::fill_uniform(double *output, int n) {
+    int i = 0;
+    while (i < n && buffer_position_ < 2) {
+      output[i++] = to_unit_interval(buffer_[buffer_position_++]);
+    }
+    std::uint64_t block[2];
+    for (; i + 1 < n; i += 2) {
+      compute_block(position_++, block);
+      output[i] = to_unit_interval(block[0]);
+      output[i + 1] = to_unit_interval(block[1]);
+    }
+    if (i < n) {
+      output[i] = to_unit_interval((*this)());
+    }
+  }
+
+  void PhiloxEngine::discard(std::uint64_t n) {
+    while (n > 0 && buffer_position_ < 2) {
+      ++buffer_position_;
+      --n;
+    }
+    position_ += n / 2;
+    if (n % 2 == 1) {
+      refill();
+      ++buffer_position_;
+    }
+  }
+
+  //======================================================================
+  RNG::RNG() : type_(MERSENNE_TWISTER) { seed(); }
+
+  RNG::RNG(RngIntType seed) : RNG(seed, MERSENNE_TWISTER) {}
+
+  RNG::RNG(RngIntType seed, GeneratorType type)
+      : type_(type), seed_(seed), generator_(seed), philox_(seed) {}
 
   void RNG::seed() {
-    generator_.seed(std::random_device()());
+    seed(std::random_device()());
+  }
+
+  void RNG::seed(RngIntType seed) {
+    seed_ = seed;
+    if (type_ == PHILOX) {
+      philox_.seed(seed);
+    } else {
+      generator_.seed(seed);
+    }
+  }
+
+  void RNG::fill_uniform(double *output, int n) {
+    if (type_ == PHILOX) {
+      philox_.fill_uniform(output, n);
+    } else {
+      for (int i = 0; i < n; ++i) {
+        output[i] = dist_(generator_);
+      }
+    }
+  }
+
+  RNG RNG::split() {
+    return RNG(random_bits(), type_);
+  }
+
+  void RNG::jump(std::uint64_t stream_id) {
+    if (type_ == PHILOX) {
+      philox_.seed(seed_);
+      philox_.set_stream(stream_id);
+    } else {
+      generator_.seed(mix_bits(seed_ ^ mix_bits(stream_id)));
+    }
   }
 
   RNG::RngIntType seed_rng(RNG &rng) {
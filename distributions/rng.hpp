@@ -24,33 +24,172 @@
 #include <cstdint>
 
 namespace BOOM {
+
+  // The Philox4x32-10 counter based random number generator from Salmon,
+  // Moraes, Dror, and Shaw (2011) "Parallel random numbers: as easy as 1, 2,
+  // 3".
+  //
+  // The output is a fixed function of a 64 bit key and a 128 bit counter, so
+  // the state is tiny, seeding is free, and any point in the sequence can be
+  // reached without generating the values before it.  Here the upper 64 bits
+  // of the counter select a "stream", and the lower 64 bits give the position
+  // within the stream.  Streams with different ids (or different keys) are
+  // statistically independent, which makes it cheap to give each thread, or
+  // each observation, a reproducible stream of its own.
+  //
+  // This class satisfies the requirements of a UniformRandomBitGenerator, so
+  // it can be used with the distributions in <random>.
+  class PhiloxEngine {
+   public:
+    using result_type = std::uint64_t;
+
+    explicit PhiloxEngine(std::uint64_t key = 0, std::uint64_t stream = 0);
+
+    // Set the key, and move to the start of stream 0.
+    void seed(std::uint64_t key);
+
+    // Move to the start of the given stream, keeping the current key.
+    void set_stream(std::uint64_t stream);
+
+    std::uint64_t key() const { return key_; }
+    std::uint64_t stream() const { return stream_; }
+
+    // Return 64 random bits.
+    result_type operator()() {
+      if (buffer_position_ >= 2) {
+        refill();
+      }
+      return buffer_[buffer_position_++];
+    }
+
+    // Fill output[0], ..., output[n-1] with U[0, 1) deviates.  Equivalent to n
+    // calls to to_unit_interval(operator()()), but avoids the per-draw buffer
+    // bookkeeping.
+    void fill_uniform(double *output, int n);
+
+    // Advance the position in the current stream by n 64-bit draws.
+    void discard(std::uint64_t n);
+
+    // Map 64 random bits to a U[0, 1) deviate with 53 bits of precision.
+    static double to_unit_interval(std::uint64_t bits) {
+      return (bits >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    // The Philox4x32-10 bijection.  Exposed for testing.
+    static void generate_block(const std::uint32_t counter[4],
+                               const std::uint32_t key[2],
+                               std::uint32_t output[4]);
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return ~result_type(0); }
+
+   private:
+    // Compute the block at position_, store it in buffer_, and increment
+    // position_.
+    void refill();
+
+    // Compute the two 64-bit outputs for block 'position' of the current
+    // stream.
+    void compute_block(std::uint64_t position, std::uint64_t *output) const;
+
+    std::uint64_t key_;
+    std::uint64_t stream_;
+
+    // The index of the next block to be computed.
+    std::uint64_t position_;
+
+    // Each block produces two 64 bit outputs.
+    std::uint64_t buffer_[2];
+    int buffer_position_;
+  };
+
   // A random number generator for simulating real valued U[0, 1) deviates.
+  //
+  // By default the generator is a Mersenne twister.  A counter based Philox
+  // generator can be requested at construction.  It is much cheaper to seed
+  // and to split into independent streams, so it is the better choice when
+  // many parallel streams are needed.
   class RNG {
    public:
     using RngIntType = std::uint_fast64_t;
 
+    enum GeneratorType { MERSENNE_TWISTER, PHILOX };
+
     // Seed with std::random_device.
     RNG();
 
     // Seed with a specified value.
     explicit RNG(RngIntType seed);
 
+    // Seed with a specified value, using the requested type of generator.
+    RNG(RngIntType seed, GeneratorType type);
+
     // Seed from a C++ standard random device, if one is present.
     void seed();
 
     // Seed using a specified value.
-    void seed(RngIntType seed) {generator_.seed(seed);}
+    void seed(RngIntType seed);
 
-    // Simulate a U[0, 1) random deviate.
-    double operator()() {return dist_(generator_);}
+    GeneratorType type() const { return type_; }
 
+    // Simulate a U[0, 1) random deviate.
+    double operator()() {
+      if (type_ == PHILOX) {
+        return PhiloxEngine::to_unit_interval(philox_());
+      }
+      return dist_(generator_);
+    }
+
+    // Fill output[0], ..., output[n-1] with U[0, 1) deviates.
+    void fill_uniform(double *output, int n);
+
+    // Simulate 64 uniformly distributed random bits.
+    RngIntType random_bits() {
+      return type_ == PHILOX ? philox_() : generator_();
+    }
+
+    // Returns a new generator of the same type, seeded with random bits drawn
+    // from this one.  The results are reproducible: a given sequence of calls
+    // to split() always produces the same children.
+    RNG split();
+
+    // Restart this generator on the stream with the given id.  The stream is
+    // a deterministic function of the most recent seed and the stream id, so
+    // jump(i) gives the same sequence no matter which thread calls it, or
+    // when.  For the Philox generator this is free.  For the Mersenne twister
+    // it requires reseeding.
+    void jump(std::uint64_t stream_id);
+
+    // The Mersenne twister underlying the default generator.  Not used by the
+    // PHILOX generator.  Code that needs a bit generator for the
+    // distributions in <random> should use BitGenerator instead.
     std::mt19937_64 & generator() {return generator_;}
 
+    // Adapts an RNG to the UniformRandomBitGenerator requirements, so that it
+    // can be used with the distributions in <random>.
+    class BitGenerator {
+     public:
+      using result_type = RngIntType;
+      explicit BitGenerator(RNG &rng) : rng_(rng) {}
+      result_type operator()() { return rng_.random_bits(); }
+      static constexpr result_type min() { return 0; }
+      static constexpr result_type max() { return ~result_type(0); }
+
+     private:
+      RNG &rng_;
+    };
+
    private:
+    GeneratorType type_;
+
+    // The most recent seed, used by jump().
+    RngIntType seed_;
+
     // TODO(steve): once you can use c++17 in R and elsewhere replace this with
     // a std::variant that will choose the fastest RNG for each implementation.
     std::mt19937_64 generator_;
     std::uniform_real_distribution<double> dist_;
+    PhiloxEngine philox_;
   };
 
   // The GlobalRng is a singleton.
@@ -0,0 +1,127 @@
+#include "gtest/gtest.h"
+#include "distributions.hpp"
+#include "distributions/rng.hpp"
+#include "Models/Glm/PosteriorSamplers/TDataImputer.hpp"
+#include "test_utils/test_utils.hpp"
+#include "stats/moments.hpp"
+
+namespace {
+
+  using namespace BOOM;
+  using std::cout;
+  using std::endl;
+
+  class BulkDeviatesTest : public ::testing::Test {
+   protected:
+    BulkDeviatesTest() {
+      GlobalRng::rng.seed(8675309);
+    }
+  };
+
+  TEST_F(BulkDeviatesTest, ZigguratNormal) {
+    RNG rng(12345);
+    Vector draws(100000);
+    for (int i = 0; i < draws.size(); ++i) {
+      draws[i] = rnorm_ziggurat_mt(rng);
+    }
+    EXPECT_NEAR(0.0, mean(draws), .02);
+    EXPECT_NEAR(1.0, sd(draws), .02);
+    EXPECT_TRUE(DistributionsMatch(draws, [](double x) {
+          return pnorm(x, 0, 1); }));
+
+    // The tail beyond the base layer must be reached, and must be right.
+    int tail_count = 0;
+    for (int i = 0; i < draws.size(); ++i) {
+      tail_count += fabs(draws[i]) > 3.6541528853610088;
+    }
+    double expected_tail = 2 * draws.size() * pnorm(-3.6541528853610088);
+    EXPECT_NEAR(expected_tail, tail_count, 5 * sqrt(expected_tail));
+  }
+
+  TEST_F(BulkDeviatesTest, ZigguratExponential) {
+    RNG rng(12345, RNG::PHILOX);
+    Vector draws(100000);
+    for (int i = 0; i < draws.size(); ++i) {
+      draws[i] = rexp_ziggurat_mt(rng);
+    }
+    EXPECT_NEAR(1.0, mean(draws), .02);
+    EXPECT_NEAR(1.0, sd(draws), .03);
+    EXPECT_TRUE(DistributionsMatch(draws, [](double x) {
+          return pexp(x, 1.0); }));
+  }
+
+  TEST_F(BulkDeviatesTest, Normal) {
+    RNG rng(2718);
+    Vector draws(50000);
+    rnorm_mt(rng, draws, 3, 2);
+    EXPECT_NEAR(3.0, mean(draws), .05);
+    EXPECT_NEAR(2.0, sd(draws), .05);
+    EXPECT_TRUE(DistributionsMatch(draws, [](double x) {
+          return pnorm(x, 3, 2); }));
+
+    // Same seed, same draws.
+    RNG rng2(2718);
+    Vector draws2(50000);
+    rnorm_mt(rng2, draws2, 3, 2);
+    EXPECT_TRUE(VectorEquals(draws, draws2));
+  }
+
+  TEST_F(BulkDeviatesTest, Uniform) {
+    RNG rng(31415);
+    Vector draws(50000);
+    runif_mt(rng, draws, -1, 3);
+    EXPECT_GE(min(draws), -1.0);
+    EXPECT_LT(max(draws), 3.0);
+    EXPECT_TRUE(DistributionsMatch(draws, [](double x) {
+          return punif(x, -1, 3); }));
+  }
+
+  TEST_F(BulkDeviatesTest, Exponential) {
+    RNG rng(1729);
+    Vector draws(50000);
+    rexp_mt(rng, draws, 4.0);
+    EXPECT_NEAR(0.25, mean(draws), .01);
+    EXPECT_TRUE(DistributionsMatch(draws, [](double x) {
+          return pexp(x, 4.0); }));
+  }
+
+  TEST_F(BulkDeviatesTest, Gamma) {
+    RNG rng(42);
+    Vector draws(50000);
+    for (double shape : {0.3, 1.0, 2.5, 40.0}) {
+      double rate = 1.7;
+      rgamma_mt(rng, draws, shape, rate);
+      EXPECT_GT(min(draws), 0.0);
+      EXPECT_NEAR(shape / rate, mean(draws), 5 * sqrt(shape / 50000) / rate)
+          << "shape = " << shape;
+      EXPECT_TRUE(DistributionsMatch(draws, [shape, rate](double x) {
+            return pgamma(x, shape, rate); }))
+          << "shape = " << shape;
+    }
+  }
+
+  TEST_F(BulkDeviatesTest, TDataImputer) {
+    RNG rng(8675309);
+    TDataImputer imputer;
+    int n = 20000;
+    Vector residuals(n, 1.3);
+    Vector weights;
+    double sd = 0.8;
+    double nu = 3.0;
+    imputer.impute(rng, residuals, sd, nu, weights);
+    EXPECT_EQ(n, weights.size());
+
+    // Each weight is a draw from Ga((nu + 1) / 2, (nu + (r / sd)^2) / 2).
+    double shape = 0.5 * (nu + 1);
+    double rate = 0.5 * (nu + square(1.3 / sd));
+    EXPECT_TRUE(DistributionsMatch(weights, [shape, rate](double x) {
+          return pgamma(x, shape, rate); }));
+
+    Vector scalar_weights(n);
+    for (int i = 0; i < n; ++i) {
+      scalar_weights[i] = imputer.impute(rng, 1.3, sd, nu);
+    }
+    EXPECT_TRUE(TwoSampleKs(weights, scalar_weights));
+  }
+
+}  // namespace
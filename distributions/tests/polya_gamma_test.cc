@@ -0,0 +1,80 @@
+#include "gtest/gtest.h"
+#include "distributions.hpp"
+#include "stats/moments.hpp"
+#include "test_utils/test_utils.hpp"
+
+namespace {
+
+  using namespace BOOM;
+  using std::endl;
+
+  class PolyaGammaTest : public ::testing::Test {
+   protected:
+    PolyaGammaTest() {
+      GlobalRng::rng.seed(8675309);
+    }
+
+    // Checks the sample mean and variance of PG(b, c) draws against the
+    // exact moments.
+    void CheckMoments(double b, double c, int niter = 20000) {
+      Vector draws(niter);
+      for (int i = 0; i < niter; ++i) {
+        draws[i] = rpolya_gamma_mt(GlobalRng::rng, b, c);
+      }
+      EXPECT_GT(min(draws), 0.0);
+      double true_mean = polya_gamma_mean(b, c);
+      double true_variance = polya_gamma_variance(b, c);
+      EXPECT_NEAR(mean(draws), true_mean, 4 * sqrt(true_variance / niter))
+          << "b = " << b << " c = " << c;
+      EXPECT_NEAR(var(draws) / true_variance, 1.0, .08)
+          << "b = " << b << " c = " << c;
+    }
+  };
+
+  TEST_F(PolyaGammaTest, Moments) {
+    // The moment formulas should be continuous where they switch to series
+    // expansions near c = 0.
+    EXPECT_NEAR(polya_gamma_mean(1, 1e-6), polya_gamma_mean(1, 1.0001e-6),
+                1e-10);
+    EXPECT_NEAR(polya_gamma_variance(1, 1e-2),
+                polya_gamma_variance(1, 1.0001e-2), 1e-8);
+    EXPECT_DOUBLE_EQ(polya_gamma_mean(1, 0), .25);
+    EXPECT_DOUBLE_EQ(polya_gamma_variance(1, 0), 1.0 / 24);
+    EXPECT_TRUE(std::isfinite(polya_gamma_variance(1, 1000)));
+
+    CheckMoments(1, 0);
+    CheckMoments(1, 2.5);
+    CheckMoments(1, -7);
+    CheckMoments(3, 0.3);
+    CheckMoments(10, 25);
+    CheckMoments(2.5, 1.2);
+    CheckMoments(0.3, 4);
+    CheckMoments(500, 1.5);
+  }
+
+  // The series method used for fractional shape parameters should agree in
+  // distribution with the exact method, because PG(1/2, c) + PG(1/2, c) has
+  // the PG(1, c) distribution.
+  TEST_F(PolyaGammaTest, FractionalShapeMatchesExact) {
+    int niter = 5000;
+    double c = 1.7;
+    Vector exact(niter);
+    Vector series(niter);
+    for (int i = 0; i < niter; ++i) {
+      exact[i] = rpolya_gamma_mt(GlobalRng::rng, 1.0, c);
+      series[i] = rpolya_gamma_mt(GlobalRng::rng, 0.5, c) +
+          rpolya_gamma_mt(GlobalRng::rng, 0.5, c);
+    }
+    EXPECT_TRUE(TwoSampleKs(exact, series));
+  }
+
+  TEST_F(PolyaGammaTest, Reproducible) {
+    RNG rng1(12345, RNG::PHILOX);
+    RNG rng2(12345, RNG::PHILOX);
+    for (int i = 0; i < 100; ++i) {
+      EXPECT_DOUBLE_EQ(rpolya_gamma_mt(rng1, 2, 1.0),
+                       rpolya_gamma_mt(rng2, 2, 1.0));
+    }
+  }
+
+}  // namespace
@@ -0,0 +1,144 @@
+#include "gtest/gtest.h"
+#include <random>
+#include "distributions.hpp"
+#include "distributions/rng.hpp"
+#include "test_utils/test_utils.hpp"
+#include "stats/moments.hpp"
+
+namespace {
+
+  using namespace BOOM;
+  using std::cout;
+  using std::endl;
+
+  // Known answer tests from the Random123 distribution.
+  TEST(PhiloxTest, KnownAnswers) {
+    std::uint32_t output[4];
+
+    const std::uint32_t zero_counter[4] = {0, 0, 0, 0};
+    const std::uint32_t zero_key[2] = {0, 0};
+    PhiloxEngine::generate_block(zero_counter, zero_key, output);
+    EXPECT_EQ(0x6627e8d5u, output[0]);
+    EXPECT_EQ(0xe169c58du, output[1]);
+    EXPECT_EQ(0xbc57ac4cu, output[2]);
+    EXPECT_EQ(0x9b00dbd8u, output[3]);
+
+    const std::uint32_t ones_counter[4] = {
+      0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff};
+    const std::uint32_t ones_key[2] = {0xffffffff, 0xffffffff};
+    PhiloxEngine::generate_block(ones_counter, ones_key, output);
+    EXPECT_EQ(0x408f276du, output[0]);
+    EXPECT_EQ(0x41c83b0eu, output[1]);
+    EXPECT_EQ(0xa20bc7c6u, output[2]);
+    EXPECT_EQ(0x6d5451fdu, output[3]);
+
+    const std::uint32_t pi_counter[4] = {
+      0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344};
+    const std::uint32_t pi_key[2] = {0xa4093822, 0x299f31d0};
+    PhiloxEngine::generate_block(pi_counter, pi_key, output);
+    EXPECT_EQ(0xd16cfe09u, output[0]);
+    EXPECT_EQ(0x94fdccebu, output[1]);
+    EXPECT_EQ(0x5001e420u, output[2]);
+    EXPECT_EQ(0x24126ea1u, output[3]);
+  }
+
+  TEST(PhiloxTest, FillUniformMatchesSequentialDraws) {
+    RNG rng1(8675309, RNG::PHILOX);
+    RNG rng2(8675309, RNG::PHILOX);
+    // Start the bulk fill at an odd position to exercise the buffer.
+    EXPECT_DOUBLE_EQ(rng1(), rng2());
+    Vector bulk(101);
+    rng1.fill_uniform(bulk.data(), bulk.size());
+    for (int i = 0; i < bulk.size(); ++i) {
+      EXPECT_DOUBLE_EQ(rng2(), bulk[i]);
+    }
+    EXPECT_DOUBLE_EQ(rng1(), rng2());
+
+    EXPECT_GE(min(bulk), 0.0);
+    EXPECT_LT(max(bulk), 1.0);
+  }
+
+  TEST(PhiloxTest, Discard) {
+    PhiloxEngine e1(17, 3);
+    PhiloxEngine e2(17, 3);
+    e1();
+    e1.discard(7);
+    for (int i = 0; i < 8; ++i) e2();
+    EXPECT_EQ(e1(), e2());
+    e1.discard(4);
+    for (int i = 0; i < 4; ++i) e2();
+    EXPECT_EQ(e1(), e2());
+  }
+
+  TEST(PhiloxTest, Moments) {
+    RNG rng(12, RNG::PHILOX);
+    int n = 100000;
+    Vector draws(n);
+    rng.fill_uniform(draws.data(), n);
+    EXPECT_NEAR(0.5, mean(draws), 4 * sqrt(1.0 / (12 * n)));
+    EXPECT_NEAR(1.0 / 12, var(draws), .002);
+    EXPECT_TRUE(DistributionsMatch(
+        draws, [](double x) {return punif(x, 0, 1);}));
+  }
+
+  TEST(RngTest, JumpIsReproducible) {
+    for (RNG::GeneratorType type : {RNG::MERSENNE_TWISTER, RNG::PHILOX}) {
+      RNG rng1(42, type);
+      RNG rng2(42, type);
+      // rng2 takes some draws before jumping.  It should not matter.
+      for (int i = 0; i < 13; ++i) rng2();
+      rng1.jump(5);
+      rng2.jump(5);
+      for (int i = 0; i < 20; ++i) {
+        EXPECT_DOUBLE_EQ(rng1(), rng2());
+      }
+
+      // Different streams give different draws.
+      rng2.jump(6);
+      rng1.jump(5);
+      int matches = 0;
+      for (int i = 0; i < 20; ++i) {
+        matches += rng1() == rng2();
+      }
+      EXPECT_EQ(0, matches);
+    }
+  }
+
+  TEST(RngTest, SplitIsReproducible) {
+    for (RNG::GeneratorType type : {RNG::MERSENNE_TWISTER, RNG::PHILOX}) {
+      RNG parent1(99, type);
+      RNG parent2(99, type);
+      RNG child1 = parent1.split();
+      RNG child2 = parent2.split();
+      EXPECT_EQ(type, child1.type());
+      for (int i = 0; i < 10; ++i) {
+        EXPECT_DOUBLE_EQ(child1(), child2());
+      }
+      RNG second_child = parent1.split();
+      EXPECT_NE(child1(), second_child());
+    }
+  }
+
+  TEST(RngTest, MersenneTwisterUnchanged) {
+    // The default generator must reproduce earlier results.
+    RNG rng(8675309);
+    std::mt19937_64 generator(8675309);
+    std::uniform_real_distribution<double> dist;
+    for (int i = 0; i < 10; ++i) {
+      EXPECT_DOUBLE_EQ(dist(generator), rng());
+    }
+  }
+
+  TEST(RngTest, BitGenerator) {
+    RNG rng(3, RNG::PHILOX);
+    RNG::BitGenerator bits(rng);
+    std::poisson_distribution<int> poisson(4.0);
+    int n = 10000;
+    Vector draws(n);
+    for (int i = 0; i < n; ++i) {
+      draws[i] = poisson(bits);
+    }
+    EXPECT_NEAR(4.0, mean(draws), 4 * sqrt(4.0 / n));
+  }
+
+}  // namespace
@@ -55,6 +55,8 @@ namespace BOOM{
   //    in the optimization.
   //  * Both: Try conjugate gradient first, and then transition to
   //    BFGS.
+  //  * LBFGS: Limited memory BFGS, which avoids storing a dense
+  //    Hessian approximation.  Use this for high dimensional problems.
   //
   // Conjugate gradient is more stable far from the mode, but requires
   // more function evaluations.  BFGS can be unstable far from the
@@ -62,7 +64,8 @@ namespace BOOM{
   enum OptimizationMethod {
     BFGS,
     ConjugateGradient,
-    Both
+    Both,
+    LBFGS
   };
 
   // Optimize a function for which no derivative information is
@@ -222,6 +225,56 @@ namespace BOOM{
               bool &fail,
               int trace_freq= -1);
 
+  // Minimize a function using limited memory BFGS.  Instead of a dense
+  // approximation to the inverse Hessian, L-BFGS keeps the most recent
+  // 'history_size' position and gradient differences, so each iteration
+  // costs O(history_size * dim) time and memory.  Step sizes are chosen by a
+  // line search satisfying the strong Wolfe conditions.  Prefer this to bfgs
+  // when x has more than a few hundred elements.
+  //
+  // Args:
+  //   x: On input x is the initial set of function arguments of the
+  //      algorithm.  On output it is the minimizing value.
+  //   dtarget:  The function to be minimized, with gradient.
+  //   max_iterations:  The maximum number of iterations allowed.
+  //   gradient_tolerance: Convergence is declared when the largest
+  //     absolute element of the gradient falls below this value.
+  //   relative_tolerance: Convergence is declared when the relative
+  //     change in the function value is less than this amount.
+  //   fncount: On output this is filled with the number of function
+  //     (and gradient) evaluations that were made.
+  //   fail: Filled with 'false' on successful exit, and 'true' otherwise.
+  //   history_size: The number of correction pairs to store.
+  //
+  // Returns:
+  //   The value of dtarget at the minimizing x.
+  double lbfgs(Vector &x,
+               const dTarget &dtarget,
+               int max_iterations,
+               double gradient_tolerance,
+               double relative_tolerance,
+               int &fncount,
+               bool &fail,
+               int history_size = 10);
+
+  // Minimize a function subject to the box constraints lower <= x <= upper
+  // using projected L-BFGS.  Variables sitting on a bound with the gradient
+  // pointing out of the box are held fixed, the L-BFGS direction is computed
+  // for the remaining variables, and a backtracking search is done along the
+  // projection of that direction onto the box.  Elements of lower and upper
+  // may be infinite.  Arguments are as in lbfgs.  The gradient tolerance
+  // applies to the projected gradient.
+  double lbfgs_bounded(Vector &x,
+                       const dTarget &dtarget,
+                       const Vector &lower,
+                       const Vector &upper,
+                       int max_iterations,
+                       double gradient_tolerance,
+                       double relative_tolerance,
+                       int &fncount,
+                       bool &fail,
+                       int history_size = 10);
+
   // Minimize the function f using the conjugate gradient algorithm.
   // Args:
 
@@ -0,0 +1,415 @@
+/*
+  Copyright (C) 2019 Steven L. Scott
+
+  This library is free software; you can redistribute it and/or modify it under
+  the terms of the GNU Lesser General Public License as published by the Free
+  Software Foundation; either version 2.1 of the License, or (at your option)
+  any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT
+  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+  FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+  details.
+
+  You should have received a copy of the GNU Lesser General Public License along
+  with this library; if not, write to the Free Software Foundation, Inc., 51
+  Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <vector>
+
+#include "LinAlg/Vector.hpp"
+#include "cpputil/math_utils.hpp"
+#include "cpputil/report_error.hpp"
+#include "numopt.hpp"
+
+namespace BOOM {
+
+  namespace {
+    // Constants for the sufficient decrease and curvature conditions.
+    const double armijo_constant = 1e-4;
+    const double curvature_constant = 0.9;
+    const int max_line_search_steps = 40;
+
+    // The minimizer of the cubic interpolating phi(a), phi'(a), phi(b) and
+    // phi'(b), safeguarded to lie well inside the interval [a, b].  Falls back
+    // to bisection if the cubic has no usable minimum.
+    double interpolate(double a, double fa, double da,
+                       double b, double fb, double db) {
+      double lo = std::min(a, b);
+      double hi = std::max(a, b);
+      double margin = 0.1 * (hi - lo);
+      double bisection = 0.5 * (a + b);
+      if (!std::isfinite(fa) || !std::isfinite(fb) || !std::isfinite(da) ||
+          !std::isfinite(db)) {
+        return bisection;
+      }
+      double d1 = da + db - 3 * (fa - fb) / (a - b);
+      double discriminant = d1 * d1 - da * db;
+      if (discriminant < 0) return bisection;
+      double d2 = (b > a ? 1.0 : -1.0) * std::sqrt(discriminant);
+      double denominator = db - da + 2 * d2;
+      if (denominator == 0) return bisection;
+      double ans = b - (b - a) * (db + d2 - d1) / denominator;
+      if (!std::isfinite(ans) || ans < lo + margin || ans > hi - margin) {
+        return bisection;
+      }
+      return ans;
+    }
+
+    // The state of an L-BFGS minimization.  Vectors are allocated once and
+    // reused across iterations.
+    class LbfgsMinimizer {
+     public:
+      LbfgsMinimizer(const dTarget &f, int dim, int history_size,
+                     const Vector *lower, const Vector *upper)
+          : f_(f),
+            lower_(lower),
+            upper_(upper),
+            history_size_(std::max(history_size, 1)),
+            number_stored_(0),
+            newest_(-1),
+            s_(history_size_, Vector(dim)),
+            y_(history_size_, Vector(dim)),
+            rho_(history_size_),
+            alpha_(history_size_),
+            gradient_(dim),
+            direction_(dim),
+            trial_x_(dim),
+            trial_gradient_(dim),
+            free_(dim, true),
+            function_count_(0) {}
+
+      bool bounded() const { return lower_ != nullptr; }
+      int number_stored() const { return number_stored_; }
+      int function_count() const { return function_count_; }
+
+      double evaluate(const Vector &x, Vector &gradient) {
+        ++function_count_;
+        return f_(x, gradient);
+      }
+
+      // Move x inside the box.
+      void project(Vector &x) const {
+        if (!bounded()) return;
+        for (int i = 0; i < x.size(); ++i) {
+          x[i] = std::min(std::max(x[i], (*lower_)[i]), (*upper_)[i]);
+        }
+      }
+
+      // Identify the variables that are free to move.  A variable is held
+      // fixed if it sits on a bound and the negative gradient points outside
+      // the box.  Returns the largest absolute element of the projected
+      // gradient.
+      double find_free_variables(const Vector &x) {
+        double ans = 0;
+        for (int i = 0; i < x.size(); ++i) {
+          bool at_lower = bounded() && x[i] <= (*lower_)[i] && gradient_[i] > 0;
+          bool at_upper = bounded() && x[i] >= (*upper_)[i] && gradient_[i] < 0;
+          free_[i] = !(at_lower || at_upper);
+          if (free_[i]) ans = std::max(ans, std::fabs(gradient_[i]));
+        }
+        return ans;
+      }
+
+      // Set direction_ to -H * gradient_ using the two loop recursion, with
+      // the fixed variables masked out.
+      void compute_direction() {
+        int dim = direction_.size();
+        for (int i = 0; i < dim; ++i) {
+          direction_[i] = free_[i] ? -gradient_[i] : 0.0;
+        }
+        if (number_stored_ == 0) return;
+        int index = newest_;
+        for (int k = 0; k < number_stored_; ++k) {
+          alpha_[index] = rho_[index] * masked_dot(s_[index], direction_);
+          masked_axpy(-alpha_[index], y_[index], direction_);
+          index = (index + history_size_ - 1) % history_size_;
+        }
+        // Scale by gamma = s'y / y'y, the usual initial Hessian approximation.
+        const Vector &y(y_[newest_]);
+        direction_ *= 1.0 / (rho_[newest_] * y.dot(y));
+        index = (newest_ + history_size_ - number_stored_ + 1) % history_size_;
+        for (int k = 0; k < number_stored_; ++k) {
+          double beta = rho_[index] * masked_dot(y_[index], direction_);
+          masked_axpy(alpha_[index] - beta, s_[index], direction_);
+          index = (index + 1) % history_size_;
+        }
+      }
+
+      // Store the correction pair s = x_new - x_old, y = g_new - g_old, if it
+      // satisfies the curvature condition s'y > 0.
+      void update_history(const Vector &x_old, const Vector &x_new,
+                          const Vector &g_old, const Vector &g_new) {
+        int next = (newest_ + 1) % history_size_;
+        Vector &s(s_[next]);
+        Vector &y(y_[next]);
+        s = x_new;
+        s -= x_old;
+        y = g_new;
+        y -= g_old;
+        double sy = s.dot(y);
+        if (sy <= 1e-10 * y.dot(y) || !std::isfinite(sy)) {
+          return;
+        }
+        rho_[next] = 1.0 / sy;
+        newest_ = next;
+        number_stored_ = std::min(number_stored_ + 1, history_size_);
+      }
+
+      void clear_history() {
+        number_stored_ = 0;
+        newest_ = -1;
+      }
+
+      // Find a step along direction_ from x satisfying the strong Wolfe
+      // conditions (Nocedal and Wright, 2006, algorithms 3.5 and 3.6).  On
+      // success x, fx and gradient_ are updated and true is returned.
+      bool strong_wolfe_search(Vector &x, double &fx, double initial_step) {
+        double dphi0 = gradient_.dot(direction_);
+        double f0 = fx;
+        double previous_step = 0;
+        double previous_f = f0;
+        double previous_slope = dphi0;
+        double step = initial_step;
+        for (int i = 0; i < max_line_search_steps; ++i) {
+          double trial_f = evaluate_step(x, step);
+          double slope = trial_gradient_.dot(direction_);
+          if (!std::isfinite(trial_f) ||
+              trial_f > f0 + armijo_constant * step * dphi0 ||
+              (i > 0 && trial_f >= previous_f)) {
+            return zoom(x, fx, f0, dphi0, previous_step, previous_f,
+                        previous_slope, step, trial_f, slope);
+          }
+          if (std::fabs(slope) <= -curvature_constant * dphi0) {
+            return accept(x, fx, trial_f);
+          }
+          if (slope >= 0) {
+            return zoom(x, fx, f0, dphi0, step, trial_f, slope,
+                        previous_step, previous_f, previous_slope);
+          }
+          previous_step = step;
+          previous_f = trial_f;
+          previous_slope = slope;
+          step *= 2.0;
+        }
+        return false;
+      }
+
+      // Backtracking search along the projection of x + step * direction_
+      // onto the box.  The sufficient decrease condition is measured along
+      // the projected path.
+      bool projected_search(Vector &x, double &fx, double initial_step) {
+        double step = initial_step;
+        for (int i = 0; i < max_line_search_steps; ++i) {
+          trial_x_ = x;
+          trial_x_.axpy(direction_, step);
+          project(trial_x_);
+          double decrease = 0;
+          for (int j = 0; j < x.size(); ++j) {
+            decrease += gradient_[j] * (trial_x_[j] - x[j]);
+          }
+          double trial_f = evaluate(trial_x_, trial_gradient_);
+          if (std::isfinite(trial_f) &&
+              trial_f <= fx + armijo_constant * decrease) {
+            return accept(x, fx, trial_f);
+          }
+          step *= 0.5;
+        }
+        return false;
+      }
+
+      Vector &gradient() { return gradient_; }
+      const Vector &direction() const { return direction_; }
+
+     private:
+      double evaluate_step(const Vector &x, double step) {
+        trial_x_ = x;
+        trial_x_.axpy(direction_, step);
+        return evaluate(trial_x_, trial_gradient_);
+      }
+
+      bool accept(Vector &x, double &fx, double trial_f) {
+        x = trial_x_;
+        fx = trial_f;
+        gradient_ = trial_gradient_;
+        return true;
+      }
+
+      bool zoom(Vector &x, double &fx, double f0, double dphi0,
+                double lo, double f_lo, double slope_lo,
+                double hi, double f_hi, double slope_hi) {
+        for (int i = 0; i < max_line_search_steps; ++i) {
+          double step = interpolate(lo, f_lo, slope_lo, hi, f_hi, slope_hi);
+          double trial_f = evaluate_step(x, step);
+          double slope = trial_gradient_.dot(direction_);
+          if (!std::isfinite(trial_f) ||
+              trial_f > f0 + armijo_constant * step * dphi0 ||
+              trial_f >= f_lo) {
+            hi = step;
+            f_hi = trial_f;
+            slope_hi = slope;
+          } else {
+            if (std::fabs(slope) <= -curvature_constant * dphi0) {
+              return accept(x, fx, trial_f);
+            }
+            if (slope * (hi - lo) >= 0) {
+              hi = lo;
+              f_hi = f_lo;
+              slope_hi = slope_lo;
+            }
+            lo = step;
+            f_lo = trial_f;
+            slope_lo = slope;
+          }
+          if (std::fabs(hi - lo) <= 1e-16 * std::max(1.0, std::fabs(lo))) {
+            break;
+          }
+        }
+        // The interval collapsed.  Settle for sufficient decrease if the best
+        // point found improves on the starting point.
+        if (lo > 0 && f_lo < f0) {
+          double trial_f = evaluate_step(x, lo);
+          return accept(x, fx, trial_f);
+        }
+        return false;
+      }
+
+      double masked_dot(const Vector &v, const Vector &w) const {
+        if (!bounded()) return v.dot(w);
+        double ans = 0;
+        for (int i = 0; i < v.size(); ++i) {
+          if (free_[i]) ans += v[i] * w[i];
+        }
+        return ans;
+      }
+
+      void masked_axpy(double a, const Vector &v, Vector &w) const {
+        if (!bounded()) {
+          w.axpy(v, a);
+          return;
+        }
+        for (int i = 0; i < v.size(); ++i) {
+          if (free_[i]) w[i] += a * v[i];
+        }
+      }
+
+      const dTarget &f_;
+      const Vector *lower_;
+      const Vector *upper_;
+      int history_size_;
+      int number_stored_;
+      int newest_;
+      std::vector<Vector> s_;
+      std::vector<Vector> y_;
+      Vector rho_;
+      Vector alpha_;
+      Vector gradient_;
+      Vector direction_;
+      Vector trial_x_;
+      Vector trial_gradient_;
+      std::vector<bool> free_;
+      int function_count_;
+    };
+
+    double lbfgs_driver(Vector &x, const dTarget &target, const Vector *lower,
+                        const Vector *upper, int max_iterations,
+                        double gradient_tolerance, double relative_tolerance,
+                        int &fncount, bool &fail, int history_size) {
+      LbfgsMinimizer minimizer(target, x.size(), history_size, lower, upper);
+      minimizer.project(x);
+      double fx = minimizer.evaluate(x, minimizer.gradient());
+      fail = false;
+      if (!std::isfinite(fx)) {
+        std::ostringstream err;
+        err << "Non-fatal warning: initial value in lbfgs is not finite"
+            << endl
+            << "Initial f(x) = " << fx << endl;
+        report_warning(err.str());
+        fail = true;
+        fncount = minimizer.function_count();
+        return fx;
+      }
+
+      Vector previous_x(x.size());
+      Vector previous_gradient(x.size());
+      bool converged = false;
+      for (int iteration = 0; iteration < max_iterations; ++iteration) {
+        double projected_gradient_norm = minimizer.find_free_variables(x);
+        if (projected_gradient_norm <= gradient_tolerance) {
+          converged = true;
+          break;
+        }
+        minimizer.compute_direction();
+        if (minimizer.direction().dot(minimizer.gradient()) >= 0) {
+          // Not a descent direction.  Discard the history and restart with
+          // steepest descent.
+          minimizer.clear_history();
+          minimizer.compute_direction();
+        }
+        // Before any curvature information is available, take a first step
+        // of unit length.
+        double initial_step = 1.0;
+        if (iteration == 0) {
+          initial_step = std::min(
+              1.0, 1.0 / std::sqrt(minimizer.direction().normsq()));
+        }
+        previous_x = x;
+        previous_gradient = minimizer.gradient();
+        double previous_f = fx;
+        bool ok = minimizer.bounded()
+                      ? minimizer.projected_search(x, fx, initial_step)
+                      : minimizer.strong_wolfe_search(x, fx, initial_step);
+        if (!ok) {
+          if (minimizer.number_stored() > 0) {
+            // The quasi-Newton direction may be poorly scaled.  Retry from
+            // the same point with steepest descent.
+            minimizer.clear_history();
+            continue;
+          }
+          break;
+        }
+        minimizer.update_history(previous_x, x, previous_gradient,
+                                 minimizer.gradient());
+        if (std::fabs(fx - previous_f) <=
+            relative_tolerance * (std::fabs(previous_f) + relative_tolerance)) {
+          converged = true;
+          break;
+        }
+      }
+      fail = !converged;
+      fncount = minimizer.function_count();
+      return fx;
+    }
+  }  // namespace
+
+  double lbfgs(Vector &x, const dTarget &target, int max_iterations,
+               double gradient_tolerance, double relative_tolerance,
+               int &fncount, bool &fail, int history_size) {
+    return lbfgs_driver(x, target, nullptr, nullptr, max_iterations,
+                        gradient_tolerance, relative_tolerance, fncount, fail,
+                        history_size);
+  }
+
+  double lbfgs_bounded(Vector &x, const dTarget &target, const Vector &lower,
+                       const Vector &upper, int max_iterations,
+                       double gradient_tolerance, double relative_tolerance,
+                       int &fncount, bool &fail, int history_size) {
+    if (lower.size() != x.size() || upper.size() != x.size()) {
+      report_error("Bounds passed to lbfgs_bounded must be the same size "
+                   "as x.");
+    }
+    for (int i = 0; i < x.size(); ++i) {
+      if (lower[i] > upper[i]) {
+        report_error("Lower bound exceeds upper bound in lbfgs_bounded.");
+      }
+    }
+    return lbfgs_driver(x, target, &lower, &upper, max_iterations,
+                        gradient_tolerance, relative_tolerance, fncount, fail,
+                        history_size);
+  }
+
+}  // namespace BOOM
@@ -87,6 +87,23 @@ namespace BOOM {
         }
         break;
       }
+
+      case LBFGS: {
+        function_value = lbfgs(x, negative_f, max_iterations, epsilon,
+                               epsilon, fcount, fail);
+        if (!std::isfinite(function_value) || !x.all_finite()) {
+          x = original_x;
+        }
+        if (fail) {
+          // The Nelder-Mead restarts below are hopeless in the high
+          // dimensional problems for which LBFGS is intended.
+          error_message = "lbfgs failed to converge.";
+          function_value *= -1;
+          return false;
+        }
+        break;
+      }
+
       default:
         error_message = "Unknown optimization method.";
         return false;
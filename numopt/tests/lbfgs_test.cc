@@ -0,0 +1,183 @@
+#include "gtest/gtest.h"
+#include "numopt.hpp"
+#include "LinAlg/Vector.hpp"
+#include "cpputil/lse.hpp"
+#include "cpputil/math_utils.hpp"
+#include "test_utils/test_utils.hpp"
+#include "Models/Glm/PosteriorSamplers/LogitSampler.hpp"
+#include "Models/Glm/PosteriorSamplers/MLVS.hpp"
+#include "Models/MvnModel.hpp"
+#include "distributions.hpp"
+
+namespace {
+  using namespace BOOM;
+  using std::endl;
+  using std::cout;
+
+  // The extended Rosenbrock function, with minimum 0 at x = (1, ..., 1).
+  // The dimension must be even.
+  double rosenbrock(const Vector &x, Vector &g) {
+    double ans = 0;
+    g.resize(x.size());
+    for (int i = 0; i < x.size(); i += 2) {
+      double a = x[i + 1] - x[i] * x[i];
+      double b = 1 - x[i];
+      ans += 100 * a * a + b * b;
+      g[i] = -400 * a * x[i] - 2 * b;
+      g[i + 1] = 200 * a;
+    }
+    return ans;
+  }
+
+  class LbfgsTest : public ::testing::Test {
+   protected:
+    LbfgsTest() {
+      GlobalRng::rng.seed(8675309);
+    }
+  };
+
+  TEST_F(LbfgsTest, Rosenbrock) {
+    Vector x = {-1.2, 1.0};
+    int fncount = 0;
+    bool fail = true;
+    double fmin = lbfgs(x, rosenbrock, 500, 1e-8, 1e-14, fncount, fail);
+    EXPECT_FALSE(fail);
+    EXPECT_NEAR(fmin, 0.0, 1e-10);
+    EXPECT_TRUE(VectorEquals(x, Vector(2, 1.0), 1e-5))
+        << "x = " << x;
+  }
+
+  TEST_F(LbfgsTest, HighDimensionalRosenbrock) {
+    int dim = 1000;
+    Vector x(dim);
+    for (int i = 0; i < dim; i += 2) {
+      x[i] = -1.2;
+      x[i + 1] = 1.0;
+    }
+    int fncount = 0;
+    bool fail = true;
+    double fmin = lbfgs(x, rosenbrock, 2000, 1e-6, 1e-14, fncount, fail);
+    EXPECT_FALSE(fail);
+    EXPECT_NEAR(fmin, 0.0, 1e-8);
+    EXPECT_TRUE(VectorEquals(x, Vector(dim, 1.0), 1e-4));
+    // The number of function evaluations should not grow with the
+    // dimension, because the problem is separable.
+    EXPECT_LT(fncount, 500);
+  }
+
+  TEST_F(LbfgsTest, BoundedQuadratic) {
+    // Minimize sum_i (x[i] - c[i])^2 with some of the c's outside the box.
+    Vector center = {-2.0, 0.5, 3.0, 0.25};
+    auto quadratic = [&center](const Vector &x, Vector &g) {
+      g = x - center;
+      double ans = g.normsq();
+      g *= 2.0;
+      return ans;
+    };
+    Vector lower = {-1.0, -1.0, -1.0, negative_infinity()};
+    Vector upper = {1.0, 1.0, 1.0, infinity()};
+    Vector x(4, 0.0);
+    int fncount = 0;
+    bool fail = true;
+    double fmin = lbfgs_bounded(x, quadratic, lower, upper, 200, 1e-8, 1e-14,
+                                fncount, fail);
+    EXPECT_FALSE(fail);
+    Vector expected = {-1.0, 0.5, 1.0, 0.25};
+    EXPECT_TRUE(VectorEquals(x, expected, 1e-6)) << "x = " << x;
+    EXPECT_NEAR(fmin, 1.0 + 4.0, 1e-8);
+  }
+
+  TEST_F(LbfgsTest, MaxNd1Careful) {
+    // Maximize the negative Rosenbrock function.
+    auto f = [](const Vector &x, Vector &g) {
+      double ans = -rosenbrock(x, g);
+      g *= -1.0;
+      return ans;
+    };
+    auto target = [&f](const Vector &x) {
+      Vector g(x.size());
+      return f(x, g);
+    };
+    Vector x(20, 0.0);
+    double max_value = 0;
+    std::string error_message;
+    bool ok = max_nd1_careful(x, max_value, target, f, error_message, 1e-12,
+                              500, LBFGS);
+    EXPECT_TRUE(ok) << error_message;
+    EXPECT_NEAR(max_value, 0.0, 1e-8);
+    EXPECT_TRUE(VectorEquals(x, Vector(20, 1.0), 1e-4));
+  }
+
+  // The posterior mode of a logistic regression found by L-BFGS should match
+  // the one found by Newton-Raphson.
+  TEST_F(LbfgsTest, LogitPosteriorMode) {
+    int sample_size = 500;
+    int xdim = 5;
+    Vector beta = {1.0, -1.0, 0.5, 0.0, 2.0};
+    NEW(LogisticRegressionModel, newton_model)(xdim);
+    NEW(LogisticRegressionModel, lbfgs_model)(xdim);
+    for (int i = 0; i < sample_size; ++i) {
+      Vector x(xdim);
+      x.randomize();
+      x[0] = 1.0;
+      bool y = runif() < plogis(x.dot(beta));
+      NEW(BinaryRegressionData, data_point)(y, x);
+      newton_model->add_data(data_point);
+      lbfgs_model->add_data(data_point);
+    }
+    NEW(MvnModel, prior)(Vector(xdim, 0.0), SpdMatrix(xdim, 1.0));
+    NEW(LogitSampler, newton_sampler)(newton_model.get(), prior);
+    NEW(LogitSampler, lbfgs_sampler)(lbfgs_model.get(), prior);
+    lbfgs_sampler->set_posterior_mode_method(LogitSampler::LimitedMemoryBFGS);
+    newton_sampler->find_posterior_mode(1e-8);
+    lbfgs_sampler->find_posterior_mode(1e-8);
+    EXPECT_TRUE(VectorEquals(newton_model->Beta(), lbfgs_model->Beta(), 1e-3))
+        << "Newton: " << newton_model->Beta() << endl
+        << "LBFGS:  " << lbfgs_model->Beta();
+    EXPECT_NEAR(newton_sampler->log_posterior_at_mode(),
+                lbfgs_sampler->log_posterior_at_mode(), 1e-6);
+  }
+
+  // The multinomial logit posterior mode, found by L-BFGS over the included
+  // coefficients, should be a stationary point of the log posterior.
+  TEST_F(LbfgsTest, MultinomialLogitPosteriorMode) {
+    int sample_size = 500;
+    int nchoices = 3;
+    int subject_xdim = 3;
+    Matrix beta_subject(subject_xdim, nchoices - 1);
+    beta_subject.randomize_gaussian();
+    NEW(MultinomialLogitModel, model)(nchoices, subject_xdim, 0);
+    for (int i = 0; i < sample_size; ++i) {
+      Vector x(subject_xdim);
+      x.randomize_gaussian();
+      x[0] = 1.0;
+      Vector eta(nchoices, 0.0);
+      VectorView(eta, 1) = x * beta_subject;
+      NEW(VectorData, subject_predictors)(x);
+      std::vector<Ptr<VectorData>> empty_choice_predictors;
+      NEW(ChoiceData, data_point)(
+          CategoricalData(rmulti(exp(eta - lse(eta))), nchoices),
+          subject_predictors, empty_choice_predictors);
+      model->add_data(data_point);
+    }
+    int xdim = model->beta_size(false);
+    NEW(MvnModel, prior)(Vector(xdim, 0.0), SpdMatrix(xdim, 1.0));
+    NEW(VariableSelectionPrior, inclusion_prior)(xdim, .5);
+    NEW(MLVS, sampler)(model.get(), prior, inclusion_prior);
+    model->coef().drop(1);
+
+    sampler->find_posterior_mode(1e-10);
+    const Selector &inc(model->coef().inc());
+    Vector mode = model->coef().included_coefficients();
+    EXPECT_EQ(xdim - 1, mode.size());
+    EXPECT_DOUBLE_EQ(0.0, model->coef().Beta()[1]);
+    Vector gradient;
+    Matrix unused;
+    double log_posterior = model->Loglike(mode, gradient, unused, 1);
+    log_posterior += prior->logp_given_inclusion(mode, &gradient, nullptr,
+                                                 inc, false);
+    EXPECT_NEAR(log_posterior, sampler->log_posterior_at_mode(), 1e-8);
+    EXPECT_LT(gradient.max_abs(), 1e-3) << gradient;
+  }
+
+}  // namespace
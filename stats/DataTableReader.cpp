@@ -0,0 +1,553 @@
+/*
+  Copyright (C) 2019 Steven L. Scott
+
+  This library is free software; you can redistribute it and/or modify it under
+  the terms of the GNU Lesser General Public License as published by the Free
+  Software Foundation; either version 2.1 of the License, or (at your option)
+  any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT
+  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+  FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+  details.
+
+  You should have received a copy of the GNU Lesser General Public License along
+  with this library; if not, write to the Free Software Foundation, Inc., 51
+  Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+*/
+
+#include "stats/DataTableReader.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "cpputil/DefaultVnames.hpp"
+#include "cpputil/ThreadTools.hpp"
+#include "cpputil/report_error.hpp"
+#include "cpputil/string_utils.hpp"
+
+namespace BOOM {
+
+  namespace {
+    //======================================================================
+    // A read-only view of the contents of a file.  On POSIX systems the file
+    // is memory mapped.  Elsewhere it is read into memory.
+    class MappedFile {
+     public:
+      explicit MappedFile(const std::string &filename)
+          : data_(nullptr), size_(0) {
+#ifndef _WIN32
+        int fd = open(filename.c_str(), O_RDONLY);
+        if (fd < 0) open_error(filename);
+        struct stat info;
+        if (fstat(fd, &info) != 0) {
+          close(fd);
+          open_error(filename);
+        }
+        size_ = info.st_size;
+        if (size_ > 0) {
+          void *mapped = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+          if (mapped == MAP_FAILED) {
+            close(fd);
+            open_error(filename);
+          }
+          madvise(mapped, size_, MADV_SEQUENTIAL);
+          data_ = static_cast<const char *>(mapped);
+        }
+        close(fd);
+#else
+        std::ifstream in(filename.c_str(), std::ios::binary);
+        if (!in) open_error(filename);
+        std::ostringstream contents;
+        contents << in.rdbuf();
+        buffer_ = contents.str();
+        data_ = buffer_.data();
+        size_ = buffer_.size();
+#endif
+      }
+
+      ~MappedFile() {
+#ifndef _WIN32
+        if (data_) {
+          munmap(const_cast<char *>(data_), size_);
+        }
+#endif
+      }
+
+      MappedFile(const MappedFile &rhs) = delete;
+      MappedFile &operator=(const MappedFile &rhs) = delete;
+
+      const char *begin() const { return data_; }
+      const char *end() const { return data_ + size_; }
+      std::size_t size() const { return size_; }
+
+     private:
+      static void open_error(const std::string &filename) {
+        std::ostringstream err;
+        err << "Could not open file: " << filename << "\n";
+        report_error(err.str());
+      }
+
+      const char *data_;
+      std::size_t size_;
+#ifdef _WIN32
+      std::string buffer_;
+#endif
+    };
+
+    //======================================================================
+    // A field is a range of characters in the mapped file.
+    struct Field {
+      const char *begin;
+      const char *end;
+      std::size_t size() const { return end - begin; }
+    };
+
+    // Returns the end of the line starting at 'begin', which is either the
+    // position of the next newline or 'end'.
+    inline const char *find_line_end(const char *begin, const char *end) {
+      const void *pos = std::memchr(begin, '\n', end - begin);
+      return pos ? static_cast<const char *>(pos) : end;
+    }
+
+    inline bool is_white(char c) {
+      return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+    }
+
+    inline bool is_blank(const char *begin, const char *end) {
+      for (; begin != end; ++begin) {
+        if (!is_white(*begin)) return false;
+      }
+      return true;
+    }
+
+    // Splits lines into fields without copying.  See the class comment for
+    // DataTableReader for the splitting rules.
+    class LineSplitter {
+     public:
+      explicit LineSplitter(const std::string &sep)
+          : sep_(sep), delimited_(!is_all_white(sep) || sep == "\t") {}
+
+      void operator()(const char *begin, const char *end,
+                      std::vector<Field> &fields) const {
+        fields.clear();
+        // Ignore the carriage return in files with DOS line endings.
+        if (end != begin && end[-1] == '\r') --end;
+        if (delimited_) {
+          split_delimited(begin, end, fields);
+        } else {
+          split_space(begin, end, fields);
+        }
+      }
+
+     private:
+      bool is_delimiter(char c) const {
+        return sep_.find(c) != std::string::npos;
+      }
+
+      static bool is_quote(char c) { return c == '"' || c == '\''; }
+
+      // Returns the position of the first character at or after 'pos' that
+      // ends the current field.
+      template <class EndOfField>
+      static const char *scan_field(const char *pos, const char *end,
+                                    EndOfField end_of_field) {
+        char open_quote = 0;
+        for (; pos != end; ++pos) {
+          if (open_quote) {
+            if (*pos == open_quote) open_quote = 0;
+          } else if (is_quote(*pos)) {
+            open_quote = *pos;
+          } else if (end_of_field(*pos)) {
+            break;
+          }
+        }
+        return pos;
+      }
+
+      static Field trim_and_unquote(const char *begin, const char *end) {
+        while (begin != end && is_white(*begin)) ++begin;
+        while (end != begin && is_white(end[-1])) --end;
+        if (end - begin >= 2 && is_quote(*begin) && end[-1] == *begin) {
+          ++begin;
+          --end;
+        }
+        return Field{begin, end};
+      }
+
+      void split_delimited(const char *begin, const char *end,
+                           std::vector<Field> &fields) const {
+        if (begin == end) return;
+        const char *start = begin;
+        while (true) {
+          const char *pos = scan_field(
+              start, end, [this](char c) { return is_delimiter(c); });
+          fields.push_back(trim_and_unquote(start, pos));
+          if (pos == end) return;
+          start = pos + 1;
+        }
+      }
+
+      void split_space(const char *begin, const char *end,
+                       std::vector<Field> &fields) const {
+        const char *start = begin;
+        while (true) {
+          while (start != end && (*start == ' ' || *start == '\t')) ++start;
+          if (start == end) return;
+          const char *pos = scan_field(
+              start, end, [](char c) { return c == ' ' || c == '\t'; });
+          fields.push_back(trim_and_unquote(start, pos));
+          start = pos;
+        }
+      }
+
+      std::string sep_;
+      bool delimited_;
+    };
+
+    //======================================================================
+    // Describes how the fields in each line map to columns of the output.
+    struct ColumnPlan {
+      // The number of fields expected on each line.
+      int number_of_fields;
+
+      // For each field in the input, the index of its numeric or categorical
+      // buffer, or -1 if the field is not read.
+      std::vector<int> numeric_slot;
+      std::vector<int> categorical_slot;
+      int number_of_numeric_columns;
+      int number_of_categorical_columns;
+      std::vector<std::string> field_names;
+    };
+
+    // The data parsed from one chunk of the file.
+    struct ParsedChunk {
+      std::vector<std::vector<double>> numeric;
+      // Categorical values are stored as integer codes, with level names
+      // local to the chunk.
+      std::vector<std::vector<int>> codes;
+      std::vector<std::vector<std::string>> levels;
+      int number_of_lines = 0;
+      int number_of_rows = 0;
+      // If parsing fails the chunk records the (zero based) line number
+      // within the chunk and a description of the problem.
+      int error_line = -1;
+      std::string error_message;
+    };
+
+    // Convert a field to a double, requiring the whole field to be consumed.
+    inline bool parse_double(const Field &field, std::string &buffer,
+                             double &value) {
+      if (field.size() == 0) return false;
+      buffer.assign(field.begin, field.end);
+      char *parse_end = nullptr;
+      value = std::strtod(buffer.c_str(), &parse_end);
+      return parse_end == buffer.c_str() + buffer.size();
+    }
+
+    void parse_chunk(const char *begin, const char *end,
+                     const ColumnPlan &plan, const LineSplitter &split,
+                     ParsedChunk &chunk) {
+      chunk.numeric.resize(plan.number_of_numeric_columns);
+      chunk.codes.resize(plan.number_of_categorical_columns);
+      chunk.levels.resize(plan.number_of_categorical_columns);
+      std::vector<std::unordered_map<std::string, int>> dictionaries(
+          plan.number_of_categorical_columns);
+      std::vector<Field> fields;
+      std::string buffer;
+
+      const char *line = begin;
+      while (line < end) {
+        const char *line_end = find_line_end(line, end);
+        int line_number = chunk.number_of_lines++;
+        if (is_blank(line, line_end)) {
+          line = line_end + 1;
+          continue;
+        }
+        split(line, line_end, fields);
+        if (fields.size() != plan.number_of_fields) {
+          std::ostringstream err;
+          err << "Found " << fields.size() << " fields.  Expected "
+              << plan.number_of_fields << ".";
+          chunk.error_line = line_number;
+          chunk.error_message = err.str();
+          return;
+        }
+        for (int i = 0; i < plan.number_of_fields; ++i) {
+          const Field &field(fields[i]);
+          int slot = plan.numeric_slot[i];
+          if (slot >= 0) {
+            double value;
+            if (!parse_double(field, buffer, value)) {
+              std::ostringstream err;
+              err << "Expected a numeric value in field number " << i + 1
+                  << " (" << plan.field_names[i] << ").  Got "
+                  << std::string(field.begin, field.end) << ".";
+              chunk.error_line = line_number;
+              chunk.error_message = err.str();
+              return;
+            }
+            chunk.numeric[slot].push_back(value);
+            continue;
+          }
+          slot = plan.categorical_slot[i];
+          if (slot >= 0) {
+            buffer.assign(field.begin, field.end);
+            std::unordered_map<std::string, int> &dictionary(
+                dictionaries[slot]);
+            auto it = dictionary.find(buffer);
+            int code;
+            if (it == dictionary.end()) {
+              code = chunk.levels[slot].size();
+              dictionary.emplace(buffer, code);
+              chunk.levels[slot].push_back(buffer);
+            } else {
+              code = it->second;
+            }
+            chunk.codes[slot].push_back(code);
+          }
+        }
+        ++chunk.number_of_rows;
+        line = line_end + 1;
+      }
+    }
+
+    // Returns the position following the end of the line containing pos.
+    inline const char *next_line(const char *pos, const char *end) {
+      const char *line_end = find_line_end(pos, end);
+      return line_end == end ? end : line_end + 1;
+    }
+  }  // namespace
+
+  //===========================================================================
+  DataTableReader::DataTableReader(bool header, const std::string &sep)
+      : header_(header),
+        sep_(sep),
+        type_inference_sample_size_(1000),
+        number_of_threads_(1),
+        chunk_size_(1 << 24) {}
+
+  void DataTableReader::set_type_inference_sample_size(int rows) {
+    type_inference_sample_size_ = std::max(rows, 1);
+  }
+
+  void DataTableReader::set_number_of_threads(int number_of_threads) {
+    number_of_threads_ = std::max(number_of_threads, 1);
+  }
+
+  void DataTableReader::set_chunk_size(std::size_t bytes) {
+    chunk_size_ = std::max<std::size_t>(bytes, 1);
+  }
+
+  void DataTableReader::select_columns(const std::vector<int> &columns) {
+    selected_columns_ = columns;
+    selected_column_names_.clear();
+  }
+
+  void DataTableReader::select_columns(
+      const std::vector<std::string> &column_names) {
+    if (!column_names.empty() && !header_) {
+      report_error("Columns can only be selected by name if the file has "
+                   "a header.");
+    }
+    selected_column_names_ = column_names;
+    selected_columns_.clear();
+  }
+
+  DataTable DataTableReader::read(const std::string &filename) const {
+    MappedFile file(filename);
+    LineSplitter split(sep_);
+    std::vector<Field> fields;
+    const char *pos = file.begin();
+    const char *end = file.end();
+    int header_lines = 0;
+
+    std::vector<std::string> variable_names;
+    if (header_ && pos != end) {
+      const char *line_end = find_line_end(pos, end);
+      split(pos, line_end, fields);
+      for (const Field &field : fields) {
+        variable_names.emplace_back(field.begin, field.end);
+      }
+      pos = next_line(pos, end);
+      header_lines = 1;
+    }
+    const char *data_begin = pos;
+
+    //--- Infer the column types from the first few rows. ---
+    int number_of_fields = variable_names.size();
+    std::vector<bool> numeric;
+    int rows_sampled = 0;
+    int line_number = header_lines;
+    while (pos != end && rows_sampled < type_inference_sample_size_) {
+      const char *line_end = find_line_end(pos, end);
+      ++line_number;
+      if (!is_blank(pos, line_end)) {
+        split(pos, line_end, fields);
+        if (number_of_fields == 0) {
+          number_of_fields = fields.size();
+        }
+        if (fields.size() != number_of_fields) {
+          std::ostringstream err;
+          err << "file: " << filename << "\n line number " << line_number
+              << " has " << fields.size() << " fields.  Expected "
+              << number_of_fields << ".";
+          report_error(err.str());
+        }
+        if (numeric.empty()) {
+          numeric.assign(number_of_fields, true);
+        }
+        for (int i = 0; i < number_of_fields; ++i) {
+          if (numeric[i]) {
+            numeric[i] = is_numeric(std::string(fields[i].begin,
+                                                fields[i].end));
+          }
+        }
+        ++rows_sampled;
+      }
+      pos = next_line(pos, end);
+    }
+    if (numeric.empty()) {
+      numeric.assign(number_of_fields, true);
+    }
+    if (variable_names.empty()) {
+      variable_names = default_vnames(number_of_fields);
+    }
+
+    //--- Decide which columns to read. ---
+    std::vector<int> columns = selected_columns_;
+    for (const auto &name : selected_column_names_) {
+      auto it = std::find(variable_names.begin(), variable_names.end(), name);
+      if (it == variable_names.end()) {
+        report_error("No column named '" + name + "' in file " + filename +
+                     ".");
+      }
+      columns.push_back(it - variable_names.begin());
+    }
+    if (columns.empty()) {
+      for (int i = 0; i < number_of_fields; ++i) columns.push_back(i);
+    }
+
+    ColumnPlan plan;
+    plan.number_of_fields = number_of_fields;
+    plan.numeric_slot.assign(number_of_fields, -1);
+    plan.categorical_slot.assign(number_of_fields, -1);
+    plan.number_of_numeric_columns = 0;
+    plan.number_of_categorical_columns = 0;
+    plan.field_names = variable_names;
+    for (int column : columns) {
+      if (column < 0 || column >= number_of_fields) {
+        std::ostringstream err;
+        err << "Column " << column << " was selected, but " << filename
+            << " only has " << number_of_fields << " columns.";
+        report_error(err.str());
+      }
+      if (plan.numeric_slot[column] >= 0 ||
+          plan.categorical_slot[column] >= 0) {
+        report_error("The same column was selected more than once.");
+      }
+      if (numeric[column]) {
+        plan.numeric_slot[column] = plan.number_of_numeric_columns++;
+      } else {
+        plan.categorical_slot[column] = plan.number_of_categorical_columns++;
+      }
+    }
+
+    //--- Divide the data into chunks of whole lines and parse them. ---
+    std::vector<std::pair<const char *, const char *>> chunk_bounds;
+    pos = data_begin;
+    while (pos != end) {
+      const char *chunk_end =
+          static_cast<std::size_t>(end - pos) > chunk_size_
+              ? next_line(pos + chunk_size_ - 1, end) : end;
+      chunk_bounds.emplace_back(pos, chunk_end);
+      pos = chunk_end;
+    }
+    std::vector<ParsedChunk> chunks(chunk_bounds.size());
+    int number_of_threads =
+        std::min<int>(number_of_threads_, chunk_bounds.size());
+    if (number_of_threads > 1) {
+      WorkStealingThreadPool &pool(WorkStealingThreadPool::global());
+      pool.set_minimum_number_of_threads(number_of_threads);
+      pool.parallel_for(0, chunks.size(), 1, [&](int i) {
+        parse_chunk(chunk_bounds[i].first, chunk_bounds[i].second, plan,
+                    split, chunks[i]);
+      });
+    } else {
+      for (int i = 0; i < chunks.size(); ++i) {
+        parse_chunk(chunk_bounds[i].first, chunk_bounds[i].second, plan,
+                    split, chunks[i]);
+      }
+    }
+
+    int number_of_rows = 0;
+    line_number = header_lines;
+    for (const ParsedChunk &chunk : chunks) {
+      if (chunk.error_line >= 0) {
+        std::ostringstream err;
+        err << "file: " << filename << "\n line number "
+            << line_number + chunk.error_line + 1 << ": "
+            << chunk.error_message;
+        report_error(err.str());
+      }
+      line_number += chunk.number_of_lines;
+      number_of_rows += chunk.number_of_rows;
+    }
+
+    //--- Assemble the columns, releasing chunk storage as we go. ---
+    DataTable table;
+    for (int column : columns) {
+      int slot = plan.numeric_slot[column];
+      if (slot >= 0) {
+        Vector values(number_of_rows);
+        double *out = values.data();
+        for (ParsedChunk &chunk : chunks) {
+          std::vector<double> &buffer(chunk.numeric[slot]);
+          out = std::copy(buffer.begin(), buffer.end(), out);
+          std::vector<double>().swap(buffer);
+        }
+        table.append_variable(values, variable_names[column]);
+        continue;
+      }
+      slot = plan.categorical_slot[column];
+      std::vector<std::string> levels;
+      for (const ParsedChunk &chunk : chunks) {
+        levels.insert(levels.end(), chunk.levels[slot].begin(),
+                      chunk.levels[slot].end());
+      }
+      std::sort(levels.begin(), levels.end());
+      levels.erase(std::unique(levels.begin(), levels.end()), levels.end());
+      std::vector<int> values;
+      values.reserve(number_of_rows);
+      std::vector<int> recode;
+      for (ParsedChunk &chunk : chunks) {
+        recode.clear();
+        for (const auto &level : chunk.levels[slot]) {
+          recode.push_back(
+              std::lower_bound(levels.begin(), levels.end(), level) -
+              levels.begin());
+        }
+        for (int code : chunk.codes[slot]) {
+          values.push_back(recode[code]);
+        }
+        std::vector<int>().swap(chunk.codes[slot]);
+      }
+      NEW(CatKey, key)(levels);
+      table.append_variable(CategoricalVariable(values, key),
+                            variable_names[column]);
+    }
+    return table;
+  }
+
+}  // namespace BOOM
@@ -0,0 +1,94 @@
+#ifndef BOOM_STATS_DATA_TABLE_READER_HPP_
+#define BOOM_STATS_DATA_TABLE_READER_HPP_
+
+/*
+  Copyright (C) 2019 Steven L. Scott
+
+  This library is free software; you can redistribute it and/or modify it under
+  the terms of the GNU Lesser General Public License as published by the Free
+  Software Foundation; either version 2.1 of the License, or (at your option)
+  any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT
+  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+  FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+  details.
+
+  You should have received a copy of the GNU Lesser General Public License along
+  with this library; if not, write to the Free Software Foundation, Inc., 51
+  Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+*/
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "stats/DataTable.hpp"
+
+namespace BOOM {
+
+  // Reads a delimited text file into a DataTable without materializing the
+  // file as strings.
+  //
+  // The file is memory mapped and divided into chunks of whole lines.  Column
+  // types are inferred from a sample of rows at the top of the file.  Each
+  // chunk is then parsed in a single pass: numeric fields are converted
+  // directly into per-column buffers, and categorical fields are interned as
+  // integer codes against a per-chunk dictionary of levels.  Chunks can be
+  // parsed in parallel.  When all chunks are done the per-chunk dictionaries
+  // are merged, so that levels are sorted as in DataTable::read_file.
+  //
+  // Field splitting follows StringSplitter.  If 'sep' is white space then
+  // fields are separated by runs of spaces or tabs.  Otherwise any character
+  // in 'sep' ends a field, and fields are trimmed of surrounding white space.
+  // Fields enclosed in matching single or double quotes have the quotes
+  // removed, and separators inside quotes are ignored.  Blank lines are
+  // skipped.
+  //
+  // Example:
+  //   DataTableReader reader(true, ",");
+  //   reader.set_number_of_threads(4);
+  //   reader.select_columns(std::vector<std::string>{"y", "x1", "x3"});
+  //   DataTable table = reader.read("big_file.csv");
+  class DataTableReader {
+   public:
+    // Args:
+    //   header: If 'true' then the first line of the file contains variable
+    //     names.  Otherwise default names are generated.
+    //   sep:  The field separator.
+    explicit DataTableReader(bool header = false, const std::string &sep = "");
+
+    // The number of rows at the top of the file used to infer column types.
+    // A column is numeric if every sampled value is numeric.  If a value that
+    // cannot be parsed as a number is later found in a numeric column an
+    // error is reported.
+    void set_type_inference_sample_size(int rows);
+
+    // The number of threads used to parse chunks.  Values less than 2 parse
+    // the file in the calling thread.
+    void set_number_of_threads(int number_of_threads);
+
+    // The approximate number of bytes in each chunk.
+    void set_chunk_size(std::size_t bytes);
+
+    // Only read the specified columns.  The columns of the resulting table
+    // appear in the order given here.  Column indices are zero based.  Names
+    // require a header.  An empty vector selects all columns.
+    void select_columns(const std::vector<int> &columns);
+    void select_columns(const std::vector<std::string> &column_names);
+
+    DataTable read(const std::string &filename) const;
+
+   private:
+    bool header_;
+    std::string sep_;
+    int type_inference_sample_size_;
+    int number_of_threads_;
+    std::size_t chunk_size_;
+    std::vector<int> selected_columns_;
+    std::vector<std::string> selected_column_names_;
+  };
+
+}  // namespace BOOM
+
+#endif  // BOOM_STATS_DATA_TABLE_READER_HPP_
@@ -0,0 +1,227 @@
+/*
+  Copyright (C) 2019 Steven L. Scott
+
+  This library is free software; you can redistribute it and/or modify it under
+  the terms of the GNU Lesser General Public License as published by the Free
+  Software Foundation; either version 2.1 of the License, or (at your option)
+  any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT
+  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+  FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+  details.
+
+  You should have received a copy of the GNU Lesser General Public License along
+  with this library; if not, write to the Free Software Foundation, Inc., 51
+  Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+*/
+
+#include "stats/QuantileSketch.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "cpputil/report_error.hpp"
+
+namespace BOOM {
+
+  namespace {
+    // The ratio between the capacities of adjacent levels.
+    const double capacity_ratio = 2.0 / 3.0;
+  }  // namespace
+
+  QuantileSketch::QuantileSketch(int k, RNG &seeding_rng)
+      : k_(k),
+        nobs_(0),
+        min_(std::numeric_limits<double>::infinity()),
+        max_(-std::numeric_limits<double>::infinity()),
+        stored_size_(0),
+        max_stored_size_(0),
+        rng_(seed_rng(seeding_rng)),
+        sorted_view_current_(false) {
+    if (k < 8) {
+      report_error("The accuracy parameter k must be at least 8.");
+    }
+    grow();
+  }
+
+  QuantileSketch::QuantileSketch(const QuantileSketchState &state,
+                                 RNG &seeding_rng)
+      : QuantileSketch(state.k, seeding_rng) {
+    restore_from_state(state);
+  }
+
+  int QuantileSketch::capacity(int level) const {
+    int depth = compactors_.size() - level - 1;
+    return static_cast<int>(std::ceil(std::pow(capacity_ratio, depth) * k_)) +
+           1;
+  }
+
+  void QuantileSketch::grow() {
+    compactors_.emplace_back();
+    max_stored_size_ = 0;
+    for (int h = 0; h < compactors_.size(); ++h) {
+      max_stored_size_ += capacity(h);
+    }
+  }
+
+  void QuantileSketch::add(double x) {
+    compactors_[0].push_back(x);
+    ++nobs_;
+    min_ = std::min(min_, x);
+    max_ = std::max(max_, x);
+    ++stored_size_;
+    sorted_view_current_ = false;
+    if (stored_size_ >= max_stored_size_) {
+      compress();
+    }
+  }
+
+  void QuantileSketch::add(const Vector &x) {
+    int start = 0;
+    int n = x.size();
+    while (start < n) {
+      // Copy as much data as fits before the next compression.
+      int room = std::max(1, max_stored_size_ - stored_size_);
+      int end = std::min(n, start + room);
+      std::vector<double> &level0(compactors_[0]);
+      for (int i = start; i < end; ++i) {
+        level0.push_back(x[i]);
+        min_ = std::min(min_, x[i]);
+        max_ = std::max(max_, x[i]);
+      }
+      nobs_ += end - start;
+      stored_size_ += end - start;
+      sorted_view_current_ = false;
+      if (stored_size_ >= max_stored_size_) {
+        compress();
+      }
+      start = end;
+    }
+  }
+
+  void QuantileSketch::compress() {
+    for (int h = 0; h < compactors_.size(); ++h) {
+      if (compactors_[h].size() >= capacity(h)) {
+        if (h + 1 >= compactors_.size()) {
+          grow();
+        }
+        std::vector<double> &level(compactors_[h]);
+        std::vector<double> &next(compactors_[h + 1]);
+        std::sort(level.begin(), level.end());
+        // An odd item out stays behind, so that weight is preserved.
+        bool odd = level.size() % 2 == 1;
+        double leftover = odd ? level.back() : 0.0;
+        if (odd) level.pop_back();
+        int offset = rng_.random_bits() & 1;
+        for (int i = offset; i < level.size(); i += 2) {
+          next.push_back(level[i]);
+        }
+        stored_size_ -= level.size() / 2;
+        level.clear();
+        if (odd) level.push_back(leftover);
+        if (stored_size_ < max_stored_size_) break;
+      }
+    }
+    sorted_view_current_ = false;
+  }
+
+  void QuantileSketch::merge(const QuantileSketch &other) {
+    if (other.nobs_ == 0) return;
+    while (compactors_.size() < other.compactors_.size()) {
+      grow();
+    }
+    for (int h = 0; h < other.compactors_.size(); ++h) {
+      compactors_[h].insert(compactors_[h].end(),
+                            other.compactors_[h].begin(),
+                            other.compactors_[h].end());
+    }
+    stored_size_ += other.stored_size_;
+    nobs_ += other.nobs_;
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+    sorted_view_current_ = false;
+    while (stored_size_ >= max_stored_size_) {
+      compress();
+    }
+  }
+
+  void QuantileSketch::build_sorted_view() const {
+    if (sorted_view_current_) return;
+    std::vector<std::pair<double, double>> weighted_items;
+    weighted_items.reserve(stored_size_);
+    double weight = 1.0;
+    for (const auto &level : compactors_) {
+      for (double item : level) {
+        weighted_items.emplace_back(item, weight);
+      }
+      weight *= 2;
+    }
+    std::sort(weighted_items.begin(), weighted_items.end());
+    sorted_items_.resize(weighted_items.size());
+    cumulative_weights_.resize(weighted_items.size());
+    double total = 0;
+    for (int i = 0; i < weighted_items.size(); ++i) {
+      sorted_items_[i] = weighted_items[i].first;
+      total += weighted_items[i].second;
+      cumulative_weights_[i] = total;
+    }
+    sorted_view_current_ = true;
+  }
+
+  double QuantileSketch::quantile(double prob) const {
+    if (nobs_ == 0) {
+      report_error("Quantiles are not defined for an empty sketch.");
+    }
+    if (prob <= 0) return min_;
+    if (prob >= 1) return max_;
+    build_sorted_view();
+    double target = prob * cumulative_weights_.back();
+    auto it = std::lower_bound(cumulative_weights_.begin(),
+                               cumulative_weights_.end(), target);
+    if (it == cumulative_weights_.end()) return max_;
+    return sorted_items_[it - cumulative_weights_.begin()];
+  }
+
+  double QuantileSketch::cdf(double x) const {
+    if (nobs_ == 0) return 0.0;
+    if (x < min_) return 0.0;
+    if (x >= max_) return 1.0;
+    build_sorted_view();
+    auto it = std::upper_bound(sorted_items_.begin(), sorted_items_.end(), x);
+    if (it == sorted_items_.begin()) return 0.0;
+    return cumulative_weights_[it - sorted_items_.begin() - 1] /
+           cumulative_weights_.back();
+  }
+
+  QuantileSketchState QuantileSketch::save_state() const {
+    QuantileSketchState ans;
+    ans.k = k_;
+    ans.nobs = nobs_;
+    ans.min = min_;
+    ans.max = max_;
+    for (const auto &level : compactors_) {
+      ans.compactors.push_back(Vector(level.begin(), level.end()));
+    }
+    return ans;
+  }
+
+  void QuantileSketch::restore_from_state(const QuantileSketchState &state) {
+    if (state.k < 8) {
+      report_error("The accuracy parameter k must be at least 8.");
+    }
+    k_ = state.k;
+    nobs_ = state.nobs;
+    min_ = state.min;
+    max_ = state.max;
+    compactors_.clear();
+    stored_size_ = 0;
+    for (const auto &level : state.compactors) {
+      grow();
+      compactors_.back().assign(level.begin(), level.end());
+      stored_size_ += level.size();
+    }
+    if (compactors_.empty()) grow();
+    sorted_view_current_ = false;
+  }
+
+}  // namespace BOOM
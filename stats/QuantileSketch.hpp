@@ -0,0 +1,136 @@
+#ifndef BOOM_STATS_QUANTILE_SKETCH_HPP_
+#define BOOM_STATS_QUANTILE_SKETCH_HPP_
+
+/*
+  Copyright (C) 2019 Steven L. Scott
+
+  This library is free software; you can redistribute it and/or modify it under
+  the terms of the GNU Lesser General Public License as published by the Free
+  Software Foundation; either version 2.1 of the License, or (at your option)
+  any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT
+  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+  FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+  details.
+
+  You should have received a copy of the GNU Lesser General Public License along
+  with this library; if not, write to the Free Software Foundation, Inc., 51
+  Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+*/
+
+#include <cstdint>
+#include <vector>
+#include "LinAlg/Vector.hpp"
+#include "distributions/rng.hpp"
+
+namespace BOOM {
+
+  // The serialized state of a QuantileSketch.
+  struct QuantileSketchState {
+    int k;
+    std::int64_t nobs;
+    double min;
+    double max;
+    // compactors[h] holds the items stored at level h, each of which
+    // represents 2^h observations.
+    std::vector<Vector> compactors;
+  };
+
+  // A mergeable approximation to the empirical distribution of a stream of
+  // numeric data, based on the KLL sketch of Karnin, Lang, and Liberty
+  // (2016), "Optimal quantile approximation in streams".
+  //
+  // Data are stored in a hierarchy of "compactors".  Items at level h carry
+  // weight 2^h.  When a level fills up it is sorted, and either the odd or the
+  // even numbered items (chosen at random) are promoted to the next level
+  // while the rest are discarded.  Lower levels get geometrically smaller
+  // capacities, so the total storage is about 3k numbers no matter how much
+  // data is seen.
+  //
+  // Error bounds: Let R(x) be the fraction of the data less than or equal to
+  // x.  For a single query, |cdf(x) - R(x)| is below roughly 1.7 / k^0.94
+  // with probability 0.99, which is about 1.7% for the default k = 200 and
+  // 0.3% for k = 1000.  The same bound applies to the rank of the value
+  // returned by quantile().  The bound does not depend on the number of
+  // observations, and it holds for sketches built by any sequence of add()
+  // and merge() calls.  The minimum and maximum are tracked exactly.
+  //
+  // Sketches of separate shards of a data set can be built independently (in
+  // separate threads, for example) and combined with merge().  A single
+  // sketch is not thread safe.
+  class QuantileSketch {
+   public:
+    // Args:
+    //   k: The accuracy parameter.  Larger values give smaller error at the
+    //     cost of more storage.  Must be at least 8.
+    //   seeding_rng: The random number generator used to seed the sketch's
+    //     own generator, which chooses the items kept during compaction.
+    explicit QuantileSketch(int k = 200, RNG &seeding_rng = GlobalRng::rng);
+    explicit QuantileSketch(const QuantileSketchState &state,
+                            RNG &seeding_rng = GlobalRng::rng);
+
+    // Add a data point to the sketch.
+    void add(double x);
+
+    // Add a collection of data points to the sketch.
+    void add(const Vector &x);
+
+    // Combine the data summarized by 'other' into this sketch.  The two
+    // sketches should have the same value of k.  If they do not, the
+    // accuracy is that of the smaller k.
+    void merge(const QuantileSketch &other);
+
+    // Return the approximate quantile associated with the given probability.
+    // Probabilities at or below 0 (or at or above 1) return the exact minimum
+    // (maximum).
+    double quantile(double prob) const;
+
+    // Return the approximate fraction of data less than or equal to x.
+    double cdf(double x) const;
+
+    // The number of observations summarized by the sketch.
+    std::int64_t nobs() const { return nobs_; }
+
+    // The number of items currently stored.
+    int stored_size() const { return stored_size_; }
+
+    int k() const { return k_; }
+    double min() const { return min_; }
+    double max() const { return max_; }
+
+    QuantileSketchState save_state() const;
+    void restore_from_state(const QuantileSketchState &state);
+
+   private:
+    // The number of items level h may hold before it must be compacted.
+    int capacity(int level) const;
+
+    // Add a new empty level at the top of the hierarchy.
+    void grow();
+
+    // Compact levels until the total storage is within capacity.
+    void compress();
+
+    // Build the sorted items and cumulative weights used by quantile() and
+    // cdf().
+    void build_sorted_view() const;
+
+    int k_;
+    std::int64_t nobs_;
+    double min_;
+    double max_;
+    std::vector<std::vector<double>> compactors_;
+    int stored_size_;
+    int max_stored_size_;
+    RNG rng_;
+
+    // The sorted view is rebuilt lazily after the sketch changes.
+    mutable bool sorted_view_current_;
+    mutable std::vector<double> sorted_items_;
+    mutable std::vector<double> cumulative_weights_;
+  };
+
+}  // namespace BOOM
+
+#endif  // BOOM_STATS_QUANTILE_SKETCH_HPP_
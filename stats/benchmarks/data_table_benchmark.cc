@@ -0,0 +1,91 @@
+/*
+  Copyright (C) 2019 Steven L. Scott
+
+  This library is free software; you can redistribute it and/or modify it under
+  the terms of the GNU Lesser General Public License as published by the Free
+  Software Foundation; either version 2.1 of the License, or (at your option)
+  any later version.
+
+  This library is distributed in the hope that it will be useful, but WITHOUT
+  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+  FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+  details.
+
+  You should have received a copy of the GNU Lesser General Public License along
+  with this library; if not, write to the Free Software Foundation, Inc., 51
+  Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+*/
+
+// Timings for reading a comma separated file into a DataTable, using
+// DataTable::read_file and DataTableReader.  The benchmark argument is the
+// number of rows in the file.  Each file has four numeric columns and two
+// categorical columns, simulated from a fixed seed.  Files are written to the
+// working directory and removed when the benchmark finishes.
+
+#include "benchmark/benchmark.h"
+#include "distributions.hpp"
+#include "stats/DataTable.hpp"
+#include "stats/DataTableReader.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+namespace {
+  using namespace BOOM;
+
+  // Writes a data file with the requested number of rows when constructed,
+  // and deletes it when destroyed.
+  class TemporaryDataFile {
+   public:
+    explicit TemporaryDataFile(int rows)
+        : filename_("data_table_benchmark_" + std::to_string(rows) + ".csv") {
+      GlobalRng::rng.seed(8675309);
+      const char *colors[] = {"red", "green", "blue", "yellow", "purple"};
+      std::ofstream out(filename_);
+      out << "y,x1,x2,x3,color,group\n";
+      for (int i = 0; i < rows; ++i) {
+        out << rnorm(0, 1) << "," << rnorm(0, 1) << "," << runif(0, 1) << ","
+            << random_int(0, 1000) << "," << colors[random_int(0, 4)]
+            << ",group" << random_int(0, 99) << "\n";
+      }
+    }
+    ~TemporaryDataFile() { std::remove(filename_.c_str()); }
+    const std::string &filename() const { return filename_; }
+
+   private:
+    std::string filename_;
+  };
+
+  void BM_ReadFile(benchmark::State &state) {
+    TemporaryDataFile file(state.range(0));
+    for (auto _ : state) {
+      DataTable table;
+      table.read_file(file.filename(), true, ",");
+      benchmark::DoNotOptimize(table.nobs());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+
+  // The second argument is the number of parsing threads.
+  void BM_DataTableReader(benchmark::State &state) {
+    TemporaryDataFile file(state.range(0));
+    DataTableReader reader(true, ",");
+    reader.set_number_of_threads(state.range(1));
+    for (auto _ : state) {
+      DataTable table = reader.read(file.filename());
+      benchmark::DoNotOptimize(table.nobs());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+
+  BENCHMARK(BM_ReadFile)
+      ->Arg(10000)->Arg(100000)->Unit(benchmark::kMillisecond);
+  BENCHMARK(BM_DataTableReader)
+      ->ArgsProduct({{10000, 100000}, {1, 4}})
+      ->Unit(benchmark::kMillisecond)
+      ->UseRealTime();
+
+}  // namespace
+
+BENCHMARK_MAIN();
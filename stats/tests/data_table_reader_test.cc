@@ -0,0 +1,114 @@
+#include "gtest/gtest.h"
+#include "LinAlg/Vector.hpp"
+#include "stats/DataTable.hpp"
+#include "stats/DataTableReader.hpp"
+#include "test_utils/test_utils.hpp"
+
+#include <cstdio>
+#include <fstream>
+
+namespace {
+  using namespace BOOM;
+  using std::endl;
+
+  class DataTableReaderTest : public ::testing::Test {
+   protected:
+    DataTableReaderTest() {
+      GlobalRng::rng.seed(8675309);
+    }
+
+    // Check that two tables hold the same variables.
+    void ExpectSameTable(const DataTable &lhs, const DataTable &rhs) {
+      ASSERT_EQ(lhs.nvars(), rhs.nvars());
+      ASSERT_EQ(lhs.nobs(), rhs.nobs());
+      for (int i = 0; i < lhs.nvars(); ++i) {
+        ASSERT_EQ(lhs.variable_type(i), rhs.variable_type(i));
+        EXPECT_EQ(lhs.vnames()[i], rhs.vnames()[i]);
+        if (lhs.variable_type(i) == VariableType::numeric) {
+          EXPECT_TRUE(VectorEquals(lhs.getvar(i), rhs.getvar(i)));
+        } else {
+          CategoricalVariable left = lhs.get_nominal(i);
+          CategoricalVariable right = rhs.get_nominal(i);
+          EXPECT_EQ(left.labels(), right.labels());
+          for (int j = 0; j < left.size(); ++j) {
+            EXPECT_EQ(left[j]->value(), right[j]->value());
+          }
+        }
+      }
+    }
+  };
+
+  TEST_F(DataTableReaderTest, MatchesReadFile) {
+    std::string path = "stats/tests/CarsClean.csv";
+    DataTable cars(path, true, ",");
+    DataTableReader reader(true, ",");
+    ExpectSameTable(cars, reader.read(path));
+
+    path = "stats/tests/autopref.txt";
+    DataTable autopref(path, false, "\t");
+    DataTableReader tab_reader(false, "\t");
+    ExpectSameTable(autopref, tab_reader.read(path));
+  }
+
+  TEST_F(DataTableReaderTest, ParallelChunks) {
+    std::string path = "stats/tests/CarsClean.csv";
+    DataTableReader reader(true, ",");
+    DataTable serial = reader.read(path);
+
+    // Small chunks force many chunk boundaries, and levels of categorical
+    // variables to be split across chunks.
+    reader.set_chunk_size(100);
+    reader.set_number_of_threads(4);
+    ExpectSameTable(serial, reader.read(path));
+  }
+
+  TEST_F(DataTableReaderTest, SelectColumns) {
+    std::string path = "stats/tests/CarsClean.csv";
+    DataTable cars(path, true, ",");
+    DataTableReader reader(true, ",");
+    reader.select_columns(std::vector<std::string>{"Price", "Make/Model"});
+    DataTable subset = reader.read(path);
+    EXPECT_EQ(subset.nvars(), 2);
+    EXPECT_EQ(subset.nobs(), cars.nobs());
+    EXPECT_EQ(subset.vnames()[0], "Price");
+    EXPECT_EQ(subset.variable_type(0), VariableType::numeric);
+    EXPECT_EQ(subset.variable_type(1), VariableType::categorical);
+    EXPECT_TRUE(VectorEquals(subset.getvar(0), cars.getvar(16)));
+
+    reader.select_columns(std::vector<int>{1, 2});
+    subset = reader.read(path);
+    EXPECT_EQ(subset.vnames()[0], "MPGCity");
+    EXPECT_TRUE(VectorEquals(subset.getvar(1), cars.getvar(2)));
+  }
+
+  TEST_F(DataTableReaderTest, TypeInferenceAndErrors) {
+    std::string path = "data_table_reader_test.txt";
+    {
+      std::ofstream out(path);
+      out << "x y\n"
+          << "1 a\n"
+          << "\n"
+          << "2.5 'b c'\n"
+          << "3 a\n";
+    }
+    DataTableReader reader(true);
+    DataTable table = reader.read(path);
+    EXPECT_EQ(table.nobs(), 3);
+    EXPECT_TRUE(VectorEquals(table.getvar(0), Vector{1.0, 2.5, 3.0}));
+    CategoricalVariable y = table.get_nominal(1);
+    EXPECT_EQ(y.labels(), (std::vector<std::string>{"a", "b c"}));
+    EXPECT_EQ(y.label(1), "b c");
+
+    // A non-numeric value after the type inference sample is an error.
+    {
+      std::ofstream out(path);
+      out << "x y\n"
+          << "1 a\n"
+          << "oops b\n";
+    }
+    reader.set_type_inference_sample_size(1);
+    EXPECT_THROW(reader.read(path), std::exception);
+    std::remove(path.c_str());
+  }
+
+}  // namespace
@@ -0,0 +1,89 @@
+#include "gtest/gtest.h"
+#include "stats/QuantileSketch.hpp"
+
+#include "LinAlg/Vector.hpp"
+#include "distributions.hpp"
+
+#include "test_utils/test_utils.hpp"
+
+namespace {
+  using namespace BOOM;
+  using std::endl;
+
+  class QuantileSketchTest : public ::testing::Test {
+   protected:
+    QuantileSketchTest() {
+      GlobalRng::rng.seed(8675309);
+    }
+  };
+
+  TEST_F(QuantileSketchTest, SmallSamplesAreExact) {
+    QuantileSketch sketch;
+    Vector y = {3.0, 1.0, 2.0, 5.0, 4.0};
+    sketch.add(y);
+    EXPECT_EQ(5, sketch.nobs());
+    EXPECT_DOUBLE_EQ(1.0, sketch.quantile(0.0));
+    EXPECT_DOUBLE_EQ(3.0, sketch.quantile(0.5));
+    EXPECT_DOUBLE_EQ(5.0, sketch.quantile(1.0));
+    EXPECT_DOUBLE_EQ(0.4, sketch.cdf(2.0));
+    EXPECT_DOUBLE_EQ(0.0, sketch.cdf(0.5));
+    EXPECT_DOUBLE_EQ(1.0, sketch.cdf(5.0));
+  }
+
+  TEST_F(QuantileSketchTest, NormalStream) {
+    QuantileSketch sketch(200);
+    int n = 200000;
+    for (int i = 0; i < n; ++i) {
+      sketch.add(rnorm());
+    }
+    EXPECT_EQ(n, sketch.nobs());
+    // Storage is bounded independent of n.
+    EXPECT_LT(sketch.stored_size(), 3 * 200 + 50);
+    for (double p : {0.01, 0.1, 0.25, 0.5, 0.75, 0.9, 0.99}) {
+      double q = sketch.quantile(p);
+      EXPECT_NEAR(pnorm(q), p, 0.017) << "p = " << p;
+      EXPECT_NEAR(sketch.cdf(qnorm(p)), p, 0.017) << "p = " << p;
+    }
+  }
+
+  TEST_F(QuantileSketchTest, MergeShards) {
+    // Four shards covering different parts of the distribution.
+    std::vector<QuantileSketch> shards;
+    int n = 50000;
+    for (int s = 0; s < 4; ++s) {
+      shards.emplace_back(200);
+      Vector data(n);
+      for (int i = 0; i < n; ++i) {
+        data[i] = runif(s, s + 1);
+      }
+      shards.back().add(data);
+    }
+    QuantileSketch total(200);
+    for (const auto &shard : shards) {
+      total.merge(shard);
+    }
+    EXPECT_EQ(4 * n, total.nobs());
+    EXPECT_LT(total.stored_size(), 3 * 200 + 50);
+    EXPECT_NEAR(0.0, total.min(), 1e-3);
+    EXPECT_NEAR(4.0, total.max(), 1e-3);
+    for (double p : {0.05, 0.3, 0.5, 0.8, 0.95}) {
+      EXPECT_NEAR(total.quantile(p), 4 * p, 4 * 0.017) << "p = " << p;
+    }
+  }
+
+  TEST_F(QuantileSketchTest, SaveAndRestore) {
+    QuantileSketch sketch(64);
+    for (int i = 0; i < 10000; ++i) {
+      sketch.add(rexp(1.0));
+    }
+    QuantileSketchState state = sketch.save_state();
+    QuantileSketch restored(state);
+    EXPECT_EQ(sketch.nobs(), restored.nobs());
+    EXPECT_EQ(sketch.stored_size(), restored.stored_size());
+    for (double p : {0.1, 0.5, 0.9}) {
+      EXPECT_DOUBLE_EQ(sketch.quantile(p), restored.quantile(p));
+    }
+    EXPECT_DOUBLE_EQ(sketch.cdf(1.0), restored.cdf(1.0));
+  }
+
+}  // namespace